@@ -54,5 +54,14 @@ int main(int argc, char *argv[])
     matrix::print(activation_functions::SOFTMAX.compute({&m1}));
     matrix::print(activation_functions::SOFTMAX.compute_derivatives({&m1}));
     // ----------- //
+    std::cout << "> fast approximations (sigmoid, tanh, softmax)" << std::endl;
+    auto derivatives = matrix(x, y, "derivatives");
+    matrix::print(activation_functions::SIGMOID_FAST.compute_with_derivatives({&m1}, derivatives));
+    matrix::print(derivatives);
+    matrix::print(activation_functions::TANH_FAST.compute_with_derivatives({&m1}, derivatives));
+    matrix::print(derivatives);
+    matrix::print(activation_functions::SOFTMAX_FAST.compute_with_derivatives({&m1}, derivatives));
+    matrix::print(derivatives);
+    // ----------- //
     return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -0,0 +1,208 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "lib/models/neural_network/neural_network.h"
+#include "lib/util/benchmark/benchmark.h"
+#include "examples/common.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <vector>
+
+
+using namespace cudaNN;
+
+
+// Largest tolerated difference between the layer and the reference.
+#define TOLERANCE 1e-4
+
+
+namespace
+{
+    /**
+     * Configuration of the comparison (see the usage in "main").
+     */
+    struct configuration
+    {
+        size_t nb_positions = 512;
+        size_t size = 128;
+        size_t nb_heads = 4;
+    };
+
+    /**
+     * @return - the columns [first, first + nb_columns[ of "m".
+     */
+    matrix columns(const matrix &m, size_t first, size_t nb_columns)
+    {
+        auto result = matrix(m.get_dimensions().first, nb_columns, "columns");
+
+        for (size_t i = 0; i < m.get_dimensions().first; i ++)
+        {
+            for (size_t j = 0; j < nb_columns; j ++)
+            {
+                result[(int) (i * nb_columns + j)] = m[(int) (i * m.get_dimensions().second + first + j)];
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Reference: the matrix of the scores of each head ("positions x
+     * positions"), masked, then its softmax (row by row), times the values.
+     * @return - the outputs of the layer "l" on "inputs".
+     */
+    matrix reference(attention &l, matrix &inputs)
+    {
+        auto nb_positions = inputs.get_dimensions().first;
+        auto size = l.size();
+        auto head_size = size / l.get_nb_heads();
+        auto projections = inputs * l.get_weights();
+        auto heads = matrix(nb_positions, size, "heads");
+
+        for (size_t i = 0; i < nb_positions; i ++)
+        {
+            for (size_t j = 0; j < 3 * size; j ++)
+            {
+                projections[(int) (i * 3 * size + j)] += l.get_biases()[(int) j];
+            }
+        }
+
+        for (size_t h = 0; h < l.get_nb_heads(); h ++)
+        {
+            auto queries = columns(projections, h * head_size, head_size);
+            auto keys = columns(projections, size + h * head_size, head_size);
+            auto values = columns(projections, 2 * size + h * head_size, head_size);
+            auto scores = queries * keys.transpose();
+            scores *= 1.f / std::sqrt((float) head_size);
+
+            for (size_t i = 0; i < nb_positions; i ++)
+            {
+                float *row = scores.get_data() + i * nb_positions;
+
+                for (size_t j = i + 1; l.is_causal() && j < nb_positions; j ++)
+                {
+                    row[j] = - std::numeric_limits<float>::infinity();
+                }
+
+                auto maximum = *std::max_element(row, row + nb_positions);
+                auto sum = 0.f;
+
+                for (size_t j = 0; j < nb_positions; j ++)
+                {
+                    row[j] = std::exp(row[j] - maximum);
+                    sum += row[j];
+                }
+
+                for (size_t j = 0; j < nb_positions; j ++)
+                {
+                    row[j] /= sum;
+                }
+            }
+
+            auto outputs = scores * values;
+
+            for (size_t i = 0; i < nb_positions; i ++)
+            {
+                std::copy(outputs.get_data() + i * head_size, outputs.get_data() + (i + 1) * head_size,
+                          heads.get_data() + i * size + h * head_size);
+            }
+        }
+
+        auto outputs = heads * l.get_output_weights();
+
+        for (size_t i = 0; i < nb_positions; i ++)
+        {
+            for (size_t j = 0; j < size; j ++)
+            {
+                outputs[(int) (i * size + j)] += l.get_output_biases()[(int) j];
+            }
+        }
+
+        return outputs;
+    }
+
+    /**
+     * @return - true if the outputs of the layer are the ones of the reference;
+     * the two are then measured, with the memory of the scores.
+     */
+    bool compare(const configuration &c, bool causal)
+    {
+        auto name = std::string(causal ? "causal attention" : "attention");
+        attention l(c.size, c.nb_heads, causal);
+        auto inputs = examples::random_matrix(c.nb_positions, c.size, "inputs");
+        auto expected = reference(l, inputs);
+        auto difference = examples::max_difference(l.feed_forward(inputs), expected);
+        auto shape = std::to_string(c.nb_positions) + "x" + std::to_string(c.size) + ", "
+                     + std::to_string(c.nb_heads) + " heads";
+        auto flops = 8. * (double) (c.nb_positions * c.size * c.size)
+                     + (causal ? 2. : 4.) * (double) (c.nb_positions * c.nb_positions * c.size);
+
+        std::cout << name << ": largest difference with the reference: " << difference << std::endl;
+
+        for (auto v: { "reference forward", "tiled forward", "tiled forward+backward" })
+        {
+            auto variant = std::string(v);
+            auto result = benchmark::run(name + " " + variant, shape, [&]()
+            {
+                if (variant == "reference forward")
+                {
+                    reference(l, inputs);
+                    return;
+                }
+
+                auto errors = l.feed_forward(inputs);
+
+                if (variant == "tiled forward+backward")
+                {
+                    l.backward_propagation(errors);
+                }
+            }, variant == "tiled forward+backward" ? 3. * flops : flops, 0.);
+
+            benchmark::print(result);
+        }
+
+        std::cout << name << ": memory of the propagations " << l.get_workspace_memory() << " bytes (tiled), "
+                  << l.get_workspace_memory() + c.nb_heads * c.nb_positions * c.nb_positions * sizeof(float)
+                  << " bytes (with the scores)" << std::endl;
+
+        return difference <= TOLERANCE;
+    }
+}
+
+
+/**
+ * Compare the attention layer (tiles of the scores, online softmax) with a
+ * reference computing the whole matrix of the scores of each head (same
+ * outputs; time of the propagations, and memory), with and without the
+ * causal mask.
+ * Usage: attention [--positions n] [--size n] [--heads n]
+ */
+int main(int argc, char *argv[])
+{
+    std::srand(0);
+
+    auto c = configuration();
+    auto sizes = std::map<std::string, size_t *>(
+    {
+        { "--positions", &c.nb_positions }, { "--size", &c.size }, { "--heads", &c.nb_heads }
+    });
+
+    examples::parse_arguments(argc, argv, sizes);
+
+    auto valid = compare(c, false);
+    valid = compare(c, true) && valid;
+
+    if (! valid)
+    {
+        util::ERROR("attention::main", "The attention layer differs from the reference");
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
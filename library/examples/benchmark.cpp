@@ -0,0 +1,213 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "lib/data_structures/matrix/matrix.h"
+#include "lib/data_structures/sparse_matrix/sparse_matrix.h"
+#include "lib/functions/activation_functions/activation_functions.h"
+#include "lib/functions/loss_functions/loss_functions.h"
+#include "lib/util/benchmark/benchmark.h"
+#include "examples/common.h"
+
+#include <cstdlib>
+#include <vector>
+
+
+using namespace cudaNN;
+
+
+// Largest side of the square matrices.
+#define MAX_SIZE 2048
+// Largest side of the square matrix products (naive product on host).
+#if _USE_GPU
+#define MAX_PRODUCT_SIZE 2048
+#else
+#define MAX_PRODUCT_SIZE 512
+#endif
+
+
+namespace
+{
+    typedef std::pair<size_t, size_t> shape;
+
+    std::vector<benchmark::result> results;
+    std::string filter;
+
+    std::string to_string(const shape &s)
+    {
+        return std::to_string(s.first) + "x" + std::to_string(s.second);
+    }
+
+    matrix random_matrix(const shape &s, float min, float max)
+    {
+        return examples::random_matrix(s.first, s.second, to_string(s), min, max);
+    }
+
+    void run(const std::string &name, const std::string &shape,
+             const std::function<void()> &f, double flops, double bytes)
+    {
+        if (!filter.empty() && (name + " " + shape).find(filter) == std::string::npos)
+        {
+            return;
+        }
+
+        results.push_back(benchmark::run(name, shape, f, flops, bytes));
+        benchmark::print(results.back());
+    }
+
+    /**
+     * Element-wise operations, reductions and transpose on a matrix.
+     */
+    void run_matrix(const shape &s)
+    {
+        auto m1 = random_matrix(s, -1.f, 1.f);
+        auto m2 = random_matrix(s, -1.f, 1.f);
+        auto row = random_matrix({ 1, s.second }, -1.f, 1.f);
+        auto n = (double) m1.get_length();
+        auto b = (double) sizeof(float);
+        auto name = to_string(s);
+
+        run("add", name, [&]() { m1 + m2; }, n, 3. * n * b);
+        run("add (row)", name, [&]() { m1 + row; }, n, (2. * n + s.second) * b);
+        run("subtract", name, [&]() { m1 - m2; }, n, 3. * n * b);
+        run("hadamard_product", name, [&]() { m1.hadamard_product(m2); }, n, 3. * n * b);
+        run("multiply (float)", name, [&]() { m1 * .1f; }, n, 2. * n * b);
+        run("transpose", name, [&]() { m1.transpose(); }, 0., 2. * n * b);
+        run("sum", name, [&]() { m1.sum(); }, n, n * b);
+        run("maximum", name, [&]() { m1.get_max(); }, n, n * b);
+        run("argmax", name, [&]() { m1.argmax(); }, n, n * b);
+        run("reduce_rows", name, [&]() { m1.reduce_rows(SUM); }, n, (n + s.first) * b);
+        run("reduce_cols", name, [&]() { m1.reduce_cols(SUM); }, n, (n + s.second) * b);
+    }
+
+    /**
+     * Product of a (n × k) matrix and a (k × m) matrix.
+     */
+    void run_product(size_t n, size_t k, size_t m)
+    {
+        auto m1 = random_matrix({ n, k }, -1.f, 1.f);
+        auto m2 = random_matrix({ k, m }, -1.f, 1.f);
+
+        run("multiply", to_string({ n, k }) + "*" + to_string({ k, m }),
+            [&]() { m1 * m2; },
+            2. * (double) n * (double) k * (double) m,
+            (double) (n * k + k * m + n * m) * sizeof(float));
+    }
+
+    /**
+     * Product of a sparse (n × k) matrix, with "nnz" non-zero values per
+     * row, and a (k × m) matrix (SpMM).
+     */
+    void run_sparse_product(size_t n, size_t k, size_t m, size_t nnz)
+    {
+        auto m1 = matrix(shape(n, k), "sparse");
+        auto m2 = random_matrix({ k, m }, -1.f, 1.f);
+
+        for (size_t i = 0; i < n; i ++)
+        {
+            for (size_t j = 0; j < nnz; j ++)
+            {
+                m1[(int) (i * k + (size_t) std::rand() % k)] = 1.f;
+            }
+        }
+
+        auto sparse = sparse_matrix(m1);
+        auto nb_values = (double) sparse.get_nnz();
+
+        run("multiply (sparse)", to_string({ n, k }) + "*" + to_string({ k, m })
+            + " nnz=" + std::to_string(sparse.get_nnz()),
+            [&]() { sparse * m2; },
+            2. * nb_values * (double) m,
+            ((2. * nb_values + (double) n) * (double) m) * sizeof(float));
+    }
+
+    void run_functions(const shape &s)
+    {
+        using namespace activation_functions;
+        using namespace loss_functions;
+
+        auto x = random_matrix(s, -4.f, 4.f);
+        auto predictions = random_matrix(s, .01f, .99f);
+        auto labels = random_matrix(s, 0.f, 1.f);
+        auto derivatives = matrix(s, "derivatives");
+        auto n = (double) x.get_length();
+        auto b = (double) sizeof(float);
+        auto name = to_string(s);
+
+        for (auto f: { LINEAR, BINARY_STEP, RELU, SIGMOID, TANH, SOFTMAX,
+                       SIGMOID_FAST, TANH_FAST, SOFTMAX_FAST })
+        {
+            run(f.get_id(), name, [&]() { f.compute({ &x }); }, 0., 2. * n * b);
+            run(f.get_id() + "_derivative", name, [&]() { f.compute_derivatives({ &x }); },
+                0., 2. * n * b);
+            run(f.get_id() + " (with derivatives)", name,
+                [&]() { f.compute_with_derivatives({ &x }, derivatives); }, 0., 3. * n * b);
+        }
+
+        for (auto f: { MEAN_SQUARED_ERROR, MEAN_ABSOLUTE_ERROR, MEAN_BIAS_ERROR, HINGE_LOSS,
+                       BINARY_CROSS_ENTROPY_LOSS, CROSS_ENTROPY_LOSS, SOFTMAX_CROSS_ENTROPY_LOSS })
+        {
+            run(f.get_id(), name, [&]() { f.compute({ &predictions, &labels }); }, 0., 3. * n * b);
+            run(f.get_id() + "_derivative", name,
+                [&]() { f.compute_derivatives({ &predictions, &labels }); }, 0., 3. * n * b);
+        }
+    }
+}
+
+
+/**
+ * Measure the operations on matrices, the activation and loss functions,
+ * on square matrices, and on the shapes of the layers (a sample 1×N,
+ * a batch B×N, and the products with the weights N×M, dense or with
+ * sparse inputs).
+ * Execute the operations either on the device or host
+ * depending on the -global.h/_USE_GPU- variable.
+ * Output the statistics in a .json file, to be compared with
+ * "plotting/benchmark.py".
+ * Usage: benchmark [--filter substring] [--label name] [--output path.json]
+ */
+int main(int argc, char *argv[])
+{
+    std::srand(0);
+
+    auto label = std::string(_USE_GPU ? "gpu" : "cpu");
+    auto path = std::string("benchmark_") + (_USE_GPU ? "gpu" : "cpu") + ".json";
+
+    examples::parse_arguments(argc, argv, { }, { },
+                              { { "--filter", &filter }, { "--label", &label }, { "--output", &path } });
+
+    // Square matrices.
+    for (size_t size = 64; size <= MAX_SIZE; size *= 2)
+    {
+        run_matrix({ size, size });
+        run_functions({ size, size });
+    }
+
+    for (size_t size = 64; size <= MAX_PRODUCT_SIZE; size *= 2)
+    {
+        run_product(size, size, size);
+    }
+
+    // Layers: one sample, and batches of samples.
+    for (size_t batch_size: { 1, 32, 256 })
+    {
+        for (size_t nb_features: { 128, 1024, 4096 })
+        {
+            run_matrix({ batch_size, nb_features });
+            run_functions({ batch_size, nb_features });
+        }
+
+        run_product(batch_size, 784, 128);
+        run_product(batch_size, 1024, 256);
+        run_product(batch_size, 128, 10);
+        // Sparse inputs (e.g. bag-of-words), and the dense product they replace.
+        run_sparse_product(batch_size, 16384, 128, 16);
+    }
+
+    run_product(1, 16384, 128);
+
+    benchmark::write_json(results, label, path);
+    util::INFO("benchmark::main", std::to_string(results.size()) + " results written in " + path);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,226 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "lib/data_structures/dataset/dataset.h"
+#include "lib/functions/activation_functions/activation_functions.h"
+#include "lib/functions/loss_functions/loss_functions.h"
+#include "lib/models/neural_network/neural_network.h"
+#include "lib/util/benchmark/benchmark.h"
+#include "lib/util/profiler/profiler.h"
+#include "examples/common.h"
+
+#include <cstdlib>
+#include <iomanip>
+#include <map>
+#include <vector>
+
+
+using namespace cudaNN;
+
+
+#define NB_PHASES 5
+
+
+namespace
+{
+    /**
+     * Configuration of the benchmark (see the usage in "main").
+     */
+    struct configuration
+    {
+        size_t depth = 2;
+        size_t width = 256;
+        size_t batch_size = 32;
+        size_t nb_features = 784;
+        size_t nb_labels = 10;
+        size_t nb_steps = 50;
+        size_t nb_repetitions = 5;
+        std::string activation = "relu";
+        std::string label = _USE_GPU ? "gpu" : "cpu";
+        std::string path = std::string("benchmark_training_") + (_USE_GPU ? "gpu" : "cpu") + ".json";
+        std::string trace_path;
+    };
+
+    const std::map<std::string, const function *> ACTIVATIONS =
+    {
+        { "linear", &activation_functions::LINEAR },
+        { "relu", &activation_functions::RELU },
+        { "sigmoid", &activation_functions::SIGMOID },
+        { "tanh", &activation_functions::TANH },
+        { "sigmoid_fast", &activation_functions::SIGMOID_FAST },
+        { "tanh_fast", &activation_functions::TANH_FAST }
+    };
+
+    /**
+     * @return - "nb_entries" random features, with a random one-hot label.
+     */
+    dataset synthetic_dataset(const configuration &c, size_t nb_entries)
+    {
+        auto data = dataset();
+
+        for (size_t i = 0; i < nb_entries; i ++)
+        {
+            auto features = matrix(1, c.nb_features, "features");
+            auto labels = matrix(1, c.nb_labels, "labels");
+
+            for (size_t j = 0; j < c.nb_features; j ++)
+            {
+                features[j] = (float) std::rand() / (float) RAND_MAX;
+            }
+
+            labels[std::rand() % c.nb_labels] = 1.f;
+            data.add(features, labels);
+        }
+
+        return data;
+    }
+
+    /**
+     * @return - a MLP of "depth" hidden layers of "width" neurons,
+     * and a linear output layer (the softmax is fused with the loss).
+     */
+    neural_network build(const configuration &c, size_t &nb_parameters)
+    {
+        auto &activation = *ACTIVATIONS.at(c.activation);
+        auto layers = std::vector<base_layer *>();
+        auto input_size = c.nb_features;
+        nb_parameters = 0;
+
+        for (size_t i = 0; i < c.depth; i ++)
+        {
+            layers.push_back(new layer(input_size, c.width, initializations::HE, activation));
+            nb_parameters += (input_size + 1) * c.width;
+            input_size = c.width;
+        }
+
+        layers.push_back(new layer(input_size, c.nb_labels,
+                                   initializations::XAVIER, activation_functions::LINEAR));
+        nb_parameters += (input_size + 1) * c.nb_labels;
+
+        return neural_network(layers);
+    }
+}
+
+
+/**
+ * Measure the training throughput of a MLP ("neural_network::fit"),
+ * on synthetic data, with the time spent in each phase of the training
+ * (batch sampling, forward propagation, loss, backward propagation and
+ * update), per step (i.e. per batch).
+ * Execute the operations either on the device or host
+ * depending on the -global.h/_USE_GPU- variable.
+ * Output the statistics over the repetitions in a .json file,
+ * to be compared with "plotting/benchmark.py".
+ * If -global.h/_PROFILE- is set, the last repetition can be exported
+ * as a Chrome trace (--trace).
+ * Usage: benchmark_training [--depth n] [--width n] [--batch-size n]
+ * [--features n] [--labels n] [--steps n] [--repetitions n]
+ * [--activation linear|relu|sigmoid|tanh|sigmoid_fast|tanh_fast]
+ * [--label name] [--output path.json] [--trace path.json]
+ */
+int main(int argc, char *argv[])
+{
+    std::srand(0);
+
+    auto c = configuration();
+    auto sizes = std::map<std::string, size_t *>(
+    {
+        { "--depth", &c.depth }, { "--width", &c.width }, { "--batch-size", &c.batch_size },
+        { "--features", &c.nb_features }, { "--labels", &c.nb_labels },
+        { "--steps", &c.nb_steps }, { "--repetitions", &c.nb_repetitions }
+    });
+
+    examples::parse_arguments(argc, argv, sizes, { },
+    {
+        { "--activation", &c.activation }, { "--label", &c.label },
+        { "--output", &c.path }, { "--trace", &c.trace_path }
+    });
+
+    if (ACTIVATIONS.find(c.activation) == ACTIVATIONS.end())
+    {
+        util::ERROR("benchmark_training::main", "Unknown activation function " + c.activation);
+        util::ERROR_EXIT();
+    }
+
+    size_t nb_parameters;
+    auto nn = build(c, nb_parameters);
+    // One epoch of "nb_steps" batches.
+    auto data = synthetic_dataset(c, c.nb_steps * c.batch_size);
+    auto warmup = synthetic_dataset(c, 2 * c.batch_size);
+    nn.fit(warmup, loss_functions::SOFTMAX_CROSS_ENTROPY_LOSS, 1, c.batch_size, 0.01f, false);
+
+    const std::string names[NB_PHASES + 1] = { "sampling", "forward", "loss", "backward", "update", "step" };
+    std::vector<double> times[NB_PHASES + 1];
+
+    for (size_t i = 0; i < c.nb_repetitions; i ++)
+    {
+#if _PROFILE
+        // Keep the events of the last repetition.
+        profiler::clear();
+#endif
+        nn.fit(data, loss_functions::SOFTMAX_CROSS_ENTROPY_LOSS, 1, c.batch_size, 0.01f, false);
+
+        auto &t = nn.get_training_times();
+        double phases[NB_PHASES] = { t.sampling, t.forward, t.loss, t.backward, t.update };
+        double total = 0.;
+
+        for (size_t j = 0; j < NB_PHASES; j ++)
+        {
+            times[j].push_back(phases[j] / (double) c.nb_steps);
+            total += phases[j];
+        }
+
+        times[NB_PHASES].push_back(total / (double) c.nb_steps);
+    }
+
+    auto shape = "depth=" + std::to_string(c.depth) + " width=" + std::to_string(c.width)
+                 + " batch=" + std::to_string(c.batch_size) + " " + c.activation;
+    auto results = std::vector<benchmark::result>();
+
+    for (size_t j = 0; j <= NB_PHASES; j ++)
+    {
+        results.push_back(benchmark::compute_statistics(times[j]));
+        results.back().name = "training " + names[j];
+        results.back().shape = shape;
+    }
+
+    // Rates of a step: the samples, and ~6 operations per parameter and sample
+    // (forward, errors and gradients).
+    auto &step = results.back();
+    step.items_per_second = step.median > 0. ? 1000. * (double) c.batch_size / step.median : 0.;
+    step.gflops = step.median > 0. ? 6. * (double) (nb_parameters * c.batch_size) / (step.median * 1e6) : 0.;
+
+    std::cout << std::endl << "Training of " << shape << " (" << nb_parameters << " parameters), "
+              << c.nb_steps << " steps × " << c.nb_repetitions << " repetitions" << std::endl;
+
+    for (auto &r: results)
+    {
+        benchmark::print(r);
+    }
+
+    std::cout << std::endl << std::fixed << std::setprecision(1);
+
+    for (size_t j = 0; j < NB_PHASES; j ++)
+    {
+        std::cout << std::left << std::setw(10) << names[j] << std::right << std::setw(6)
+                  << (step.median > 0. ? 100. * results[j].median / step.median : 0.)
+                  << " % of a step" << std::endl;
+    }
+
+    std::cout << "throughput " << step.items_per_second << " samples/s" << std::endl;
+
+    benchmark::write_json(results, c.label, c.path);
+
+    if (!c.trace_path.empty())
+    {
+#if _PROFILE
+        profiler::export_chrome_trace(c.trace_path);
+        std::cout << profiler::get_nb_events() << " events written in " << c.trace_path << std::endl;
+#else
+        util::ERROR("benchmark_training::main", "-global.h/_PROFILE- is not set, no trace to export");
+#endif
+    }
+
+    return EXIT_SUCCESS;
+}
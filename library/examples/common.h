@@ -0,0 +1,113 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#ifndef CUDANN_EXAMPLES_COMMON_H
+#define CUDANN_EXAMPLES_COMMON_H
+
+#include "lib/data_structures/matrix/matrix.h"
+#include "lib/util/util.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <string>
+
+
+/**
+ * Helpers shared by the examples (header only: each example is a single
+ * translation unit).
+ */
+namespace cudaNN
+{
+    namespace examples
+    {
+        /**
+         * Parse the options "--name value" of the command line (see the usage
+         * of each example): the sizes, then the floats and the strings.
+         * An unknown option is reported, and ignored.
+         * @return - the names of the options given.
+         */
+        inline std::set<std::string> parse_arguments(int argc, char *argv[],
+                                                     const std::map<std::string, size_t *> &sizes,
+                                                     const std::map<std::string, float *> &floats = {},
+                                                     const std::map<std::string, std::string *> &strings = {})
+        {
+            auto given = std::set<std::string>();
+
+            for (int i = 1; i + 1 < argc; i += 2)
+            {
+                auto arg = std::string(argv[i]);
+                auto value = std::string(argv[i + 1]);
+
+                if (sizes.find(arg) != sizes.end())
+                {
+                    *sizes.at(arg) = std::stoul(value);
+                }
+                else if (floats.find(arg) != floats.end())
+                {
+                    *floats.at(arg) = std::stof(value);
+                }
+                else if (strings.find(arg) != strings.end())
+                {
+                    *strings.at(arg) = value;
+                }
+                else
+                {
+                    util::ERROR("examples::parse_arguments", "Unknown option " + arg);
+                    continue;
+                }
+
+                given.insert(arg);
+            }
+
+            return given;
+        }
+
+        /**
+         * @return - a matrix of values drawn uniformly in [min, max] (with
+         * "std::rand", seeded by the example).
+         */
+        inline matrix random_matrix(size_t nb_rows, size_t nb_columns, const std::string &id,
+                                    float min = -1.f, float max = 1.f)
+        {
+            auto m = matrix(nb_rows, nb_columns, id);
+
+            for (size_t i = 0; i < m.get_length(); i ++)
+            {
+                m.get_data()[i] = min + (max - min) * (float) std::rand() / (float) RAND_MAX;
+            }
+
+            return m;
+        }
+
+        /**
+         * @return - the largest of the differences "d1" and "d2"; NaN if any
+         * is NaN (so that it fails any tolerance, unlike "std::max").
+         */
+        inline float max_difference(float d1, float d2)
+        {
+            return std::isnan(d1) || d2 <= d1 ? d1 : d2;
+        }
+
+        /**
+         * @return - the largest absolute difference between the values of "m1"
+         * and "m2" (of the same length); NaN if any difference is NaN.
+         */
+        inline float max_difference(const matrix &m1, const matrix &m2)
+        {
+            float difference = 0.f;
+
+            for (size_t i = 0; i < m1.get_length(); i ++)
+            {
+                difference = max_difference(difference, std::abs(m1.get_data()[i] - m2.get_data()[i]));
+            }
+
+            return difference;
+        }
+    }
+}
+
+
+#endif //CUDANN_EXAMPLES_COMMON_H
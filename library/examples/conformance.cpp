@@ -0,0 +1,752 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "lib/data_structures/matrix/matrix.h"
+#include "lib/functions/activation_functions/activation_functions.h"
+#include "lib/functions/loss_functions/loss_functions.h"
+#include "lib/util/benchmark/benchmark.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <random>
+#include <sstream>
+#include <vector>
+
+
+using namespace cudaNN;
+
+
+#define DEFAULT_SEED 42
+#define NB_RANDOM_SHAPES 8
+#define MAX_RANDOM_SIZE 300
+
+// Tolerated error (ULP) of the fast approximations (see activation_functions.h).
+#if _USE_GPU
+#define FAST_MAX_ULP 64
+#else
+#define FAST_MAX_ULP 2
+#endif
+
+// Timing: size of the (square) matrices, and tolerated slowdown
+// over the baseline (relative, and absolute in ms for the noise).
+#define TIME_SIZE 256
+#define TIME_TOLERANCE 1.25
+#define TIME_MIN_DIFFERENCE 0.05
+
+
+namespace
+{
+    typedef std::pair<size_t, size_t> shape;
+
+    size_t nb_checks = 0;
+    size_t nb_failures = 0;
+    std::mt19937 generator;
+
+    std::string to_string(const shape &s)
+    {
+        return std::to_string(s.first) + "×" + std::to_string(s.second);
+    }
+
+    matrix random_matrix(const shape &s, float min, float max)
+    {
+        auto distribution = std::uniform_real_distribution<float>(min, max);
+        auto values = std::vector<float>(s.first * s.second);
+
+        for (auto &value: values)
+        {
+            value = distribution(generator);
+        }
+
+        return matrix(values.data(), s, "random");
+    }
+
+    /**
+     * @return - a matrix of labels in {"a", "b"}.
+     */
+    matrix random_labels(const shape &s, float a, float b)
+    {
+        auto distribution = std::bernoulli_distribution(.5);
+        auto values = std::vector<float>(s.first * s.second);
+
+        for (auto &value: values)
+        {
+            value = distribution(generator) ? a : b;
+        }
+
+        return matrix(values.data(), s, "labels");
+    }
+
+    /**
+     * @return - a matrix with one label set to 1 on each row (if any column).
+     */
+    matrix random_one_hot(const shape &s)
+    {
+        auto distribution = std::uniform_int_distribution<size_t>(0, s.second - 1);
+        auto values = std::vector<float>(s.first * s.second, 0.f);
+
+        for (size_t i = 0; i < s.first && s.second > 0; i ++)
+        {
+            values[i * s.second + distribution(generator)] = 1.f;
+        }
+
+        return matrix(values.data(), s, "labels");
+    }
+
+    std::vector<double> to_reference(const matrix &m)
+    {
+        return std::vector<double>(m.get_data(), m.get_data() + m.get_length());
+    }
+
+    double max_abs(const std::vector<double> &values)
+    {
+        double max = 0.;
+
+        for (auto value: values)
+        {
+            max = std::max(max, std::abs(value));
+        }
+
+        return max;
+    }
+
+    /**
+     * Typical error bound of the sum of "n" floats whose absolute values
+     * sum to "sum_abs" (the rounding errors are assumed independent).
+     */
+    double accumulation_tolerance(size_t n, double sum_abs)
+    {
+        return 4. * (std::sqrt((double) n) + 1.) * FLT_EPSILON * sum_abs;
+    }
+
+    /**
+     * @return - the number of floats between "a" and "b" (ULP; units in the last place).
+     */
+    int64_t ulp_distance(float a, float b)
+    {
+        if (std::isnan(a) || std::isnan(b))
+        {
+            return std::isnan(a) && std::isnan(b) ? 0 : INT64_MAX;
+        }
+
+        int32_t i;
+        int32_t j;
+        std::memcpy(&i, &a, sizeof(float));
+        std::memcpy(&j, &b, sizeof(float));
+        // Map the floats on a monotonic integer scale (-0 and +0 are equal).
+        int64_t i_ = i < 0 ? (int64_t) INT32_MIN - i : i;
+        int64_t j_ = j < 0 ? (int64_t) INT32_MIN - j : j;
+
+        return i_ < j_ ? j_ - i_ : i_ - j_;
+    }
+
+    /**
+     * Compare the result of a kernel with its reference (computed in double).
+     * A value is correct if it is at most "max_ulp" away from the rounded
+     * reference, or at most "tolerance" away from the reference (for the
+     * accumulations, and the cancellations near 0).
+     * The first incorrect value is reported.
+     */
+    void check(const std::string &name, const shape &s,
+               const matrix &result, const std::vector<double> &reference,
+               int64_t max_ulp, double tolerance)
+    {
+        nb_checks ++;
+
+        if (result.get_length() != reference.size())
+        {
+            nb_failures ++;
+            util::ERROR("conformance::check",
+                        name + " on " + to_string(s) + ": invalid number of values ("
+                        + std::to_string(result.get_length()) + " instead of "
+                        + std::to_string(reference.size()) + ")");
+            return;
+        }
+
+        for (size_t i = 0; i < reference.size(); i ++)
+        {
+            float value = result.get_data()[i];
+            auto ulp = ulp_distance(value, (float) reference[i]);
+
+            if (ulp > max_ulp && !(std::abs(value - reference[i]) <= tolerance))
+            {
+                nb_failures ++;
+                std::ostringstream message;
+                message.precision(9);
+                message << name << " on " << to_string(s) << ": value n°" << i
+                        << " is " << value << " instead of " << reference[i]
+                        << " (" << ulp << " ULP)";
+                util::ERROR("conformance::check", message.str());
+                return;
+            }
+        }
+    }
+
+    /**
+     * @return - f(m[i]) for each value of "m".
+     */
+    std::vector<double> map(const matrix &m, const std::function<double(double)> &f)
+    {
+        auto results = to_reference(m);
+
+        for (auto &value: results)
+        {
+            value = f(value);
+        }
+
+        return results;
+    }
+
+    /**
+     * @return - f(m1[i], m2[i]) for each value of "m1", with "m2" broadcast.
+     */
+    std::vector<double> map(const matrix &m1, const matrix &m2,
+                            const std::function<double(double, double)> &f)
+    {
+        auto nb_rows = m1.get_dimensions().first;
+        auto nb_cols = m1.get_dimensions().second;
+        auto nb_rows_2 = m2.get_dimensions().first;
+        auto nb_cols_2 = m2.get_dimensions().second;
+        auto results = std::vector<double>(m1.get_length());
+
+        for (size_t i = 0; i < nb_rows; i ++)
+        {
+            for (size_t j = 0; j < nb_cols; j ++)
+            {
+                auto v = m2.get_data()[(nb_rows_2 == 1 ? 0 : i) * nb_cols_2
+                                       + (nb_cols_2 == 1 ? 0 : j)];
+                results[i * nb_cols + j] = f(m1.get_data()[i * nb_cols + j], v);
+            }
+        }
+
+        return results;
+    }
+
+    /**
+     * @return - the reduction of "length" values separated by "stride".
+     */
+    double reduce(const float *data, size_t length, size_t stride, reductions r)
+    {
+        double result = r == MAXIMUM || r == ARGMAX ? -INFINITY
+                      : r == MINIMUM ? INFINITY : 0.;
+        size_t index = 0;
+
+        for (size_t i = 0; i < length; i ++)
+        {
+            double value = data[i * stride];
+
+            switch (r)
+            {
+                case MAXIMUM:
+                    result = std::max(result, value);
+                    break;
+                case MINIMUM:
+                    result = std::min(result, value);
+                    break;
+                case ARGMAX:
+                    if (value > result)
+                    {
+                        result = value;
+                        index = i;
+                    }
+                    break;
+                default:
+                    result += value;
+            }
+        }
+
+        if (r == MEAN)
+        {
+            // The mean of no value is 0 (as for the library).
+            result = length == 0 ? 0. : result / (double) length;
+        }
+
+        return r == ARGMAX ? (double) index : result;
+    }
+
+    /**
+     * @return - the tolerance of a reduction (only the sums are rounded).
+     */
+    double reduction_tolerance(const float *data, size_t length, size_t stride, reductions r)
+    {
+        if ((r != SUM && r != MEAN) || length == 0)
+        {
+            return 0.;
+        }
+
+        double sum_abs = 0.;
+
+        for (size_t i = 0; i < length; i ++)
+        {
+            sum_abs += std::abs(data[i * stride]);
+        }
+
+        return accumulation_tolerance(length, sum_abs) / (r == MEAN ? (double) length : 1.);
+    }
+
+    std::vector<double> softmax(const matrix &m)
+    {
+        auto nb_cols = m.get_dimensions().second;
+        auto results = to_reference(m);
+
+        for (size_t i = 0; i < m.get_dimensions().first && nb_cols > 0; i ++)
+        {
+            double *row = results.data() + i * nb_cols;
+            double max = *std::max_element(row, row + nb_cols);
+            double sum = 0.;
+
+            for (size_t j = 0; j < nb_cols; j ++)
+            {
+                row[j] = std::exp(row[j] - max);
+                sum += row[j];
+            }
+            for (size_t j = 0; j < nb_cols; j ++)
+            {
+                row[j] /= sum;
+            }
+        }
+
+        return results;
+    }
+
+
+    /**
+     * Operations of the matrices (with broadcasting, and reductions).
+     */
+    void check_matrix(const shape &s)
+    {
+        auto nb_rows = s.first;
+        auto nb_cols = s.second;
+        auto m1 = random_matrix(s, -1.f, 1.f);
+        auto m2 = random_matrix(s, -1.f, 1.f);
+        auto row = random_matrix({ 1, nb_cols }, -1.f, 1.f);
+        auto col = random_matrix({ nb_rows, 1 }, -1.f, 1.f);
+        auto scalar = random_matrix({ 1, 1 }, -1.f, 1.f);
+        auto plus = [](double a, double b) { return a + b; };
+        auto minus = [](double a, double b) { return a - b; };
+        auto times = [](double a, double b) { return a * b; };
+
+        // Element-wise.
+        check("add", s, m1 + m2, map(m1, m2, plus), 1, 0.);
+        check("add (row)", s, m1 + row, map(m1, row, plus), 1, 0.);
+        check("add (column)", s, m1 + col, map(m1, col, plus), 1, 0.);
+        check("add (scalar)", s, m1 + scalar, map(m1, scalar, plus), 1, 0.);
+        check("add (float)", s, m1 + .5f, map(m1, [](double a) { return a + .5; }), 1, 0.);
+        check("subtract", s, m1 - m2, map(m1, m2, minus), 1, 0.);
+        check("subtract (row)", s, m1 - row, map(m1, row, minus), 1, 0.);
+        check("subtract (column)", s, m1 - col, map(m1, col, minus), 1, 0.);
+        check("hadamard_product", s, m1.hadamard_product(m2), map(m1, m2, times), 1, 0.);
+        check("hadamard_product (row)", s, m1.hadamard_product(row), map(m1, row, times), 1, 0.);
+        check("hadamard_product (column)", s, m1.hadamard_product(col), map(m1, col, times), 1, 0.);
+        check("multiply (float)", s, m1 * 3.f, map(m1, [](double a) { return a * 3.; }), 1, 0.);
+        // Transpose (exact).
+        auto transpose = std::vector<double>(m1.get_length());
+        for (size_t i = 0; i < nb_rows; i ++)
+        {
+            for (size_t j = 0; j < nb_cols; j ++)
+            {
+                transpose[j * nb_rows + i] = m1.get_data()[i * nb_cols + j];
+            }
+        }
+        check("transpose", s, m1.transpose(), transpose, 0, 0.);
+        // Product with a (nb_cols × k) matrix.
+        size_t k = (nb_rows + nb_cols) / 2 + 1;
+        auto m3 = random_matrix({ nb_cols, k }, -1.f, 1.f);
+        auto product = std::vector<double>(nb_rows * k, 0.);
+        double product_tolerance = 0.;
+        for (size_t i = 0; i < nb_rows; i ++)
+        {
+            for (size_t j = 0; j < k; j ++)
+            {
+                double sum_abs = 0.;
+                for (size_t l = 0; l < nb_cols; l ++)
+                {
+                    double term = (double) m1.get_data()[i * nb_cols + l] * m3.get_data()[l * k + j];
+                    product[i * k + j] += term;
+                    sum_abs += std::abs(term);
+                }
+                product_tolerance = std::max(product_tolerance, accumulation_tolerance(nb_cols, sum_abs));
+            }
+        }
+        check("multiply", s, m1 * m3, product, 1, product_tolerance);
+        // Reductions.
+        const reductions all[] = { SUM, MEAN, MAXIMUM, MINIMUM, ARGMAX };
+        const std::string names[] = { "sum", "mean", "maximum", "minimum", "argmax" };
+        float values[] = { m1.sum(), m1.mean(), m1.get_max(), m1.get_min(), (float) m1.argmax() };
+        for (size_t r = 0; r < 5; r ++)
+        {
+            auto reference = reduce(m1.get_data(), m1.get_length(), 1, all[r]);
+            auto tolerance = reduction_tolerance(m1.get_data(), m1.get_length(), 1, all[r]);
+            check(names[r], s, matrix({ values[r] }, 1, 1), { reference }, 0, tolerance);
+
+            auto rows = std::vector<double>(nb_rows);
+            auto cols = std::vector<double>(nb_cols);
+            double rows_tolerance = 0.;
+            double cols_tolerance = 0.;
+            for (size_t i = 0; i < nb_rows; i ++)
+            {
+                rows[i] = reduce(m1.get_data() + i * nb_cols, nb_cols, 1, all[r]);
+                rows_tolerance = std::max(rows_tolerance,
+                                          reduction_tolerance(m1.get_data() + i * nb_cols, nb_cols, 1, all[r]));
+            }
+            for (size_t j = 0; j < nb_cols; j ++)
+            {
+                cols[j] = reduce(m1.get_data() + j, nb_rows, nb_cols, all[r]);
+                cols_tolerance = std::max(cols_tolerance,
+                                          reduction_tolerance(m1.get_data() + j, nb_rows, nb_cols, all[r]));
+            }
+            check("reduce_rows (" + names[r] + ")", s, m1.reduce_rows(all[r]), rows, 0, rows_tolerance);
+            check("reduce_cols (" + names[r] + ")", s, m1.reduce_cols(all[r]), cols, 0, cols_tolerance);
+        }
+    }
+
+    /**
+     * Check a function, its derivative, and both computed at once.
+     */
+    void check_function(const function &f, const shape &s, std::vector<matrix *> inputs,
+                        const std::vector<double> &outputs, const std::vector<double> &derivatives,
+                        int64_t max_ulp, double tolerance, double derivatives_tolerance)
+    {
+        auto name = f.get_id();
+        auto derivatives_ = matrix(s, "derivatives");
+
+        check(name, s, f.compute(inputs), outputs, max_ulp, tolerance);
+        check(name + "_derivative", s, f.compute_derivatives(inputs), derivatives,
+              max_ulp, derivatives_tolerance);
+        check(name + " (with derivatives)", s, f.compute_with_derivatives(inputs, derivatives_),
+              outputs, max_ulp, tolerance);
+        check(name + "_derivative (with derivatives)", s, derivatives_, derivatives,
+              max_ulp, derivatives_tolerance);
+    }
+
+    void check_activation_functions(const shape &s)
+    {
+        using namespace activation_functions;
+
+        auto x = random_matrix(s, -8.f, 8.f);
+        // Derivatives computed from the outputs (cancellations near 0).
+        double tolerance = 4. * FLT_EPSILON;
+        auto sigmoid = [](double v) { return 1. / (1. + std::exp(-v)); };
+        auto sigmoid_derivative = [&](double v) { return sigmoid(v) * (1. - sigmoid(v)); };
+        auto tanh_derivative = [](double v) { return 1. - std::tanh(v) * std::tanh(v); };
+        auto softmax_ = softmax(x);
+        auto softmax_derivative = softmax_;
+        for (auto &v: softmax_derivative)
+        {
+            v = v * (1. - v);
+        }
+
+        check_function(LINEAR, s, { &x }, map(x, [](double v) { return v; }),
+                       map(x, [](double) { return 1.; }), 0, 0., 0.);
+        check_function(BINARY_STEP, s, { &x }, map(x, [](double v) { return v < 0. ? 0. : 1.; }),
+                       map(x, [](double) { return 0.; }), 0, 0., 0.);
+        check_function(RELU, s, { &x }, map(x, [](double v) { return std::max(0., v); }),
+                       map(x, [](double v) { return v > 0. ? 1. : 0.; }), 0, 0., 0.);
+        check_function(SIGMOID, s, { &x }, map(x, sigmoid), map(x, sigmoid_derivative),
+                       2, 0., tolerance);
+        check_function(TANH, s, { &x }, map(x, [](double v) { return std::tanh(v); }),
+                       map(x, tanh_derivative), 2, 0., tolerance);
+        // The inputs are shifted by the maximum of the row (rounded).
+        check_function(SOFTMAX, s, { &x }, softmax_, softmax_derivative,
+                       16, tolerance, tolerance);
+        check_function(SIGMOID_FAST, s, { &x }, map(x, sigmoid), map(x, sigmoid_derivative),
+                       FAST_MAX_ULP, 0., tolerance);
+        check_function(TANH_FAST, s, { &x }, map(x, [](double v) { return std::tanh(v); }),
+                       map(x, tanh_derivative), FAST_MAX_ULP, 0., tolerance);
+        check_function(SOFTMAX_FAST, s, { &x }, softmax_, softmax_derivative,
+                       16 + FAST_MAX_ULP, tolerance, tolerance);
+    }
+
+    void check_loss_functions(const shape &s)
+    {
+        using namespace loss_functions;
+
+        auto nb_cols = s.second;
+        auto predictions = random_matrix(s, .01f, .99f);
+        auto labels = random_labels(s, 1.f, 0.f);
+        auto signs = random_labels(s, 1.f, -1.f);
+        auto margins = random_matrix(s, -2.f, 2.f);
+        auto logits = random_matrix(s, -8.f, 8.f);
+        auto one_hot = random_one_hot(s);
+        auto p = to_reference(predictions);
+        auto y = to_reference(labels);
+        auto output = [&](const std::function<double(double, double)> &f)
+        {
+            return map(predictions, labels, f);
+        };
+
+        check(MEAN_SQUARED_ERROR.get_id(), s, MEAN_SQUARED_ERROR.compute({ &predictions, &labels }),
+              output([](double p, double y) { return (y - p) * (y - p); }), 2, 0.);
+        check(MEAN_SQUARED_ERROR.get_id() + "_derivative", s,
+              MEAN_SQUARED_ERROR.compute_derivatives({ &predictions, &labels }),
+              output([](double p, double y) { return -2. * (y - p); }), 1, 0.);
+        check(MEAN_ABSOLUTE_ERROR.get_id(), s, MEAN_ABSOLUTE_ERROR.compute({ &predictions, &labels }),
+              output([](double p, double y) { return std::abs(y - p); }), 1, 0.);
+        check(MEAN_ABSOLUTE_ERROR.get_id() + "_derivative", s,
+              MEAN_ABSOLUTE_ERROR.compute_derivatives({ &predictions, &labels }),
+              output([](double p, double y) { return p > y ? 1. : -1.; }), 0, 0.);
+        check(MEAN_BIAS_ERROR.get_id(), s, MEAN_BIAS_ERROR.compute({ &predictions, &labels }),
+              output([](double p, double y) { return y - p; }), 1, 0.);
+        check(MEAN_BIAS_ERROR.get_id() + "_derivative", s,
+              MEAN_BIAS_ERROR.compute_derivatives({ &predictions, &labels }),
+              output([](double, double) { return -1.; }), 0, 0.);
+        check(HINGE_LOSS.get_id(), s, HINGE_LOSS.compute({ &margins, &signs }),
+              map(margins, signs, [](double p, double y) { return std::max(0., 1. - y * p); }), 1, 0.);
+        check(HINGE_LOSS.get_id() + "_derivative", s,
+              HINGE_LOSS.compute_derivatives({ &margins, &signs }),
+              map(margins, signs, [](double p, double y) { return y * p < 1. ? -y : 0.; }), 0, 0.);
+        // 1 - p is rounded (cancellation in the logarithms and the divisions).
+        auto bce = output([](double p, double y)
+        {
+            return -(y * std::log(p) + (1. - y) * std::log(1. - p));
+        });
+        auto bce_derivative = output([](double p, double y)
+        {
+            return -(y / p - (1. - y) / (1. - p));
+        });
+        check(BINARY_CROSS_ENTROPY_LOSS.get_id(), s,
+              BINARY_CROSS_ENTROPY_LOSS.compute({ &predictions, &labels }),
+              bce, 4, 4. * FLT_EPSILON);
+        check(BINARY_CROSS_ENTROPY_LOSS.get_id() + "_derivative", s,
+              BINARY_CROSS_ENTROPY_LOSS.compute_derivatives({ &predictions, &labels }),
+              bce_derivative, 4, 4. * FLT_EPSILON * max_abs(bce_derivative));
+        // Sum over the whole matrix.
+        double ce = 0.;
+        for (size_t i = 0; i < p.size(); i ++)
+        {
+            ce += -y[i] * std::log(p[i]);
+        }
+        check(CROSS_ENTROPY_LOSS.get_id(), s, CROSS_ENTROPY_LOSS.compute({ &predictions, &labels }),
+              std::vector<double>(p.size(), ce), 4, accumulation_tolerance(p.size(), ce));
+        auto ce_derivative = output([](double p, double y)
+        {
+            return -y / p;
+        });
+        check(CROSS_ENTROPY_LOSS.get_id() + "_derivative", s,
+              CROSS_ENTROPY_LOSS.compute_derivatives({ &predictions, &labels }),
+              ce_derivative, 4, 4. * FLT_EPSILON * max_abs(ce_derivative));
+        // For each row; -sum(y_i * log(softmax(x)_i)), and softmax(x) - y.
+        auto softmax_ = softmax(logits);
+        auto sce = std::vector<double>(softmax_.size());
+        auto sce_derivative = std::vector<double>(softmax_.size());
+        for (size_t i = 0; i < s.first; i ++)
+        {
+            double loss = 0.;
+            for (size_t j = 0; j < nb_cols; j ++)
+            {
+                loss -= one_hot.get_data()[i * nb_cols + j] * std::log(softmax_[i * nb_cols + j]);
+            }
+            for (size_t j = 0; j < nb_cols; j ++)
+            {
+                sce[i * nb_cols + j] = loss;
+                sce_derivative[i * nb_cols + j] = softmax_[i * nb_cols + j]
+                                                  - one_hot.get_data()[i * nb_cols + j];
+            }
+        }
+        check_function(SOFTMAX_CROSS_ENTROPY_LOSS, s, { &logits, &one_hot }, sce, sce_derivative, 16,
+                       16. * FLT_EPSILON * (8. + std::log((double) nb_cols)),
+                       4. * FLT_EPSILON * (8. + std::log((double) nb_cols)));
+    }
+
+
+    std::map<std::string, double> load_baseline(const std::string &path)
+    {
+        auto baseline = std::map<std::string, double>();
+        auto file = std::ifstream(path);
+        std::string line;
+
+        while (std::getline(file, line))
+        {
+            auto separator = line.find(';');
+
+            if (separator != std::string::npos)
+            {
+                baseline[line.substr(0, separator)] = std::stod(line.substr(separator + 1));
+            }
+        }
+
+        return baseline;
+    }
+
+    /**
+     * Time each kernel, and compare with the baseline stored at "path"
+     * (a kernel fails if slower than "tolerance" times its baseline).
+     * The kernels without baseline (or every kernel if "update") are
+     * recorded in the file.
+     */
+    void check_times(const std::string &path, bool update, double tolerance)
+    {
+        using namespace activation_functions;
+        using namespace loss_functions;
+
+        auto s = shape(TIME_SIZE, TIME_SIZE);
+        auto m1 = random_matrix(s, -1.f, 1.f);
+        auto m2 = random_matrix(s, .01f, .99f);
+        auto row = random_matrix({ 1, TIME_SIZE }, -1.f, 1.f);
+        auto labels = random_labels(s, 1.f, 0.f);
+        auto derivatives = matrix(s, "derivatives");
+        auto kernels = std::vector<std::pair<std::string, std::function<void()>>>(
+        {
+            { "add", [&]() { m1 + m2; } },
+            { "add (row)", [&]() { m1 + row; } },
+            { "subtract", [&]() { m1 - m2; } },
+            { "hadamard_product", [&]() { m1.hadamard_product(m2); } },
+            { "multiply (float)", [&]() { m1 * 2.f; } },
+            { "multiply", [&]() { m1 * m2; } },
+            { "transpose", [&]() { m1.transpose(); } },
+            { "sum", [&]() { m1.sum(); } },
+            { "maximum", [&]() { m1.get_max(); } },
+            { "argmax", [&]() { m1.argmax(); } },
+            { "reduce_rows", [&]() { m1.reduce_rows(SUM); } },
+            { "reduce_cols", [&]() { m1.reduce_cols(SUM); } }
+        });
+
+        for (auto f: { LINEAR, BINARY_STEP, RELU, SIGMOID, TANH, SOFTMAX,
+                       SIGMOID_FAST, TANH_FAST, SOFTMAX_FAST })
+        {
+            kernels.emplace_back(f.get_id(), [&, f]() { f.compute({ &m1 }); });
+            kernels.emplace_back(f.get_id() + "_derivative", [&, f]() { f.compute_derivatives({ &m1 }); });
+            kernels.emplace_back(f.get_id() + " (with derivatives)",
+                                 [&, f]() { f.compute_with_derivatives({ &m1 }, derivatives); });
+        }
+
+        for (auto f: { MEAN_SQUARED_ERROR, MEAN_ABSOLUTE_ERROR, MEAN_BIAS_ERROR, HINGE_LOSS,
+                       BINARY_CROSS_ENTROPY_LOSS, CROSS_ENTROPY_LOSS, SOFTMAX_CROSS_ENTROPY_LOSS })
+        {
+            kernels.emplace_back(f.get_id(), [&, f]() { f.compute({ &m2, &labels }); });
+            kernels.emplace_back(f.get_id() + "_derivative",
+                                 [&, f]() { f.compute_derivatives({ &m2, &labels }); });
+        }
+
+        auto baseline = load_baseline(path);
+        auto nb_recorded = 0;
+
+        for (auto &kernel: kernels)
+        {
+            auto t = benchmark::run(kernel.first, to_string(s), kernel.second, 0., 0.).median;
+            auto entry = baseline.find(kernel.first);
+
+            if (update || entry == baseline.end())
+            {
+                baseline[kernel.first] = t;
+                nb_recorded ++;
+                continue;
+            }
+
+            nb_checks ++;
+
+            if (t > entry->second * tolerance && t - entry->second > TIME_MIN_DIFFERENCE)
+            {
+                nb_failures ++;
+                util::ERROR("conformance::check_times",
+                            kernel.first + " on " + to_string(s) + " is slower than the baseline ("
+                            + std::to_string(t) + " ms instead of "
+                            + std::to_string(entry->second) + " ms)");
+            }
+        }
+
+        if (nb_recorded > 0)
+        {
+            auto file = std::ofstream(path);
+
+            for (auto &entry: baseline)
+            {
+                file << entry.first << ";" << entry.second << "\n";
+            }
+
+            util::INFO("conformance::check_times",
+                       std::to_string(nb_recorded) + " time(s) recorded in " + path);
+        }
+    }
+}
+
+
+/**
+ * Conformance of the kernels of the current backend (-global.h/_USE_GPU-):
+ * the operations of the matrices, the activation and the loss functions
+ * are compared with references computed in double, on fixed (empty, degenerate,
+ * odd, non power of two) and random shapes, with tolerances in ULP.
+ * Then each kernel is timed (median of the runs, see benchmark.h), and
+ * compared with the baseline of a previous run on the same machine (a kernel
+ * slower than TIME_TOLERANCE times its baseline fails); the missing
+ * baselines are recorded.
+ * Usage: conformance [--seed n] [--tolerance t] [--no-time] [--update] [baseline.csv]
+ * @return - EXIT_FAILURE if a check failed.
+ */
+int main(int argc, char *argv[])
+{
+    auto seed = (unsigned int) DEFAULT_SEED;
+    auto timed = true;
+    auto update = false;
+    auto tolerance = TIME_TOLERANCE;
+    auto path = std::string("conformance_") + (_USE_GPU ? "gpu" : "cpu") + ".csv";
+
+    for (int i = 1; i < argc; i ++)
+    {
+        auto arg = std::string(argv[i]);
+
+        if (arg == "--seed" && i + 1 < argc)
+        {
+            seed = (unsigned int) std::stoul(argv[++ i]);
+        }
+        else if (arg == "--tolerance" && i + 1 < argc)
+        {
+            tolerance = std::stod(argv[++ i]);
+        }
+        else if (arg == "--no-time")
+        {
+            timed = false;
+        }
+        else if (arg == "--update")
+        {
+            update = true;
+        }
+        else
+        {
+            path = arg;
+        }
+    }
+
+    generator.seed(seed);
+
+    auto shapes = std::vector<shape>(
+    {
+        { 0, 7 }, { 7, 0 }, { 1, 1 }, { 1, 2 }, { 2, 1 }, { 1, 1000 }, { 1000, 1 },
+        { 3, 5 }, { 7, 13 }, { 17, 31 }, { 64, 64 }, { 33, 129 },
+        { 255, 3 }, { 128, 1025 }
+    });
+    auto distribution = std::uniform_int_distribution<size_t>(1, MAX_RANDOM_SIZE);
+
+    for (size_t i = 0; i < NB_RANDOM_SHAPES; i ++)
+    {
+        size_t nb_rows = distribution(generator);
+        shapes.emplace_back(nb_rows, distribution(generator));
+    }
+
+    for (auto &s: shapes)
+    {
+        check_matrix(s);
+        check_activation_functions(s);
+        check_loss_functions(s);
+    }
+
+    util::INFO("conformance::main",
+               std::to_string(shapes.size()) + " shapes checked (seed "
+               + std::to_string(seed) + ")");
+
+    if (timed)
+    {
+        check_times(path, update, tolerance);
+    }
+
+    std::cout << (nb_failures == 0 ? TERM_GREEN : TERM_RED)
+              << nb_checks - nb_failures << "/" << nb_checks << " checks passed"
+              << TERM_RESET << std::endl;
+
+    return nb_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,213 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "lib/functions/activation_functions/activation_functions.h"
+#include "lib/models/neural_network/neural_network.h"
+#include "lib/util/benchmark/benchmark.h"
+#include "examples/common.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+
+using namespace cudaNN;
+
+
+// Largest tolerated difference between the algorithms (and layouts).
+#define TOLERANCE 1e-4
+// Largest number of weights of the dense layer compared (1 GB).
+#define MAX_DENSE_WEIGHTS (1 << 28)
+
+
+namespace
+{
+    /**
+     * Configuration of the comparison (see the usage in "main").
+     */
+    struct configuration
+    {
+        size_t channels = 1;
+        size_t size = 28;
+        size_t nb_filters = 16;
+        size_t kernel_size = 3;
+    };
+
+    matrix random_images(const configuration &c, size_t nb_images)
+    {
+        auto images = matrix(nb_images, c.channels * c.size * c.size, "images");
+
+        for (size_t i = 0; i < images.get_length(); i ++)
+        {
+            images[(int) i] = (float) std::rand() / (float) RAND_MAX;
+        }
+
+        return images;
+    }
+
+    /**
+     * @return - the images of "m" (a row per image, of "nb_channels" channels
+     * of "nb_pixels" pixels) from NCHW to NHWC.
+     */
+    matrix to_nhwc(const matrix &m, size_t nb_channels, size_t nb_pixels)
+    {
+        auto result = matrix(m.get_dimensions(), "nhwc");
+
+        for (size_t n = 0; n < m.get_dimensions().first; n ++)
+        {
+            for (size_t c = 0; c < nb_channels; c ++)
+            {
+                for (size_t p = 0; p < nb_pixels; p ++)
+                {
+                    result[(int) ((n * nb_pixels + p) * nb_channels + c)]
+                            = m[(int) ((n * nb_channels + c) * nb_pixels + p)];
+                }
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Measure the forward propagation of an image, then its forward and
+     * backward propagations.
+     */
+    void run(const std::string &name, base_layer &l, matrix &images)
+    {
+        size_t i = 0;
+        auto nb_parameters = l.get_parameters_memory() / sizeof(float);
+        auto next_image = [&]()
+        {
+            return matrix(images.get_data() + (i ++ % images.get_dimensions().first)
+                          * images.get_dimensions().second,
+                          { 1, images.get_dimensions().second }, "image");
+        };
+
+        for (auto backward: { false, true })
+        {
+            auto r = benchmark::run(name + (backward ? " forward+backward" : " forward"),
+                                    std::to_string(nb_parameters) + " parameters", [&]()
+            {
+                auto image = next_image();
+                auto errors = l.feed_forward(image);
+
+                if (backward)
+                {
+                    l.backward_propagation(errors);
+                    l.clear_gradients();
+                }
+            }, 0., 0.);
+
+            benchmark::print(r);
+        }
+    }
+}
+
+
+/**
+ * Compare the forward propagations of a convolution layer by im2col and
+ * by Winograd, in both layouts (NCHW and NHWC), then measure its forward
+ * and backward propagations against a dense layer with the same inputs
+ * and outputs (the images, and the channels of the filters), and the ones
+ * of the pooling layers on its outputs.
+ * Usage: convolution [--channels n] [--size n] [--filters n] [--kernel n]
+ */
+int main(int argc, char *argv[])
+{
+    std::srand(0);
+
+    auto c = configuration();
+    auto sizes = std::map<std::string, size_t *>(
+    {
+        { "--channels", &c.channels }, { "--size", &c.size },
+        { "--filters", &c.nb_filters }, { "--kernel", &c.kernel_size }
+    });
+
+    examples::parse_arguments(argc, argv, sizes);
+
+    // Same outputs (padding).
+    auto padding = c.kernel_size / 2;
+    auto images = random_images(c, 16);
+    auto nchw = convolution(c.channels, c.size, c.size, c.nb_filters, c.kernel_size, 1, padding);
+    auto nhwc = convolution(c.channels, c.size, c.size, c.nb_filters, c.kernel_size, 1, padding,
+                            initializations::HE, activation_functions::LINEAR, layouts::NHWC);
+    nhwc.get_filters() = nchw.get_filters();
+    nhwc.get_biases() = nchw.get_biases();
+
+    auto nb_pixels = nchw.get_output_height() * nchw.get_output_width();
+    auto nhwc_images = to_nhwc(images, c.channels, c.size * c.size);
+    auto reference = matrix();
+    float difference = 0.f;
+
+    for (auto algorithm: { convolution_algorithms::IM2COL, convolution_algorithms::WINOGRAD })
+    {
+        if (algorithm == convolution_algorithms::WINOGRAD && c.kernel_size != 3)
+        {
+            continue;
+        }
+
+        nchw.set_algorithm(algorithm);
+        nhwc.set_algorithm(algorithm);
+        auto outputs = nchw.feed_forward(images);
+        auto nhwc_outputs = nhwc.feed_forward(nhwc_images);
+        reference = reference.get_length() == 0 ? outputs : reference;
+        difference = examples::max_difference(difference, examples::max_difference(reference, outputs));
+        difference = examples::max_difference(difference, examples::max_difference(
+                to_nhwc(outputs, c.nb_filters, nb_pixels), nhwc_outputs));
+    }
+
+    std::cout << "images: " << c.channels << "x" << c.size << "x" << c.size << ", filters: "
+              << c.nb_filters << "x" << c.kernel_size << "x" << c.kernel_size
+              << ", largest difference: " << difference << std::endl;
+
+    // Forward and backward propagations of an image.
+    for (auto algorithm: { convolution_algorithms::IM2COL, convolution_algorithms::WINOGRAD })
+    {
+        if (algorithm == convolution_algorithms::WINOGRAD && c.kernel_size != 3)
+        {
+            continue;
+        }
+
+        auto name = std::string(algorithm == convolution_algorithms::WINOGRAD ? "winograd" : "im2col");
+        nchw.set_algorithm(algorithm);
+        nhwc.set_algorithm(algorithm);
+        run("convolution (" + name + ", nchw)", nchw, images);
+        run("convolution (" + name + ", nhwc)", nhwc, nhwc_images);
+    }
+
+    // Pooling (2x2) of the outputs of the convolution.
+    auto outputs = nchw.feed_forward(images);
+    auto nhwc_outputs = to_nhwc(outputs, c.nb_filters, nb_pixels);
+
+    for (auto type: { pooling_types::MAX_POOLING, pooling_types::AVERAGE_POOLING })
+    {
+        auto name = std::string(type == pooling_types::MAX_POOLING ? "max" : "average");
+        auto nchw_pooling = pooling(c.nb_filters, nchw.get_output_height(), nchw.get_output_width(),
+                                    2, 2, type);
+        auto nhwc_pooling = pooling(c.nb_filters, nchw.get_output_height(), nchw.get_output_width(),
+                                    2, 2, type, layouts::NHWC);
+        difference = examples::max_difference(difference, examples::max_difference(
+                to_nhwc(nchw_pooling.feed_forward(outputs), c.nb_filters, nchw_pooling.size() / c.nb_filters),
+                nhwc_pooling.feed_forward(nhwc_outputs)));
+        run(name + " pooling (nchw)", nchw_pooling, outputs);
+        run(name + " pooling (nhwc)", nhwc_pooling, nhwc_outputs);
+    }
+
+    if (images.get_dimensions().second * nchw.size() <= MAX_DENSE_WEIGHTS)
+    {
+        auto dense = layer(images.get_dimensions().second, nchw.size());
+        run("dense layer", dense, images);
+    }
+
+    if (! (difference <= TOLERANCE))
+    {
+        util::ERROR("convolution::main", "The algorithms or layouts differ");
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -74,7 +74,7 @@ int main(int argc, char *argv[])
     //ERROR PROPAGATION
     auto errors = weights_l1 * errors_l1;
     matrix::print(errors);
-    errors_l0 = errors.hadamard_product(inputs.transpose());
+    errors_l0 = errors.hadamard_product(inputs);
     std::cout << "AFTER : errors_l0 \n";
     matrix::print(errors_l0);
 
@@ -0,0 +1,238 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "lib/data_structures/dataset/dataset.h"
+#include "lib/functions/activation_functions/activation_functions.h"
+#include "lib/functions/loss_functions/loss_functions.h"
+#include "lib/models/neural_network/neural_network.h"
+#include "lib/util/distributed/distributed.h"
+#include "examples/common.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+
+using namespace cudaNN;
+
+
+#define NB_FEATURES 32
+#define NB_LABELS 4
+
+
+namespace
+{
+    /**
+     * Configuration of the training (see the usage in "main").
+     */
+    struct configuration
+    {
+        size_t nb_processes = 4;
+        size_t rank = 0;
+        size_t port = DISTRIBUTED_PORT;
+        size_t nb_epochs = 5;
+        size_t batch_size = 8;
+        size_t nb_entries = 4096;
+    };
+
+    /**
+     * @return - "nb_entries" random features, labelled by the quarter
+     * of the features with the largest sum (one-hot). Same for every
+     * process.
+     */
+    dataset synthetic_dataset(size_t nb_entries)
+    {
+        auto data = dataset();
+        std::srand(0);
+
+        for (size_t i = 0; i < nb_entries; i ++)
+        {
+            auto features = matrix(1, NB_FEATURES, "features");
+            auto labels = matrix(1, NB_LABELS, "labels");
+            float sums[NB_LABELS] = {};
+
+            for (size_t j = 0; j < NB_FEATURES; j ++)
+            {
+                features[j] = (float) std::rand() / (float) RAND_MAX;
+                sums[j * NB_LABELS / NB_FEATURES] += features[j];
+            }
+
+            labels[std::max_element(sums, sums + NB_LABELS) - sums] = 1.f;
+            data.add(features, labels);
+        }
+
+        return data;
+    }
+
+    /**
+     * @return - true if the all-reduce of buffers of several lengths
+     * (smaller and larger than the number of processes) is exact.
+     */
+    bool check_all_reduce(distributed::communicator &c)
+    {
+        auto n = (double) c.get_nb_processes();
+        auto valid = true;
+
+        for (size_t length: { (size_t) 1, (size_t) 7, (size_t) 1000, (size_t) 100003 })
+        {
+            auto data = std::vector<float>(length);
+
+            for (size_t i = 0; i < length; i ++)
+            {
+                data[i] = (float) (c.get_rank() + i % 100);
+            }
+
+            c.all_reduce(data.data(), length);
+
+            for (size_t i = 0; i < length; i ++)
+            {
+                valid &= data[i] == (float) (n * (n - 1.) / 2. + n * (double) (i % 100));
+            }
+        }
+
+        return valid;
+    }
+
+    /**
+     * @return - true if every process has the same parameters.
+     */
+    bool check_parameters(distributed::communicator &c, neural_network &nn, size_t nb_layers)
+    {
+        // The checksum of each process in its slot.
+        auto checksums = std::vector<float>(c.get_nb_processes(), 0.f);
+
+        for (size_t i = 0; i < nb_layers; i ++)
+        {
+            for (auto m: nn.get_layer((int) i)->get_parameters())
+            {
+                for (size_t j = 0; j < m->get_length(); j ++)
+                {
+                    checksums[c.get_rank()] += (*m)[j] * (float) (j % 7 + 1);
+                }
+            }
+        }
+
+        c.all_reduce(checksums.data(), checksums.size());
+
+        return std::equal(checksums.begin() + 1, checksums.end(), checksums.begin());
+    }
+
+    /**
+     * Train on the entries of "rank" (one every "nb_processes"),
+     * and check the communication.
+     * @return - the exit code of the process.
+     */
+    int worker(const configuration &c)
+    {
+        auto data = synthetic_dataset(c.nb_entries).train_test_split();
+        auto local = dataset();
+
+        for (size_t i = c.rank; i < data.first.size(); i += c.nb_processes)
+        {
+            local.add(data.first.get(i).get_features(), data.first.get(i).get_labels());
+        }
+
+        // Different initial weights: the ones of the process 0 are used.
+        std::srand((unsigned int) c.rank + 1);
+        auto nn = neural_network(
+        {
+            new layer(NB_FEATURES, 64, initializations::HE, activation_functions::RELU),
+            new layer(64, 64, initializations::HE, activation_functions::RELU),
+            new layer(64, NB_LABELS, initializations::XAVIER, activation_functions::LINEAR)
+        });
+
+        distributed::communicator communicator(c.rank, c.nb_processes, (int) c.port);
+        auto valid = check_all_reduce(communicator);
+        nn.set_communicator(&communicator);
+        nn.fit(local, loss_functions::SOFTMAX_CROSS_ENTROPY_LOSS,
+               c.nb_epochs, c.batch_size, 0.05f, false);
+        valid &= check_parameters(communicator, nn, 3);
+
+        if (c.rank == 0)
+        {
+            auto predictions = nn.predict(data.second);
+            auto accuracy = 0.;
+
+            for (size_t i = 0; i < predictions.size(); i ++)
+            {
+                accuracy += predictions[i].argmax() == data.second.get(i).get_labels().argmax();
+            }
+
+            auto &t = nn.get_training_times();
+            std::cout << "processes: " << c.nb_processes
+                      << ", global batch size: " << c.nb_processes * c.batch_size << std::endl
+                      << "accuracy: " << accuracy / (double) predictions.size() << std::endl
+                      << "time (ms): forward " << t.forward << ", backward " << t.backward
+                      << ", communication " << t.communication << ", update " << t.update
+                      << std::endl;
+        }
+
+        if (! valid)
+        {
+            util::ERROR("distributed_training::worker",
+                        "Invalid all-reduce on process " + std::to_string(c.rank));
+        }
+
+        return valid ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+}
+
+
+/**
+ * Distributed training of a MLP over several processes on this host
+ * (ring all-reduce of the gradients over TCP, see -distributed.h-).
+ * Check that the all-reduce is exact, and that every process ends with
+ * the same parameters.
+ * Without "--rank", the processes are started (forked) by this one.
+ * Usage: distributed_training [--processes n] [--rank i] [--port p]
+ * [--epochs n] [--batch-size n] [--entries n]
+ */
+int main(int argc, char *argv[])
+{
+    auto c = configuration();
+    auto sizes = std::map<std::string, size_t *>(
+    {
+        { "--processes", &c.nb_processes }, { "--rank", &c.rank }, { "--port", &c.port },
+        { "--epochs", &c.nb_epochs }, { "--batch-size", &c.batch_size }, { "--entries", &c.nb_entries }
+    });
+
+    // The workers are given their rank.
+    auto fork_workers = examples::parse_arguments(argc, argv, sizes).count("--rank") == 0;
+
+    if (! fork_workers)
+    {
+        return worker(c);
+    }
+
+    auto pids = std::vector<pid_t>();
+
+    for (size_t i = 0; i < c.nb_processes; i ++)
+    {
+        auto pid = fork();
+
+        if (pid == 0)
+        {
+            c.rank = i;
+            std::exit(worker(c));
+        }
+
+        pids.push_back(pid);
+    }
+
+    auto code = EXIT_SUCCESS;
+
+    for (auto pid: pids)
+    {
+        int status;
+        waitpid(pid, &status, 0);
+        code = WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS ? code : EXIT_FAILURE;
+    }
+
+    std::cout << (code == EXIT_SUCCESS ? "all processes succeeded" : "a process failed") << std::endl;
+
+    return code;
+}
@@ -0,0 +1,239 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "lib/data_structures/dataset/dataset.h"
+#include "lib/functions/activation_functions/activation_functions.h"
+#include "lib/functions/loss_functions/loss_functions.h"
+#include "lib/models/neural_network/neural_network.h"
+#include "lib/util/benchmark/benchmark.h"
+#include "examples/common.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <vector>
+
+
+using namespace cudaNN;
+
+
+// Largest tolerated difference between the measured and the expected rates.
+#define RATE_TOLERANCE 1e-2
+// Largest tolerated difference between gradients computed with the same masks.
+#define TOLERANCE 1e-6
+
+
+namespace
+{
+    /**
+     * Configuration of the comparison (see the usage in "main").
+     */
+    struct configuration
+    {
+        size_t nb_rows = 64;
+        size_t size = 4096;
+        float rate = .5f;
+    };
+
+    /**
+     * @return - true if the inputs are dropped with the expected rate (and the
+     * other ones scaled), and not at all during the predictions.
+     */
+    bool check_masks(const configuration &c)
+    {
+        auto d = dropout(c.size, c.rate);
+        auto inputs = matrix(c.nb_rows, c.size, "inputs");
+        inputs += 1.f;
+
+        d.set_training(true);
+        auto outputs = d.feed_forward(inputs);
+        size_t nb_dropped = 0;
+        size_t nb_wrong = 0;
+
+        for (size_t i = 0; i < outputs.get_length(); i ++)
+        {
+            nb_dropped += outputs[i] == 0.f ? 1 : 0;
+            nb_wrong += outputs[i] != 0.f && std::abs(outputs[i] * (1.f - c.rate) - 1.f) > 1e-6f ? 1 : 0;
+        }
+
+        auto rate = (double) nb_dropped / (double) outputs.get_length();
+        d.set_training(false);
+        auto predictions = d.feed_forward(inputs);
+        auto identity = examples::max_difference(predictions, inputs) == 0.f;
+
+        std::cout << "dropped: " << rate << " (rate " << c.rate << "), predictions unchanged: "
+                  << (identity ? "yes" : "no") << std::endl;
+
+        return std::abs(rate - c.rate) <= RATE_TOLERANCE && nb_wrong == 0 && identity;
+    }
+
+    /**
+     * @return - true if dropouts built after setting the same seed have the
+     * same masks (and the ones of another seed, or the next dropout, not).
+     */
+    bool check_seeds(const configuration &c)
+    {
+        auto inputs = matrix(c.nb_rows, c.size, "inputs");
+        inputs += 1.f;
+        auto outputs = std::vector<matrix>();
+
+        for (auto seed: { 7, 7, 8 })
+        {
+            rng::set_seed(seed);
+
+            for (auto i = 0; i < 2; i ++)
+            {
+                auto d = dropout(c.size, c.rate);
+                d.set_training(true);
+                outputs.push_back(d.feed_forward(inputs));
+            }
+        }
+
+        auto same = outputs[0] == outputs[2] && outputs[1] == outputs[3];
+        auto different = outputs[0] != outputs[1] && outputs[0] != outputs[4];
+
+        std::cout << "same seed, same masks: " << (same ? "yes" : "no")
+                  << "; next dropout or other seed, other ones: " << (different ? "yes" : "no") << std::endl;
+
+        return same && different;
+    }
+
+    /**
+     * @return - true if the gradients of a network with dropouts are the same
+     * with activation checkpoints (entries computed again), and with masks
+     * generated again during the backpropagation.
+     */
+    bool check_gradients(const configuration &c)
+    {
+        auto width = (size_t) 64;
+        auto dropouts = std::vector<dropout *>(
+        {
+            new dropout(16, c.rate), new dropout(width, c.rate), new dropout(width, c.rate)
+        });
+        // (With an interval of 2, the checkpoints are the dropouts: their inputs
+        // are only kept there.)
+        auto nn = neural_network(
+        {
+            dropouts[0], new layer(16, width, initializations::XAVIER, activation_functions::TANH),
+            dropouts[1], new layer(width, width, initializations::XAVIER, activation_functions::TANH),
+            dropouts[2], new layer(width, 1, initializations::XAVIER, activation_functions::LINEAR)
+        });
+        auto data = dataset();
+
+        for (size_t i = 0; i < 32; i ++)
+        {
+            data.add(examples::random_matrix(1, 16, "features"), examples::random_matrix(1, 1, "labels"));
+        }
+
+        auto reference = nn.compute_gradients(data, loss_functions::MEAN_SQUARED_ERROR);
+        auto difference = 0.f;
+
+        for (auto variant: { "checkpoints", "generated masks" })
+        {
+            if (std::string(variant) == "checkpoints")
+            {
+                nn.set_checkpoint_interval(2);
+            }
+            else
+            {
+                nn.set_checkpoint_interval(1);
+
+                for (auto d: dropouts)
+                {
+                    d->set_keep_masks(false);
+                }
+            }
+
+            auto gradients = nn.compute_gradients(data, loss_functions::MEAN_SQUARED_ERROR);
+
+            for (size_t l = 0; l < gradients.size(); l ++)
+            {
+                for (size_t p = 0; p < gradients[l].size(); p ++)
+                {
+                    difference = examples::max_difference(
+                            difference, examples::max_difference(gradients[l][p], reference[l][p]));
+                }
+            }
+        }
+
+        std::cout << "largest difference of the gradients (checkpoints, generated masks): "
+                  << difference << std::endl;
+
+        return difference <= TOLERANCE;
+    }
+}
+
+
+/**
+ * Check the dropout layer (rate of the masks, predictions unchanged, masks
+ * reproduced from the seed, same gradients whatever the checkpoints and the
+ * storage of the masks), then
+ * measure its propagations with the masks kept (bitmasks) or generated again,
+ * against a float mask drawn sequentially.
+ * Usage: dropout [--rows n] [--size n] [--rate f]
+ */
+int main(int argc, char *argv[])
+{
+    std::srand(0);
+
+    auto c = configuration();
+    auto sizes = std::map<std::string, size_t *>({ { "--rows", &c.nb_rows }, { "--size", &c.size } });
+
+    examples::parse_arguments(argc, argv, sizes, { { "--rate", &c.rate } });
+
+    auto valid = check_masks(c);
+    valid = check_seeds(c) && valid;
+    valid = check_gradients(c) && valid;
+
+    auto inputs = examples::random_matrix(c.nb_rows, c.size, "inputs");
+    auto shape = std::to_string(c.nb_rows) + "x" + std::to_string(c.size);
+    auto bytes = (double) inputs.get_length() * 4. * sizeof(float);
+    auto d = dropout(c.size, c.rate);
+    d.set_training(true);
+
+    for (auto keep: { true, false })
+    {
+        d.set_keep_masks(keep);
+        auto r = benchmark::run(keep ? "dropout forward+backward (bitmask)"
+                                     : "dropout forward+backward (generated)", shape, [&]()
+        {
+            auto errors = d.feed_forward(inputs);
+            d.backward_propagation(errors);
+        }, 0., bytes);
+
+        benchmark::print(r);
+    }
+
+    // Reference: a float per input, drawn by a sequential generator.
+    auto generator = std::mt19937(0);
+    auto uniform = std::uniform_real_distribution<float>(0.f, 1.f);
+    auto mask = matrix(inputs.get_dimensions(), "mask");
+    auto r = benchmark::run("dropout forward+backward (float mask)", shape, [&]()
+    {
+        for (size_t i = 0; i < mask.get_length(); i ++)
+        {
+            mask[(int) i] = uniform(generator) < c.rate ? 0.f : 1.f / (1.f - c.rate);
+        }
+
+        auto errors = inputs;
+        errors.hadamard_product_in_place(mask);
+        errors.hadamard_product_in_place(mask);
+    }, 0., bytes + (double) mask.get_length() * 2. * sizeof(float));
+
+    benchmark::print(r);
+    d.set_keep_masks(true);
+    std::cout << "memory of the masks per entry: " << d.get_workspace_memory() << " bytes (bitmask), "
+              << c.size * sizeof(float) << " bytes (float mask)" << std::endl;
+
+    if (! valid)
+    {
+        util::ERROR("dropout::main", "Invalid masks or gradients");
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,138 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "lib/data_structures/dataset/dataset.h"
+#include "lib/functions/activation_functions/activation_functions.h"
+#include "lib/functions/loss_functions/loss_functions.h"
+#include "lib/models/neural_network/neural_network.h"
+#include "lib/util/benchmark/benchmark.h"
+#include "examples/common.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+
+using namespace cudaNN;
+
+
+namespace
+{
+    /**
+     * Configuration of the comparison (see the usage in "main").
+     */
+    struct configuration
+    {
+        size_t nb_entries = 4096;
+        size_t nb_used_ids = 100;
+        size_t nb_ids = 3;
+        size_t nb_labels = 2;
+        size_t dimension = 16;
+        size_t nb_epochs = 5;
+        size_t batch_size = 16;
+    };
+
+    /**
+     * @return - entries of "nb_ids" ids (among "nb_used_ids" ids spread over
+     * the vocabulary), each id having a class: the entries are labelled by
+     * the most frequent class of their ids (one-hot).
+     */
+    dataset categorical_dataset(const configuration &c, size_t vocabulary_size)
+    {
+        // The same ids and classes for every vocabulary.
+        std::srand(0);
+        auto used_ids = std::vector<size_t>(c.nb_used_ids);
+        auto classes = std::vector<size_t>(c.nb_used_ids);
+        auto data = dataset();
+
+        for (size_t i = 0; i < c.nb_used_ids; i ++)
+        {
+            used_ids[i] = (size_t) std::rand() % vocabulary_size;
+            classes[i] = (size_t) std::rand() % c.nb_labels;
+        }
+
+        for (size_t i = 0; i < c.nb_entries; i ++)
+        {
+            auto features = matrix(1, c.nb_ids, "features");
+            auto labels = matrix(1, c.nb_labels, "labels");
+            auto counts = std::vector<size_t>(c.nb_labels, 0);
+
+            for (size_t j = 0; j < c.nb_ids; j ++)
+            {
+                auto k = (size_t) std::rand() % c.nb_used_ids;
+                features[(int) j] = (float) used_ids[k];
+                counts[classes[k]] ++;
+            }
+
+            labels[(int) (std::max_element(counts.begin(), counts.end()) - counts.begin())] = 1.f;
+            data.add(features, labels);
+        }
+
+        return data;
+    }
+
+    double accuracy(neural_network &nn, dataset &test)
+    {
+        auto predictions = nn.predict(test);
+        double correct = 0.;
+
+        for (size_t i = 0; i < predictions.size(); i ++)
+        {
+            correct += predictions[i].argmax() == test.get(i).get_labels().argmax() ? 1. : 0.;
+        }
+
+        return correct / (double) predictions.size();
+    }
+}
+
+
+/**
+ * Train an embedding of categorical features (ids), followed by a MLP, on
+ * vocabularies of increasing sizes: the training time does not depend on
+ * the size of the vocabulary (only the rows of the ids of a batch are
+ * read and updated).
+ * The ids are given to the network as features (a row of ids per entry).
+ * Usage: embedding [--entries n] [--ids n] [--dimension n] [--epochs n]
+ * [--batch-size n] [--max-vocabulary n]
+ */
+int main(int argc, char *argv[])
+{
+    auto c = configuration();
+    size_t max_vocabulary_size = 1000000;
+    auto sizes = std::map<std::string, size_t *>(
+    {
+        { "--entries", &c.nb_entries }, { "--ids", &c.nb_ids }, { "--dimension", &c.dimension },
+        { "--epochs", &c.nb_epochs }, { "--batch-size", &c.batch_size },
+        { "--max-vocabulary", &max_vocabulary_size }
+    });
+
+    examples::parse_arguments(argc, argv, sizes);
+
+    for (size_t vocabulary_size = 10000; vocabulary_size <= max_vocabulary_size; vocabulary_size *= 10)
+    {
+        auto data = categorical_dataset(c, vocabulary_size).train_test_split();
+        auto nn = neural_network(
+        {
+            new embedding(vocabulary_size, c.dimension),
+            new layer(c.dimension, 32, initializations::HE, activation_functions::RELU),
+            new layer(32, c.nb_labels, initializations::XAVIER, activation_functions::LINEAR)
+        });
+
+        // A large learning rate: each vector is only updated by the few
+        // entries of a batch containing its id.
+        auto stopwatch = benchmark::stopwatch();
+        nn.fit(data.first, loss_functions::SOFTMAX_CROSS_ENTROPY_LOSS,
+               c.nb_epochs, c.batch_size, 0.5f, false);
+        auto time = stopwatch.lap();
+        auto &t = nn.get_training_times();
+
+        std::cout << "vocabulary: " << vocabulary_size << ", training: " << time
+                  << " ms (forward " << t.forward << ", backward " << t.backward
+                  << ", update " << t.update << "), accuracy " << accuracy(nn, data.second)
+                  << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,429 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "lib/data_structures/dataset/dataset.h"
+#include "lib/functions/activation_functions/activation_functions.h"
+#include "lib/functions/loss_functions/loss_functions.h"
+#include "lib/models/neural_network/neural_network.h"
+#include "lib/util/gradient_check/gradient_check.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+
+using namespace cudaNN;
+
+
+#define DEFAULT_SEED 42
+#define NB_ENTRIES 4
+#define NB_FEATURES 5
+#define NB_HIDDEN 6
+#define NB_LABELS 3
+// Factor of the altered gradients, to be rejected (see "check_rejection").
+#define WRONG_GRADIENT_SCALE 1.5f
+
+
+namespace
+{
+    std::mt19937 generator;
+
+    /**
+     * A loss, with the activation of the output layer giving
+     * predictions in its domain, and its type of labels.
+     */
+    struct loss_case
+    {
+        const function *loss_function;
+        const function *output_activation;
+        enum { REAL, BINARY, SIGNS, ONE_HOT } labels;
+    };
+
+    /**
+     * Layers of other types than "layer", checked as the first layers of
+     * a network (followed by a dense output layer).
+     * @nb_features - the size of the inputs.
+     * @nb_steps - the number of rows of the inputs (the steps of the sequences).
+     */
+    struct layer_case
+    {
+        std::string name;
+        size_t nb_features;
+        std::function<std::vector<base_layer *>()> build;
+        size_t nb_steps;
+    };
+
+    /**
+     * Random scales, shifts and statistics of a normalization.
+     */
+    void randomize(normalization &n)
+    {
+        auto values = std::uniform_real_distribution<float>(.5f, 1.5f);
+
+        for (size_t j = 0; j < n.size(); j ++)
+        {
+            n.get_scales()[j] = values(generator);
+            n.get_shifts()[j] = values(generator) - 1.f;
+            n.get_means()[j] = values(generator) - 1.f;
+            n.get_variances()[j] = values(generator);
+        }
+    }
+
+    dataset random_dataset(const loss_case &c, size_t nb_features = NB_FEATURES, size_t nb_steps = 1)
+    {
+        auto values = std::uniform_real_distribution<float>(-1.f, 1.f);
+        auto bits = std::bernoulli_distribution(.5);
+        auto classes = std::uniform_int_distribution<size_t>(0, NB_LABELS - 1);
+        auto data = dataset();
+
+        for (size_t i = 0; i < NB_ENTRIES; i ++)
+        {
+            auto features = matrix(nb_steps, nb_features, "features");
+            auto labels = matrix(1, NB_LABELS, "labels");
+
+            for (size_t j = 0; j < nb_steps * nb_features; j ++)
+            {
+                features[j] = values(generator);
+            }
+
+            for (size_t j = 0; j < NB_LABELS; j ++)
+            {
+                labels[j] = c.labels == loss_case::REAL ? values(generator)
+                            : c.labels == loss_case::BINARY ? (bits(generator) ? 1.f : 0.f)
+                            : c.labels == loss_case::SIGNS ? (bits(generator) ? 1.f : -1.f)
+                            : 0.f;
+            }
+
+            if (c.labels == loss_case::ONE_HOT)
+            {
+                labels[classes(generator)] = 1.f;
+            }
+
+            data.add(features, labels);
+        }
+
+        return data;
+    }
+
+    /**
+     * @return - true if a combination passes: no parameter with a wrong
+     * gradient (the non-differentiable points are skipped), and at least
+     * one checked.
+     */
+    bool passes(const gradient_check::report &r)
+    {
+        return r.nb_failures == 0 && r.nb_checks > 0;
+    }
+
+    /**
+     * Check that the gradients of a single matrix of parameters (of the layer
+     * n°"l", n°"parameter" in its parameters), multiplied by
+     * -WRONG_GRADIENT_SCALE-, are rejected (and reported as the worst).
+     */
+    bool check_rejection(const loss_case &c, size_t l, size_t parameter,
+                         double epsilon, double tolerance)
+    {
+        auto data = random_dataset(c);
+        auto nn = neural_network(
+        {
+            new layer(NB_FEATURES, NB_HIDDEN, initializations::XAVIER, activation_functions::TANH),
+            new layer(NB_HIDDEN, NB_HIDDEN, initializations::XAVIER, activation_functions::TANH),
+            new layer(NB_HIDDEN, NB_LABELS, initializations::XAVIER, *c.output_activation)
+        });
+        nn.set_training(true);
+        auto gradients = nn.compute_gradients(data, *c.loss_function);
+        gradients[l][parameter] *= WRONG_GRADIENT_SCALE;
+        auto r = gradient_check::check(nn, data, *c.loss_function, gradients, epsilon, tolerance);
+        auto rejected = ! passes(r) && r.worst.layer == l && r.worst.parameter == parameter;
+
+        std::cout << (rejected ? TERM_GREEN : TERM_RED)
+                  << "gradients of layer " << l << " parameter " << parameter << " x"
+                  << WRONG_GRADIENT_SCALE << ": " << r.nb_failures << "/" << r.nb_checks
+                  << " failures, " << (rejected ? "rejected" : "accepted")
+                  << TERM_RESET << std::endl;
+
+        return rejected;
+    }
+}
+
+
+/**
+ * Validate the backpropagation ("layer::backward_propagation") with
+ * finite differences (see -gradient_check.h-), for each combination of
+ * activation function (hidden layers) and loss function, on a small
+ * network of 3 layers; then the one of the other types of layers.
+ * Can be used as a test: the exit code is non-zero if a parameter of a
+ * combination has a wrong gradient, or if deliberately scaled gradients
+ * are not rejected (the check itself is checked first).
+ * Usage: gradient_check [--seed n] [--epsilon f] [--tolerance f] [--verbose]
+ */
+int main(int argc, char *argv[])
+{
+    auto seed = (unsigned int) DEFAULT_SEED;
+    auto epsilon = GRADIENT_CHECK_EPSILON;
+    auto tolerance = GRADIENT_CHECK_TOLERANCE;
+    auto verbose = false;
+
+    for (int i = 1; i < argc; i ++)
+    {
+        auto arg = std::string(argv[i]);
+
+        if (arg == "--verbose")
+        {
+            verbose = true;
+        }
+        else if (i + 1 < argc && arg == "--seed")
+        {
+            seed = (unsigned int) std::stoul(argv[++ i]);
+        }
+        else if (i + 1 < argc && arg == "--epsilon")
+        {
+            epsilon = std::stod(argv[++ i]);
+        }
+        else if (i + 1 < argc && arg == "--tolerance")
+        {
+            tolerance = std::stod(argv[++ i]);
+        }
+    }
+
+    generator.seed(seed);
+
+    using namespace activation_functions;
+    using namespace loss_functions;
+
+    const function *activations[] = { &LINEAR, &SIGMOID, &TANH, &SIGMOID_FAST, &TANH_FAST, &RELU };
+    const loss_case losses[] =
+    {
+        { &MEAN_SQUARED_ERROR, &LINEAR, loss_case::REAL },
+        // The product of the Jacobian of the softmax (not fused with the loss).
+        { &MEAN_SQUARED_ERROR, &SOFTMAX, loss_case::ONE_HOT },
+        { &MEAN_ABSOLUTE_ERROR, &LINEAR, loss_case::REAL },
+        { &MEAN_BIAS_ERROR, &LINEAR, loss_case::REAL },
+        { &HINGE_LOSS, &LINEAR, loss_case::SIGNS },
+        { &BINARY_CROSS_ENTROPY_LOSS, &SIGMOID, loss_case::BINARY },
+        { &CROSS_ENTROPY_LOSS, &SIGMOID, loss_case::ONE_HOT },
+        { &SOFTMAX_CROSS_ENTROPY_LOSS, &LINEAR, loss_case::ONE_HOT }
+    };
+    size_t nb_failures = 0;
+    size_t nb_cases = 0;
+
+    // The biases of the output layer, and the weights of the first one.
+    for (auto p: { std::make_pair(2, 1), std::make_pair(0, 0) })
+    {
+        nb_failures += check_rejection(losses[0], p.first, p.second, epsilon, tolerance) ? 0 : 1;
+        nb_cases ++;
+    }
+
+    std::cout << std::endl;
+    std::cout << std::setw(28) << "loss" << std::setw(10) << "output" << std::setw(14) << "activation"
+              << std::setw(16) << "max error" << std::setw(12) << "failures" << std::endl;
+
+    for (auto &c: losses)
+    {
+        for (auto activation: activations)
+        {
+            auto data = random_dataset(c);
+            auto nn = neural_network(
+            {
+                new layer(NB_FEATURES, NB_HIDDEN, initializations::XAVIER, *activation),
+                new layer(NB_HIDDEN, NB_HIDDEN, initializations::XAVIER, *activation),
+                new layer(NB_HIDDEN, NB_LABELS, initializations::XAVIER, *c.output_activation)
+            });
+            auto r = gradient_check::check(nn, data, *c.loss_function, epsilon, tolerance);
+            auto max_error = *std::max_element(r.max_errors.begin(), r.max_errors.end());
+
+            auto failed = ! passes(r);
+
+            std::cout << (failed ? TERM_RED : TERM_GREEN)
+                      << std::setw(28) << c.loss_function->get_id()
+                      << std::setw(10) << c.output_activation->get_id()
+                      << std::setw(14) << activation->get_id()
+                      << std::setw(16) << std::scientific << std::setprecision(2) << max_error
+                      << std::setw(12) << r.nb_failures
+                      << TERM_RESET << std::endl;
+
+            if (verbose || failed)
+            {
+                gradient_check::print(r);
+            }
+
+            nb_failures += failed ? 1 : 0;
+            nb_cases ++;
+        }
+    }
+
+    // The other types of layers (mean squared error).
+    const loss_case &mse = losses[0];
+    const layer_case layers[] =
+    {
+        { "convolution (im2col)", 2 * 5 * 5, []()
+        {
+            auto l = new convolution(2, 5, 5, 3, 3, 1, 1, initializations::XAVIER, TANH);
+            l->set_algorithm(convolution_algorithms::IM2COL);
+            return std::vector<base_layer *>({ l });
+        }, 1 },
+        { "convolution (winograd)", 2 * 5 * 5, []()
+        {
+            return std::vector<base_layer *>(
+            {
+                new convolution(2, 5, 5, 3, 3, 1, 1, initializations::XAVIER, TANH)
+            });
+        }, 1 },
+        { "convolution (nhwc, stride 2)", 2 * 6 * 5, []()
+        {
+            return std::vector<base_layer *>(
+            {
+                new convolution(2, 6, 5, 3, 2, 2, 1, initializations::XAVIER, TANH, layouts::NHWC)
+            });
+        }, 1 },
+        // The errors on the inputs of the convolutions.
+        { "layer -> convolution (im2col, stride 2)", NB_FEATURES, []()
+        {
+            auto l = new convolution(2, 5, 4, 3, 2, 2, 1, initializations::XAVIER, TANH);
+            l->set_algorithm(convolution_algorithms::IM2COL);
+            return std::vector<base_layer *>(
+            {
+                new layer(NB_FEATURES, 2 * 5 * 4, initializations::XAVIER, TANH), l
+            });
+        }, 1 },
+        { "layer -> convolution (nhwc, winograd)", NB_FEATURES, []()
+        {
+            return std::vector<base_layer *>(
+            {
+                new layer(NB_FEATURES, 2 * 4 * 4, initializations::XAVIER, TANH),
+                new convolution(2, 4, 4, 2, 3, 1, 1, initializations::XAVIER, TANH, layouts::NHWC)
+            });
+        }, 1 },
+        // The pooling layers have no parameters: checked through the errors
+        // they propagate to a convolution.
+        { "convolution -> max pooling", 2 * 6 * 6, []()
+        {
+            return std::vector<base_layer *>(
+            {
+                new convolution(2, 6, 6, 3, 3, 1, 1, initializations::XAVIER, TANH),
+                new pooling(3, 6, 6, 2)
+            });
+        }, 1 },
+        { "convolution -> average pooling (nhwc, overlapping)", 2 * 6 * 6, []()
+        {
+            return std::vector<base_layer *>(
+            {
+                new convolution(2, 6, 6, 3, 3, 1, 1, initializations::XAVIER, TANH, layouts::NHWC),
+                new pooling(3, 6, 6, 3, 2, pooling_types::AVERAGE_POOLING, layouts::NHWC)
+            });
+        }, 1 },
+        { "convolution -> max pooling (overlapping)", 2 * 6 * 6, []()
+        {
+            return std::vector<base_layer *>(
+            {
+                new convolution(2, 6, 6, 3, 3, 1, 1, initializations::XAVIER, TANH),
+                new pooling(3, 6, 6, 3, 1)
+            });
+        }, 1 },
+        // (With statistics and parameters away from the identity.)
+        { "layer -> batch normalization", NB_FEATURES, []()
+        {
+            auto n = new normalization(NB_HIDDEN, normalization_types::BATCH_NORMALIZATION, TANH);
+            randomize(*n);
+            return std::vector<base_layer *>(
+            {
+                new layer(NB_FEATURES, NB_HIDDEN, initializations::XAVIER, LINEAR), n
+            });
+        }, 1 },
+        { "layer -> layer normalization", NB_FEATURES, []()
+        {
+            auto n = new normalization(NB_HIDDEN, normalization_types::LAYER_NORMALIZATION, TANH);
+            randomize(*n);
+            return std::vector<base_layer *>(
+            {
+                new layer(NB_FEATURES, NB_HIDDEN, initializations::XAVIER, TANH), n
+            });
+        }, 1 },
+        // (The losses with the masks of the gradients.)
+        { "layer -> dropout -> layer", NB_FEATURES, []()
+        {
+            return std::vector<base_layer *>(
+            {
+                new layer(NB_FEATURES, NB_HIDDEN, initializations::XAVIER, TANH),
+                new dropout(NB_HIDDEN, .5f),
+                new layer(NB_HIDDEN, NB_HIDDEN, initializations::XAVIER, TANH)
+            });
+        }, 1 },
+        // Sequences of 4 time steps (the last state, then the dense layer).
+        { "recurrent (lstm)", NB_FEATURES, []()
+        {
+            return std::vector<base_layer *>({ new recurrent(NB_FEATURES, NB_HIDDEN, LSTM, false) });
+        }, 4 },
+        { "recurrent (gru)", NB_FEATURES, []()
+        {
+            return std::vector<base_layer *>({ new recurrent(NB_FEATURES, NB_HIDDEN, GRU, false) });
+        }, 4 },
+        // The errors on the sequences of outputs and inputs.
+        { "recurrent (gru) -> recurrent (lstm)", NB_FEATURES, []()
+        {
+            return std::vector<base_layer *>(
+            {
+                new recurrent(NB_FEATURES, NB_HIDDEN, GRU, true),
+                new recurrent(NB_HIDDEN, NB_HIDDEN, LSTM, false)
+            });
+        }, 5 },
+        // Sequences of 6 positions (attention, then the last state of a
+        // recurrent layer); the causal one over several tiles of positions.
+        { "layer -> attention -> recurrent (gru)", NB_FEATURES, []()
+        {
+            return std::vector<base_layer *>(
+            {
+                new layer(NB_FEATURES, NB_HIDDEN, initializations::XAVIER, TANH),
+                new attention(NB_HIDDEN, 2),
+                new recurrent(NB_HIDDEN, NB_HIDDEN, GRU, false)
+            });
+        }, 6 },
+        { "layer -> attention (causal) -> recurrent (gru)", NB_FEATURES, []()
+        {
+            return std::vector<base_layer *>(
+            {
+                new layer(NB_FEATURES, NB_HIDDEN, initializations::XAVIER, TANH),
+                new attention(NB_HIDDEN, 2, true),
+                new recurrent(NB_HIDDEN, NB_HIDDEN, GRU, false)
+            });
+        }, ATTENTION_TILE_SIZE + 6 }
+    };
+
+    std::cout << std::endl << std::setw(52) << "layer" << std::setw(16) << "max error"
+              << std::setw(12) << "failures" << std::endl;
+
+    for (auto &c: layers)
+    {
+        auto data = random_dataset(mse, c.nb_features, c.nb_steps);
+        auto stack = c.build();
+        stack.push_back(new layer(stack.back()->size(), NB_LABELS, initializations::XAVIER, LINEAR));
+        auto nn = neural_network(stack);
+        auto r = gradient_check::check(nn, data, *mse.loss_function, epsilon, tolerance);
+        auto max_error = *std::max_element(r.max_errors.begin(), r.max_errors.end());
+        auto failed = ! passes(r);
+
+        std::cout << (failed ? TERM_RED : TERM_GREEN)
+                  << std::setw(52) << c.name
+                  << std::setw(16) << std::scientific << std::setprecision(2) << max_error
+                  << std::setw(12) << r.nb_failures
+                  << TERM_RESET << std::endl;
+
+        if (verbose || failed)
+        {
+            gradient_check::print(r);
+        }
+
+        nb_failures += failed ? 1 : 0;
+        nb_cases ++;
+    }
+
+    std::cout << (nb_failures == 0 ? TERM_GREEN : TERM_RED)
+              << nb_cases - nb_failures << "/" << nb_cases << " checks passed"
+              << TERM_RESET << std::endl;
+
+    return nb_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
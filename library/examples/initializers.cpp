@@ -0,0 +1,227 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "lib/data_structures/dataset/dataset.h"
+#include "lib/models/neural_network/neural_network.h"
+#include "lib/util/benchmark/benchmark.h"
+#include "lib/util/parallel/parallel.h"
+#include "examples/common.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <vector>
+
+
+using namespace cudaNN;
+
+
+// Largest tolerated relative difference between the measured and the expected
+// deviations.
+#define DEVIATION_TOLERANCE 1e-2
+// Largest tolerated difference between the products of orthogonal weights and
+// the identity.
+#define ORTHOGONALITY_TOLERANCE 1e-4
+
+
+namespace
+{
+    /**
+     * Configuration of the comparison (see the usage in "main").
+     */
+    struct configuration
+    {
+        size_t nb_rows = 2048;
+        size_t nb_columns = 2048;
+        size_t nb_threads = 0;
+    };
+
+    double deviation(const matrix &m)
+    {
+        double sum = 0.;
+        double squares = 0.;
+
+        for (size_t i = 0; i < m.get_length(); i ++)
+        {
+            sum += m[i];
+            squares += (double) m[i] * m[i];
+        }
+
+        auto mean = sum / (double) m.get_length();
+
+        return std::sqrt(squares / (double) m.get_length() - mean * mean);
+    }
+
+    /**
+     * @return - the largest difference between the products of the rows (or
+     * columns) of "m" and the identity.
+     */
+    float orthogonality(const matrix &m)
+    {
+        auto nb_rows = m.get_dimensions().first;
+        auto nb_columns = m.get_dimensions().second;
+        auto difference = 0.f;
+
+        for (size_t i = 0; i < std::min(nb_rows, nb_columns); i ++)
+        {
+            for (size_t j = 0; j <= i; j ++)
+            {
+                float product = 0.f;
+
+                for (size_t k = 0; k < std::max(nb_rows, nb_columns); k ++)
+                {
+                    product += nb_rows < nb_columns ? m[(int) (i * nb_columns + k)] * m[(int) (j * nb_columns + k)]
+                                                    : m[(int) (k * nb_columns + i)] * m[(int) (k * nb_columns + j)];
+                }
+
+                difference = examples::max_difference(difference, std::abs(product - (i == j ? 1.f : 0.f)));
+            }
+        }
+
+        return difference;
+    }
+
+    /**
+     * @return - true if each initialization has the expected deviation (or
+     * orthonormal vectors), and the same weights with a single thread.
+     */
+    bool check_initializations(const configuration &c)
+    {
+        auto names = std::map<initializations, std::string>(
+        {
+            { XAVIER, "xavier" }, { HE, "he" }, { XAVIER_UNIFORM, "xavier (uniform)" },
+            { HE_UNIFORM, "he (uniform)" }, { ORTHOGONAL, "orthogonal" }
+        });
+        auto valid = true;
+
+        for (auto &n: names)
+        {
+            auto init = n.first;
+            auto nb_rows = init == ORTHOGONAL ? (size_t) 96 : c.nb_rows;
+            auto nb_columns = init == ORTHOGONAL ? (size_t) 256 : c.nb_columns;
+            auto weights = matrix(nb_rows, nb_columns, "weights");
+            auto sequential = matrix(nb_rows, nb_columns, "weights");
+            auto fan_in = nb_rows;
+            auto first = rng::next_counter();
+
+            initializers::initialize(weights, init, fan_in, 1.f, rng::get_key(), first);
+            auto nb_threads = parallel::get_nb_threads();
+            parallel::set_nb_threads(1);
+            initializers::initialize(sequential, init, fan_in, 1.f, rng::get_key(), first);
+            parallel::set_nb_threads(nb_threads);
+
+            auto same = weights == sequential;
+            auto expected = std::sqrt((init == HE || init == HE_UNIFORM ? 2. : 1.) / (double) fan_in);
+            auto error = init == ORTHOGONAL ? orthogonality(weights)
+                                            : std::abs(deviation(weights) / expected - 1.);
+
+            std::cout << n.second << ": " << (init == ORTHOGONAL ? "orthogonality error " : "relative error of the deviation ")
+                      << error << ", same weights with 1 thread: " << (same ? "yes" : "no") << std::endl;
+
+            valid = valid && same && error <= (init == ORTHOGONAL ? ORTHOGONALITY_TOLERANCE : DEVIATION_TOLERANCE);
+        }
+
+        return valid;
+    }
+
+    /**
+     * @return - true if networks built after setting the same seed have the
+     * same weights (and the ones of another seed not), and datasets the same
+     * shuffles.
+     */
+    bool check_seeds()
+    {
+        auto weights = std::vector<matrix>();
+        auto batches = std::vector<matrix>();
+
+        for (auto seed: { 7, 7, 8 })
+        {
+            rng::set_seed(seed);
+            auto nn = neural_network(
+            {
+                new layer(16, 32, initializations::HE_UNIFORM),
+                new recurrent(32, 8, recurrent_types::GRU, false, 0, initializations::ORTHOGONAL)
+            });
+            auto data = dataset();
+
+            for (size_t i = 0; i < 32; i ++)
+            {
+                data.add(matrix({ (float) i }, 1, 1), matrix({ 0.f }, 1, 1));
+            }
+
+            weights.push_back(*nn.get_layer(1)->get_parameters()[1]);
+            batches.push_back(data.get_random_batch(8).stack(0, 8).first);
+        }
+
+        auto same = weights[0] == weights[1] && batches[0] == batches[1];
+        auto different = weights[0] != weights[2] && batches[0] != batches[2];
+
+        std::cout << "same seed, same weights and batches: " << (same ? "yes" : "no")
+                  << "; other seed, other ones: " << (different ? "yes" : "no") << std::endl;
+
+        return same && different;
+    }
+}
+
+
+/**
+ * Check the initializations of the weights (deviations, orthogonality, same
+ * weights whatever the number of threads, reproduced from a seed), then
+ * measure them against a normal distribution drawn sequentially from a
+ * random device (the previous initialization).
+ * Usage: initializers [--rows n] [--columns n] [--threads n]
+ */
+int main(int argc, char *argv[])
+{
+    auto c = configuration();
+    auto sizes = std::map<std::string, size_t *>(
+    {
+        { "--rows", &c.nb_rows }, { "--columns", &c.nb_columns }, { "--threads", &c.nb_threads }
+    });
+
+    examples::parse_arguments(argc, argv, sizes);
+
+    parallel::set_nb_threads(c.nb_threads);
+    auto valid = check_initializations(c);
+    valid = check_seeds() && valid;
+
+    auto weights = matrix(c.nb_rows, c.nb_columns, "weights");
+    auto shape = std::to_string(c.nb_rows) + "x" + std::to_string(c.nb_columns);
+    auto bytes = (double) weights.get_length() * sizeof(float);
+
+    auto r = benchmark::run("initialization (random device, sequential)", shape, [&]()
+    {
+        std::random_device generator;
+        auto distribution = std::normal_distribution<float>(0.f, std::sqrt(2.f / (float) c.nb_rows));
+
+        for (size_t i = 0; i < weights.get_length(); i ++)
+        {
+            weights[(int) i] = distribution(generator);
+        }
+    }, 0., bytes);
+
+    benchmark::print(r);
+
+    for (auto init: { HE, HE_UNIFORM })
+    {
+        r = benchmark::run(init == HE ? "initialization (philox, normal)" : "initialization (philox, uniform)",
+                           shape, [&]()
+        {
+            initializers::initialize(weights, init, c.nb_rows);
+        }, 0., bytes);
+
+        benchmark::print(r);
+    }
+
+    if (! valid)
+    {
+        util::ERROR("initializers::main", "Invalid initializations");
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -65,6 +65,10 @@ int main(int argc, char *argv[])
     matrix::print(loss_functions::CROSS_ENTROPY_LOSS.compute({ &m1, &m2 }));
     matrix::print(loss_functions::CROSS_ENTROPY_LOSS.compute_derivatives({&m1, &m2}));
     // ----------- //
+    std::cout << "> Softmax cross entropy loss" << std::endl;
+    matrix::print(loss_functions::SOFTMAX_CROSS_ENTROPY_LOSS.compute({ &m1, &m2 }));
+    matrix::print(loss_functions::SOFTMAX_CROSS_ENTROPY_LOSS.compute_derivatives({&m1, &m2}));
+    // ----------- //
 
     return EXIT_SUCCESS;
 }
\ No newline at end of file
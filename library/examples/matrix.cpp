@@ -48,6 +48,16 @@ int main(int argc, char *argv[])
     std::cout << "> sum of m1 (1)" << std::endl;
     std::cout << "= " << m1.sum() << std::endl;
     // ----------- //
+    std::cout << "> mean, max, min and argmax of m1 (1)" << std::endl;
+    std::cout << "= " << m1.mean()
+              << ", " << m1.get_max()
+              << ", " << m1.get_min()
+              << ", " << m1.argmax() << std::endl;
+    // ----------- //
+    std::cout << "> sum of each row, and max of each column of m1 (1)" << std::endl;
+    matrix::print(m1.reduce_rows(SUM));
+    matrix::print(m1.reduce_cols(MAXIMUM));
+    // ----------- //
     std::cout << "> Hadamard product"<< std::endl;
     matrix::print(m1.hadamard_product(m2));
     // ----------- //
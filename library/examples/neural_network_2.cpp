@@ -41,12 +41,12 @@ int main(int argc, char *argv[])
                               activation_functions::SIGMOID),
                     new layer(8, dataset::SMALLIMG_NB_LABELS,
                               initializations::XAVIER,
-                              activation_functions::SOFTMAX)
+                              activation_functions::LINEAR)
             }
     );
     neural_network::print(nn);
     //Print the first layer at the beginning
-    auto l = nn.get_layer(1);
+    auto l = dynamic_cast<layer *>(nn.get_layer(1));
     //Weights from this layer to the next
     l->print_weights();
     //Biases from this layer to the next
@@ -55,7 +55,8 @@ int main(int argc, char *argv[])
     // Train the neural network and record the time.
     float time;
     util::CPU_start_record(&time);
-    nn.fit(train, loss_functions::CROSS_ENTROPY_LOSS,
+    // The softmax of the outputs is fused with the loss.
+    nn.fit(train, loss_functions::SOFTMAX_CROSS_ENTROPY_LOSS,
            1,1, 0.01);
     util::CPU_end_record(&time);
     // Predict using the test dataset.
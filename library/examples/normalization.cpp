@@ -0,0 +1,223 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "lib/data_structures/dataset/dataset.h"
+#include "lib/functions/activation_functions/activation_functions.h"
+#include "lib/functions/loss_functions/loss_functions.h"
+#include "lib/models/neural_network/neural_network.h"
+#include "lib/util/benchmark/benchmark.h"
+#include "lib/util/parallel/parallel.h"
+#include "examples/common.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <vector>
+
+
+using namespace cudaNN;
+
+
+// Largest tolerated difference between the predictions of a network and of
+// its folded version.
+#define TOLERANCE 1e-3
+
+
+namespace
+{
+    /**
+     * Configuration of the comparison (see the usage in "main").
+     */
+    struct configuration
+    {
+        size_t nb_epochs = 10;
+        size_t depth = 8;
+        size_t width = 32;
+        size_t batch_size = 16;
+        float learning_rate = 0.02f;
+        size_t nb_threads = 16;
+    };
+
+    /**
+     * @return - "nb_entries" features far from zero (not normalized), labelled
+     * by a smooth function of them.
+     */
+    dataset synthetic_dataset(size_t nb_entries, size_t nb_features)
+    {
+        auto data = dataset();
+
+        for (size_t i = 0; i < nb_entries; i ++)
+        {
+            auto features = matrix(1, nb_features, "features");
+            auto labels = matrix(1, 1, "labels");
+            float sum = 0.f;
+
+            for (size_t j = 0; j < nb_features; j ++)
+            {
+                features[j] = 10.f + 5.f * (float) std::rand() / (float) RAND_MAX;
+                sum += (j % 2 == 0 ? 1.f : -1.f) * features[j];
+            }
+
+            labels[0] = std::tanh(sum / 8.f);
+            data.add(features, labels);
+        }
+
+        return data;
+    }
+
+    /**
+     * @return - "depth" hidden layers of "width" neurons (ReLU), each one
+     * followed by a normalization if "normalized".
+     */
+    neural_network build(const configuration &c, size_t nb_features, bool normalized,
+                         normalization_types type)
+    {
+        auto layers = std::vector<base_layer *>();
+        auto size = nb_features;
+
+        for (size_t i = 0; i < c.depth; i ++)
+        {
+            if (normalized)
+            {
+                layers.push_back(new layer(size, c.width, initializations::HE, activation_functions::LINEAR));
+                layers.push_back(new normalization(c.width, type, activation_functions::RELU));
+            }
+            else
+            {
+                layers.push_back(new layer(size, c.width, initializations::HE, activation_functions::RELU));
+            }
+
+            size = c.width;
+        }
+
+        layers.push_back(new layer(size, 1, initializations::XAVIER, activation_functions::LINEAR));
+
+        return neural_network(layers);
+    }
+
+    double evaluate(const neural_network &nn, dataset &test)
+    {
+        auto predictions = nn.predict(test);
+        double loss = 0.;
+
+        for (size_t i = 0; i < predictions.size(); i ++)
+        {
+            auto labels = test.get(i).get_labels();
+            auto value = loss_functions::MEAN_SQUARED_ERROR.compute({ &predictions[i], &labels })[0];
+            loss += std::isfinite(value) ? value : std::numeric_limits<double>::infinity();
+        }
+
+        return loss / (double) predictions.size();
+    }
+}
+
+
+/**
+ * Train a deep network of dense layers, without normalization, with batch
+ * normalizations and with layer normalizations (see -normalization.h-):
+ * loss on the test set after each epoch, with several threads (the batch
+ * statistics are the ones of the whole batch, whatever the number of threads).
+ * Then fold the batch normalizations in the previous layers
+ * ("neural_network::fold_normalizations"), and compare the predictions and
+ * their time.
+ * Usage: normalization [--epochs n] [--depth n] [--width n] [--batch-size n]
+ * [--learning-rate f] [--threads n]
+ */
+int main(int argc, char *argv[])
+{
+    std::srand(0);
+
+    auto c = configuration();
+    auto sizes = std::map<std::string, size_t *>(
+    {
+        { "--epochs", &c.nb_epochs }, { "--depth", &c.depth }, { "--width", &c.width },
+        { "--batch-size", &c.batch_size }, { "--threads", &c.nb_threads }
+    });
+
+    examples::parse_arguments(argc, argv, sizes, { { "--learning-rate", &c.learning_rate } });
+
+    parallel::set_nb_threads(c.nb_threads);
+    auto nb_features = (size_t) 16;
+    auto data = synthetic_dataset(2048, nb_features).train_test_split();
+    auto networks = std::vector<std::pair<std::string, neural_network>>(
+    {
+        { "none", build(c, nb_features, false, normalization_types::BATCH_NORMALIZATION) },
+        { "batch", build(c, nb_features, true, normalization_types::BATCH_NORMALIZATION) },
+        { "layer", build(c, nb_features, true, normalization_types::LAYER_NORMALIZATION) }
+    });
+
+    std::cout << "depth: " << c.depth << ", width: " << c.width << ", learning rate: "
+              << c.learning_rate << ", threads: " << parallel::get_nb_threads() << std::endl;
+    std::cout << std::setw(15) << "normalization" << std::setw(7) << "epoch"
+              << std::setw(12) << "test loss" << std::endl;
+
+    // The losses of the batch normalization after the first and the last epochs.
+    auto first_loss = 0.;
+    auto last_loss = 0.;
+
+    for (auto &n: networks)
+    {
+        for (size_t i = 1; i <= c.nb_epochs; i ++)
+        {
+            n.second.fit(data.first, loss_functions::MEAN_SQUARED_ERROR, 1, c.batch_size,
+                         c.learning_rate, false);
+            auto loss = evaluate(n.second, data.second);
+            std::cout << std::setw(15) << n.first << std::setw(7) << i
+                      << std::setw(12) << std::setprecision(4) << loss << std::endl;
+
+            if (n.first == "batch")
+            {
+                first_loss = i == 1 ? loss : first_loss;
+                last_loss = loss;
+            }
+        }
+    }
+
+    // Inference: the batch normalizations folded in the previous layers.
+    auto &trained = networks[1].second;
+    auto folded = trained;
+    auto nb_folded = folded.fold_normalizations();
+    auto predictions = trained.predict(data.second);
+    auto folded_predictions = folded.predict(data.second);
+    float difference = 0.f;
+
+    for (size_t i = 0; i < predictions.size(); i ++)
+    {
+        difference = examples::max_difference(
+                difference, std::abs(predictions[i][0] - folded_predictions[i][0]));
+    }
+
+    std::cout << nb_folded << " folded normalizations, " << trained.get_nb_layers() << " -> "
+              << folded.get_nb_layers() << " layers, largest difference: " << difference << std::endl;
+
+    for (auto n: { &trained, &folded })
+    {
+        auto r = benchmark::run(n == &trained ? "predictions (normalized)" : "predictions (folded)",
+                                std::to_string(n->get_nb_layers()) + " layers", [&]()
+        {
+            n->predict(data.second.get(0).get_features());
+        }, 0., 0.);
+
+        benchmark::print(r);
+    }
+
+    if (! (difference <= TOLERANCE))
+    {
+        util::ERROR("normalization::main", "The folded network differs");
+
+        return EXIT_FAILURE;
+    }
+
+    if (! (last_loss <= first_loss))
+    {
+        util::ERROR("normalization::main", "The batch normalization does not learn");
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
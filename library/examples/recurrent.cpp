@@ -0,0 +1,315 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "lib/data_structures/dataset/dataset.h"
+#include "lib/functions/activation_functions/activation_functions.h"
+#include "lib/functions/loss_functions/loss_functions.h"
+#include "lib/models/neural_network/neural_network.h"
+#include "lib/util/benchmark/benchmark.h"
+#include "examples/common.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <map>
+#include <vector>
+
+
+using namespace cudaNN;
+
+
+// Largest tolerated difference between the layer and the reference.
+#define TOLERANCE 1e-4
+
+
+namespace
+{
+    /**
+     * Configuration of the comparison (see the usage in "main").
+     */
+    struct configuration
+    {
+        size_t nb_steps = 64;
+        size_t input_size = 32;
+        size_t size = 128;
+        size_t nb_epochs = 5;
+    };
+
+    /**
+     * @return - the columns [first, first + nb_columns[ of "m".
+     */
+    matrix columns(const matrix &m, size_t first, size_t nb_columns)
+    {
+        auto result = matrix(m.get_dimensions().first, nb_columns, "columns");
+
+        for (size_t i = 0; i < m.get_dimensions().first; i ++)
+        {
+            for (size_t j = 0; j < nb_columns; j ++)
+            {
+                result[(int) (i * nb_columns + j)] = m[(int) (i * m.get_dimensions().second + first + j)];
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * Reference: the weights of each gate apart, and a product per gate and
+     * time step for the inputs and the previous state, then the element-wise
+     * operations one by one.
+     */
+    struct reference
+    {
+        std::vector<matrix> input_weights;
+        std::vector<matrix> recurrent_weights;
+        std::vector<matrix> biases;
+        matrix recurrent_biases;
+        recurrent_types type;
+        size_t size;
+
+        explicit reference(recurrent &l):
+                recurrent_biases(l.get_recurrent_biases()),
+                type(l.get_type()),
+                size(l.size())
+        {
+            for (size_t q = 0; q < (type == recurrent_types::LSTM ? 4 : 3); q ++)
+            {
+                input_weights.push_back(columns(l.get_input_weights(), q * size, size));
+                recurrent_weights.push_back(columns(l.get_recurrent_weights(), q * size, size));
+                biases.push_back(columns(l.get_biases(), q * size, size));
+            }
+        }
+
+        /**
+         * @return - the states of every time step (a row each).
+         */
+        matrix forward(const matrix &inputs)
+        {
+            using namespace activation_functions;
+            auto nb_steps = inputs.get_dimensions().first;
+            auto nb_inputs = inputs.get_dimensions().second;
+            auto outputs = matrix(nb_steps, size, "reference::outputs");
+            auto h = matrix(1, size, "h");
+            auto c = matrix(1, size, "c");
+
+            for (size_t t = 0; t < nb_steps; t ++)
+            {
+                auto x = matrix(inputs.get_data() + t * nb_inputs, { 1, nb_inputs }, "x");
+                auto gates = std::vector<matrix>();
+
+                for (size_t q = 0; q < input_weights.size(); q ++)
+                {
+                    auto a = x * input_weights[q];
+                    a += biases[q];
+
+                    if (type == recurrent_types::GRU && q == 2)
+                    {
+                        // n = tanh(x Wn + bn + r * (h Un + un)).
+                        auto recurrent = h * recurrent_weights[q];
+                        recurrent += recurrent_biases;
+                        a += recurrent.hadamard_product(gates[0]);
+                    }
+                    else
+                    {
+                        a += h * recurrent_weights[q];
+                    }
+
+                    gates.push_back((type == recurrent_types::LSTM && q == 2) || (type == recurrent_types::GRU && q == 2)
+                                    ? TANH.compute({ &a }) : SIGMOID.compute({ &a }));
+                }
+
+                if (type == recurrent_types::LSTM)
+                {
+                    c = c.hadamard_product(gates[1]) + gates[0].hadamard_product(gates[2]);
+                    h = gates[3].hadamard_product(TANH.compute({ &c }));
+                }
+                else
+                {
+                    // h = n + z * (h' - n).
+                    auto difference = h - gates[2];
+                    h = gates[2] + gates[1].hadamard_product(difference);
+                }
+
+                std::copy(h.get_data(), h.get_data() + size, outputs.get_data() + t * size);
+            }
+
+            return outputs;
+        }
+    };
+
+    /**
+     * @return - true if the outputs of the layer are the ones of the reference;
+     * the two are then measured.
+     */
+    bool compare(const configuration &c, recurrent_types type)
+    {
+        auto name = std::string(type == recurrent_types::LSTM ? "lstm" : "gru");
+        recurrent l(c.input_size, c.size, type);
+        auto r = reference(l);
+        auto inputs = examples::random_matrix(c.nb_steps, c.input_size, "inputs");
+        auto difference = examples::max_difference(l.feed_forward(inputs), r.forward(inputs));
+        auto shape = std::to_string(c.nb_steps) + "x" + std::to_string(c.input_size) + " -> "
+                     + std::to_string(c.size);
+        auto flops = 2. * (double) (c.nb_steps * (type == recurrent_types::LSTM ? 4 : 3) * c.size
+                                    * (c.input_size + c.size));
+
+        std::cout << name << ": largest difference with the reference: " << difference << std::endl;
+
+        for (auto v: { "reference forward", "fused forward", "fused forward+backward" })
+        {
+            auto variant = std::string(v);
+            auto result = benchmark::run(name + " " + variant, shape, [&]()
+            {
+                if (variant == "reference forward")
+                {
+                    r.forward(inputs);
+                    return;
+                }
+
+                auto errors = l.feed_forward(inputs);
+
+                if (variant == "fused forward+backward")
+                {
+                    l.backward_propagation(errors);
+                }
+            }, variant == "fused forward+backward" ? 3. * flops : flops, 0.);
+
+            benchmark::print(result);
+        }
+
+        return difference <= TOLERANCE;
+    }
+
+    /**
+     * @return - true if a truncation longer than the sequences gives the
+     * gradients of the whole backpropagation through time (and a shorter one
+     * other gradients).
+     */
+    bool check_truncation()
+    {
+        auto l = new recurrent(4, 16, recurrent_types::LSTM, false);
+        auto nn = neural_network({ l, new layer(16, 1, initializations::XAVIER, activation_functions::LINEAR) });
+        auto data = dataset();
+
+        for (size_t i = 0; i < 8; i ++)
+        {
+            data.add(examples::random_matrix(16, 4, "features"), examples::random_matrix(1, 1, "labels"));
+        }
+
+        auto differences = std::vector<float>();
+        auto full = nn.compute_gradients(data, loss_functions::MEAN_SQUARED_ERROR);
+
+        for (size_t truncation: { 16, 4 })
+        {
+            l->set_truncation(truncation);
+            auto gradients = nn.compute_gradients(data, loss_functions::MEAN_SQUARED_ERROR);
+            differences.push_back(examples::max_difference(gradients[0][1], full[0][1]));
+        }
+
+        std::cout << "difference of the recurrent gradients with a truncation of 16 (16 steps): "
+                  << differences[0] << ", of 4: " << differences[1] << std::endl;
+
+        return differences[0] == 0.f && differences[1] > 0.f;
+    }
+
+    /**
+     * @return - sequences of "nb_steps" values of a noisy sum of sines, labelled
+     * by their next values.
+     */
+    dataset sequences(size_t nb_sequences, size_t nb_steps)
+    {
+        auto data = dataset();
+
+        for (size_t i = 0; i < nb_sequences; i ++)
+        {
+            auto features = matrix(nb_steps, 1, "features");
+            auto labels = matrix(nb_steps, 1, "labels");
+            auto phase = 6.28f * (float) std::rand() / (float) RAND_MAX;
+            auto value = [&](size_t t)
+            {
+                return .6f * std::sin(phase + .3f * (float) t) + .3f * std::sin(2.f * phase + .71f * (float) t);
+            };
+
+            for (size_t t = 0; t < nb_steps; t ++)
+            {
+                features[(int) t] = value(t) + .02f * ((float) std::rand() / (float) RAND_MAX - .5f);
+                labels[(int) t] = value(t + 1);
+            }
+
+            data.add(features, labels);
+        }
+
+        return data;
+    }
+
+    double evaluate(const neural_network &nn, dataset &test)
+    {
+        auto predictions = nn.predict(test);
+        double loss = 0.;
+
+        for (size_t i = 0; i < predictions.size(); i ++)
+        {
+            auto labels = test.get(i).get_labels();
+            loss += loss_functions::MEAN_SQUARED_ERROR.compute({ &predictions[i], &labels }).mean();
+        }
+
+        return loss / (double) predictions.size();
+    }
+}
+
+
+/**
+ * Compare the recurrent layers (LSTM and GRU) with a reference computing each
+ * gate apart (same outputs; time of the propagations), check the truncated
+ * backpropagation through time, then train both cells to predict the next
+ * value of time series (loss on the test set after each epoch).
+ * Usage: recurrent [--steps n] [--inputs n] [--size n] [--epochs n]
+ */
+int main(int argc, char *argv[])
+{
+    std::srand(0);
+
+    auto c = configuration();
+    auto sizes = std::map<std::string, size_t *>(
+    {
+        { "--steps", &c.nb_steps }, { "--inputs", &c.input_size }, { "--size", &c.size },
+        { "--epochs", &c.nb_epochs }
+    });
+
+    examples::parse_arguments(argc, argv, sizes);
+
+    auto valid = compare(c, recurrent_types::LSTM);
+    valid = compare(c, recurrent_types::GRU) && valid;
+    valid = check_truncation() && valid;
+
+    auto data = sequences(512, 32).train_test_split();
+    std::cout << std::setw(6) << "cell" << std::setw(7) << "epoch" << std::setw(12) << "test loss" << std::endl;
+
+    for (auto type: { recurrent_types::LSTM, recurrent_types::GRU })
+    {
+        auto nn = neural_network(
+        {
+            new recurrent(1, 32, type),
+            new layer(32, 1, initializations::XAVIER, activation_functions::LINEAR)
+        });
+
+        for (size_t i = 1; i <= c.nb_epochs; i ++)
+        {
+            // (The errors of the time steps add up: small learning rate.)
+            nn.fit(data.first, loss_functions::MEAN_SQUARED_ERROR, 1, 8, .002f, false);
+            std::cout << std::setw(6) << (type == recurrent_types::LSTM ? "lstm" : "gru") << std::setw(7) << i
+                      << std::setw(12) << std::setprecision(4) << evaluate(nn, data.second) << std::endl;
+        }
+    }
+
+    if (! valid)
+    {
+        util::ERROR("recurrent::main", "The recurrent layers differ from the references");
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,190 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "lib/data_structures/dataset/dataset.h"
+#include "lib/functions/activation_functions/activation_functions.h"
+#include "lib/functions/loss_functions/loss_functions.h"
+#include "lib/models/neural_network/neural_network.h"
+#include "lib/util/benchmark/benchmark.h"
+#include "examples/common.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+
+using namespace cudaNN;
+
+
+// Largest tolerated difference between the dense and sparse computations.
+#define TOLERANCE 1e-4
+
+
+namespace
+{
+    /**
+     * Configuration of the comparison (see the usage in "main").
+     */
+    struct configuration
+    {
+        size_t nb_entries = 1024;
+        size_t nb_features = 4096;
+        size_t nb_non_zeros = 16;
+        size_t nb_labels = 8;
+        size_t nb_hidden = 64;
+        size_t nb_epochs = 2;
+        size_t batch_size = 16;
+    };
+
+    /**
+     * @return - bag-of-words like features ("nb_non_zeros" counts among
+     * "nb_features"), labelled by the block of features with the largest
+     * sum (one-hot).
+     */
+    dataset bag_of_words(const configuration &c)
+    {
+        auto data = dataset();
+
+        for (size_t i = 0; i < c.nb_entries; i ++)
+        {
+            auto features = matrix(1, c.nb_features, "features");
+            auto labels = matrix(1, c.nb_labels, "labels");
+            auto sums = std::vector<float>(c.nb_labels, 0.f);
+
+            for (size_t j = 0; j < c.nb_non_zeros; j ++)
+            {
+                auto k = (size_t) std::rand() % c.nb_features;
+                auto count = (float) (1 + std::rand() % 4);
+                features[k] += count;
+                sums[k * c.nb_labels / c.nb_features] += count;
+            }
+
+            labels[std::max_element(sums.begin(), sums.end()) - sums.begin()] = 1.f;
+            data.add(features, labels);
+        }
+
+        return data;
+    }
+
+    double accuracy(neural_network &nn, dataset &test)
+    {
+        auto predictions = nn.predict(test);
+        double correct = 0.;
+
+        for (size_t i = 0; i < predictions.size(); i ++)
+        {
+            correct += predictions[i].argmax() == test.get(i).get_labels().argmax() ? 1. : 0.;
+        }
+
+        return correct / (double) predictions.size();
+    }
+}
+
+
+/**
+ * Train a MLP on bag-of-words features (mostly zeros), with a dense first
+ * layer and with a first layer of sparse inputs (see "layer::set_sparse_inputs"),
+ * starting from the same weights.
+ * Check that both compute the same predictions and gradients, and compare
+ * their training times.
+ * Usage: sparse_inputs [--entries n] [--features n] [--non-zeros n]
+ * [--hidden n] [--epochs n] [--batch-size n]
+ */
+int main(int argc, char *argv[])
+{
+    std::srand(0);
+
+    auto c = configuration();
+    auto sizes = std::map<std::string, size_t *>(
+    {
+        { "--entries", &c.nb_entries }, { "--features", &c.nb_features },
+        { "--non-zeros", &c.nb_non_zeros }, { "--hidden", &c.nb_hidden },
+        { "--epochs", &c.nb_epochs }, { "--batch-size", &c.batch_size }
+    });
+
+    examples::parse_arguments(argc, argv, sizes);
+
+    auto data = bag_of_words(c).train_test_split();
+    auto build = [&]()
+    {
+        return neural_network(
+        {
+            new layer(c.nb_features, c.nb_hidden, initializations::HE, activation_functions::RELU),
+            new layer(c.nb_hidden, c.nb_labels, initializations::XAVIER, activation_functions::LINEAR)
+        });
+    };
+    auto dense = build();
+    auto sparse = build();
+
+    for (int i = 0; i < 2; i ++)
+    {
+        auto parameters = sparse.get_layer(i)->get_parameters();
+        auto dense_parameters = dense.get_layer(i)->get_parameters();
+
+        for (size_t p = 0; p < parameters.size(); p ++)
+        {
+            *parameters[p] = *dense_parameters[p];
+        }
+    }
+
+    dynamic_cast<layer *>(sparse.get_layer(0))->set_sparse_inputs(true);
+
+    // Same predictions and gradients.
+    float difference = 0.f;
+    auto dense_predictions = dense.predict(data.second);
+    auto sparse_predictions = sparse.predict(data.second);
+
+    for (size_t i = 0; i < dense_predictions.size(); i ++)
+    {
+        difference = examples::max_difference(
+                difference, examples::max_difference(dense_predictions[i], sparse_predictions[i]));
+    }
+
+    auto batch = data.first.get_random_batch(c.batch_size);
+    auto &loss_function = loss_functions::SOFTMAX_CROSS_ENTROPY_LOSS;
+    auto dense_gradients = dense.compute_gradients(batch, loss_function);
+    auto sparse_gradients = sparse.compute_gradients(batch, loss_function);
+    // The same, with the features of the entries converted once (as during "fit").
+    batch.set_sparse_features();
+    auto converted_gradients = sparse.compute_gradients(batch, loss_function);
+
+    for (size_t i = 0; i < dense_gradients.size(); i ++)
+    {
+        for (size_t p = 0; p < dense_gradients[i].size(); p ++)
+        {
+            difference = examples::max_difference(
+                    difference, examples::max_difference(dense_gradients[i][p], sparse_gradients[i][p]));
+            difference = examples::max_difference(
+                    difference, examples::max_difference(dense_gradients[i][p], converted_gradients[i][p]));
+        }
+    }
+
+    std::cout << "features: " << c.nb_features << " (" << c.nb_non_zeros << " non-zero)"
+              << ", largest difference: " << difference << std::endl;
+
+    // Training times.
+    for (auto nn: { &dense, &sparse })
+    {
+        auto stopwatch = benchmark::stopwatch();
+        nn->fit(data.first, loss_function, c.nb_epochs, c.batch_size, 0.05f, false);
+        auto time = stopwatch.lap();
+        auto &t = nn->get_training_times();
+
+        std::cout << (nn == &dense ? "dense " : "sparse") << " first layer: "
+                  << time << " ms (forward " << t.forward << ", backward " << t.backward
+                  << ", update " << t.update << "), accuracy " << accuracy(*nn, data.second)
+                  << std::endl;
+    }
+
+    if (! (difference <= TOLERANCE))
+    {
+        util::ERROR("sparse_inputs::main", "The dense and sparse layers differ");
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
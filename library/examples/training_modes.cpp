@@ -0,0 +1,194 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "lib/data_structures/dataset/dataset.h"
+#include "lib/functions/activation_functions/activation_functions.h"
+#include "lib/functions/loss_functions/loss_functions.h"
+#include "lib/models/neural_network/neural_network.h"
+#include "lib/util/benchmark/benchmark.h"
+#include "lib/util/parallel/parallel.h"
+#include "examples/common.h"
+
+#include <cstdlib>
+#include <iomanip>
+#include <map>
+#include <vector>
+
+
+using namespace cudaNN;
+
+
+namespace
+{
+    /**
+     * Configuration of the comparison (see the usage in "main").
+     */
+    struct configuration
+    {
+        size_t nb_epochs = 20;
+        size_t batch_size = 4;
+        size_t nb_threads = 0;
+        float learning_rate = 0.01f;
+    };
+
+    /**
+     * A problem on which the modes are compared.
+     * @classification - if set, the accuracy is computed (argmax of the outputs).
+     */
+    struct problem
+    {
+        std::string name;
+        dataset train;
+        dataset test;
+        std::vector<size_t> sizes;
+        const function *loss_function;
+        bool classification;
+    };
+
+    /**
+     * @return - "nb_entries" sparse features (a few non-zero values
+     * among "nb_features"), labelled by the block of features
+     * containing the largest one (one-hot, "nb_labels" classes).
+     */
+    dataset sparse_dataset(size_t nb_entries, size_t nb_features, size_t nb_labels,
+                           size_t nb_non_zeros)
+    {
+        auto data = dataset();
+
+        for (size_t i = 0; i < nb_entries; i ++)
+        {
+            auto features = matrix(1, nb_features, "features");
+            auto labels = matrix(1, nb_labels, "labels");
+            size_t max = 0;
+
+            for (size_t j = 0; j < nb_non_zeros; j ++)
+            {
+                auto k = (size_t) std::rand() % nb_features;
+                features[k] = (float) std::rand() / (float) RAND_MAX;
+                max = features[k] > features[max] ? k : max;
+            }
+
+            labels[max * nb_labels / nb_features] = 1.f;
+            data.add(features, labels);
+        }
+
+        return data;
+    }
+
+    neural_network build(const problem &p)
+    {
+        auto layers = std::vector<base_layer *>();
+
+        for (size_t i = 1; i < p.sizes.size(); i ++)
+        {
+            auto last = i + 1 == p.sizes.size();
+            layers.push_back(new layer(p.sizes[i - 1], p.sizes[i],
+                                       last ? initializations::XAVIER : initializations::HE,
+                                       last ? activation_functions::LINEAR : activation_functions::RELU));
+        }
+
+        return neural_network(layers);
+    }
+
+    /**
+     * @return - the mean loss of "nn" on "test", and its accuracy
+     * in "accuracy" (for a classification).
+     */
+    double evaluate(const neural_network &nn, const problem &p, dataset &test, double &accuracy)
+    {
+        auto predictions = nn.predict(test);
+        double loss = 0.;
+        accuracy = 0.;
+
+        for (size_t i = 0; i < predictions.size(); i ++)
+        {
+            auto labels = test.get(i).get_labels();
+            loss += p.loss_function->compute({ &predictions[i], &labels })[0];
+            accuracy += predictions[i].argmax() == labels.argmax() ? 1. : 0.;
+        }
+
+        accuracy /= (double) predictions.size();
+
+        return loss / (double) predictions.size();
+    }
+}
+
+
+/**
+ * Compare the synchronous and Hogwild! training modes (see
+ * -neural_network.h/training_modes-), on the bundled datasets and on a
+ * synthetic dataset with sparse features (whose updates rarely overlap):
+ * loss on the test set after each epoch, and throughput (samples/s).
+ * Usage: training_modes [--epochs n] [--batch-size n] [--threads n]
+ * [--learning-rate f]
+ */
+int main(int argc, char *argv[])
+{
+    std::srand(0);
+
+    auto c = configuration();
+    auto sizes = std::map<std::string, size_t *>(
+    {
+        { "--epochs", &c.nb_epochs }, { "--batch-size", &c.batch_size }, { "--threads", &c.nb_threads }
+    });
+
+    examples::parse_arguments(argc, argv, sizes, { { "--learning-rate", &c.learning_rate } });
+
+    parallel::set_nb_threads(c.nb_threads);
+
+    auto mult = dataset::load_mult().train_test_split();
+    auto smallimg = dataset::load_smallimg();
+    auto sparse = sparse_dataset(4096, 512, 8, 8).train_test_split();
+    auto problems = std::vector<problem>(
+    {
+        { "mult", mult.first, mult.second,
+          { dataset::MULT_NB_FEATURES, 16, dataset::MULT_NB_LABELS },
+          &loss_functions::MEAN_SQUARED_ERROR, false },
+        // Too small to be split: evaluated on its training set.
+        { "smallimg", smallimg, smallimg,
+          { dataset::SMALLIMG_NB_FEATURES, 8, dataset::SMALLIMG_NB_LABELS },
+          &loss_functions::SOFTMAX_CROSS_ENTROPY_LOSS, true },
+        { "sparse", sparse.first, sparse.second,
+          { 512, 64, 8 }, &loss_functions::SOFTMAX_CROSS_ENTROPY_LOSS, true }
+    });
+    const std::pair<training_modes, std::string> modes[] =
+    {
+        { training_modes::SYNCHRONOUS, "synchronous" }, { training_modes::HOGWILD, "hogwild" }
+    };
+
+    std::cout << "threads: " << parallel::get_nb_threads()
+              << ", batch size: " << c.batch_size << std::endl;
+    std::cout << std::setw(10) << "dataset" << std::setw(13) << "mode"
+              << std::setw(7) << "epoch" << std::setw(12) << "test loss"
+              << std::setw(10) << "accuracy" << std::setw(12) << "samples/s" << std::endl;
+
+    for (auto &p: problems)
+    {
+        for (auto &m: modes)
+        {
+            auto nn = build(p);
+            auto stopwatch = benchmark::stopwatch();
+            double time = 0.;
+            nn.set_training_mode(m.first);
+
+            for (size_t i = 1; i <= c.nb_epochs; i ++)
+            {
+                stopwatch.lap();
+                nn.fit(p.train, *p.loss_function, 1, c.batch_size, c.learning_rate, false);
+                time += stopwatch.lap();
+
+                double accuracy;
+                auto loss = evaluate(nn, p, p.test, accuracy);
+                std::cout << std::setw(10) << p.name << std::setw(13) << m.second
+                          << std::setw(7) << i << std::setw(12) << std::setprecision(4) << loss
+                          << std::setw(10) << (p.classification ? std::to_string(accuracy) : "-")
+                          << std::setw(12) << std::setprecision(6)
+                          << (time > 0. ? 1000. * (double) (i * p.train.size()) / time : 0.)
+                          << std::endl;
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -3,6 +3,9 @@
 //
 
 #include "dataset.h"
+#include "lib/util/parallel/parallel.h"
+#include "lib/util/profiler/profiler.h"
+#include "lib/util/rng/rng.h"
 
 
 using namespace cudaNN;
@@ -70,9 +73,7 @@ std::pair<dataset, dataset> dataset::train_test_split(const float train_size_rat
     // Fill array with [0, "size_"] sequence, and shuffle it.
     auto numbers = std::vector<size_t>(size_);
     std::iota(numbers.begin(), numbers.end(), 0);
-    std::random_device generator;
-    auto distribution = std::mt19937(generator());
-    std::shuffle(numbers.begin(), numbers.end(), distribution);
+    rng::shuffle(numbers, rng::get_key(), rng::next_counter());
     // Select the "train_size" first indexes for the training set.
     for (size_t i = 0; i < size_; i ++)
     {
@@ -98,13 +99,12 @@ dataset dataset::get_random_batch(const size_t batch_size)
         util::ERROR_EXIT();
     }
 
+    PROFILE_SCOPE("dataset", "get_random_batch", batch_size);
     auto batch = dataset();
     // Fill array with [0, "size()"] sequence, and shuffle it.
     auto numbers = std::vector<size_t>(size());
     std::iota(numbers.begin(), numbers.end(), 0);
-    std::random_device generator;
-    auto distribution = std::mt19937(generator());
-    std::shuffle(numbers.begin(), numbers.end(), distribution);
+    rng::shuffle(numbers, rng::get_key(), rng::next_counter());
     // Select the "batch_size" first numbers as indexes.
     for (size_t i = 0; i < batch_size; i ++)
     {
@@ -114,6 +114,52 @@ dataset dataset::get_random_batch(const size_t batch_size)
     return batch;
 }
 
+std::pair<matrix, matrix> dataset::stack(size_t begin, size_t end)
+{
+    if (begin >= end || size() < end)
+    {
+        // Invalid.
+        util::ERROR("dataset::stack", "Invalid entries [@begin, @end[");
+        util::ERROR_EXIT();
+    }
+
+    auto nb_features = _entries[begin].get_features().get_length();
+    auto nb_labels = _entries[begin].get_labels().get_length();
+    auto features = matrix(end - begin, nb_features, "dataset::stack::features");
+    auto labels = matrix(end - begin, nb_labels, "dataset::stack::labels");
+
+    for (size_t i = begin; i < end; i ++)
+    {
+        const float *f = _entries[i].get_features().get_data();
+        const float *l = _entries[i].get_labels().get_data();
+        std::copy(f, f + nb_features, features.get_data() + (i - begin) * nb_features);
+        std::copy(l, l + nb_labels, labels.get_data() + (i - begin) * nb_labels);
+    }
+
+    return { features, labels };
+}
+
+void dataset::set_sparse_features()
+{
+    if (_entries.empty())
+    {
+        return;
+    }
+
+    PROFILE_SCOPE("dataset", "set_sparse_features", size());
+    // (An entry already sparse is skipped.)
+    auto nb_features = std::max((size_t) 1, _entries[0].get_features().get_length());
+
+    parallel::for_range(size(), std::max((size_t) 1, (size_t) PARALLEL_MIN_CHUNK_SIZE / nb_features),
+                        [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i ++)
+        {
+            _entries[i].set_sparse_features();
+        }
+    });
+}
+
 dataset dataset::load_mult()
 {
     util::INFO("dataset::load_mult", "loading the mult dataset");
@@ -43,17 +43,32 @@ namespace cudaNN
             /**
              * @param train_size_ratio - represent the proportion of the training dataset
              * (between 0.f and 1.f).
-             * @return - a partition of the dataset. The first part is for training,
-             * and the other for testing.
+             * @return - a partition of the dataset (random, as "get_random_batch").
+             * The first part is for training, and the other for testing.
              */
             std::pair<dataset, dataset> train_test_split(float train_size_ratio = 0.8f);
 
             /**
              * @param batch_size - the size of the batch.
-             * @return - a random batch of the current dataset.
+             * @return - a random batch of the current dataset (drawn from the
+             * seed of the library, see -rng.h/set_seed-).
              */
             dataset get_random_batch(size_t batch_size);
 
+            /**
+             * @return - the features and the labels of the entries [begin, end[
+             * (of a row each), a row per entry.
+             */
+            std::pair<matrix, matrix> stack(size_t begin, size_t end);
+
+            /**
+             * Keep the features of every entry also sparse, built once (over the
+             * threads): the trainings of a network whose first layer has sparse
+             * inputs use them instead of converting the features of each entry
+             * (called by -neural_network.h/fit-; the batches and splits keep them).
+             */
+            void set_sparse_features();
+
 
             /**
              * @multiplication_dataset
@@ -10,7 +10,8 @@ using namespace cudaNN;
 
 entry::entry(matrix features, matrix labels):
         _features(features),
-        _labels(labels)
+        _labels(labels),
+        _has_sparse_features(false)
 {
 }
 
@@ -29,6 +30,25 @@ const matrix &entry::get_labels() const
     return _labels;
 }
 
+void entry::set_sparse_features()
+{
+    if (! _has_sparse_features)
+    {
+        _sparse_features = sparse_matrix(_features);
+        _has_sparse_features = true;
+    }
+}
+
+bool entry::has_sparse_features() const
+{
+    return _has_sparse_features;
+}
+
+const sparse_matrix &entry::get_sparse_features() const
+{
+    return _sparse_features;
+}
+
 bool entry::compare_features(const matrix &features) const
 {
     return _features == features;
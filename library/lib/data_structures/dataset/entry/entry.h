@@ -6,6 +6,7 @@
 #define CUDANN_ENTRY_H
 
 #include "lib/data_structures/matrix/matrix.h"
+#include "lib/data_structures/sparse_matrix/sparse_matrix.h"
 
 
 namespace cudaNN
@@ -24,6 +25,15 @@ namespace cudaNN
             const matrix &get_features() const;
             const matrix &get_labels() const;
 
+            /**
+             * Keep the features also sparse (see -sparse_matrix.h-), built once:
+             * e.g. the inputs of a first layer with sparse inputs, which are not
+             * converted again at each propagation (see -dataset.h/set_sparse_features-).
+             */
+            void set_sparse_features();
+            bool has_sparse_features() const;
+            const sparse_matrix &get_sparse_features() const;
+
             bool compare_features(const matrix &features) const;
             bool compare_labels(const matrix &labels) const;
             bool compare(const entry &e) const;
@@ -41,6 +51,8 @@ namespace cudaNN
 
             const matrix _features;
             const matrix _labels;
+            sparse_matrix _sparse_features;
+            bool _has_sparse_features;
     };
 }
 
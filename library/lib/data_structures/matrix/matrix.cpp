@@ -4,6 +4,9 @@
 
 #include "matrix.h"
 #include "chrono"
+#include "lib/util/profiler/profiler.h"
+#include "lib/util/statistics/statistics.h"
+#include <limits>
 
 using namespace cudaNN;
 using namespace std::chrono;
@@ -14,6 +17,15 @@ using namespace matrix_parallel;
 using namespace matrix_sequential;
 #endif
 
+// Bytes of "n" values.
+#define FLOAT_BYTES(n) ((double) (n) * (double) sizeof(float))
+
+// Trace and count an operation on the current matrix.
+#define MATRIX_OPERATION(operation, depth, nb_elements, bytes, flops)                     \
+    PROFILE_SCOPE("matrix", statistics::get_name(operation),                              \
+                  _dimensions.first, _dimensions.second, depth, bytes, flops);            \
+    COUNT_OPERATION(operation, nb_elements, bytes, flops)
+
 
 matrix::matrix(const matrix &m):
         matrix(m, m.get_id())
@@ -78,7 +90,8 @@ matrix::matrix(const float *values, std::pair<size_t, size_t> dimensions, std::s
 {
     _id = std::move(id);
     _allocate(dimensions);
-    std::copy(values, values + get_length() * sizeof(float), _data);
+    MATRIX_OPERATION(statistics::COPY, 0, get_length(), FLOAT_BYTES(2 * get_length()), 0.);
+    std::copy(values, values + get_length(), _data);
 }
 
 matrix::~matrix()
@@ -92,16 +105,28 @@ void matrix::_allocate(const std::pair<size_t, size_t> &dimensions)
     _dimensions.first = dimensions.first;
     _dimensions.second = dimensions.second;
     // Allocate the memory with the given dimensions.
-    _data = new float[get_length() * sizeof(float)](); // TODO remove * sizeof(float)......
+    _data = new float[get_length()]();
+    COUNT_ALLOCATION(get_length() * sizeof(float));
 }
 
 void matrix::_free()
 {
     // If existing, free previous memory.
+    if (_data != nullptr)
+    {
+        COUNT_FREE(get_length() * sizeof(float));
+    }
+
     delete[] _data;
     _data = nullptr;
 }
 
+void matrix::clear()
+{
+    _free();
+    _dimensions = { 0, 0 };
+}
+
 void matrix::set_id(const std::string &id)
 {
     _id = id;
@@ -127,11 +152,6 @@ float *matrix::get_data()
     return _data;
 }
 
-float matrix::get_max()
-{
-    return *std::max_element(_data, _data + get_length());
-}
-
 const std::string &matrix::get_id() const
 {
     return _id;
@@ -144,19 +164,35 @@ matrix &matrix::operator=(const matrix &m)
         return *this;
     }
 
-    _free();
-    _allocate(m.get_dimensions());
+    if (_data == nullptr || m.get_dimensions() != _dimensions)
+    {
+        // Keep the memory if the dimensions are the same.
+        _free();
+        _allocate(m.get_dimensions());
+    }
+
+    MATRIX_OPERATION(statistics::COPY, 0, get_length(), FLOAT_BYTES(2 * get_length()), 0.);
     // Copy the values on host memory.
     std::copy(m.get_data(),
-              m.get_data() + get_length() * sizeof(float),
+              m.get_data() + get_length(),
               _data);
 
     return *this;
 }
 
+bool matrix::is_broadcastable(const matrix &m) const
+{
+    auto &dimensions = m.get_dimensions();
+
+    return dimensions == _dimensions
+           || (dimensions.first == 1 && dimensions.second == _dimensions.second)
+           || (dimensions.first == _dimensions.first && dimensions.second == 1)
+           || (dimensions.first == 1 && dimensions.second == 1);
+}
+
 matrix &matrix::operator+=(const matrix &m)
 {
-    if (_dimensions != m.get_dimensions())
+    if (! is_broadcastable(m))
     {
         // Invalid.
         util::ERROR("matrix::operator+=",
@@ -166,6 +202,8 @@ matrix &matrix::operator+=(const matrix &m)
         util::ERROR_EXIT();
     }
 
+    MATRIX_OPERATION(statistics::ADD, 0, get_length(),
+                     FLOAT_BYTES(2 * get_length() + m.get_length()), (double) get_length());
     add(*this, m);
     return *this;
 }
@@ -178,7 +216,7 @@ matrix matrix::operator+(const matrix &m)
 
 matrix &matrix::operator-=(const matrix &m)
 {
-    if (_dimensions != m.get_dimensions())
+    if (! is_broadcastable(m))
     {
         // Invalid.
         util::ERROR("matrix::operator-=",
@@ -188,6 +226,8 @@ matrix &matrix::operator-=(const matrix &m)
         util::ERROR_EXIT();
     }
 
+    MATRIX_OPERATION(statistics::SUBTRACT, 0, get_length(),
+                     FLOAT_BYTES(2 * get_length() + m.get_length()), (double) get_length());
     subtract(*this, m);
 
     return *this;
@@ -213,6 +253,9 @@ matrix &matrix::operator*=(const matrix &m)
         util::ERROR_EXIT();
     }
 
+    MATRIX_OPERATION(statistics::MULTIPLY, m.get_dimensions().second, _dimensions.first * m.get_dimensions().second,
+                     FLOAT_BYTES(get_length() + m.get_length() + _dimensions.first * m.get_dimensions().second),
+                     2. * (double) (get_length() * m.get_dimensions().second));
     matrix output = matrix(_dimensions.first, m.get_dimensions().second, "matrix::operator*=::helper");
     multiply(output, *this, m);
     // Get the result.
@@ -227,8 +270,38 @@ matrix matrix::operator*(const matrix &m)
     return (m_ *= m);
 }
 
+matrix &matrix::operator+=(float f)
+{
+    MATRIX_OPERATION(statistics::ADD_FLOAT, 0, get_length(),
+                     FLOAT_BYTES(2 * get_length()), (double) get_length());
+    add(*this, matrix({ f }, 1, 1));
+    return *this;
+}
+
+matrix matrix::operator+(float f)
+{
+    matrix m_ = matrix(*this, "add(" + _id + ", float(" + std::to_string(f) + "))");
+    return (m_ += f);
+}
+
+matrix &matrix::operator-=(float f)
+{
+    MATRIX_OPERATION(statistics::SUBTRACT_FLOAT, 0, get_length(),
+                     FLOAT_BYTES(2 * get_length()), (double) get_length());
+    subtract(*this, matrix({ f }, 1, 1));
+    return *this;
+}
+
+matrix matrix::operator-(float f)
+{
+    matrix m_ = matrix(*this, "subtract(" + _id + ", float(" + std::to_string(f) + "))");
+    return (m_ -= f);
+}
+
 matrix &matrix::operator*=(float f)
 {
+    MATRIX_OPERATION(statistics::MULTIPLY_FLOAT, 0, get_length(),
+                     FLOAT_BYTES(2 * get_length()), (double) get_length());
     multiply(*this, f);
     return *this;
 }
@@ -274,7 +347,15 @@ bool matrix::operator!=(const matrix &m) const
 
 matrix matrix::hadamard_product(const matrix &v)
 {
-    if (_dimensions != v.get_dimensions() && !(_dimensions.first != 1 || _dimensions.second != 1))
+    matrix m = matrix(*this, "hadamard_product(" + _id + ", " + v.get_id() + ")");
+    m.hadamard_product_in_place(v);
+
+    return m;
+}
+
+matrix &matrix::hadamard_product_in_place(const matrix &v)
+{
+    if (! is_broadcastable(v))
     {
         // Invalid.
         util::ERROR("matrix::hadamard_product",
@@ -284,26 +365,112 @@ matrix matrix::hadamard_product(const matrix &v)
         util::ERROR_EXIT();
     }
 
-    matrix m = matrix(*this, "hadamard_product(" + _id + ", " + v.get_id() + ")");
-    do_hadamard_product(m, v);
+    MATRIX_OPERATION(statistics::HADAMARD_PRODUCT, 0, get_length(),
+                     FLOAT_BYTES(2 * get_length() + v.get_length()), (double) get_length());
+    do_hadamard_product(*this, v);
 
-    return m;
+    return *this;
 }
 
 float matrix::sum() const
 {
     float sum = 0.f;
 
+    MATRIX_OPERATION(statistics::SUM, 0, get_length(),
+                     FLOAT_BYTES(get_length()), (double) get_length());
+
     if (get_length() > 0)
     {
-        do_sum(&sum, *this);
+        do_reduce(&sum, *this, SUM);
     }
 
     return sum;
 }
 
+float matrix::mean() const
+{
+    float mean = 0.f;
+
+    MATRIX_OPERATION(statistics::MEAN, 0, get_length(),
+                     FLOAT_BYTES(get_length()), (double) get_length());
+
+    if (get_length() > 0)
+    {
+        do_reduce(&mean, *this, MEAN);
+    }
+
+    return mean;
+}
+
+float matrix::get_max() const
+{
+    float max = -std::numeric_limits<float>::infinity();
+
+    MATRIX_OPERATION(statistics::MAXIMUM, 0, get_length(),
+                     FLOAT_BYTES(get_length()), (double) get_length());
+
+    if (get_length() > 0)
+    {
+        do_reduce(&max, *this, MAXIMUM);
+    }
+
+    return max;
+}
+
+float matrix::get_min() const
+{
+    float min = std::numeric_limits<float>::infinity();
+
+    MATRIX_OPERATION(statistics::MINIMUM, 0, get_length(),
+                     FLOAT_BYTES(get_length()), (double) get_length());
+
+    if (get_length() > 0)
+    {
+        do_reduce(&min, *this, MINIMUM);
+    }
+
+    return min;
+}
+
+size_t matrix::argmax() const
+{
+    size_t index = 0;
+
+    MATRIX_OPERATION(statistics::ARGMAX, 0, get_length(),
+                     FLOAT_BYTES(get_length()), (double) get_length());
+
+    if (get_length() > 0)
+    {
+        do_argmax(&index, *this);
+    }
+
+    return index;
+}
+
+matrix matrix::reduce_rows(reductions r) const
+{
+    MATRIX_OPERATION(statistics::REDUCE_ROWS, 0, get_length(),
+                     FLOAT_BYTES(get_length() + _dimensions.first), (double) get_length());
+    matrix m = matrix(_dimensions.first, 1, "reduce_rows(" + _id + ")");
+    do_reduce_rows(m, *this, r);
+
+    return m;
+}
+
+matrix matrix::reduce_cols(reductions r) const
+{
+    MATRIX_OPERATION(statistics::REDUCE_COLS, 0, get_length(),
+                     FLOAT_BYTES(get_length() + _dimensions.second), (double) get_length());
+    matrix m = matrix(1, _dimensions.second, "reduce_cols(" + _id + ")");
+    do_reduce_cols(m, *this, r);
+
+    return m;
+}
+
 matrix matrix::transpose() const
 {
+    MATRIX_OPERATION(statistics::TRANSPOSE, 0, get_length(),
+                     FLOAT_BYTES(2 * get_length()), 0.);
     matrix m = matrix(_dimensions.second, _dimensions.first, "transpose(" + _id + ")");
     do_transpose(m, *this);
 
@@ -7,6 +7,7 @@
 
 #include "lib/global.h"
 #include "lib/util/util.h"
+#include "lib/data_structures/matrix/reduction/reduction.h"
 
 #include <vector_types.h> // To keep .cpp/.h extensions (cuda types).
 #include <cstddef>
@@ -44,12 +45,16 @@ namespace cudaNN
             matrix(const float *values, std::pair<size_t, size_t> dimensions, std::string id);
             ~matrix();
 
+            /**
+             * Free the memory of the matrix (its dimensions become 0×0).
+             */
+            void clear();
+
             void set_id(const std::string &id);
 
             const std::string &get_id() const;
             float *get_data() const;
             float *get_data();
-            float get_max();
 
             /**
              * @return - the number of rows, and columns of the matrix.
@@ -61,8 +66,17 @@ namespace cudaNN
              */
             size_t get_length() const;
 
+            /**
+             * @return - true if "m" can be broadcast over the current matrix;
+             * i.e. it has the same dimensions, or is a row vector (1*M), a column
+             * vector (N*1) or a scalar (1*1) matching the current dimensions.
+             */
+            bool is_broadcastable(const matrix &m) const;
+
             /**
              * @operators
+             * The element-wise operators (+, -) broadcast "m"
+             * (see "is_broadcastable").
              */
             matrix &operator=(const matrix &m);
             matrix &operator+=(const matrix &m);
@@ -71,6 +85,10 @@ namespace cudaNN
             matrix operator-(const matrix &m);
             matrix &operator*=(const matrix &m);
             matrix operator*(const matrix &m);
+            matrix &operator+=(float f);
+            matrix operator+(float f);
+            matrix &operator-=(float f);
+            matrix operator-(float f);
             matrix &operator*=(float f);
             matrix operator*(float f);
             float &operator[](const int &i);
@@ -79,16 +97,60 @@ namespace cudaNN
             bool operator!=(const matrix &m) const;
 
             /**
-             * @param v - a vector of the same dimensions as the current matrix
+             * @param v - a matrix that can be broadcast over the current matrix
+             * (see "is_broadcastable").
              * @return - the Hadamard product between the current matrix and "v".
              */
             matrix hadamard_product(const matrix &v);
 
+            /**
+             * Compute the Hadamard product between the current matrix and "v",
+             * and store it in the current matrix.
+             * @param v - a matrix that can be broadcast over the current matrix
+             * (see "is_broadcastable").
+             * @return - the current matrix.
+             */
+            matrix &hadamard_product_in_place(const matrix &v);
+
             /**
              * @return - the sum of all the values in the matrix.
              */
             float sum() const;
 
+            /**
+             * @return - the mean of all the values in the matrix.
+             */
+            float mean() const;
+
+            /**
+             * @return - the greatest value in the matrix.
+             */
+            float get_max() const;
+
+            /**
+             * @return - the smallest value in the matrix.
+             */
+            float get_min() const;
+
+            /**
+             * @return - the index of the (first) greatest value in the matrix.
+             */
+            size_t argmax() const;
+
+            /**
+             * @param r - the type of reduction.
+             * @return - the reduction of each row of the matrix (N*1 matrix).
+             * For ARGMAX, the column index of the greatest value of each row.
+             */
+            matrix reduce_rows(reductions r) const;
+
+            /**
+             * @param r - the type of reduction.
+             * @return - the reduction of each column of the matrix (1*M matrix).
+             * For ARGMAX, the row index of the greatest value of each column.
+             */
+            matrix reduce_cols(reductions r) const;
+
             /**
              * @return - the transpose of the matrix.
              */
@@ -118,13 +180,21 @@ namespace cudaNN
     {
         void start_operation(const matrix &m, float **device_data);
         void end_operation(const matrix &m, float **device_data);
+        /**
+         * Element-wise operations (on both device and host); "m2" is broadcast
+         * over "m1" if it is a row vector, column vector or scalar
+         * (see matrix::is_broadcastable).
+         */
         void add(const matrix &m1, const matrix &m2);
         void subtract(const matrix &m1, const matrix &m2);
         void multiply(const matrix &m,
                       const matrix &m1, const matrix &m2);
         void multiply(const matrix &m, float f);
         void do_hadamard_product(const matrix &v1, const matrix &v2);
-        void do_sum(float *result, const matrix &m);
+        void do_reduce(float *result, const matrix &m, reductions r);
+        void do_argmax(size_t *result, const matrix &m);
+        void do_reduce_rows(const matrix &result, const matrix &m, reductions r);
+        void do_reduce_cols(const matrix &result, const matrix &m, reductions r);
         void do_transpose(matrix &result, const matrix &m);
     }
 
@@ -140,7 +210,10 @@ namespace cudaNN
                       const matrix &m1, const matrix &m2);
         void multiply(const matrix &m, float f);
         void do_hadamard_product(const matrix &v1, const matrix &v2);
-        void do_sum(float *result, const matrix &m);
+        void do_reduce(float *result, const matrix &m, reductions r);
+        void do_argmax(size_t *result, const matrix &m);
+        void do_reduce_rows(const matrix &result, const matrix &m, reductions r);
+        void do_reduce_cols(const matrix &result, const matrix &m, reductions r);
         void do_transpose(matrix &result, const matrix &m);
     }
 }
@@ -4,19 +4,40 @@
 
 #include "matrix.h"
 
+#include <vector>
+
 
 using namespace cudaNN;
 
 #define TILE_DIM 32
 
+/**
+ * Reductions: number of threads per block (power of 2), number of values
+ * reduced by a thread in the first pass, and maximal number of blocks.
+ */
+#define REDUCTION_NB_THREADS 256
+#define REDUCTION_NB_ELEMENTS 16
+#define REDUCTION_MAX_NB_BLOCKS 1024
+
 
 /**
  * Kernel functions.
  */
 
 
+/**
+ * @return - the index of the value of a broadcast matrix (of size
+ * "nb_rows_2" * "nb_cols_2") corresponding to the cell ("row", "col").
+ */
+__device__ size_t __broadcast_index(size_t row, size_t col,
+                                    size_t nb_rows_2, size_t nb_cols_2)
+{
+    return (nb_rows_2 == 1 ? 0 : row) * nb_cols_2 + (nb_cols_2 == 1 ? 0 : col);
+}
+
 __global__ void __kernel_add(float *data1, const float *data2,
-                             size_t nb_rows, size_t nb_cols)
+                             size_t nb_rows, size_t nb_cols,
+                             size_t nb_rows_2, size_t nb_cols_2)
 {
     size_t col = blockIdx.x * blockDim.x + threadIdx.x;
 
@@ -25,13 +46,14 @@ __global__ void __kernel_add(float *data1, const float *data2,
     {
         for (size_t i = 0; i < nb_rows; i ++)
         {
-            data1[nb_cols * i + col] += data2[nb_cols * i + col];
+            data1[nb_cols * i + col] += data2[__broadcast_index(i, col, nb_rows_2, nb_cols_2)];
         }
     }
 }
 
 __global__ void __kernel_subtract(float *data1, const float *data2,
-                                  size_t nb_rows, size_t nb_cols)
+                                  size_t nb_rows, size_t nb_cols,
+                                  size_t nb_rows_2, size_t nb_cols_2)
 {
     size_t col = blockIdx.x * blockDim.x + threadIdx.x;
 
@@ -40,7 +62,7 @@ __global__ void __kernel_subtract(float *data1, const float *data2,
     {
         for (size_t i = 0; i < nb_rows; i ++)
         {
-            data1[nb_cols * i + col] -= data2[nb_cols * i + col];
+            data1[nb_cols * i + col] -= data2[__broadcast_index(i, col, nb_rows_2, nb_cols_2)];
         }
     }
 }
@@ -136,7 +158,8 @@ __global__ void __kernel_multiply(float *data, float f,
 }
 
 __global__ void __kernel_do_hadamard_product(float *v1, float *v2,
-                                             size_t nb_rows, size_t nb_cols)
+                                             size_t nb_rows, size_t nb_cols,
+                                             size_t nb_rows_2, size_t nb_cols_2)
 {
     size_t col = blockIdx.x * blockDim.x + threadIdx.x;
 
@@ -145,42 +168,105 @@ __global__ void __kernel_do_hadamard_product(float *v1, float *v2,
     {
         for (size_t i = 0; i < nb_rows; i ++)
         {
-            v1[nb_cols * i + col] *= v2[nb_cols * i + col];
+            v1[nb_cols * i + col] *= v2[__broadcast_index(i, col, nb_rows_2, nb_cols_2)];
         }
     }
 }
 
-__global__ void __kernel_do_sum(float *data, float *result,
-                                size_t nb_rows, size_t nb_cols)
+__device__ float __reduction_init(reductions r)
 {
-    size_t col = blockIdx.x * blockDim.x + threadIdx.x;
-    size_t row = blockIdx.y * blockDim.y + threadIdx.y;
-    size_t index = row * nb_cols + col;
+    switch (r)
+    {
+        case MAXIMUM:
+        case ARGMAX:
+            return -INFINITY;
+        case MINIMUM:
+            return INFINITY;
+        default:
+            return 0.f;
+    }
+}
 
-    if (index < nb_rows * nb_cols)
+__device__ void __reduction_apply(float *value, size_t *index,
+                                  float x, size_t index_x, reductions r)
+{
+    switch (r)
     {
-        // Do a reduction to compute the sum.
-        extern __shared__ float shared_sum[];
-        // Copy into shared memory.
-        shared_sum[threadIdx.x] = data[blockIdx.x * blockDim.x + threadIdx.x];
+        case MAXIMUM:
+            *value = *value < x ? x : *value;
+            break;
+        case MINIMUM:
+            *value = x < *value ? x : *value;
+            break;
+        case ARGMAX:
+            // Keep the first index in case of equality.
+            if (x > *value || (x == *value && index_x < *index))
+            {
+                *value = x;
+                *index = index_x;
+            }
+            break;
+        default:
+            *value += x;
+    }
+}
+
+__global__ void __kernel_reduce(float *values, size_t *indices,
+                                const float *data, const size_t *data_indices,
+                                size_t nb_values, size_t nb_segments,
+                                size_t segment_length, size_t segment_stride,
+                                size_t element_stride, bool global_indices,
+                                reductions r)
+{
+    // The value n°k of the segment n°s is at "data[s * segment_stride + k * element_stride]".
+    extern __shared__ float shared_values[];
+    size_t *shared_indices = (size_t *) &shared_values[blockDim.x];
+
+    for (size_t s = blockIdx.x; s < nb_segments; s += gridDim.x)
+    {
+        float value = __reduction_init(r);
+        size_t index = 0;
+
+        // Each thread reduces a part of the segment.
+        for (size_t k = threadIdx.x; k < segment_length; k += blockDim.x)
+        {
+            size_t position = s * segment_stride + k * element_stride;
+
+            if (position >= nb_values)
+            {
+                break;
+            }
+
+            size_t index_x = data_indices != nullptr ? data_indices[position]
+                                                     : (global_indices ? position : k);
+            __reduction_apply(&value, &index, data[position], index_x, r);
+        }
+
+        shared_values[threadIdx.x] = value;
+        shared_indices[threadIdx.x] = index;
 
         __syncthreads();
 
+        // Then the threads of the block reduce their results (tree reduction).
         for (size_t stride = blockDim.x / 2; stride > 0; stride >>= 1)
         {
             if (threadIdx.x < stride)
             {
-                shared_sum[threadIdx.x] += shared_sum[threadIdx.x + stride];
+                __reduction_apply(&shared_values[threadIdx.x], &shared_indices[threadIdx.x],
+                                  shared_values[threadIdx.x + stride],
+                                  shared_indices[threadIdx.x + stride], r);
             }
-        }
 
-        __syncthreads();
+            __syncthreads();
+        }
 
-        // Retrieve and sum the sum computed by each block.
         if (threadIdx.x == 0)
         {
-            atomicAdd(result, shared_sum[0]);
+            values[s] = shared_values[0];
+            indices[s] = shared_indices[0];
         }
+
+        __syncthreads();
     }
 }
 
@@ -240,7 +326,8 @@ void matrix_parallel::add(const matrix &m1, const matrix &m2)
     // Do computations with CUDA threads.
     __kernel_add<<<block_dims, thread_dims>>>(
             device_data1, device_data2,
-            m1.get_dimensions().first, m1.get_dimensions().second);
+            m1.get_dimensions().first, m1.get_dimensions().second,
+            m2.get_dimensions().first, m2.get_dimensions().second);
     // Wait for all threads.
     CUDA_CHECK(cudaDeviceSynchronize());
     // Retrieve/free data from device.
@@ -264,7 +351,8 @@ void matrix_parallel::subtract(const matrix &m1, const matrix &m2)
     // Do computations with CUDA threads.
     __kernel_subtract<<<block_dims, thread_dims>>>(
             device_data1, device_data2,
-            m1.get_dimensions().first, m1.get_dimensions().second);
+            m1.get_dimensions().first, m1.get_dimensions().second,
+            m2.get_dimensions().first, m2.get_dimensions().second);
     // Wait for all threads.
     CUDA_CHECK(cudaDeviceSynchronize());
     // Retrieve/free data from device.
@@ -338,7 +426,8 @@ void matrix_parallel::do_hadamard_product(const matrix &v1, const matrix &v2)
     // Do computations with CUDA threads.
     __kernel_do_hadamard_product<<<block_dims, thread_dims>>>(
             device_data1, device_data2,
-            v1.get_dimensions().first, v1.get_dimensions().second);
+            v1.get_dimensions().first, v1.get_dimensions().second,
+            v2.get_dimensions().first, v2.get_dimensions().second);
     // Wait for all threads.
     CUDA_CHECK(cudaDeviceSynchronize());
     // Retrieve/free data from device.
@@ -346,45 +435,165 @@ void matrix_parallel::do_hadamard_product(const matrix &v1, const matrix &v2)
     end_operation(v2, &device_data2);
 }
 
-void matrix_parallel::do_sum(float *result, const matrix &m)
+/**
+ * Reduce segments of the values in "device_data" (see "__kernel_reduce"),
+ * and retrieve the "nb_segments" results on host.
+ */
+void __helper_reduce(float *values, size_t *indices,
+                     const float *device_data, const size_t *device_data_indices,
+                     size_t nb_values, size_t nb_segments,
+                     size_t segment_length, size_t segment_stride,
+                     size_t element_stride, bool global_indices,
+                     reductions r)
 {
-    // We use a reduction that assumes that the data is contained
-    // in an array of size 2^n. Therefore, we round up to the next
-    // power of 2 our matrix array.
-    auto ceil2 = util::ceil2(m.get_length());
-    auto cuda_dims = util::get_cuda_1dims(
-            std::pair<size_t, size_t>(ceil2, 1));
-    auto block_dims = cuda_dims.first;
-    auto thread_dims = cuda_dims.second;
-    *result = 0.f;
+    if (nb_segments == 0)
+    {
+        return;
+    }
 
-    float *device_data;
-    float *device_result;
+    auto nb_blocks = std::min(nb_segments, (size_t) REDUCTION_MAX_NB_BLOCKS);
+    auto shared_size = REDUCTION_NB_THREADS * (sizeof(float) + sizeof(size_t));
 
-    // Prepare data on device.
-    // - Allocate memory on device (of size 2^n).
-    CUDA_CHECK(cudaMalloc(&device_data, ceil2 * sizeof(float)));
-    // - Copy the matrix to this memory.
-    CUDA_CHECK(cudaMemcpy(device_data, m.get_data(),
-                          m.get_length() * sizeof(float),
-                          cudaMemcpyHostToDevice));
-    // Allocate result.
-    CUDA_CHECK(cudaMalloc(&device_result, sizeof(float)));
-    CUDA_CHECK(cudaMemcpy(device_result, result,
-                          sizeof(float),
-                          cudaMemcpyHostToDevice));
+    float *device_values;
+    size_t *device_indices;
+
+    CUDA_CHECK(cudaMalloc(&device_values, nb_segments * sizeof(float)));
+    CUDA_CHECK(cudaMalloc(&device_indices, nb_segments * sizeof(size_t)));
     // Do computations with CUDA threads.
-    __kernel_do_sum<<<block_dims, thread_dims, (ceil2 / block_dims.x) * sizeof(float)>>>(
-            device_data, device_result,
-            m.get_dimensions().first, m.get_dimensions().second);
+    __kernel_reduce<<<nb_blocks, REDUCTION_NB_THREADS, shared_size>>>(
+            device_values, device_indices,
+            device_data, device_data_indices,
+            nb_values, nb_segments,
+            segment_length, segment_stride,
+            element_stride, global_indices, r);
     // Wait for all threads.
     CUDA_CHECK(cudaDeviceSynchronize());
     // Retrieve/free data from device.
-    CUDA_CHECK(cudaMemcpy(result, device_result,
-                          sizeof(float),
+    CUDA_CHECK(cudaMemcpy(values, device_values,
+                          nb_segments * sizeof(float),
+                          cudaMemcpyDeviceToHost));
+    CUDA_CHECK(cudaMemcpy(indices, device_indices,
+                          nb_segments * sizeof(size_t),
                           cudaMemcpyDeviceToHost));
+    CUDA_CHECK(cudaFree(device_values));
+    CUDA_CHECK(cudaFree(device_indices));
+}
+
+/**
+ * Reduce all the values of the matrix in two passes; each block reduces
+ * a contiguous chunk, then a single block reduces the partial results.
+ * The order of the operations only depends on the size of the matrix.
+ */
+void __helper_reduce(float *value, size_t *index, const matrix &m, reductions r)
+{
+    auto r_ = r == MEAN ? SUM : r;
+    auto length = m.get_length();
+
+    if (length == 0)
+    {
+        // Same results as on host (the mean of no value is 0).
+        *value = r == MAXIMUM || r == ARGMAX ? -INFINITY : r == MINIMUM ? INFINITY : 0.f;
+        *index = 0;
+        return;
+    }
+
+    auto chunk_size = (size_t) REDUCTION_NB_THREADS * REDUCTION_NB_ELEMENTS;
+    auto nb_chunks = (length + chunk_size - 1) / chunk_size;
+    auto values = std::vector<float>(nb_chunks);
+    auto indices = std::vector<size_t>(nb_chunks);
+
+    float *device_data;
+    float *device_values;
+    size_t *device_indices;
+
+    // Prepare data on device.
+    matrix_parallel::start_operation(m, &device_data);
+    // First pass.
+    __helper_reduce(values.data(), indices.data(),
+                    device_data, nullptr,
+                    length, nb_chunks,
+                    chunk_size, chunk_size, 1, true, r_);
+    CUDA_CHECK(cudaFree(device_data));
+    // Second pass.
+    CUDA_CHECK(cudaMalloc(&device_values, nb_chunks * sizeof(float)));
+    CUDA_CHECK(cudaMalloc(&device_indices, nb_chunks * sizeof(size_t)));
+    CUDA_CHECK(cudaMemcpy(device_values, values.data(),
+                          nb_chunks * sizeof(float),
+                          cudaMemcpyHostToDevice));
+    CUDA_CHECK(cudaMemcpy(device_indices, indices.data(),
+                          nb_chunks * sizeof(size_t),
+                          cudaMemcpyHostToDevice));
+    __helper_reduce(value, index,
+                    device_values, device_indices,
+                    nb_chunks, 1,
+                    nb_chunks, nb_chunks, 1, true, r_);
+    CUDA_CHECK(cudaFree(device_values));
+    CUDA_CHECK(cudaFree(device_indices));
+
+    if (r == MEAN)
+    {
+        *value /= (float) length;
+    }
+}
+
+/**
+ * Reduce the rows (or columns) of the matrix, one segment per row (or column).
+ */
+void __helper_reduce(const matrix &result, const matrix &m,
+                     size_t nb_segments, size_t segment_length,
+                     size_t segment_stride, size_t element_stride,
+                     reductions r)
+{
+    auto indices = std::vector<size_t>(nb_segments);
+
+    float *device_data;
+
+    // Prepare data on device.
+    matrix_parallel::start_operation(m, &device_data);
+    __helper_reduce(result.get_data(), indices.data(),
+                    device_data, nullptr,
+                    m.get_length(), nb_segments,
+                    segment_length, segment_stride,
+                    element_stride, false, r);
     CUDA_CHECK(cudaFree(device_data));
-    CUDA_CHECK(cudaFree(device_result));
+
+    for (size_t i = 0; i < nb_segments; i ++)
+    {
+        if (r == MEAN)
+        {
+            result.get_data()[i] /= (float) std::max(segment_length, (size_t) 1);
+        }
+        else if (r == ARGMAX)
+        {
+            result.get_data()[i] = (float) indices[i];
+        }
+    }
+}
+
+void matrix_parallel::do_reduce(float *result, const matrix &m, reductions r)
+{
+    size_t index;
+    __helper_reduce(result, &index, m, r);
+}
+
+void matrix_parallel::do_argmax(size_t *result, const matrix &m)
+{
+    float value;
+    __helper_reduce(&value, result, m, ARGMAX);
+}
+
+void matrix_parallel::do_reduce_rows(const matrix &result, const matrix &m, reductions r)
+{
+    __helper_reduce(result, m,
+                    m.get_dimensions().first, m.get_dimensions().second,
+                    m.get_dimensions().second, 1, r);
+}
+
+void matrix_parallel::do_reduce_cols(const matrix &result, const matrix &m, reductions r)
+{
+    __helper_reduce(result, m,
+                    m.get_dimensions().second, m.get_dimensions().first,
+                    1, m.get_dimensions().second, r);
 }
 
 void matrix_parallel::do_transpose(matrix &result, const matrix &m)
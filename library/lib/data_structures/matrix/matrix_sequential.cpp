@@ -3,24 +3,80 @@
 //
 
 #include "matrix.h"
+#include "lib/util/parallel/parallel.h"
+
+#include <functional>
 
 using namespace cudaNN;
 
 
-void matrix_sequential::add(const matrix &m1, const matrix &m2)
+namespace
 {
-    for (size_t i = 0; i < m1.get_length(); i ++)
+    /**
+     * Apply "op" between each value of "m1" and the corresponding value
+     * of "m2", where "m2" is broadcast over "m1" (same dimensions, row vector,
+     * column vector or scalar). The rows are split over the threads, and the
+     * inner loops are contiguous (vectorized).
+     */
+    template <typename op>
+    void broadcast(const matrix &m1, const matrix &m2)
     {
-        m1.get_data()[i] += m2.get_data()[i];
+        auto nb_rows = m1.get_dimensions().first;
+        auto nb_cols = m1.get_dimensions().second;
+        auto &dimensions = m2.get_dimensions();
+        float *data1 = m1.get_data();
+        const float *data2 = m2.get_data();
+        op f;
+
+        size_t min_nb_rows = std::max((size_t) 1, PARALLEL_MIN_CHUNK_SIZE / std::max((size_t) 1, nb_cols));
+
+        parallel::for_range(nb_rows, min_nb_rows, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i ++)
+            {
+                float *row = data1 + i * nb_cols;
+
+                if (dimensions == m1.get_dimensions())
+                {
+                    const float *row2 = data2 + i * nb_cols;
+
+                    for (size_t j = 0; j < nb_cols; j ++)
+                    {
+                        row[j] = f(row[j], row2[j]);
+                    }
+                }
+                else if (dimensions.first == 1 && dimensions.second == nb_cols)
+                {
+                    // Row vector.
+                    for (size_t j = 0; j < nb_cols; j ++)
+                    {
+                        row[j] = f(row[j], data2[j]);
+                    }
+                }
+                else
+                {
+                    // Column vector or scalar.
+                    float value = data2[dimensions.first == 1 ? 0 : i];
+
+                    for (size_t j = 0; j < nb_cols; j ++)
+                    {
+                        row[j] = f(row[j], value);
+                    }
+                }
+            }
+        });
     }
 }
 
+
+void matrix_sequential::add(const matrix &m1, const matrix &m2)
+{
+    broadcast<std::plus<float>>(m1, m2);
+}
+
 void matrix_sequential::subtract(const matrix &m1, const matrix &m2)
 {
-    for (size_t i = 0; i < m1.get_length(); i ++)
-    {
-        m1.get_data()[i] -= m2.get_data()[i];
-    }
+    broadcast<std::minus<float>>(m1, m2);
 }
 
 void matrix_sequential::multiply(const matrix &m,
@@ -50,18 +106,29 @@ void matrix_sequential::multiply(const matrix &m, float f)
 
 void matrix_sequential::do_hadamard_product(const matrix &v1, const matrix &v2)
 {
-    for (size_t i = 0; i < v1.get_length(); i ++)
-    {
-        v1.get_data()[i] *= v2.get_data()[i];
-    }
+    broadcast<std::multiplies<float>>(v1, v2);
 }
 
-void matrix_sequential::do_sum(float *result, const matrix &m)
+void matrix_sequential::do_reduce(float *result, const matrix &m, reductions r)
 {
-    for (size_t i = 0; i < m.get_length(); i ++)
-    {
-        *result += m.get_data()[i];
-    }
+    *result = reduction::reduce_parallel(m.get_data(), m.get_length(), r).value;
+}
+
+void matrix_sequential::do_argmax(size_t *result, const matrix &m)
+{
+    *result = reduction::reduce_parallel(m.get_data(), m.get_length(), ARGMAX).index;
+}
+
+void matrix_sequential::do_reduce_rows(const matrix &result, const matrix &m, reductions r)
+{
+    reduction::reduce_rows(result.get_data(), m.get_data(),
+                           m.get_dimensions().first, m.get_dimensions().second, r);
+}
+
+void matrix_sequential::do_reduce_cols(const matrix &result, const matrix &m, reductions r)
+{
+    reduction::reduce_cols(result.get_data(), m.get_data(),
+                           m.get_dimensions().first, m.get_dimensions().second, r);
 }
 
 void matrix_sequential::do_transpose(matrix &result, const matrix &m)
@@ -0,0 +1,333 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "reduction.h"
+#include "lib/util/parallel/parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace cudaNN;
+
+
+namespace
+{
+    /**
+     * Binary operations of the reductions, with their identity.
+     */
+    struct sum_op
+    {
+        static float init() { return 0.f; }
+        static float apply(float a, float b) { return a + b; }
+    };
+
+    struct max_op
+    {
+        static float init() { return -std::numeric_limits<float>::infinity(); }
+        static float apply(float a, float b) { return a < b ? b : a; }
+    };
+
+    struct min_op
+    {
+        static float init() { return std::numeric_limits<float>::infinity(); }
+        static float apply(float a, float b) { return b < a ? b : a; }
+    };
+
+    /**
+     * Combine the "length" values two by two, in a fixed order
+     * ((0, 1), (2, 3), ..., then (0, 2), ...).
+     */
+    template <typename op>
+    float combine(float *values, size_t length)
+    {
+        for (size_t width = 1; width < length; width *= 2)
+        {
+            for (size_t i = 0; i + width < length; i += 2 * width)
+            {
+                values[i] = op::apply(values[i], values[i + width]);
+            }
+        }
+
+        return length == 0 ? op::init() : values[0];
+    }
+
+    /**
+     * The value n°i is accumulated on the lane n°(i % REDUCTION_NB_LANES),
+     * whatever the stride (the contiguous case is vectorized).
+     */
+    template <typename op>
+    float reduce_lanes(const float *data, size_t length, size_t stride)
+    {
+        float lanes[REDUCTION_NB_LANES];
+        std::fill(lanes, lanes + REDUCTION_NB_LANES, op::init());
+        size_t i = 0;
+
+        if (stride == 1)
+        {
+            for (; i + REDUCTION_NB_LANES <= length; i += REDUCTION_NB_LANES)
+            {
+                for (size_t j = 0; j < REDUCTION_NB_LANES; j ++)
+                {
+                    lanes[j] = op::apply(lanes[j], data[i + j]);
+                }
+            }
+        }
+
+        for (; i < length; i ++)
+        {
+            lanes[i % REDUCTION_NB_LANES] = op::apply(lanes[i % REDUCTION_NB_LANES],
+                                                      data[i * stride]);
+        }
+
+        return combine<op>(lanes, REDUCTION_NB_LANES);
+    }
+
+    reduction::result argmax(const float *data, size_t length, size_t stride)
+    {
+        // Vectorized search of the greatest value, then of its first occurrence.
+        float max = reduce_lanes<max_op>(data, length, stride);
+        size_t index = 0;
+
+        while (index < length && data[index * stride] != max)
+        {
+            index ++;
+        }
+
+        return { max, index < length ? index : 0 };
+    }
+
+    reduction::result identity(reductions r)
+    {
+        switch (r)
+        {
+            case MAXIMUM:
+            case ARGMAX:
+                return { max_op::init(), 0 };
+            case MINIMUM:
+                return { min_op::init(), 0 };
+            default:
+                return { sum_op::init(), 0 };
+        }
+    }
+
+    /**
+     * @return - the combination of two partial results, where "a" comes
+     * from values preceding the values of "b" (to keep the first index
+     * for ARGMAX).
+     */
+    reduction::result combine(const reduction::result &a, const reduction::result &b,
+                              reductions r)
+    {
+        switch (r)
+        {
+            case MAXIMUM:
+                return { max_op::apply(a.value, b.value), 0 };
+            case MINIMUM:
+                return { min_op::apply(a.value, b.value), 0 };
+            case ARGMAX:
+                return b.value > a.value ? b : a;
+            default:
+                return { sum_op::apply(a.value, b.value), 0 };
+        }
+    }
+
+    template <typename op>
+    void reduce_cols_range(float *results, const float *data,
+                           size_t nb_rows, size_t nb_cols,
+                           size_t begin, size_t end)
+    {
+        std::fill(results + begin, results + end, op::init());
+
+        // Row after row, such that the columns are vectorized.
+        for (size_t i = 0; i < nb_rows; i ++)
+        {
+            const float *row = data + i * nb_cols;
+
+            for (size_t j = begin; j < end; j ++)
+            {
+                results[j] = op::apply(results[j], row[j]);
+            }
+        }
+    }
+
+    void argmax_cols_range(float *results, const float *data,
+                           size_t nb_rows, size_t nb_cols,
+                           size_t begin, size_t end)
+    {
+        auto max = std::vector<float>(end - begin, max_op::init());
+        std::fill(results + begin, results + end, 0.f);
+
+        for (size_t i = 0; i < nb_rows; i ++)
+        {
+            const float *row = data + i * nb_cols;
+
+            for (size_t j = begin; j < end; j ++)
+            {
+                if (row[j] > max[j - begin])
+                {
+                    max[j - begin] = row[j];
+                    results[j] = (float) i;
+                }
+            }
+        }
+    }
+}
+
+
+reduction::result reduction::reduce(const float *data, size_t length, size_t stride,
+                                    reductions r)
+{
+    switch (r)
+    {
+        case SUM:
+            return { reduce_lanes<sum_op>(data, length, stride), 0 };
+        case MEAN:
+            return { length == 0 ? 0.f
+                                 : reduce_lanes<sum_op>(data, length, stride) / (float) length, 0 };
+        case MAXIMUM:
+            return { reduce_lanes<max_op>(data, length, stride), 0 };
+        case MINIMUM:
+            return { reduce_lanes<min_op>(data, length, stride), 0 };
+        case ARGMAX:
+            return argmax(data, length, stride);
+    }
+
+    return identity(r);
+}
+
+float reduction::log_sum_exp(const float *data, size_t length)
+{
+    float max = reduce_lanes<max_op>(data, length, 1);
+
+    if (std::isinf(max))
+    {
+        // No values, or an infinite value.
+        return max;
+    }
+
+    float lanes[REDUCTION_NB_LANES] = { 0.f };
+    size_t i = 0;
+
+    for (; i + REDUCTION_NB_LANES <= length; i += REDUCTION_NB_LANES)
+    {
+        for (size_t j = 0; j < REDUCTION_NB_LANES; j ++)
+        {
+            lanes[j] += expf(data[i + j] - max);
+        }
+    }
+
+    for (; i < length; i ++)
+    {
+        lanes[i % REDUCTION_NB_LANES] += expf(data[i] - max);
+    }
+
+    return max + logf(combine<sum_op>(lanes, REDUCTION_NB_LANES));
+}
+
+reduction::result reduction::reduce_parallel(const float *data, size_t length, reductions r)
+{
+    if (length <= REDUCTION_CHUNK_SIZE)
+    {
+        return reduce(data, length, 1, r);
+    }
+
+    // The mean is computed from the sum of the chunks.
+    auto r_ = r == MEAN ? SUM : r;
+    size_t nb_chunks;
+    size_t chunk_size;
+
+    if (parallel::is_deterministic())
+    {
+        // Same chunks whatever the number of threads.
+        chunk_size = REDUCTION_CHUNK_SIZE;
+        nb_chunks = (length + chunk_size - 1) / chunk_size;
+    }
+    else
+    {
+        // One chunk per thread.
+        nb_chunks = parallel::get_nb_chunks(length, REDUCTION_CHUNK_SIZE);
+        chunk_size = (length + nb_chunks - 1) / nb_chunks;
+    }
+
+    auto partials = std::vector<result>(nb_chunks, identity(r_));
+
+    parallel::for_each_chunk(nb_chunks, [&](size_t i)
+    {
+        size_t begin = i * chunk_size;
+        size_t end = std::min(length, begin + chunk_size);
+
+        if (begin < end)
+        {
+            partials[i] = reduce(data + begin, end - begin, 1, r_);
+            partials[i].index += begin;
+        }
+    });
+
+    // Combine the partial results in a fixed order.
+    for (size_t width = 1; width < nb_chunks; width *= 2)
+    {
+        for (size_t i = 0; i + width < nb_chunks; i += 2 * width)
+        {
+            partials[i] = combine(partials[i], partials[i + width], r_);
+        }
+    }
+
+    if (r == MEAN)
+    {
+        partials[0].value /= (float) length;
+    }
+
+    return partials[0];
+}
+
+void reduction::reduce_rows(float *results, const float *data,
+                            size_t nb_rows, size_t nb_cols, reductions r)
+{
+    size_t min_nb_rows = std::max((size_t) 1, REDUCTION_CHUNK_SIZE / std::max((size_t) 1, nb_cols));
+
+    parallel::for_range(nb_rows, min_nb_rows, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i ++)
+        {
+            auto result = reduce(data + i * nb_cols, nb_cols, 1, r);
+            results[i] = r == ARGMAX ? (float) result.index : result.value;
+        }
+    });
+}
+
+void reduction::reduce_cols(float *results, const float *data,
+                            size_t nb_rows, size_t nb_cols, reductions r)
+{
+    size_t min_nb_cols = std::max((size_t) 1, REDUCTION_CHUNK_SIZE / std::max((size_t) 1, nb_rows));
+
+    parallel::for_range(nb_cols, min_nb_cols, [&](size_t begin, size_t end)
+    {
+        switch (r)
+        {
+            case SUM:
+            case MEAN:
+                reduce_cols_range<sum_op>(results, data, nb_rows, nb_cols, begin, end);
+                break;
+            case MAXIMUM:
+                reduce_cols_range<max_op>(results, data, nb_rows, nb_cols, begin, end);
+                break;
+            case MINIMUM:
+                reduce_cols_range<min_op>(results, data, nb_rows, nb_cols, begin, end);
+                break;
+            case ARGMAX:
+                argmax_cols_range(results, data, nb_rows, nb_cols, begin, end);
+                break;
+        }
+
+        if (r == MEAN && nb_rows > 0)
+        {
+            for (size_t j = begin; j < end; j ++)
+            {
+                results[j] /= (float) nb_rows;
+            }
+        }
+    });
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#ifndef CUDANN_REDUCTION_H
+#define CUDANN_REDUCTION_H
+
+#include "lib/global.h"
+
+#include <cstddef>
+
+
+/**
+ * Number of values reduced by a single thread before its partial result
+ * is combined with the others. In deterministic mode, the values are
+ * always split in chunks of this size (whatever the number of threads).
+ */
+#define REDUCTION_CHUNK_SIZE 16384
+
+/**
+ * Number of independent accumulators used to reduce a chunk
+ * (such that the loops can be vectorized).
+ */
+#define REDUCTION_NB_LANES 8
+
+
+namespace cudaNN
+{
+    /**
+     * Type of reduction of a set of values into one value.
+     * @SUM - the sum of the values.
+     * @MEAN - the mean of the values.
+     * @MAXIMUM - the greatest value.
+     * @MINIMUM - the smallest value.
+     * @ARGMAX - the index of the (first) greatest value.
+     */
+    enum reductions
+    {
+        SUM,
+        MEAN,
+        MAXIMUM,
+        MINIMUM,
+        ARGMAX
+    };
+
+
+    /**
+     * Reductions of arrays on host. The values are accumulated on
+     * REDUCTION_NB_LANES lanes, combined with a fixed pairwise tree,
+     * such that a given input always gives the same result on a thread.
+     */
+    namespace reduction
+    {
+        /**
+         * Result of a reduction.
+         * @value - the reduced value (the greatest value for ARGMAX).
+         * @index - for ARGMAX; the index of this value.
+         */
+        struct result
+        {
+            float value;
+            size_t index;
+        };
+
+        /**
+         * Reduce the values on the calling thread.
+         * @param data - the values to be reduced.
+         * @param length - the number of values.
+         * @param stride - the distance between two values in "data".
+         * @param r - the type of reduction.
+         * @return - the reduction of the "length" values.
+         */
+        result reduce(const float *data, size_t length, size_t stride, reductions r);
+
+        /**
+         * Compute log(sum(exp(x_i))) on the calling thread, as
+         * max + log(sum(exp(x_i - max))) such that it does not overflow
+         * for large values.
+         * @param data - the contiguous values.
+         * @param length - the number of values.
+         * @return - the log-sum-exp of the "length" values.
+         */
+        float log_sum_exp(const float *data, size_t length);
+
+        /**
+         * Reduce the contiguous values using all the threads.
+         * If in deterministic mode (see parallel::is_deterministic), the result
+         * does not depend on the number of threads.
+         * @param data - the values to be reduced.
+         * @param length - the number of values.
+         * @param r - the type of reduction.
+         * @return - the reduction of the "length" values.
+         */
+        result reduce_parallel(const float *data, size_t length, reductions r);
+
+        /**
+         * Reduce each row of a (row major) matrix, using all the threads.
+         * @param results - the "nb_rows" results (indices for ARGMAX).
+         * @param data - the values of the matrix.
+         */
+        void reduce_rows(float *results, const float *data,
+                         size_t nb_rows, size_t nb_cols, reductions r);
+
+        /**
+         * Reduce each column of a (row major) matrix, using all the threads.
+         * @param results - the "nb_cols" results (indices for ARGMAX).
+         * @param data - the values of the matrix.
+         */
+        void reduce_cols(float *results, const float *data,
+                         size_t nb_rows, size_t nb_cols, reductions r);
+    }
+}
+
+
+#endif //CUDANN_REDUCTION_H
\ No newline at end of file
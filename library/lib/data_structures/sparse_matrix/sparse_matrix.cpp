@@ -0,0 +1,201 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "sparse_matrix.h"
+#include "lib/util/parallel/parallel.h"
+#include "lib/util/profiler/profiler.h"
+
+#include <algorithm>
+#include <numeric>
+
+
+using namespace cudaNN;
+
+
+sparse_matrix::sparse_matrix(const matrix &m):
+        _dimensions(m.get_dimensions()),
+        _row_offsets(m.get_dimensions().first + 1, 0)
+{
+    auto nb_cols = _dimensions.second;
+    const float *data = m.get_data();
+
+    for (size_t i = 0; i < _dimensions.first; i ++)
+    {
+        for (size_t j = 0; j < nb_cols; j ++)
+        {
+            if (data[i * nb_cols + j] != 0.f)
+            {
+                _columns.push_back(j);
+                _values.push_back(data[i * nb_cols + j]);
+            }
+        }
+
+        _row_offsets[i + 1] = _values.size();
+    }
+}
+
+sparse_matrix::sparse_matrix(std::pair<size_t, size_t> dimensions,
+                             const std::vector<size_t> &rows,
+                             const std::vector<size_t> &columns,
+                             const std::vector<float> &values):
+        _dimensions(dimensions),
+        _row_offsets(dimensions.first + 1, 0)
+{
+    if (rows.size() != values.size() || columns.size() != values.size())
+    {
+        // Invalid.
+        util::ERROR("sparse_matrix::sparse_matrix",
+                    "Invalid coordinates (" + std::to_string(rows.size()) + " rows and "
+                    + std::to_string(columns.size()) + " columns for "
+                    + std::to_string(values.size()) + " values)");
+        util::ERROR_EXIT();
+    }
+
+    for (size_t i = 0; i < values.size(); i ++)
+    {
+        if (rows[i] >= dimensions.first || columns[i] >= dimensions.second)
+        {
+            // Invalid.
+            util::ERROR("sparse_matrix::sparse_matrix",
+                        "Invalid coordinates (" + std::to_string(rows[i]) + ", "
+                        + std::to_string(columns[i]) + ") in a "
+                        + std::to_string(dimensions.first) + "x"
+                        + std::to_string(dimensions.second) + " matrix");
+            util::ERROR_EXIT();
+        }
+    }
+
+    // The values in the order of the rows, then of the columns.
+    auto order = std::vector<size_t>(values.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+    {
+        return std::make_pair(rows[a], columns[a]) < std::make_pair(rows[b], columns[b]);
+    });
+
+    for (size_t k = 0; k < order.size(); k ++)
+    {
+        auto i = order[k];
+
+        if (k > 0 && rows[i] == rows[order[k - 1]] && columns[i] == columns[order[k - 1]])
+        {
+            // Duplicate.
+            _values.back() += values[i];
+            continue;
+        }
+
+        _columns.push_back(columns[i]);
+        _values.push_back(values[i]);
+        _row_offsets[rows[i] + 1] = _values.size();
+    }
+
+    // The empty rows end where the previous ones do.
+    for (size_t i = 1; i <= _dimensions.first; i ++)
+    {
+        _row_offsets[i] = std::max(_row_offsets[i], _row_offsets[i - 1]);
+    }
+}
+
+const std::pair<size_t, size_t> &sparse_matrix::get_dimensions() const
+{
+    return _dimensions;
+}
+
+size_t sparse_matrix::get_nnz() const
+{
+    return _values.size();
+}
+
+const std::vector<size_t> &sparse_matrix::get_row_offsets() const
+{
+    return _row_offsets;
+}
+
+const std::vector<size_t> &sparse_matrix::get_columns() const
+{
+    return _columns;
+}
+
+const std::vector<float> &sparse_matrix::get_values() const
+{
+    return _values;
+}
+
+matrix sparse_matrix::operator*(const matrix &m) const
+{
+    if (_dimensions.second != m.get_dimensions().first)
+    {
+        // Invalid.
+        util::ERROR("sparse_matrix::operator*",
+                    "Invalid dimensions ("
+                    + std::to_string(_dimensions.first) + "x" + std::to_string(_dimensions.second)
+                    + " and "
+                    + std::to_string(m.get_dimensions().first) + "x"
+                    + std::to_string(m.get_dimensions().second) + ")");
+        util::ERROR_EXIT();
+    }
+
+    auto nb_cols = m.get_dimensions().second;
+    PROFILE_SCOPE("sparse_matrix", "multiply", _dimensions.first, nb_cols, get_nnz(),
+                  (double) ((2 * get_nnz() + _dimensions.first) * nb_cols) * sizeof(float),
+                  2. * (double) get_nnz() * (double) nb_cols);
+    auto result = matrix(_dimensions.first, nb_cols, "sparse_matrix::multiply");
+    float *output = result.get_data();
+    const float *input = m.get_data();
+
+    // The columns are split over the threads: even a single row (an entry)
+    // is shared, and the inner loops are contiguous (vectorized). The values
+    // are added in the order of their columns, as the dense product does.
+    auto min_nb_cols = std::max((size_t) 1, PARALLEL_MIN_CHUNK_SIZE / std::max((size_t) 1, get_nnz()));
+
+    parallel::for_range(nb_cols, min_nb_cols, [&](size_t begin, size_t end)
+    {
+        for (size_t i = 0; i < _dimensions.first; i ++)
+        {
+            float *row = output + i * nb_cols;
+
+            for (size_t p = _row_offsets[i]; p < _row_offsets[i + 1]; p ++)
+            {
+                const float *row2 = input + _columns[p] * nb_cols;
+                auto value = _values[p];
+
+                for (size_t j = begin; j < end; j ++)
+                {
+                    row[j] += value * row2[j];
+                }
+            }
+        }
+    });
+
+    return result;
+}
+
+matrix sparse_matrix::to_dense() const
+{
+    auto result = matrix(_dimensions, "sparse_matrix::to_dense");
+
+    for (size_t i = 0; i < _dimensions.first; i ++)
+    {
+        for (size_t p = _row_offsets[i]; p < _row_offsets[i + 1]; p ++)
+        {
+            result[(int) (i * _dimensions.second + _columns[p])] = _values[p];
+        }
+    }
+
+    return result;
+}
+
+void sparse_matrix::print(const sparse_matrix &m)
+{
+    std::cout << "> " << m.get_dimensions().first << "x" << m.get_dimensions().second
+              << ", " << m.get_nnz() << " non-zero values <" << std::endl;
+
+    for (size_t i = 0; i < m.get_dimensions().first; i ++)
+    {
+        for (size_t p = m._row_offsets[i]; p < m._row_offsets[i + 1]; p ++)
+        {
+            std::cout << "(" << i << ", " << m._columns[p] << ")\t" << m._values[p] << std::endl;
+        }
+    }
+}
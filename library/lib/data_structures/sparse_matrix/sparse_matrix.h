@@ -0,0 +1,96 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#ifndef CUDANN_SPARSE_MATRIX_H
+#define CUDANN_SPARSE_MATRIX_H
+
+#include "lib/data_structures/matrix/matrix.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+
+namespace cudaNN
+{
+    /**
+     * Sparse matrix representation, in compressed sparse rows (CSR): only the
+     * non-zero values are stored, with their column, row after row. To be used
+     * for the inputs that are mostly zeros (e.g. one-hot or bag-of-words
+     * features), such that the products cost the number of non-zero values
+     * instead of the number of values.
+     * The computations are done on host (in both configurations, see
+     * -global.h/_USE_GPU-).
+     */
+    class sparse_matrix
+    {
+        public:
+
+            sparse_matrix() = default;
+
+            /**
+             * @param m - a dense matrix, whose non-zero values are kept.
+             */
+            explicit sparse_matrix(const matrix &m);
+
+            /**
+             * From coordinates (COO): the value n°i is at the row "rows[i]" and
+             * the column "columns[i]" (in any order; duplicates are summed).
+             * @param dimensions - the number of rows and columns of the matrix.
+             */
+            sparse_matrix(std::pair<size_t, size_t> dimensions,
+                          const std::vector<size_t> &rows,
+                          const std::vector<size_t> &columns,
+                          const std::vector<float> &values);
+
+            /**
+             * @return - the number of rows, and columns of the matrix.
+             */
+            const std::pair<size_t, size_t> &get_dimensions() const;
+
+            /**
+             * @return - the number of stored (non-zero) values.
+             */
+            size_t get_nnz() const;
+
+            /**
+             * @return - the non-zero values of the row n°i are at the indices
+             * ["get_row_offsets()[i]", "get_row_offsets()[i + 1]"[ of
+             * "get_columns()" and "get_values()" (in increasing columns).
+             */
+            const std::vector<size_t> &get_row_offsets() const;
+            const std::vector<size_t> &get_columns() const;
+            const std::vector<float> &get_values() const;
+
+            /**
+             * Product with a dense matrix (SpMM): each non-zero value (i, k) adds
+             * the row n°k of "m" to the row n°i of the result. The columns of the
+             * result are split over the threads.
+             * @param m - a matrix with as many rows as the current matrix has columns.
+             * @return - the (dense) product.
+             */
+            matrix operator*(const matrix &m) const;
+
+            /**
+             * @return - the dense representation of the matrix.
+             */
+            matrix to_dense() const;
+
+            /**
+             * Print the given matrix (non-zero values and their coordinates).
+             * @param m - the matrix concerned.
+             */
+            static void print(const sparse_matrix &m);
+
+        private:
+
+            std::pair<size_t, size_t> _dimensions;
+            std::vector<size_t> _row_offsets;
+            std::vector<size_t> _columns;
+            std::vector<float> _values;
+    };
+}
+
+
+#endif //CUDANN_SPARSE_MATRIX_H
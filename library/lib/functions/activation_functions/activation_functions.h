@@ -28,6 +28,18 @@ namespace cudaNN
         void tanh_derivative(std::vector<matrix *> m);
         void softmax(std::vector<matrix *> m);
         void softmax_derivative(std::vector<matrix *> m);
+        void sigmoid_with_derivative(std::vector<matrix *> m);
+        void tanh_with_derivative(std::vector<matrix *> m);
+        void softmax_with_derivative(std::vector<matrix *> m);
+        void sigmoid_fast(std::vector<matrix *> m);
+        void sigmoid_fast_derivative(std::vector<matrix *> m);
+        void sigmoid_fast_with_derivative(std::vector<matrix *> m);
+        void tanh_fast(std::vector<matrix *> m);
+        void tanh_fast_derivative(std::vector<matrix *> m);
+        void tanh_fast_with_derivative(std::vector<matrix *> m);
+        void softmax_fast(std::vector<matrix *> m);
+        void softmax_fast_derivative(std::vector<matrix *> m);
+        void softmax_fast_with_derivative(std::vector<matrix *> m);
     }
 
 
@@ -48,6 +60,18 @@ namespace cudaNN
         void tanh_derivative(std::vector<matrix *> m);
         void softmax(std::vector<matrix *> m);
         void softmax_derivative(std::vector<matrix *> m);
+        void sigmoid_with_derivative(std::vector<matrix *> m);
+        void tanh_with_derivative(std::vector<matrix *> m);
+        void softmax_with_derivative(std::vector<matrix *> m);
+        void sigmoid_fast(std::vector<matrix *> m);
+        void sigmoid_fast_derivative(std::vector<matrix *> m);
+        void sigmoid_fast_with_derivative(std::vector<matrix *> m);
+        void tanh_fast(std::vector<matrix *> m);
+        void tanh_fast_derivative(std::vector<matrix *> m);
+        void tanh_fast_with_derivative(std::vector<matrix *> m);
+        void softmax_fast(std::vector<matrix *> m);
+        void softmax_fast_derivative(std::vector<matrix *> m);
+        void softmax_fast_with_derivative(std::vector<matrix *> m);
     }
 
 
@@ -77,7 +101,8 @@ namespace cudaNN
 
         const auto SIGMOID = function("sigmoid",
                                       sigmoid,
-                                      sigmoid_derivative);
+                                      sigmoid_derivative,
+                                      sigmoid_with_derivative);
 
         const auto RELU = function("relu",
                                    relu,
@@ -85,10 +110,54 @@ namespace cudaNN
 
         const auto TANH = function("tanh",
                                    tanh,
-                                   tanh_derivative);
+                                   tanh_derivative,
+                                   tanh_with_derivative);
+
+        /**
+         * Computed on each row. The derivative is the diagonal of the
+         * Jacobian only (the full Jacobian is never built): a "layer" keeps
+         * the outputs instead, and propagates the errors with the product of
+         * the Jacobian ("y * (errors - sum(errors * y))" on each row); the
+         * other layers reject it (see "is_row_wise"). For classification, use
+         * a LINEAR output layer with the SOFTMAX_CROSS_ENTROPY_LOSS (exact
+         * and cheaper gradient).
+         */
         const auto SOFTMAX = function("softmax",
-                                   softmax,
-                                   softmax_derivative);
+                                      softmax,
+                                      softmax_derivative,
+                                      softmax_with_derivative);
+
+        /**
+         * Faster (less precise) versions, selected by using these functions
+         * instead of the precise ones. On host, polynomial approximations
+         * are used (see approximations.h; at most 2 ULP for the sigmoid,
+         * 1 ULP for the tanh and the exponential, for inputs in [-80, 80]);
+         * on device, the intrinsics __expf and __fdividef (2 + 1.5 * |x| ULP).
+         */
+        const auto SIGMOID_FAST = function("sigmoid_fast",
+                                           sigmoid_fast,
+                                           sigmoid_fast_derivative,
+                                           sigmoid_fast_with_derivative);
+
+        const auto TANH_FAST = function("tanh_fast",
+                                        tanh_fast,
+                                        tanh_fast_derivative,
+                                        tanh_fast_with_derivative);
+
+        const auto SOFTMAX_FAST = function("softmax_fast",
+                                           softmax_fast,
+                                           softmax_fast_derivative,
+                                           softmax_fast_with_derivative);
+
+        /**
+         * @return - true if each output of "f" depends on the whole row
+         * (SOFTMAX, SOFTMAX_FAST): its derivative is not enough to propagate
+         * the errors.
+         */
+        inline bool is_row_wise(const function &f)
+        {
+            return f.get_id() == SOFTMAX.get_id() || f.get_id() == SOFTMAX_FAST.get_id();
+        }
     }
 }
 
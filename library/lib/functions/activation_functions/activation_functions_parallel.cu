@@ -7,6 +7,13 @@
 
 using namespace cudaNN;
 
+/**
+ * Kernels working on rows: number of threads per block (power of 2),
+ * and maximal number of blocks.
+ */
+#define ROWS_NB_THREADS 256
+#define ROWS_MAX_NB_BLOCKS 1024
+
 
 /**
  * Kernel functions.
@@ -165,100 +172,267 @@ __global__ void __kernel_tanh_derivative(float *results, float *inputs,
     }
 }
 
-__global__ void __kernel_softmax(float *results, float *inputs,
-                                 float *sum, float max_d,
-                                 size_t nb_rows, size_t nb_cols)
+__global__ void __kernel_sigmoid_with_derivative(float *results, float *derivatives, float *inputs,
+                                                 size_t nb_rows, size_t nb_cols)
 {
-    size_t index = blockIdx.x * blockDim.x + threadIdx.x;
+    size_t col = blockIdx.x * blockDim.x + threadIdx.x;
 
-    if (index < nb_rows * nb_cols)
+    // Check if thread index is in the output dimensions.
+    if (col < nb_cols)
     {
-        // Do a reduction to compute the sum.
-        extern __shared__ float shared_sum[];
-        // Copy into shared memory.
-        shared_sum[threadIdx.x] = expf(inputs[index] - max_d);
+        for (size_t i = 0; i < nb_rows; i ++)
+        {
+            float sigmoid = 1.f / (1.f + expf(-inputs[nb_cols * i + col]));
+            results[nb_cols * i + col] = sigmoid;
+            derivatives[nb_cols * i + col] = sigmoid * (1.f - sigmoid);
+        }
+    }
+}
 
-        __syncthreads();
+__global__ void __kernel_tanh_with_derivative(float *results, float *derivatives, float *inputs,
+                                              size_t nb_rows, size_t nb_cols)
+{
+    size_t col = blockIdx.x * blockDim.x + threadIdx.x;
 
-        for (size_t stride = blockDim.x / 2; stride > 0; stride >>= 1)
+    // Check if thread index is in the output dimensions.
+    if (col < nb_cols)
+    {
+        for (size_t i = 0; i < nb_rows; i ++)
         {
-            if (threadIdx.x < stride)
-            {
-                shared_sum[threadIdx.x] += shared_sum[threadIdx.x + stride];
-            }
+            float tanh_ = tanhf(inputs[nb_cols * i + col]);
+            results[nb_cols * i + col] = tanh_;
+            derivatives[nb_cols * i + col] = 1.f - tanh_ * tanh_;
         }
+    }
+}
 
-        __syncthreads();
+/**
+ * Fast versions, with the intrinsics of the special function units.
+ */
+static __device__ float __sigmoid_fast(float x)
+{
+    return __fdividef(1.f, 1.f + __expf(-x));
+}
+
+static __device__ float __tanh_fast(float x)
+{
+    // 1 - 2 / (exp(2x) + 1), with the odd polynomial of tanh near 0.
+    float z = x * x;
+    float small = ((((-5.70498872745e-3f * z + 2.06390887954e-2f) * z
+                     - 5.37397155531e-2f) * z + 1.33314422036e-1f) * z
+                   - 3.33332819422e-1f) * z * x + x;
+    float large = copysignf(1.f - __fdividef(2.f, __expf(2.f * fabsf(x)) + 1.f), x);
+
+    return fabsf(x) < 0.625f ? small : large;
+}
+
+__global__ void __kernel_sigmoid_fast(float *results, float *inputs,
+                                      size_t nb_rows, size_t nb_cols)
+{
+    size_t col = blockIdx.x * blockDim.x + threadIdx.x;
 
-        // Retrieve and sum the sum computed by each block.
-        if (threadIdx.x == 0)
+    // Check if thread index is in the output dimensions.
+    if (col < nb_cols)
+    {
+        for (size_t i = 0; i < nb_rows; i ++)
         {
-            atomicAdd(sum, shared_sum[0]);
+            results[nb_cols * i + col] = __sigmoid_fast(inputs[nb_cols * i + col]);
         }
+    }
+}
 
-        __syncthreads();
+__global__ void __kernel_sigmoid_fast_derivative(float *results, float *inputs,
+                                                 size_t nb_rows, size_t nb_cols)
+{
+    size_t col = blockIdx.x * blockDim.x + threadIdx.x;
 
-        // Compute the softmax using the previously computed sum.
-        if (index < nb_rows * nb_cols)
+    // Check if thread index is in the output dimensions.
+    if (col < nb_cols)
+    {
+        for (size_t i = 0; i < nb_rows; i ++)
         {
-            results[index] = expf(inputs[index] - max_d) / sum[0];
+            float sigmoid = __sigmoid_fast(inputs[nb_cols * i + col]);
+            results[nb_cols * i + col] = sigmoid * (1.f - sigmoid);
         }
     }
 }
 
-__global__ void __kernel_softmax_derivative(float *results, float *inputs,
-                                            float *sum, float max_d,
-                                            size_t nb_rows, size_t nb_cols)
+__global__ void __kernel_sigmoid_fast_with_derivative(float *results, float *derivatives, float *inputs,
+                                                      size_t nb_rows, size_t nb_cols)
+{
+    size_t col = blockIdx.x * blockDim.x + threadIdx.x;
+
+    // Check if thread index is in the output dimensions.
+    if (col < nb_cols)
+    {
+        for (size_t i = 0; i < nb_rows; i ++)
+        {
+            float sigmoid = __sigmoid_fast(inputs[nb_cols * i + col]);
+            results[nb_cols * i + col] = sigmoid;
+            derivatives[nb_cols * i + col] = sigmoid * (1.f - sigmoid);
+        }
+    }
+}
+
+__global__ void __kernel_tanh_fast(float *results, float *inputs,
+                                   size_t nb_rows, size_t nb_cols)
 {
-    size_t index = blockIdx.x * blockDim.x + threadIdx.x;
+    size_t col = blockIdx.x * blockDim.x + threadIdx.x;
 
-    if (index < nb_rows * nb_cols)
+    // Check if thread index is in the output dimensions.
+    if (col < nb_cols)
     {
-        // Do a reduction to compute the sum.
-        extern __shared__ float shared_sum[];
-        // Copy into shared memory.
-        shared_sum[threadIdx.x] = inputs[index];
+        for (size_t i = 0; i < nb_rows; i ++)
+        {
+            results[nb_cols * i + col] = __tanh_fast(inputs[nb_cols * i + col]);
+        }
+    }
+}
 
-        __syncthreads();
+__global__ void __kernel_tanh_fast_derivative(float *results, float *inputs,
+                                              size_t nb_rows, size_t nb_cols)
+{
+    size_t col = blockIdx.x * blockDim.x + threadIdx.x;
 
-        for (size_t stride = blockDim.x / 2; stride > 0; stride >>= 1)
+    // Check if thread index is in the output dimensions.
+    if (col < nb_cols)
+    {
+        for (size_t i = 0; i < nb_rows; i ++)
         {
-            if (threadIdx.x < stride)
-            {
-                shared_sum[threadIdx.x] += shared_sum[threadIdx.x + stride];
-            }
+            float tanh_ = __tanh_fast(inputs[nb_cols * i + col]);
+            results[nb_cols * i + col] = 1.f - tanh_ * tanh_;
+        }
+    }
+}
+
+__global__ void __kernel_tanh_fast_with_derivative(float *results, float *derivatives, float *inputs,
+                                                   size_t nb_rows, size_t nb_cols)
+{
+    size_t col = blockIdx.x * blockDim.x + threadIdx.x;
+
+    // Check if thread index is in the output dimensions.
+    if (col < nb_cols)
+    {
+        for (size_t i = 0; i < nb_rows; i ++)
+        {
+            float tanh_ = __tanh_fast(inputs[nb_cols * i + col]);
+            results[nb_cols * i + col] = tanh_;
+            derivatives[nb_cols * i + col] = 1.f - tanh_ * tanh_;
         }
+    }
+}
 
-        __syncthreads();
+/**
+ * Reduce the values of the threads of the block (sum or max).
+ * @return - the result, to every thread of the block.
+ */
+static __device__ float __block_reduce(float value, float *shared, bool is_max)
+{
+    shared[threadIdx.x] = value;
+
+    __syncthreads();
 
-        // Retrieve and sum the sum computed by each block.
-        if (threadIdx.x == 0)
+    for (size_t stride = blockDim.x / 2; stride > 0; stride >>= 1)
+    {
+        if (threadIdx.x < stride)
         {
-            atomicAdd(sum, shared_sum[0]);
+            shared[threadIdx.x] = is_max ? fmaxf(shared[threadIdx.x], shared[threadIdx.x + stride])
+                                         : shared[threadIdx.x] + shared[threadIdx.x + stride];
         }
 
         __syncthreads();
+    }
+
+    float result = shared[0];
+
+    __syncthreads();
+
+    return result;
+}
+
+/**
+ * Softmax of each row; one block per row.
+ * @param results - the softmax (if not null).
+ * @param derivatives - the diagonal of its Jacobian (if not null).
+ * @param fast - if true, the intrinsic __expf is used.
+ */
+static __device__ void __softmax(float *results, float *derivatives, float *inputs,
+                                 size_t nb_rows, size_t nb_cols, bool fast)
+{
+    extern __shared__ float shared[];
 
-        // Compute the derivative using the previously computed sum.
-        if (index < nb_rows * nb_cols)
+    for (size_t row = blockIdx.x; row < nb_rows; row += gridDim.x)
+    {
+        float *x = inputs + row * nb_cols;
+        float max = -INFINITY;
+        float sum = 0.f;
+
+        for (size_t col = threadIdx.x; col < nb_cols; col += blockDim.x)
+        {
+            max = fmaxf(max, x[col]);
+        }
+
+        max = __block_reduce(max, shared, true);
+
+        for (size_t col = threadIdx.x; col < nb_cols; col += blockDim.x)
+        {
+            sum += fast ? __expf(x[col] - max) : expf(x[col] - max);
+        }
+
+        float inverse = 1.f / __block_reduce(sum, shared, false);
+
+        for (size_t col = threadIdx.x; col < nb_cols; col += blockDim.x)
         {
-            size_t row = index / nb_cols;
-            size_t col = index % nb_cols;
-            float softmax_x = expf(inputs[row] - max_d) / sum[0];
-            float softmax_y = expf(inputs[col] - max_d) / sum[0];
+            float softmax = (fast ? __expf(x[col] - max) : expf(x[col] - max)) * inverse;
 
-            if (row == col)
+            if (results != nullptr)
             {
-                results[index] = softmax_x * (1 - softmax_x);
+                results[row * nb_cols + col] = softmax;
             }
-            else
+            if (derivatives != nullptr)
             {
-                results[index] = -softmax_x * softmax_y;
+                derivatives[row * nb_cols + col] = softmax * (1.f - softmax);
             }
         }
     }
 }
 
+__global__ void __kernel_softmax(float *results, float *inputs,
+                                 size_t nb_rows, size_t nb_cols)
+{
+    __softmax(results, nullptr, inputs, nb_rows, nb_cols, false);
+}
+
+__global__ void __kernel_softmax_derivative(float *results, float *inputs,
+                                            size_t nb_rows, size_t nb_cols)
+{
+    __softmax(nullptr, results, inputs, nb_rows, nb_cols, false);
+}
+
+__global__ void __kernel_softmax_with_derivative(float *results, float *derivatives, float *inputs,
+                                                 size_t nb_rows, size_t nb_cols)
+{
+    __softmax(results, derivatives, inputs, nb_rows, nb_cols, false);
+}
+
+__global__ void __kernel_softmax_fast(float *results, float *inputs,
+                                      size_t nb_rows, size_t nb_cols)
+{
+    __softmax(results, nullptr, inputs, nb_rows, nb_cols, true);
+}
+
+__global__ void __kernel_softmax_fast_derivative(float *results, float *inputs,
+                                                 size_t nb_rows, size_t nb_cols)
+{
+    __softmax(nullptr, results, inputs, nb_rows, nb_cols, true);
+}
+
+__global__ void __kernel_softmax_fast_with_derivative(float *results, float *derivatives, float *inputs,
+                                                      size_t nb_rows, size_t nb_cols)
+{
+    __softmax(results, derivatives, inputs, nb_rows, nb_cols, true);
+}
+
 void __helper(const matrix &results, const matrix &inputs,
               void (kernel)(float *result, float *inputs, size_t nb_rows, size_t nb_cols))
 {
@@ -285,49 +459,89 @@ void __helper(const matrix &results, const matrix &inputs,
     matrix_parallel::end_operation(inputs, &device_data2);
 }
 
-void __helper_softmax(const matrix &results, const matrix &inputs, float max_data,
-                      void (kernel)(float *result, float *inputs, float *sum, float max_data,
-                                    size_t nb_rows, size_t nb_cols))
+/**
+ * Launch a kernel processing each row of the matrix with a block.
+ */
+void __helper_rows(const matrix &results, const matrix &inputs,
+                   void (kernel)(float *result, float *inputs, size_t nb_rows, size_t nb_cols))
+{
+    auto nb_blocks = std::min(results.get_dimensions().first, (size_t) ROWS_MAX_NB_BLOCKS);
+
+    float *device_data1;
+    float *device_data2;
+
+    // Prepare data on device.
+    matrix_parallel::start_operation(results, &device_data1);
+    matrix_parallel::start_operation(inputs, &device_data2);
+    // Do computations with CUDA threads.
+    kernel<<<nb_blocks, ROWS_NB_THREADS, ROWS_NB_THREADS * sizeof(float)>>>(
+            device_data1, device_data2,
+            results.get_dimensions().first, results.get_dimensions().second);
+    // Wait for all threads.
+    CUDA_CHECK(cudaDeviceSynchronize());
+    // Retrieve/free data from device.
+    matrix_parallel::end_operation(results, &device_data1);
+    matrix_parallel::end_operation(inputs, &device_data2);
+}
+
+
+/**
+ * Launch a kernel computing both the outputs and the derivatives.
+ */
+void __helper(const matrix &results, const matrix &derivatives, const matrix &inputs,
+              void (kernel)(float *result, float *derivatives, float *inputs,
+                            size_t nb_rows, size_t nb_cols))
 {
-    // We use a reduction that assumes that the data is contained
-    // in an array of size 2^n. Therefore, we round up to the next
-    // power of 2 our matrix array.
-    auto ceil2 = util::ceil2(inputs.get_length());
     auto cuda_dims = util::get_cuda_1dims(
-            std::pair<size_t, size_t>(ceil2, 1));
+            std::pair<size_t, size_t>(1, inputs.get_dimensions().second));
     auto block_dims = cuda_dims.first;
     auto thread_dims = cuda_dims.second;
 
     float *device_data1;
     float *device_data2;
-    float *sum;
-    float zero = 0.f;
+    float *device_data3;
 
     // Prepare data on device.
     matrix_parallel::start_operation(results, &device_data1);
-    // For the matrix on which we will do the reduction:
-    // - Allocate memory on device (of size 2^n).
-    CUDA_CHECK(cudaMalloc(&device_data2, ceil2 * sizeof(float)));
-    // - Copy the matrix to this memory.
-    CUDA_CHECK(cudaMemcpy(device_data2, inputs.get_data(),
-                          inputs.get_length() * sizeof(float),
-                          cudaMemcpyHostToDevice));
-    // Allocate for the sum.
-    CUDA_CHECK(cudaMalloc(&sum, sizeof(float)));
-    CUDA_CHECK(cudaMemcpy(sum, &zero,
-                          sizeof(float),
-                          cudaMemcpyHostToDevice));
+    matrix_parallel::start_operation(derivatives, &device_data2);
+    matrix_parallel::start_operation(inputs, &device_data3);
+
     // Do computations with CUDA threads.
-    kernel<<<block_dims, thread_dims, (ceil2 / block_dims.x) * sizeof(float)>>>(
-            device_data1, device_data2,
-            sum, max_data,
+    kernel<<<block_dims, thread_dims>>>(
+            device_data1, device_data2, device_data3,
             results.get_dimensions().first, results.get_dimensions().second);
     // Wait for all threads.
     CUDA_CHECK(cudaDeviceSynchronize());
     // Retrieve/free data from device.
     matrix_parallel::end_operation(results, &device_data1);
-    matrix_parallel::end_operation(inputs, &device_data2);
-    CUDA_CHECK(cudaFree(sum));
+    matrix_parallel::end_operation(derivatives, &device_data2);
+    matrix_parallel::end_operation(inputs, &device_data3);
+}
+
+void __helper_rows(const matrix &results, const matrix &derivatives, const matrix &inputs,
+                   void (kernel)(float *result, float *derivatives, float *inputs,
+                                 size_t nb_rows, size_t nb_cols))
+{
+    auto nb_blocks = std::min(results.get_dimensions().first, (size_t) ROWS_MAX_NB_BLOCKS);
+
+    float *device_data1;
+    float *device_data2;
+    float *device_data3;
+
+    // Prepare data on device.
+    matrix_parallel::start_operation(results, &device_data1);
+    matrix_parallel::start_operation(derivatives, &device_data2);
+    matrix_parallel::start_operation(inputs, &device_data3);
+    // Do computations with CUDA threads.
+    kernel<<<nb_blocks, ROWS_NB_THREADS, ROWS_NB_THREADS * sizeof(float)>>>(
+            device_data1, device_data2, device_data3,
+            results.get_dimensions().first, results.get_dimensions().second);
+    // Wait for all threads.
+    CUDA_CHECK(cudaDeviceSynchronize());
+    // Retrieve/free data from device.
+    matrix_parallel::end_operation(results, &device_data1);
+    matrix_parallel::end_operation(derivatives, &device_data2);
+    matrix_parallel::end_operation(inputs, &device_data3);
 }
 
 
@@ -388,10 +602,70 @@ void activation_functions_parallel::tanh_derivative(std::vector<matrix *> m)
 
 void activation_functions_parallel::softmax(std::vector<matrix *> m)
 {
-    __helper_softmax(*m[0], *m[1],m[1]->get_max(),__kernel_softmax);
+    __helper_rows(*m[0], *m[1], __kernel_softmax);
 }
 
 void activation_functions_parallel::softmax_derivative(std::vector<matrix *> m)
 {
-    __helper_softmax(*m[0], *m[1],m[1]->get_max(),__kernel_softmax_derivative);
-}
\ No newline at end of file
+    __helper_rows(*m[0], *m[1], __kernel_softmax_derivative);
+}
+
+void activation_functions_parallel::sigmoid_with_derivative(std::vector<matrix *> m)
+{
+    __helper(*m[0], *m[1], *m[2], __kernel_sigmoid_with_derivative);
+}
+
+void activation_functions_parallel::tanh_with_derivative(std::vector<matrix *> m)
+{
+    __helper(*m[0], *m[1], *m[2], __kernel_tanh_with_derivative);
+}
+
+void activation_functions_parallel::softmax_with_derivative(std::vector<matrix *> m)
+{
+    __helper_rows(*m[0], *m[1], *m[2], __kernel_softmax_with_derivative);
+}
+
+void activation_functions_parallel::sigmoid_fast(std::vector<matrix *> m)
+{
+    __helper(*m[0], *m[1], __kernel_sigmoid_fast);
+}
+
+void activation_functions_parallel::sigmoid_fast_derivative(std::vector<matrix *> m)
+{
+    __helper(*m[0], *m[1], __kernel_sigmoid_fast_derivative);
+}
+
+void activation_functions_parallel::sigmoid_fast_with_derivative(std::vector<matrix *> m)
+{
+    __helper(*m[0], *m[1], *m[2], __kernel_sigmoid_fast_with_derivative);
+}
+
+void activation_functions_parallel::tanh_fast(std::vector<matrix *> m)
+{
+    __helper(*m[0], *m[1], __kernel_tanh_fast);
+}
+
+void activation_functions_parallel::tanh_fast_derivative(std::vector<matrix *> m)
+{
+    __helper(*m[0], *m[1], __kernel_tanh_fast_derivative);
+}
+
+void activation_functions_parallel::tanh_fast_with_derivative(std::vector<matrix *> m)
+{
+    __helper(*m[0], *m[1], *m[2], __kernel_tanh_fast_with_derivative);
+}
+
+void activation_functions_parallel::softmax_fast(std::vector<matrix *> m)
+{
+    __helper_rows(*m[0], *m[1], __kernel_softmax_fast);
+}
+
+void activation_functions_parallel::softmax_fast_derivative(std::vector<matrix *> m)
+{
+    __helper_rows(*m[0], *m[1], __kernel_softmax_fast_derivative);
+}
+
+void activation_functions_parallel::softmax_fast_with_derivative(std::vector<matrix *> m)
+{
+    __helper_rows(*m[0], *m[1], *m[2], __kernel_softmax_fast_with_derivative);
+}
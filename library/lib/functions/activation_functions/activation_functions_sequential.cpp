@@ -3,11 +3,148 @@
 //
 
 #include "activation_functions.h"
+#include "lib/functions/approximations/approximations.h"
+#include "lib/util/parallel/parallel.h"
+
+#include <algorithm>
 
 
 using namespace cudaNN;
 
 
+namespace
+{
+    float expf_(float x)
+    {
+        return expf(x);
+    }
+
+    float tanhf_(float x)
+    {
+        return tanhf(x);
+    }
+
+    float sigmoid_(float x)
+    {
+        return 1.f / (1.f + expf(-x));
+    }
+
+    float sigmoid_derivative_(float y)
+    {
+        return y * (1.f - y);
+    }
+
+    float tanh_derivative_(float y)
+    {
+        return 1.f - y * y;
+    }
+
+    /**
+     * m[0] = f(m[1]), element-wise, over the threads.
+     */
+    template <float (*f)(float)>
+    void map(std::vector<matrix *> &m)
+    {
+        float *outputs = m[0]->get_data();
+        const float *inputs = m[1]->get_data();
+
+        parallel::for_range(m[0]->get_length(), PARALLEL_MIN_CHUNK_SIZE,
+                            [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i ++)
+            {
+                outputs[i] = f(inputs[i]);
+            }
+        });
+    }
+
+    /**
+     * m[0] = df(f(m[1])), element-wise, over the threads.
+     */
+    template <float (*f)(float), float (*df)(float)>
+    void map_derivative(std::vector<matrix *> &m)
+    {
+        float *outputs = m[0]->get_data();
+        const float *inputs = m[1]->get_data();
+
+        parallel::for_range(m[0]->get_length(), PARALLEL_MIN_CHUNK_SIZE,
+                            [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i ++)
+            {
+                outputs[i] = df(f(inputs[i]));
+            }
+        });
+    }
+
+    /**
+     * m[0] = f(m[2]) and m[1] = df(m[0]), element-wise, over the threads.
+     */
+    template <float (*f)(float), float (*df)(float)>
+    void map_with_derivative(std::vector<matrix *> &m)
+    {
+        float *outputs = m[0]->get_data();
+        float *derivatives = m[1]->get_data();
+        const float *inputs = m[2]->get_data();
+
+        parallel::for_range(m[0]->get_length(), PARALLEL_MIN_CHUNK_SIZE,
+                            [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i ++)
+            {
+                outputs[i] = f(inputs[i]);
+                derivatives[i] = df(outputs[i]);
+            }
+        });
+    }
+
+    /**
+     * Softmax of each row of m[1] into m[0]; exp(x_i - max) / sum(exp(x_j - max)).
+     * If "derivatives" is not null, it receives the diagonal of the Jacobian.
+     */
+    template <float (*exp_)(float)>
+    void softmax_(std::vector<matrix *> &m, float *outputs_, float *derivatives_)
+    {
+        auto nb_rows = m[0]->get_dimensions().first;
+        auto nb_cols = m[0]->get_dimensions().second;
+        const float *inputs_ = m[m.size() - 1]->get_data();
+        size_t min_nb_rows = std::max((size_t) 1, PARALLEL_MIN_CHUNK_SIZE / std::max((size_t) 1, nb_cols));
+
+        parallel::for_range(nb_rows, min_nb_rows, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i ++)
+            {
+                const float *inputs = inputs_ + i * nb_cols;
+                float *outputs = outputs_ + i * nb_cols;
+                float max = reduction::reduce(inputs, nb_cols, 1, MAXIMUM).value;
+
+                for (size_t j = 0; j < nb_cols; j ++)
+                {
+                    outputs[j] = exp_(inputs[j] - max);
+                }
+
+                float inverse = 1.f / reduction::reduce(outputs, nb_cols, 1, SUM).value;
+
+                for (size_t j = 0; j < nb_cols; j ++)
+                {
+                    outputs[j] *= inverse;
+                }
+
+                if (derivatives_ != nullptr)
+                {
+                    float *derivatives = derivatives_ + i * nb_cols;
+
+                    for (size_t j = 0; j < nb_cols; j ++)
+                    {
+                        derivatives[j] = outputs[j] * (1.f - outputs[j]);
+                    }
+                }
+            }
+        });
+    }
+}
+
+
 void activation_functions_sequential::linear(std::vector<matrix *> m)
 {
     for (size_t i = 0; i < m[0]->get_length(); i ++)
@@ -42,19 +179,12 @@ void activation_functions_sequential::binary_step_derivative(std::vector<matrix
 
 void activation_functions_sequential::sigmoid(std::vector<matrix *> m)
 {
-    for (size_t i = 0; i < m[0]->get_length(); i ++)
-    {
-        m[0]->get_data()[i] = 1.f / (1.f + expf(-m[1]->get_data()[i]));
-    }
+    map<sigmoid_>(m);
 }
 
 void activation_functions_sequential::sigmoid_derivative(std::vector<matrix *> m)
 {
-    for (size_t i = 0; i < m[0]->get_length(); i ++)
-    {
-        float sigmoid = 1.f / (1.f + expf(-m[1]->get_data()[i]));
-        m[0]->get_data()[i] = sigmoid * (1.f - sigmoid);
-    }
+    map_derivative<sigmoid_, sigmoid_derivative_>(m);
 }
 
 void activation_functions_sequential::relu(std::vector<matrix *> m)
@@ -75,54 +205,84 @@ void activation_functions_sequential::relu_derivative(std::vector<matrix *> m)
 
 void activation_functions_sequential::tanh(std::vector<matrix *> m)
 {
-    for (size_t i = 0; i < m[0]->get_length(); i ++)
-    {
-        m[0]->get_data()[i] = tanhf(m[1]->get_data()[i]);
-    }
+    map<tanhf_>(m);
 }
 
 void activation_functions_sequential::tanh_derivative(std::vector<matrix *> m)
 {
-    for (size_t i = 0; i < m[0]->get_length(); i ++)
-    {
-        float tanh_ = tanhf(m[1]->get_data()[i]);
-        m[0]->get_data()[i] = 1.f - tanh_ * tanh_;
-    }
+    map_derivative<tanhf_, tanh_derivative_>(m);
 }
 
 void activation_functions_sequential::softmax(std::vector<matrix *> m)
 {
-    float sum = 0.f;
+    softmax_<expf_>(m, m[0]->get_data(), nullptr);
+}
 
-    for (size_t i = 0; i < m[0]->get_length(); i ++)
-    {
-        sum += expf(m[1]->get_data()[i] - m[1]->get_max());
-    }
+void activation_functions_sequential::softmax_derivative(std::vector<matrix *> m)
+{
+    // Diagonal of the Jacobian.
+    auto outputs = matrix(m[0]->get_dimensions(), "softmax");
+    softmax_<expf_>(m, outputs.get_data(), m[0]->get_data());
+}
 
-    for (size_t i = 0; i < m[0]->get_length(); i ++)
-    {
-        m[0]->get_data()[i] = expf(m[1]->get_data()[i]) / sum;
-    }
+void activation_functions_sequential::sigmoid_with_derivative(std::vector<matrix *> m)
+{
+    map_with_derivative<sigmoid_, sigmoid_derivative_>(m);
 }
 
-void activation_functions_sequential::softmax_derivative(std::vector<matrix *> m)
+void activation_functions_sequential::tanh_with_derivative(std::vector<matrix *> m)
 {
-    float sum = m[1]->sum();
+    map_with_derivative<tanhf_, tanh_derivative_>(m);
+}
 
-    for (size_t i = 0; i < m[0]->get_length(); i ++)
-    {
-        size_t row = i / m[0]->get_dimensions().second;
-        size_t col = i % m[0]->get_dimensions().second;
-        float softmax_x = expf(m[1]->get_data()[row]) / sum;
-        float softmax_y = expf(m[1]->get_data()[col]) / sum;
+void activation_functions_sequential::softmax_with_derivative(std::vector<matrix *> m)
+{
+    softmax_<expf_>(m, m[0]->get_data(), m[1]->get_data());
+}
 
-        if (row == col)
-        {
-            m[0]->get_data()[i] = softmax_x * (1 - softmax_x);
-        }
-        else
-        {
-            m[0]->get_data()[i] = -softmax_x * softmax_y;
-        }
-    }
-}
\ No newline at end of file
+void activation_functions_sequential::sigmoid_fast(std::vector<matrix *> m)
+{
+    map<approximations::sigmoid>(m);
+}
+
+void activation_functions_sequential::sigmoid_fast_derivative(std::vector<matrix *> m)
+{
+    map_derivative<approximations::sigmoid, sigmoid_derivative_>(m);
+}
+
+void activation_functions_sequential::sigmoid_fast_with_derivative(std::vector<matrix *> m)
+{
+    map_with_derivative<approximations::sigmoid, sigmoid_derivative_>(m);
+}
+
+void activation_functions_sequential::tanh_fast(std::vector<matrix *> m)
+{
+    map<approximations::tanh>(m);
+}
+
+void activation_functions_sequential::tanh_fast_derivative(std::vector<matrix *> m)
+{
+    map_derivative<approximations::tanh, tanh_derivative_>(m);
+}
+
+void activation_functions_sequential::tanh_fast_with_derivative(std::vector<matrix *> m)
+{
+    map_with_derivative<approximations::tanh, tanh_derivative_>(m);
+}
+
+void activation_functions_sequential::softmax_fast(std::vector<matrix *> m)
+{
+    softmax_<approximations::exp>(m, m[0]->get_data(), nullptr);
+}
+
+void activation_functions_sequential::softmax_fast_derivative(std::vector<matrix *> m)
+{
+    // Diagonal of the Jacobian.
+    auto outputs = matrix(m[0]->get_dimensions(), "softmax_fast");
+    softmax_<approximations::exp>(m, outputs.get_data(), m[0]->get_data());
+}
+
+void activation_functions_sequential::softmax_fast_with_derivative(std::vector<matrix *> m)
+{
+    softmax_<approximations::exp>(m, m[0]->get_data(), m[1]->get_data());
+}
@@ -0,0 +1,88 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#ifndef CUDANN_APPROXIMATIONS_H
+#define CUDANN_APPROXIMATIONS_H
+
+#include <cstdint>
+#include <cstring>
+
+
+namespace cudaNN
+{
+    /**
+     * Fast approximations of transcendental functions on host.
+     * They are branch-free (inlined in loops, they can be vectorized),
+     * and their error has been measured on every float of the given
+     * ranges, against the correctly rounded result (in ULP; units in
+     * the last place).
+     */
+    namespace approximations
+    {
+        /**
+         * Error of at most 1 ULP for x in [-87.3, 88.72] (normal, finite
+         * results). Saturates to exp(-87.3) and exp(88.72) outside of this
+         * range.
+         * The input is split as x = n * ln(2) + r, with |r| <= ln(2) / 2;
+         * exp(r) is computed with a polynomial of degree 7, and 2^n
+         * by building the exponents of two floats (2^(n - n / 2) * 2^(n / 2):
+         * n reaches 128 near the largest float, whose exponent alone would
+         * be infinite).
+         */
+        inline float exp(float x)
+        {
+            x = x < -87.3f ? -87.3f : (x > 88.72f ? 88.72f : x);
+            // n = round(x / ln(2)) (adding 1.5 * 2^23 rounds to an integer).
+            float n = (x * 1.44269504089f + 12582912.f) - 12582912.f;
+            // r = x - n * ln(2), with ln(2) in two parts (exact product).
+            float r = x - n * 0.693359375f;
+            r = r + n * 2.12194440e-4f;
+            float p = 1.9875691500e-4f;
+            p = p * r + 1.3981999507e-3f;
+            p = p * r + 8.3334519073e-3f;
+            p = p * r + 4.1665795894e-2f;
+            p = p * r + 1.6666665459e-1f;
+            p = p * r + 5.0000001201e-1f;
+            p = p * r * r + r + 1.f;
+            // 2^n, in two halves.
+            int32_t half = (int32_t) n / 2;
+            int32_t bits = ((int32_t) n - half + 127) << 23;
+            int32_t half_bits = (half + 127) << 23;
+            float scale, half_scale;
+            std::memcpy(&scale, &bits, sizeof(float));
+            std::memcpy(&half_scale, &half_bits, sizeof(float));
+
+            return p * scale * half_scale;
+        }
+
+        /**
+         * Error of at most 2 ULP for x in [-80, 80].
+         */
+        inline float sigmoid(float x)
+        {
+            return 1.f / (1.f + exp(-x));
+        }
+
+        /**
+         * Error of at most 1 ULP for x in [-80, 80].
+         * An odd polynomial is used near 0 (where 1 - 2 / (exp(2x) + 1)
+         * loses precision), both results are computed then selected.
+         */
+        inline float tanh(float x)
+        {
+            float abs = x < 0.f ? -x : x;
+            float z = x * x;
+            float small = ((((-5.70498872745e-3f * z + 2.06390887954e-2f) * z
+                             - 5.37397155531e-2f) * z + 1.33314422036e-1f) * z
+                           - 3.33332819422e-1f) * z * x + x;
+            float large = 1.f - 2.f / (exp(2.f * abs) + 1.f);
+            large = x < 0.f ? -large : large;
+
+            return abs < 0.625f ? small : large;
+        }
+    }
+}
+
+
+#endif //CUDANN_APPROXIMATIONS_H
\ No newline at end of file
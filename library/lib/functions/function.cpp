@@ -5,20 +5,26 @@
 #include "function.h"
 #include "lib/functions/activation_functions/activation_functions.h"
 #include "lib/functions/loss_functions/loss_functions.h"
+#include "lib/util/profiler/profiler.h"
+#include "lib/util/statistics/statistics.h"
 
 
 using namespace cudaNN;
 
 
-function::function(std::string id, function_t f, function_t df):
+function::function(std::string id, function_t f, function_t df, function_t fdf /*= nullptr*/):
         _id(std::move(id)),
         _f(f),
-        _df(df)
+        _df(df),
+        _fdf(fdf)
 {
 }
 
 matrix function::compute(std::vector<matrix *> inputs) const
 {
+    PROFILE_SCOPE("function", _id, inputs[0]->get_dimensions().first, inputs[0]->get_dimensions().second);
+    COUNT_OPERATION(statistics::FUNCTION, inputs[0]->get_length(),
+                    (double) (inputs.size() + 1) * (double) (inputs[0]->get_length() * sizeof(float)));
     auto outputs = matrix(inputs[0]->get_dimensions(),
                           "function::" + _id + "("
                           + inputs[0]->get_id() + ")");
@@ -30,25 +36,43 @@ matrix function::compute(std::vector<matrix *> inputs) const
 
 matrix function::compute_derivatives(std::vector<matrix *> inputs) const
 {
-    matrix outputs;
-    if(_id == "softmax")
-    {
-        outputs = matrix(std::pair<size_t, size_t>(inputs[0]->get_dimensions().second,inputs[0]->get_dimensions().second),
-                              "function::" + _id + "_derivative("
-                              + inputs[0]->get_id() + ")");
-    }
-    else
-    {
-        outputs = matrix(inputs[0]->get_dimensions(),
-                              "function::" + _id + "_derivative("
-                              + inputs[0]->get_id() + ")");
-    }
+    PROFILE_SCOPE("function derivative", _id, inputs[0]->get_dimensions().first, inputs[0]->get_dimensions().second);
+    COUNT_OPERATION(statistics::FUNCTION_DERIVATIVE, inputs[0]->get_length(),
+                    (double) (inputs.size() + 1) * (double) (inputs[0]->get_length() * sizeof(float)));
+    auto outputs = matrix(inputs[0]->get_dimensions(),
+                          "function::" + _id + "_derivative("
+                          + inputs[0]->get_id() + ")");
     inputs.insert(inputs.begin(), &outputs);
     _df(inputs);
 
     return outputs;
 }
 
+matrix function::compute_with_derivatives(std::vector<matrix *> inputs,
+                                          matrix &derivatives) const
+{
+    if (_fdf == nullptr)
+    {
+        derivatives = compute_derivatives(inputs);
+        return compute(inputs);
+    }
+
+    PROFILE_SCOPE("function with derivative", _id,
+                  inputs[0]->get_dimensions().first, inputs[0]->get_dimensions().second);
+    COUNT_OPERATION(statistics::FUNCTION_WITH_DERIVATIVE, inputs[0]->get_length(),
+                    (double) (inputs.size() + 2) * (double) (inputs[0]->get_length() * sizeof(float)));
+    auto outputs = matrix(inputs[0]->get_dimensions(),
+                          "function::" + _id + "("
+                          + inputs[0]->get_id() + ")");
+    derivatives = matrix(inputs[0]->get_dimensions(),
+                         "function::" + _id + "_derivative("
+                         + inputs[0]->get_id() + ")");
+    inputs.insert(inputs.begin(), { &outputs, &derivatives });
+    _fdf(inputs);
+
+    return outputs;
+}
+
 std::string function::get_id() const
 {
     return _id;
@@ -19,12 +19,15 @@ namespace cudaNN
      * Abstract wrapper to execute a function or its derivative on matrices.
      * The wrapped functions should be of the form "function_t", such that
      * the first matrix is the output (results), and the following the parameters.
+     * A function may also wrap "_fdf", computing both the outputs and the
+     * derivatives in one pass (the first two matrices are the outputs); the
+     * derivatives are then obtained from the outputs, without recomputation.
      */
     class function
     {
         public:
 
-            function(std::string id, function_t f, function_t df);
+            function(std::string id, function_t f, function_t df, function_t fdf = nullptr);
 
             /**
              * @param inputs - the matrices to be used for computation.
@@ -38,6 +41,14 @@ namespace cudaNN
              */
             matrix compute_derivatives(std::vector<matrix *> inputs) const;
 
+            /**
+             * @param inputs - the matrices to be used for computation.
+             * @param derivatives - receives the result of the derivative "_df" on "inputs".
+             * @return - the result of the function "_f" on "inputs".
+             */
+            matrix compute_with_derivatives(std::vector<matrix *> inputs,
+                                            matrix &derivatives) const;
+
             std::string get_id() const;
 
         private:
@@ -45,6 +56,7 @@ namespace cudaNN
             const std::string _id;
             const function_t _f;
             const function_t _df;
+            const function_t _fdf;
     };
 }
 
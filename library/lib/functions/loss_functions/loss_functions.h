@@ -28,6 +28,9 @@ namespace cudaNN
         void binary_cross_entropy_loss_derivative(std::vector<matrix *> m);
         void cross_entropy_loss(std::vector<matrix *> m);
         void cross_entropy_loss_derivative(std::vector<matrix *> m);
+        void softmax_cross_entropy_loss(std::vector<matrix *> m);
+        void softmax_cross_entropy_loss_derivative(std::vector<matrix *> m);
+        void softmax_cross_entropy_loss_with_derivative(std::vector<matrix *> m);
     }
 
 
@@ -48,6 +51,9 @@ namespace cudaNN
         void binary_cross_entropy_loss_derivative(std::vector<matrix *> m);
         void cross_entropy_loss(std::vector<matrix *> m);
         void cross_entropy_loss_derivative(std::vector<matrix *> m);
+        void softmax_cross_entropy_loss(std::vector<matrix *> m);
+        void softmax_cross_entropy_loss_derivative(std::vector<matrix *> m);
+        void softmax_cross_entropy_loss_with_derivative(std::vector<matrix *> m);
     }
 
 
@@ -118,10 +124,26 @@ namespace cudaNN
          * Measure the performance of a classification model whose output
          * is a probability value between 0 and 1.
          * Increase as the predicted probability diverges from the actual label.
+         * The value is "-sum(y * log(p))" (over the whole matrix), the
+         * derivative "-y / p".
          */
         const auto CROSS_ENTROPY_LOSS = function("cross_entropy_loss",
                                                  cross_entropy_loss,
                                                  cross_entropy_loss_derivative);
+
+        /**
+         * For classification.
+         * Softmax followed by the cross entropy, fused; the predictions are
+         * the raw scores (logits) of a LINEAR output layer. Computed on each
+         * row with a log-sum-exp (stable for large scores), in linear time.
+         * The derivative is "softmax(predictions) - labels" (the Jacobian
+         * of the softmax is never built). Both can be computed in one
+         * pass (see function::compute_with_derivatives).
+         */
+        const auto SOFTMAX_CROSS_ENTROPY_LOSS = function("softmax_cross_entropy_loss",
+                                                         softmax_cross_entropy_loss,
+                                                         softmax_cross_entropy_loss_derivative,
+                                                         softmax_cross_entropy_loss_with_derivative);
     }
 }
 
@@ -7,6 +7,13 @@
 
 using namespace cudaNN;
 
+/**
+ * Kernels working on rows: number of threads per block (power of 2),
+ * and maximal number of blocks.
+ */
+#define ROWS_NB_THREADS 256
+#define ROWS_MAX_NB_BLOCKS 1024
+
 
 /**
  * Kernel functions.
@@ -210,9 +217,9 @@ __global__ void __kernel_hinge_loss_derivative(float *errors,
     {
         for (size_t i = 0; i < nb_rows; i ++)
         {
-            // TODO check if correct definition.
-            errors[nb_cols * i + col] = predictions[nb_cols * i + col] > 1.f ?
-                                        0.f : -labels[nb_cols * i + col] * 1.f;
+            // No gradient once the margin is reached (label * prediction >= 1).
+            errors[nb_cols * i + col] = labels[nb_cols * i + col] * predictions[nb_cols * i + col] < 1.f ?
+                                        -labels[nb_cols * i + col] : 0.f;
         }
     }
 }
@@ -318,9 +325,146 @@ __global__ void __kernel_cross_entropy_loss_derivative(float *errors,
         for (size_t i = 0; i < nb_rows; i ++)
         {
             errors[nb_cols * i + col] = -(labels[nb_cols * i + col]
-                                          / predictions[nb_cols * i + col])
-                                        + ((1.f - labels[nb_cols * i + col])
-                                           / (1.f - predictions[nb_cols * i + col]));
+                                          / predictions[nb_cols * i + col]);
+        }
+    }
+}
+
+/**
+ * Reduce the values of the threads of the block (sum or max).
+ * @return - the result, to every thread of the block.
+ */
+static __device__ float __block_reduce(float value, float *shared, bool is_max)
+{
+    shared[threadIdx.x] = value;
+
+    __syncthreads();
+
+    for (size_t stride = blockDim.x / 2; stride > 0; stride >>= 1)
+    {
+        if (threadIdx.x < stride)
+        {
+            shared[threadIdx.x] = is_max ? fmaxf(shared[threadIdx.x], shared[threadIdx.x + stride])
+                                         : shared[threadIdx.x] + shared[threadIdx.x + stride];
+        }
+
+        __syncthreads();
+    }
+
+    float result = shared[0];
+
+    __syncthreads();
+
+    return result;
+}
+
+/**
+ * @return - log(sum(exp(x_i))) of the row, to every thread of the block.
+ */
+static __device__ float __block_log_sum_exp(const float *x, size_t nb_cols, float *shared)
+{
+    float max = -INFINITY;
+    float sum = 0.f;
+
+    for (size_t col = threadIdx.x; col < nb_cols; col += blockDim.x)
+    {
+        max = fmaxf(max, x[col]);
+    }
+
+    max = __block_reduce(max, shared, true);
+
+    for (size_t col = threadIdx.x; col < nb_cols; col += blockDim.x)
+    {
+        sum += expf(x[col] - max);
+    }
+
+    return max + logf(__block_reduce(sum, shared, false));
+}
+
+__global__ void __kernel_softmax_cross_entropy_loss(float *errors,
+                                                    float *predictions, float *labels,
+                                                    size_t nb_rows, size_t nb_cols)
+{
+    extern __shared__ float shared[];
+
+    // One block per row.
+    for (size_t row = blockIdx.x; row < nb_rows; row += gridDim.x)
+    {
+        float *x = predictions + row * nb_cols;
+        float *y = labels + row * nb_cols;
+        float log_sum_exp = __block_log_sum_exp(x, nb_cols, shared);
+        float loss = 0.f;
+
+        for (size_t col = threadIdx.x; col < nb_cols; col += blockDim.x)
+        {
+            loss += y[col] * (log_sum_exp - x[col]);
+        }
+
+        loss = __block_reduce(loss, shared, false);
+
+        for (size_t col = threadIdx.x; col < nb_cols; col += blockDim.x)
+        {
+            errors[row * nb_cols + col] = loss;
+        }
+    }
+}
+
+__global__ void __kernel_softmax_cross_entropy_loss_derivative(float *errors,
+                                                               float *predictions, float *labels,
+                                                               size_t nb_rows, size_t nb_cols)
+{
+    extern __shared__ float shared[];
+
+    // One block per row.
+    for (size_t row = blockIdx.x; row < nb_rows; row += gridDim.x)
+    {
+        float *x = predictions + row * nb_cols;
+        float *y = labels + row * nb_cols;
+        float log_sum_exp = __block_log_sum_exp(x, nb_cols, shared);
+        float sum_labels = 0.f;
+
+        for (size_t col = threadIdx.x; col < nb_cols; col += blockDim.x)
+        {
+            sum_labels += y[col];
+        }
+
+        sum_labels = __block_reduce(sum_labels, shared, false);
+
+        for (size_t col = threadIdx.x; col < nb_cols; col += blockDim.x)
+        {
+            errors[row * nb_cols + col] = sum_labels * expf(x[col] - log_sum_exp) - y[col];
+        }
+    }
+}
+
+__global__ void __kernel_softmax_cross_entropy_loss_with_derivative(float *errors, float *derivatives,
+                                                                    float *predictions, float *labels,
+                                                                    size_t nb_rows, size_t nb_cols)
+{
+    extern __shared__ float shared[];
+
+    // One block per row.
+    for (size_t row = blockIdx.x; row < nb_rows; row += gridDim.x)
+    {
+        float *x = predictions + row * nb_cols;
+        float *y = labels + row * nb_cols;
+        float log_sum_exp = __block_log_sum_exp(x, nb_cols, shared);
+        float loss = 0.f;
+        float sum_labels = 0.f;
+
+        for (size_t col = threadIdx.x; col < nb_cols; col += blockDim.x)
+        {
+            loss += y[col] * (log_sum_exp - x[col]);
+            sum_labels += y[col];
+        }
+
+        loss = __block_reduce(loss, shared, false);
+        sum_labels = __block_reduce(sum_labels, shared, false);
+
+        for (size_t col = threadIdx.x; col < nb_cols; col += blockDim.x)
+        {
+            errors[row * nb_cols + col] = loss;
+            derivatives[row * nb_cols + col] = sum_labels * expf(x[col] - log_sum_exp) - y[col];
         }
     }
 }
@@ -401,6 +545,74 @@ void __helper_reduction(const matrix &errors,
 }
 
 
+/**
+ * Launch a kernel processing each row of the matrices with a block.
+ */
+void __helper_rows(const matrix &errors,
+                   const matrix &predictions, const matrix &labels,
+                   void (kernel)(float *errors, float *predictions, float *labels,
+                                 size_t nb_rows, size_t nb_cols))
+{
+    auto nb_blocks = std::min(errors.get_dimensions().first, (size_t) ROWS_MAX_NB_BLOCKS);
+
+    float *device_data0;
+    float *device_data1;
+    float *device_data2;
+
+    // Prepare data on device.
+    matrix_parallel::start_operation(errors, &device_data0);
+    matrix_parallel::start_operation(predictions, &device_data1);
+    matrix_parallel::start_operation(labels, &device_data2);
+    // Do computations with CUDA threads.
+    kernel<<<nb_blocks, ROWS_NB_THREADS, ROWS_NB_THREADS * sizeof(float)>>>(
+            device_data0,
+            device_data1, device_data2,
+            errors.get_dimensions().first, errors.get_dimensions().second);
+    // Wait for all threads.
+    CUDA_CHECK(cudaDeviceSynchronize());
+    // Retrieve/free data from device.
+    matrix_parallel::end_operation(errors, &device_data0);
+    matrix_parallel::end_operation(predictions, &device_data1);
+    matrix_parallel::end_operation(labels, &device_data2);
+}
+
+/**
+ * Launch a kernel processing each row of the matrices with a block,
+ * computing both the errors and their derivatives.
+ */
+void __helper_rows(const matrix &errors, const matrix &derivatives,
+                   const matrix &predictions, const matrix &labels,
+                   void (kernel)(float *errors, float *derivatives,
+                                 float *predictions, float *labels,
+                                 size_t nb_rows, size_t nb_cols))
+{
+    auto nb_blocks = std::min(errors.get_dimensions().first, (size_t) ROWS_MAX_NB_BLOCKS);
+
+    float *device_data0;
+    float *device_data1;
+    float *device_data2;
+    float *device_data3;
+
+    // Prepare data on device.
+    matrix_parallel::start_operation(errors, &device_data0);
+    matrix_parallel::start_operation(derivatives, &device_data1);
+    matrix_parallel::start_operation(predictions, &device_data2);
+    matrix_parallel::start_operation(labels, &device_data3);
+    // Do computations with CUDA threads.
+    kernel<<<nb_blocks, ROWS_NB_THREADS, ROWS_NB_THREADS * sizeof(float)>>>(
+            device_data0, device_data1,
+            device_data2, device_data3,
+            errors.get_dimensions().first, errors.get_dimensions().second);
+    // Wait for all threads.
+    CUDA_CHECK(cudaDeviceSynchronize());
+    // Retrieve/free data from device.
+    matrix_parallel::end_operation(errors, &device_data0);
+    matrix_parallel::end_operation(derivatives, &device_data1);
+    matrix_parallel::end_operation(predictions, &device_data2);
+    matrix_parallel::end_operation(labels, &device_data3);
+}
+
+
 /**
  * Wrappers for call on host.
  */
@@ -464,4 +676,19 @@ void loss_functions_parallel::cross_entropy_loss(std::vector<matrix *> m)
 void loss_functions_parallel::cross_entropy_loss_derivative(std::vector<matrix *> m)
 {
     __helper(*m[0], *m[1], *m[2], __kernel_cross_entropy_loss_derivative);
+}
+
+void loss_functions_parallel::softmax_cross_entropy_loss(std::vector<matrix *> m)
+{
+    __helper_rows(*m[0], *m[1], *m[2], __kernel_softmax_cross_entropy_loss);
+}
+
+void loss_functions_parallel::softmax_cross_entropy_loss_derivative(std::vector<matrix *> m)
+{
+    __helper_rows(*m[0], *m[1], *m[2], __kernel_softmax_cross_entropy_loss_derivative);
+}
+
+void loss_functions_parallel::softmax_cross_entropy_loss_with_derivative(std::vector<matrix *> m)
+{
+    __helper_rows(*m[0], *m[1], *m[2], *m[3], __kernel_softmax_cross_entropy_loss_with_derivative);
 }
\ No newline at end of file
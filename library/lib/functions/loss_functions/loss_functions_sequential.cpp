@@ -70,7 +70,9 @@ void loss_functions_sequential::hinge_loss_derivative(std::vector<matrix *> m)
 {
     for (size_t i = 0; i < m[0]->get_length(); i ++)
     {
-        m[0]->get_data()[i] = m[1]->get_data()[i] > 1.f ? 0.f : -m[2]->get_data()[i] * 1.f; // TODO check
+        // No gradient once the margin is reached (label * prediction >= 1).
+        m[0]->get_data()[i] = m[2]->get_data()[i] * m[1]->get_data()[i] < 1.f ?
+                              -m[2]->get_data()[i] : 0.f;
     }
 }
 
@@ -111,7 +113,73 @@ void loss_functions_sequential::cross_entropy_loss_derivative(std::vector<matrix
 {
     for (size_t i = 0; i < m[0]->get_length(); i ++)
     {
-        m[0]->get_data()[i] = -(m[2]->get_data()[i] / m[1]->get_data()[i])
-                + ((1.f - m[2]->get_data()[i]) / (1.f - m[1]->get_data()[i]));
+        m[0]->get_data()[i] = -(m[2]->get_data()[i] / m[1]->get_data()[i]);
+    }
+}
+
+void loss_functions_sequential::softmax_cross_entropy_loss(std::vector<matrix *> m)
+{
+    auto nb_cols = m[0]->get_dimensions().second;
+
+    // For each row; sum(y_i * (log(sum(exp(x_j))) - x_i)).
+    for (size_t i = 0; i < m[0]->get_dimensions().first; i ++)
+    {
+        const float *predictions = m[1]->get_data() + i * nb_cols;
+        const float *labels = m[2]->get_data() + i * nb_cols;
+        float *errors = m[0]->get_data() + i * nb_cols;
+        float log_sum_exp = reduction::log_sum_exp(predictions, nb_cols);
+        float loss = 0.f;
+
+        for (size_t j = 0; j < nb_cols; j ++)
+        {
+            loss += labels[j] * (log_sum_exp - predictions[j]);
+        }
+
+        std::fill(errors, errors + nb_cols, loss);
+    }
+}
+
+void loss_functions_sequential::softmax_cross_entropy_loss_derivative(std::vector<matrix *> m)
+{
+    auto nb_cols = m[0]->get_dimensions().second;
+
+    // For each row; sum(y) * softmax(x_i) - y_i.
+    for (size_t i = 0; i < m[0]->get_dimensions().first; i ++)
+    {
+        const float *predictions = m[1]->get_data() + i * nb_cols;
+        const float *labels = m[2]->get_data() + i * nb_cols;
+        float *errors = m[0]->get_data() + i * nb_cols;
+        float log_sum_exp = reduction::log_sum_exp(predictions, nb_cols);
+        float sum_labels = reduction::reduce(labels, nb_cols, 1, SUM).value;
+
+        for (size_t j = 0; j < nb_cols; j ++)
+        {
+            errors[j] = sum_labels * expf(predictions[j] - log_sum_exp) - labels[j];
+        }
+    }
+}
+
+void loss_functions_sequential::softmax_cross_entropy_loss_with_derivative(std::vector<matrix *> m)
+{
+    auto nb_cols = m[0]->get_dimensions().second;
+
+    // For each row, with a single log-sum-exp.
+    for (size_t i = 0; i < m[0]->get_dimensions().first; i ++)
+    {
+        const float *predictions = m[2]->get_data() + i * nb_cols;
+        const float *labels = m[3]->get_data() + i * nb_cols;
+        float *errors = m[0]->get_data() + i * nb_cols;
+        float *derivatives = m[1]->get_data() + i * nb_cols;
+        float log_sum_exp = reduction::log_sum_exp(predictions, nb_cols);
+        float sum_labels = reduction::reduce(labels, nb_cols, 1, SUM).value;
+        float loss = 0.f;
+
+        for (size_t j = 0; j < nb_cols; j ++)
+        {
+            loss += labels[j] * (log_sum_exp - predictions[j]);
+            derivatives[j] = sum_labels * expf(predictions[j] - log_sum_exp) - labels[j];
+        }
+
+        std::fill(errors, errors + nb_cols, loss);
     }
 }
\ No newline at end of file
@@ -23,5 +23,29 @@
  */
 #define MAX_NB_THREADS_BLOCK 1024
 
+/**
+ * Number of threads used for the computations on host
+ * (0 to use every hardware thread).
+ */
+#define _NB_THREADS 0
+
+/**
+ * Do the reductions on host in a fixed order, such that the
+ * results are bit-reproducible whatever the number of threads.
+ */
+#define _DETERMINISTIC false
+
+/**
+ * Record the operations (matrices, functions, layers and training)
+ * with "lib/util/profiler" (no cost if not set).
+ */
+#define _PROFILE false
+
+/**
+ * Count the operations and the allocations of the matrices
+ * with "lib/util/statistics" (no cost if not set).
+ */
+#define _STATISTICS false
+
 
 #endif //CUDANN_GLOBAL_H
\ No newline at end of file
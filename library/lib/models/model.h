@@ -30,7 +30,7 @@ namespace cudaNN
              * @param print_loss - if set to true, the loss is printed in a file, and in the
              * console.
              * @param delta_loss - if "print_loss"; the number of entries processed before
-             * printing the loss.
+             * printing the loss (the mean loss of these entries).
              */
             virtual void fit(dataset &data,
                              const function &loss_function,
@@ -0,0 +1,121 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "initializers.h"
+#include "lib/util/parallel/parallel.h"
+#include "lib/util/profiler/profiler.h"
+#include "lib/util/util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+using namespace cudaNN;
+
+
+namespace
+{
+    /**
+     * Orthonormalize the "nb_vectors" rows of "vectors" (of "length" values,
+     * "nb_vectors <= length"), in place: modified Gram-Schmidt, the projections
+     * on a vector removed from the next ones over the threads.
+     */
+    void orthonormalize(float *vectors, size_t nb_vectors, size_t length)
+    {
+        for (size_t i = 0; i < nb_vectors; i ++)
+        {
+            float *v = vectors + i * length;
+            double norm = 0.;
+
+            for (size_t k = 0; k < length; k ++)
+            {
+                norm += (double) v[k] * v[k];
+            }
+
+            auto inverse = (float) (1. / std::sqrt(norm));
+
+            for (size_t k = 0; k < length; k ++)
+            {
+                v[k] *= inverse;
+            }
+
+            parallel::for_range(nb_vectors - i - 1, std::max((size_t) 1, (size_t) PARALLEL_MIN_CHUNK_SIZE / length),
+                                [&](size_t begin, size_t end)
+            {
+                for (size_t j = i + 1 + begin; j < i + 1 + end; j ++)
+                {
+                    float *w = vectors + j * length;
+                    float projection = 0.f;
+
+                    for (size_t k = 0; k < length; k ++)
+                    {
+                        projection += v[k] * w[k];
+                    }
+
+                    for (size_t k = 0; k < length; k ++)
+                    {
+                        w[k] -= projection * v[k];
+                    }
+                }
+            });
+        }
+    }
+}
+
+
+void initializers::initialize(matrix &weights, initializations init, size_t fan_in, float scale /*= 1.f*/)
+{
+    initialize(weights, init, fan_in, scale, rng::get_key(), rng::next_counter());
+}
+
+void initializers::initialize(matrix &weights, initializations init, size_t fan_in, float scale,
+                              rng::key k, rng::counter first)
+{
+    auto nb_rows = weights.get_dimensions().first;
+    auto nb_columns = weights.get_dimensions().second;
+    PROFILE_SCOPE("initializers", "initialize", nb_rows, nb_columns);
+    auto variance = (init == initializations::HE || init == initializations::HE_UNIFORM ? 2.f : 1.f)
+                    / (float) std::max((size_t) 1, fan_in);
+
+    switch (init)
+    {
+        case initializations::XAVIER:
+        case initializations::HE:
+            rng::normal(weights.get_data(), weights.get_length(), 0.f, scale * std::sqrt(variance), k, first);
+            break;
+        case initializations::XAVIER_UNIFORM:
+        case initializations::HE_UNIFORM:
+        {
+            // The variance of "U(-a, a)" is "a^2 / 3".
+            auto limit = scale * std::sqrt(3.f * variance);
+            rng::uniform(weights.get_data(), weights.get_length(), - limit, limit, k, first);
+            break;
+        }
+        case initializations::ORTHOGONAL:
+        {
+            // Orthonormal vectors of the larger dimension: the rows, or the
+            // columns (transposed).
+            auto nb_vectors = std::min(nb_rows, nb_columns);
+            auto length = std::max(nb_rows, nb_columns);
+            auto vectors = std::vector<float>(nb_vectors * length);
+            rng::normal(vectors.data(), vectors.size(), 0.f, 1.f, k, first);
+            orthonormalize(vectors.data(), nb_vectors, length);
+
+            for (size_t i = 0; i < nb_rows; i ++)
+            {
+                for (size_t j = 0; j < nb_columns; j ++)
+                {
+                    weights[(int) (i * nb_columns + j)] = scale * (nb_rows < nb_columns ? vectors[i * length + j]
+                                                                                        : vectors[j * length + i]);
+                }
+            }
+            break;
+        }
+        default:
+            // Invalid.
+            util::ERROR("initializers::initialize", "Invalid @init");
+            util::ERROR_EXIT();
+    }
+}
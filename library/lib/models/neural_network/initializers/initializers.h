@@ -0,0 +1,61 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#ifndef CUDANN_INITIALIZERS_H
+#define CUDANN_INITIALIZERS_H
+
+#include "lib/data_structures/matrix/matrix.h"
+#include "lib/util/rng/rng.h"
+
+#include <cstddef>
+
+
+namespace cudaNN
+{
+    /**
+     * Layer weights type of initialization ("fan_in" the number of inputs of
+     * each output).
+     * @XAVIER - for tanh activation: normal, of variance "1 / fan_in".
+     * @HE - for RELU activation: normal, of variance "2 / fan_in".
+     * @XAVIER_UNIFORM, @HE_UNIFORM - uniform, of the same variances.
+     * @ORTHOGONAL - orthonormal rows (or columns, the smaller number of the
+     * two), e.g. for recurrent weights.
+     */
+    enum initializations
+    {
+        XAVIER,
+        HE,
+        XAVIER_UNIFORM,
+        HE_UNIFORM,
+        ORTHOGONAL
+    };
+
+
+    /**
+     * Initializations of the weights, from the counter-based random numbers of
+     * the seed of the library (see -rng.h-): generated over the threads, the
+     * weights only depend on the seed and on the order of the initializations
+     * (not on the number of threads).
+     */
+    namespace initializers
+    {
+        /**
+         * Initialize "weights" with the next sequence of the seed of the library
+         * (see "rng::set_seed").
+         * @param fan_in - the number of inputs of each output.
+         * @param scale - multiplies the weights (e.g. to reduce the ones of the
+         * residual branches).
+         */
+        void initialize(matrix &weights, initializations init, size_t fan_in, float scale = 1.f);
+
+        /**
+         * Initialize "weights" with the sequence starting at "first" of "k".
+         */
+        void initialize(matrix &weights, initializations init, size_t fan_in, float scale,
+                        rng::key k, rng::counter first);
+    }
+}
+
+
+#endif //CUDANN_INITIALIZERS_H
@@ -0,0 +1,535 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "attention.h"
+#include "lib/util/parallel/parallel.h"
+#include "lib/util/profiler/profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+using namespace cudaNN;
+
+
+namespace
+{
+    /**
+     * @return - the dot product of "v1" and "v2".
+     * (Local sizes: vectorized.)
+     */
+    float dot(const float *v1, const float *v2, size_t length)
+    {
+        float sum = 0.f;
+
+        for (size_t j = 0; j < length; j ++)
+        {
+            sum += v1[j] * v2[j];
+        }
+
+        return sum;
+    }
+
+    /**
+     * outputs[j] += value * inputs[j].
+     */
+    void add_scaled(const float *inputs, size_t length, float value, float *outputs)
+    {
+        for (size_t j = 0; j < length; j ++)
+        {
+            outputs[j] += value * inputs[j];
+        }
+    }
+
+    /**
+     * Add "biases" to each row of "m".
+     */
+    void add_biases(matrix &m, const matrix &biases)
+    {
+        auto nb_columns = m.get_dimensions().second;
+
+        for (size_t i = 0; i < m.get_dimensions().first; i ++)
+        {
+            add_scaled(biases.get_data(), nb_columns, 1.f, m.get_data() + i * nb_columns);
+        }
+    }
+
+    /**
+     * Add the sums of the columns of "m" to "sums".
+     */
+    void add_column_sums(const matrix &m, matrix &sums)
+    {
+        auto nb_columns = m.get_dimensions().second;
+
+        for (size_t i = 0; i < m.get_dimensions().first; i ++)
+        {
+            add_scaled(m.get_data() + i * nb_columns, nb_columns, 1.f, sums.get_data());
+        }
+    }
+}
+
+
+attention::attention(size_t size, size_t nb_heads, bool causal /*= false*/,
+                     initializations init /*= initializations::XAVIER*/):
+        _size(size),
+        _nb_heads(nb_heads),
+        _head_size(nb_heads == 0 ? 0 : size / nb_heads),
+        _causal(causal),
+        _scale(_head_size == 0 ? 0.f : 1.f / std::sqrt((float) _head_size)),
+        _sequence_length(1),
+        _weights(size, 3 * size, "attention::weights"),
+        _biases(1, 3 * size, "attention::biases"),
+        _output_weights(size, size, "attention::output_weights"),
+        _output_biases(1, size, "attention::output_biases"),
+        _replicas(1)
+{
+    if (size == 0 || nb_heads == 0 || size % nb_heads != 0)
+    {
+        // Invalid.
+        util::ERROR("attention::attention",
+                    "Invalid " + std::to_string(nb_heads) + " heads for a size of "
+                    + std::to_string(size));
+        util::ERROR_EXIT();
+    }
+
+    _initialize(_weights, init, size);
+    _initialize(_output_weights, init, size);
+}
+
+matrix attention::feed_forward(matrix &inputs, size_t replica /*= 0*/)
+{
+    if (inputs.get_dimensions().second != _size || inputs.get_dimensions().first == 0)
+    {
+        // Invalid.
+        util::ERROR("attention::feed_forward",
+                    "Invalid @inputs size ("
+                    + std::to_string(inputs.get_dimensions().second)
+                    + " instead of "
+                    + std::to_string(_size)
+                    + ")");
+        util::ERROR_EXIT();
+    }
+
+    // Save the inputs from previous layer (for backpropagation).
+    _replicas[replica].inputs = inputs;
+
+    return _forward(replica);
+}
+
+matrix attention::recompute(size_t replica)
+{
+    return _forward(replica);
+}
+
+matrix attention::_forward(size_t replica)
+{
+    auto &r = _replicas[replica];
+    auto nb_positions = r.inputs.get_dimensions().first;
+    auto nb_tiles = _get_nb_tiles(nb_positions);
+    _sequence_length.store(nb_positions, std::memory_order_relaxed);
+    PROFILE_SCOPE("attention", _causal ? "forward (causal)" : "forward",
+                  nb_positions, _size, _nb_heads,
+                  (double) (r.inputs.get_length() * 6 + _weights.get_length() + _output_weights.get_length())
+                  * sizeof(float),
+                  8. * (double) (nb_positions * _size * _size)
+                  + (_causal ? 2. : 4.) * (double) (nb_positions * nb_positions * _size));
+    // The queries, keys and values of every head (a single product).
+    r.projections = r.inputs * _weights;
+    add_biases(r.projections, _biases);
+    r.heads = matrix(nb_positions, _size, "attention::heads");
+    r.log_sums = matrix(nb_positions, _nb_heads, "attention::log_sums");
+
+    parallel::for_range(_nb_heads * nb_tiles, 1, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i ++)
+        {
+            _forward_tile(replica, i / nb_tiles, i % nb_tiles);
+        }
+    });
+
+    auto outputs = r.heads * _output_weights;
+    add_biases(outputs, _output_biases);
+
+    return outputs;
+}
+
+void attention::_forward_tile(size_t replica, size_t head, size_t tile)
+{
+    auto &r = _replicas[replica];
+    auto nb_positions = r.inputs.get_dimensions().first;
+    auto width = 3 * _size;
+    auto query_begin = tile * ATTENTION_TILE_SIZE;
+    auto query_end = std::min(nb_positions, query_begin + ATTENTION_TILE_SIZE);
+    auto nb_queries = query_end - query_begin;
+    const float *projections = r.projections.get_data();
+    const float *queries = projections + head * _head_size;
+    const float *keys = queries + _size;
+    const float *values = keys + _size;
+    // Running maximum and sum of the scores of each query.
+    auto maxima = std::vector<float>(nb_queries, - std::numeric_limits<float>::infinity());
+    auto sums = std::vector<float>(nb_queries, 0.f);
+    auto scores = std::vector<float>(ATTENTION_TILE_SIZE);
+
+    for (size_t key_begin = 0; key_begin < (_causal ? query_end : nb_positions);
+         key_begin += ATTENTION_TILE_SIZE)
+    {
+        auto key_end = std::min(nb_positions, key_begin + ATTENTION_TILE_SIZE);
+
+        for (size_t i = query_begin; i < query_end; i ++)
+        {
+            // (Causal: the keys after the query are masked.)
+            auto last = _causal ? std::min(key_end, i + 1) : key_end;
+
+            if (last <= key_begin)
+            {
+                continue;
+            }
+
+            const float *query = queries + i * width;
+            float *outputs = r.heads.get_data() + i * _size + head * _head_size;
+            auto maximum = maxima[i - query_begin];
+
+            for (size_t j = key_begin; j < last; j ++)
+            {
+                scores[j - key_begin] = _scale * dot(query, keys + j * width, _head_size);
+                maximum = std::max(maximum, scores[j - key_begin]);
+            }
+
+            // Rescale what was accumulated with the previous maximum.
+            auto correction = std::exp(maxima[i - query_begin] - maximum);
+            auto sum = sums[i - query_begin] * correction;
+
+            for (size_t k = 0; k < _head_size; k ++)
+            {
+                outputs[k] *= correction;
+            }
+
+            for (size_t j = key_begin; j < last; j ++)
+            {
+                auto p = std::exp(scores[j - key_begin] - maximum);
+                sum += p;
+                add_scaled(values + j * width, _head_size, p, outputs);
+            }
+
+            maxima[i - query_begin] = maximum;
+            sums[i - query_begin] = sum;
+        }
+    }
+
+    for (size_t i = query_begin; i < query_end; i ++)
+    {
+        float *outputs = r.heads.get_data() + i * _size + head * _head_size;
+        auto sum = sums[i - query_begin];
+
+        for (size_t k = 0; k < _head_size; k ++)
+        {
+            outputs[k] /= sum;
+        }
+
+        r.log_sums[(int) (i * _nb_heads + head)] = maxima[i - query_begin] + std::log(sum);
+    }
+}
+
+void attention::backward_propagation(matrix &errors, size_t replica /*= 0*/,
+                                     bool propagate /*= true*/)
+{
+    auto &r = _replicas[replica];
+    auto nb_positions = r.inputs.get_dimensions().first;
+    auto nb_tiles = _get_nb_tiles(nb_positions);
+    auto width = 3 * _size;
+    PROFILE_SCOPE("attention", _causal ? "backward_propagation (causal)" : "backward_propagation",
+                  nb_positions, _size, _nb_heads,
+                  (double) (r.inputs.get_length() * 12 + _weights.get_length() + _output_weights.get_length())
+                  * sizeof(float),
+                  (propagate ? 16. : 12.) * (double) (nb_positions * _size * _size)
+                  + (_causal ? 7. : 14.) * (double) (nb_positions * nb_positions * _size));
+
+    if (r.first_entry)
+    {
+        // The first entry of the batch (i.e. first computed errors).
+        r.weight_gradients = matrix(_weights.get_dimensions(), "attention::weight_gradients");
+        r.bias_gradients = matrix(_biases.get_dimensions(), "attention::bias_gradients");
+        r.output_weight_gradients = matrix(_output_weights.get_dimensions(),
+                                           "attention::output_weight_gradients");
+        r.output_bias_gradients = matrix(_output_biases.get_dimensions(), "attention::output_bias_gradients");
+        r.first_entry = false;
+    }
+
+    // The output projection.
+    r.output_weight_gradients += r.heads.transpose() * errors;
+    add_column_sums(errors, r.output_bias_gradients);
+    auto head_errors = errors * _output_weights.transpose();
+    // Sum of the errors of the outputs of each head, weighted by the outputs
+    // (the part of the errors of the scores common to every key).
+    auto deltas = matrix(nb_positions, _nb_heads, "attention::deltas");
+
+    for (size_t i = 0; i < nb_positions; i ++)
+    {
+        for (size_t h = 0; h < _nb_heads; h ++)
+        {
+            auto offset = i * _size + h * _head_size;
+            deltas[(int) (i * _nb_heads + h)] = dot(head_errors.get_data() + offset,
+                                                    r.heads.get_data() + offset, _head_size);
+        }
+    }
+
+    // The errors of the queries, keys and values (a tile at a time, as the
+    // forward propagation): first the keys and values of each tile of keys
+    // (over the tiles of queries), then the queries of each tile of queries
+    // (over the tiles of keys). Each tile is written by a single thread.
+    auto projection_errors = matrix(nb_positions, width, "attention::projection_errors");
+    const float *projections = r.projections.get_data();
+
+    for (auto keys_first: { true, false })
+    {
+        parallel::for_range(_nb_heads * nb_tiles, 1, [&](size_t begin, size_t end)
+        {
+            auto probabilities = std::vector<float>(ATTENTION_TILE_SIZE * ATTENTION_TILE_SIZE);
+            auto score_errors = std::vector<float>(ATTENTION_TILE_SIZE * ATTENTION_TILE_SIZE);
+
+            for (size_t c = begin; c < end; c ++)
+            {
+                auto head = c / nb_tiles;
+                auto first = (c % nb_tiles) * ATTENTION_TILE_SIZE;
+                auto last = std::min(nb_positions, first + ATTENTION_TILE_SIZE);
+                // (Causal: the tiles of queries before the tile of keys are masked,
+                // and the ones of keys after the tile of queries.)
+                auto other_begin = keys_first && _causal ? first : 0;
+                auto other_end = ! keys_first && _causal ? last : nb_positions;
+                auto offset = head * _head_size;
+
+                for (size_t o = other_begin; o < other_end; o += ATTENTION_TILE_SIZE)
+                {
+                    auto o_end = std::min(nb_positions, o + ATTENTION_TILE_SIZE);
+                    auto query_begin = keys_first ? o : first;
+                    auto query_end = keys_first ? o_end : last;
+                    auto key_begin = keys_first ? first : o;
+                    auto key_end = keys_first ? last : o_end;
+                    auto nb_keys = key_end - key_begin;
+                    _probabilities(replica, head, query_begin, query_end, key_begin, key_end,
+                                   head_errors.get_data(), deltas.get_data(),
+                                   probabilities.data(), score_errors.data());
+
+                    for (size_t i = query_begin; i < query_end; i ++)
+                    {
+                        const float *p = probabilities.data() + (i - query_begin) * nb_keys;
+                        const float *e = score_errors.data() + (i - query_begin) * nb_keys;
+                        float *query_errors = projection_errors.get_data() + i * width + offset;
+
+                        for (size_t j = key_begin; j < key_end; j ++)
+                        {
+                            if (keys_first)
+                            {
+                                // Keys: "dK += dS Q"; values: "dV += Pt dO".
+                                float *key_errors = projection_errors.get_data() + j * width + _size + offset;
+                                add_scaled(projections + i * width + offset, _head_size, e[j - key_begin],
+                                           key_errors);
+                                add_scaled(head_errors.get_data() + i * _size + offset, _head_size,
+                                           p[j - key_begin], key_errors + _size);
+                            }
+                            else
+                            {
+                                // Queries: "dQ += dS K".
+                                add_scaled(projections + j * width + _size + offset, _head_size,
+                                           e[j - key_begin], query_errors);
+                            }
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    // The projections of the queries, keys and values.
+    r.weight_gradients += r.inputs.transpose() * projection_errors;
+    add_column_sums(projection_errors, r.bias_gradients);
+
+    if (propagate)
+    {
+        errors = projection_errors * _weights.transpose();
+    }
+}
+
+void attention::_probabilities(size_t replica, size_t head,
+                               size_t query_begin, size_t query_end,
+                               size_t key_begin, size_t key_end,
+                               const float *output_errors, const float *deltas,
+                               float *probabilities, float *errors) const
+{
+    auto &r = _replicas[replica];
+    auto width = 3 * _size;
+    auto nb_keys = key_end - key_begin;
+    auto offset = head * _head_size;
+    const float *projections = r.projections.get_data();
+
+    for (size_t i = query_begin; i < query_end; i ++)
+    {
+        const float *query = projections + i * width + offset;
+        const float *query_errors = output_errors + i * _size + offset;
+        auto log_sum = r.log_sums[(int) (i * _nb_heads + head)];
+        auto delta = deltas[i * _nb_heads + head];
+        float *p = probabilities + (i - query_begin) * nb_keys;
+        float *e = errors + (i - query_begin) * nb_keys;
+
+        for (size_t j = key_begin; j < key_end; j ++)
+        {
+            if (_causal && j > i)
+            {
+                p[j - key_begin] = 0.f;
+                e[j - key_begin] = 0.f;
+
+                continue;
+            }
+
+            // "P = exp(S - log-sum-exp)", "dS = P (dP - delta)", with "dP = dO Vt".
+            auto probability = std::exp(_scale * dot(query, projections + j * width + _size + offset, _head_size)
+                                        - log_sum);
+            auto probability_errors = dot(query_errors, projections + j * width + 2 * _size + offset, _head_size);
+            p[j - key_begin] = probability;
+            e[j - key_begin] = _scale * probability * (probability_errors - delta);
+        }
+    }
+}
+
+void attention::release(size_t replica, bool keep_inputs)
+{
+    auto &r = _replicas[replica];
+    r.projections.clear();
+    r.heads.clear();
+    r.log_sums.clear();
+
+    if (! keep_inputs)
+    {
+        r.inputs.clear();
+    }
+}
+
+void attention::gradient_descent(size_t batch_size, float learning_rate)
+{
+    PROFILE_SCOPE("attention", "gradient_descent", _size, 4 * _size);
+    // The replicas that processed entries.
+    auto replicas = std::vector<size_t>();
+
+    for (size_t r = 0; r < _replicas.size(); r ++)
+    {
+        if (! _replicas[r].first_entry)
+        {
+            replicas.push_back(r);
+            // Reset for next backpropagation.
+            _replicas[r].first_entry = true;
+        }
+    }
+
+    if (replicas.empty())
+    {
+        return;
+    }
+
+    _sum_gradients(replicas);
+    _update_parameters(replicas[0], learning_rate / (float) batch_size);
+}
+
+void attention::apply_gradients(size_t replica, size_t batch_size, float learning_rate)
+{
+    PROFILE_SCOPE("attention", "apply_gradients", _size, 4 * _size);
+
+    if (_replicas[replica].first_entry)
+    {
+        return;
+    }
+
+    // Reset for next backpropagation.
+    _replicas[replica].first_entry = true;
+    _update_parameters(replica, learning_rate / (float) batch_size, true);
+}
+
+void attention::clear_gradients()
+{
+    for (auto &r: _replicas)
+    {
+        // Overwritten by the next backpropagation.
+        r.first_entry = true;
+    }
+}
+
+void attention::set_nb_replicas(size_t nb_replicas)
+{
+    _replicas.resize(std::max((size_t) 1, nb_replicas));
+}
+
+size_t attention::get_nb_replicas() const
+{
+    return _replicas.size();
+}
+
+std::vector<matrix *> attention::get_parameters()
+{
+    return { &_weights, &_biases, &_output_weights, &_output_biases };
+}
+
+std::vector<matrix *> attention::get_gradients(size_t replica /*= 0*/)
+{
+    auto &r = _replicas[replica];
+
+    return { &r.weight_gradients, &r.bias_gradients, &r.output_weight_gradients, &r.output_bias_gradients };
+}
+
+size_t attention::size() const
+{
+    return _size;
+}
+
+size_t attention::get_inputs_memory() const
+{
+    return _sequence_length.load(std::memory_order_relaxed) * _size * sizeof(float);
+}
+
+size_t attention::get_workspace_memory() const
+{
+    // The queries, keys and values, the outputs of the heads and the log-sum-exp.
+    return _sequence_length.load(std::memory_order_relaxed) * (4 * _size + _nb_heads) * sizeof(float);
+}
+
+size_t attention::get_nb_heads() const
+{
+    return _nb_heads;
+}
+
+bool attention::is_causal() const
+{
+    return _causal;
+}
+
+matrix &attention::get_weights()
+{
+    return _weights;
+}
+
+matrix &attention::get_biases()
+{
+    return _biases;
+}
+
+matrix &attention::get_output_weights()
+{
+    return _output_weights;
+}
+
+matrix &attention::get_output_biases()
+{
+    return _output_biases;
+}
+
+size_t attention::_get_nb_tiles(size_t nb_positions) const
+{
+    return (nb_positions + ATTENTION_TILE_SIZE - 1) / ATTENTION_TILE_SIZE;
+}
+
+void attention::_print() const
+{
+    std::cout << "Attention:  " << _nb_heads << " heads of " << _head_size
+              << (_causal ? " (causal)" : "") << std::endl;
+    std::cout << "Size:       " << _size << std::endl;
+}
@@ -0,0 +1,182 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#ifndef CUDANN_ATTENTION_H
+#define CUDANN_ATTENTION_H
+
+#include "lib/models/neural_network/layers/base_layer.h"
+#include "lib/util/util.h"
+
+#include <atomic>
+#include <vector>
+
+
+/**
+ * Number of rows (queries or keys) of the tiles of the attention.
+ */
+#define ATTENTION_TILE_SIZE 64
+
+
+namespace cudaNN
+{
+    /**
+     * Multi-head self-attention layer: each entry is a sequence, a row of the
+     * inputs per position (as -recurrent.h-). With "d" the size, and "n" heads
+     * of "d / n" values:
+     * - the queries, keys and values of every head are a single matrix product
+     * (inputs x "d x 3d" weights, a column block per head in each part);
+     * - each head computes "softmax(Q Kt / sqrt(d / n)) V";
+     * - the outputs are the concatenated heads x "d x d" weights.
+     * The softmax is computed by tiles of "ATTENTION_TILE_SIZE" queries and keys,
+     * normalized online (running maximum and sum of each query): the matrix of the
+     * scores ("positions x positions" per head) is never stored, only a tile per
+     * thread, and the backpropagation computes the tiles again from the
+     * log-sum-exp of each query. The memory is linear in the number of positions.
+     * Not to be combined with layers depending on the batch (the rows are
+     * positions, see -base_layer.h/depends_on_batch-).
+     */
+    class attention: public base_layer
+    {
+        public:
+
+            /**
+             * @param size - the number of values of each position (inputs and outputs).
+             * @param nb_heads - the number of heads (dividing "size").
+             * @param causal - if set, each position only attends to itself and the
+             * previous ones.
+             * @param init - the type of initialization of the weights.
+             */
+            attention(size_t size, size_t nb_heads, bool causal = false,
+                      initializations init = initializations::XAVIER);
+
+            matrix feed_forward(matrix &inputs, size_t replica = 0) override;
+            void backward_propagation(matrix &errors, size_t replica = 0,
+                                      bool propagate = true) override;
+            void release(size_t replica, bool keep_inputs) override;
+            matrix recompute(size_t replica) override;
+            void gradient_descent(size_t batch_size, float learning_rate) override;
+            void apply_gradients(size_t replica, size_t batch_size, float learning_rate) override;
+            void clear_gradients() override;
+            void set_nb_replicas(size_t nb_replicas) override;
+            size_t get_nb_replicas() const override;
+
+            /**
+             * @return - the weights and the biases of the queries, keys and values
+             * (concatenated), then the ones of the outputs.
+             */
+            std::vector<matrix *> get_parameters() override;
+            std::vector<matrix *> get_gradients(size_t replica = 0) override;
+
+            size_t size() const override;
+
+            /**
+             * Memory of a sequence of the length of the last one (1 before the
+             * first forward propagation).
+             * @return - the inputs.
+             */
+            size_t get_inputs_memory() const override;
+
+            /**
+             * @return - the queries, keys and values, the outputs of the heads and
+             * the log-sum-exp of each query (no scores).
+             */
+            size_t get_workspace_memory() const override;
+
+            size_t get_nb_heads() const;
+            bool is_causal() const;
+            matrix &get_weights();
+            matrix &get_biases();
+            matrix &get_output_weights();
+            matrix &get_output_biases();
+
+        protected:
+
+            /**
+             * Print the heads, the dimensions and the mask.
+             */
+            void _print() const override;
+
+        private:
+
+            /**
+             * Forward propagation of the sequence saved in the replica.
+             */
+            matrix _forward(size_t replica);
+
+            /**
+             * Outputs of the head "head", for the tile of queries n°"tile":
+             * online softmax over the tiles of keys (the outputs rescaled each
+             * time the maximum score of a query increases), and the log-sum-exp
+             * of each query.
+             */
+            void _forward_tile(size_t replica, size_t head, size_t tile);
+
+            /**
+             * Probabilities of the tile of queries [query_begin, query_end[ and
+             * keys [key_begin, key_end[ of a head (computed again from the queries,
+             * the keys and the log-sum-exp), and the errors of the scores (from the
+             * errors on the outputs of the heads "output_errors", and "deltas").
+             * @param probabilities - receives the tile (0 where masked).
+             * @param errors - receives the errors of the scores of the tile
+             * (multiplied by the scale of the scores).
+             */
+            void _probabilities(size_t replica, size_t head,
+                                size_t query_begin, size_t query_end,
+                                size_t key_begin, size_t key_end,
+                                const float *output_errors, const float *deltas,
+                                float *probabilities, float *errors) const;
+
+            /**
+             * @return - the number of tiles of the sequence.
+             */
+            size_t _get_nb_tiles(size_t nb_positions) const;
+
+            const size_t _size;
+            const size_t _nb_heads;
+            const size_t _head_size;
+            const bool _causal;
+            const float _scale;
+            std::atomic<size_t> _sequence_length;
+
+            /**
+             * @_weights - "size x (3 * size)": the queries, keys and values.
+             * @_biases - "1 x (3 * size)".
+             * @_output_weights - "size x size".
+             * @_output_biases - "1 x size".
+             */
+            matrix _weights;
+            matrix _biases;
+            matrix _output_weights;
+            matrix _output_biases;
+
+            /**
+             * Buffers of the propagations (of a replica), a row per position.
+             * @inputs - the current sequence.
+             * @projections - the queries, keys and values.
+             * @heads - the outputs of the heads (concatenated).
+             * @log_sums - the log-sum-exp of the scores of each query (a column
+             * per head).
+             * @*_gradients - the sums over the entries of the batch (dimensions of
+             * the parameters).
+             * @first_entry - true if no entry has been processed since the last update.
+             */
+            struct replica
+            {
+                matrix inputs;
+                matrix projections;
+                matrix heads;
+                matrix log_sums;
+                matrix weight_gradients;
+                matrix bias_gradients;
+                matrix output_weight_gradients;
+                matrix output_bias_gradients;
+                bool first_entry = true;
+            };
+
+            std::vector<replica> _replicas;
+    };
+}
+
+
+#endif //CUDANN_ATTENTION_H
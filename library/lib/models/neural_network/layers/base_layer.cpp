@@ -0,0 +1,168 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "base_layer.h"
+#include "lib/util/parallel/parallel.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+
+using namespace cudaNN;
+
+
+namespace
+{
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(float),
+                  "The floats are updated through atomic integers of their size");
+
+    /**
+     * "value -= delta", with a compare and swap of the bits of "value" (a
+     * concurrent update between the read and the write is retried).
+     */
+    inline void atomic_subtract(float *value, float delta)
+    {
+        auto bits = reinterpret_cast<std::atomic<uint32_t> *>(value);
+        auto expected = bits->load(std::memory_order_relaxed);
+        uint32_t desired;
+
+        do
+        {
+            float current;
+            std::memcpy(&current, &expected, sizeof(float));
+            current -= delta;
+            std::memcpy(&desired, &current, sizeof(float));
+        }
+        while (! bits->compare_exchange_weak(expected, desired, std::memory_order_relaxed,
+                                             std::memory_order_relaxed));
+    }
+}
+
+
+bool base_layer::has_dense_gradients() const
+{
+    return true;
+}
+
+bool base_layer::can_propagate() const
+{
+    return true;
+}
+
+bool base_layer::needs_inputs() const
+{
+    return true;
+}
+
+void base_layer::keep_inputs(const matrix &, size_t)
+{
+}
+
+void base_layer::set_training(bool)
+{
+}
+
+bool base_layer::depends_on_batch() const
+{
+    return false;
+}
+
+size_t base_layer::get_parameters_memory()
+{
+    size_t memory = 0;
+
+    for (auto p: get_parameters())
+    {
+        memory += p->get_length() * sizeof(float);
+    }
+
+    return memory;
+}
+
+void base_layer::print(const base_layer &l)
+{
+    l._print();
+}
+
+void base_layer::_initialize(matrix &weights, initializations init, size_t fan_in)
+{
+    initializers::initialize(weights, init, fan_in);
+}
+
+void base_layer::_reduce(const std::vector<float *> &data, size_t length)
+{
+    parallel::for_range(length, PARALLEL_MIN_CHUNK_SIZE, [&](size_t begin, size_t end)
+    {
+        for (size_t stride = 1; stride < data.size(); stride *= 2)
+        {
+            for (size_t i = 0; i + stride < data.size(); i += 2 * stride)
+            {
+                for (size_t j = begin; j < end; j ++)
+                {
+                    data[i][j] += data[i + stride][j];
+                }
+            }
+        }
+    });
+}
+
+void base_layer::_sum_gradients(const std::vector<size_t> &replicas)
+{
+    auto gradients = std::vector<std::vector<matrix *>>();
+
+    for (auto r: replicas)
+    {
+        gradients.push_back(get_gradients(r));
+    }
+
+    for (size_t p = 0; ! gradients.empty() && p < gradients[0].size(); p ++)
+    {
+        auto data = std::vector<float *>();
+
+        for (auto &g: gradients)
+        {
+            data.push_back(g[p]->get_data());
+        }
+
+        _reduce(data, gradients[0][p]->get_length());
+    }
+}
+
+void base_layer::_update_parameters(size_t replica, float scale, bool atomic /*= false*/)
+{
+    auto parameters = get_parameters();
+    auto gradients = get_gradients(replica);
+
+    for (size_t p = 0; p < parameters.size(); p ++)
+    {
+        float *values = parameters[p]->get_data();
+        const float *g = gradients[p]->get_data();
+
+        parallel::for_range(parameters[p]->get_length(), PARALLEL_MIN_CHUNK_SIZE,
+                            [&](size_t begin, size_t end)
+        {
+            _subtract(values + begin, g + begin, end - begin, scale, atomic);
+        });
+    }
+}
+
+void base_layer::_subtract(float *values, const float *gradients, size_t length,
+                           float scale, bool atomic)
+{
+    if (atomic)
+    {
+        for (size_t i = 0; i < length; i ++)
+        {
+            atomic_subtract(values + i, scale * gradients[i]);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < length; i ++)
+        {
+            values[i] -= scale * gradients[i];
+        }
+    }
+}
@@ -0,0 +1,232 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#ifndef CUDANN_BASE_LAYER_H
+#define CUDANN_BASE_LAYER_H
+
+#include "lib/data_structures/matrix/matrix.h"
+#include "lib/models/neural_network/initializers/initializers.h"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace cudaNN
+{
+    /**
+     * Interface of the layers of a neural network: the network only uses
+     * these functions, such that layers of any type (dense, sparse,
+     * convolution...) can be combined.
+     * A layer processes an entry at a time per replica: each replica has its
+     * own buffers (inputs, gradients...), such that several entries can be
+     * processed at the same time (one per replica). Its parameters are shared
+     * by the replicas.
+     */
+    class base_layer
+    {
+        public:
+
+            virtual ~base_layer() = default;
+
+            /**
+             * Forward propagation of an entry: the buffers needed by its
+             * backpropagation are kept in the replica.
+             * @param inputs - the outputs of the previous layer (or the features).
+             * @param replica - in [0, "get_nb_replicas()"[.
+             * @return - the outputs of the layer.
+             */
+            virtual matrix feed_forward(matrix &inputs, size_t replica = 0) = 0;
+
+            /**
+             * Backpropagation of the entry of the last forward propagation of
+             * the replica: its gradients are added to the ones of the replica.
+             * @param errors - the derivatives of the loss for the outputs of the
+             * layer (same dimensions), replaced by the derivatives of the loss for
+             * its inputs if "propagate".
+             * @param propagate - false for the first layer (no previous layer).
+             */
+            virtual void backward_propagation(matrix &errors, size_t replica = 0,
+                                              bool propagate = true) = 0;
+
+            /**
+             * Activation checkpointing: free the buffers of the forward propagation
+             * of a replica, to be computed again before its backpropagation.
+             * @param keep_inputs - if set, only the other buffers are freed
+             * (checkpoint: see "recompute").
+             */
+            virtual void release(size_t replica, bool keep_inputs) = 0;
+
+            /**
+             * Forward propagation of the inputs kept by "release" (the buffers of
+             * the replica are computed again).
+             * @return - the outputs of the layer.
+             */
+            virtual matrix recompute(size_t replica) = 0;
+
+            /**
+             * @return - true (default) if the backpropagation uses the inputs of the
+             * forward propagation (kept by the layer). Otherwise (e.g. dropout,
+             * pooling), the layer does not keep them: they are only given at the
+             * checkpoints (see "keep_inputs").
+             */
+            virtual bool needs_inputs() const;
+
+            /**
+             * Activation checkpointing, for a layer which does not need its inputs:
+             * keep "inputs", the ones of the next forward propagation of the
+             * replica, to compute it again (see "recompute"; freed by "release").
+             * Nothing by default.
+             */
+            virtual void keep_inputs(const matrix &inputs, size_t replica);
+
+            /**
+             * Sum the gradients of the replicas (in a fixed order), and update the
+             * parameters with them (the gradients are reset).
+             * @param batch_size - the number of entries processed since the
+             * last update (over the replicas).
+             * @param learning_rate - the step of the update.
+             */
+            virtual void gradient_descent(size_t batch_size, float learning_rate) = 0;
+
+            /**
+             * Update the parameters with the gradients of a single replica, without
+             * any lock (Hogwild!: other threads may read or update the parameters at
+             * the same time; the updates are not lost, see "_subtract").
+             * @param replica - the replica whose gradients are applied (and reset).
+             * @param batch_size - the number of entries processed by this replica
+             * since its last update.
+             */
+            virtual void apply_gradients(size_t replica, size_t batch_size, float learning_rate) = 0;
+
+            /**
+             * Discard the gradients of every replica computed since the last update.
+             */
+            virtual void clear_gradients() = 0;
+
+            /**
+             * @param nb_replicas - the number of entries that can be processed
+             * at the same time (at least 1).
+             */
+            virtual void set_nb_replicas(size_t nb_replicas) = 0;
+            virtual size_t get_nb_replicas() const = 0;
+
+            /**
+             * @return - the parameters of the layer (e.g. weights and biases).
+             */
+            virtual std::vector<matrix *> get_parameters() = 0;
+
+            /**
+             * @return - the gradients summed by a replica since the last update, a
+             * matrix per parameter (same order and dimensions as "get_parameters").
+             */
+            virtual std::vector<matrix *> get_gradients(size_t replica = 0) = 0;
+
+            /**
+             * @return - false if the gradients of a replica only cover a part of the
+             * parameters (e.g. the rows of the non-zero inputs), and must not be
+             * summed as a whole (e.g. over processes).
+             */
+            virtual bool has_dense_gradients() const;
+
+            /**
+             * @return - false if the derivatives of the loss for the inputs cannot be
+             * computed (e.g. ids): the layer must be the first of the network.
+             */
+            virtual bool can_propagate() const;
+
+            /**
+             * @param training - if set, the next forward propagations are the ones
+             * of a training, otherwise of predictions (e.g. batch statistics instead
+             * of the running ones). Predictions by default.
+             */
+            virtual void set_training(bool training);
+
+            /**
+             * @return - true if the outputs of an entry depend on the other entries
+             * of its batch during a training (e.g. batch statistics): the entries
+             * of a batch are then propagated together, a row per entry.
+             */
+            virtual bool depends_on_batch() const;
+
+            /**
+             * @return - the number of outputs (columns) of the layer.
+             */
+            virtual size_t size() const = 0;
+
+            /**
+             * Memory (bytes) kept by a replica between the forward and backward
+             * propagations of an entry, to plan the activation checkpoints (see
+             * -neural_network.h/set_activation_budget-).
+             * @return - the memory of the inputs: kept at a checkpoint, and between
+             * the propagations if "needs_inputs".
+             */
+            virtual size_t get_inputs_memory() const = 0;
+
+            /**
+             * @return - the memory of the other buffers (e.g. the derivatives of
+             * the activation function).
+             */
+            virtual size_t get_workspace_memory() const = 0;
+
+            /**
+             * @return - the memory (bytes) of the parameters of the layer.
+             */
+            size_t get_parameters_memory();
+
+            /**
+             * Print the given layer (type and dimensions).
+             * @param l - the layer concerned.
+             */
+            static void print(const base_layer &l);
+
+        protected:
+
+            /**
+             * Print the description of the layer (see "print").
+             */
+            virtual void _print() const = 0;
+
+            /**
+             * Initialize "weights" using the specified method (see
+             * -initializers.h-).
+             * @param fan_in - the number of inputs of each output.
+             */
+            static void _initialize(matrix &weights, initializations init, size_t fan_in);
+
+            /**
+             * Sum the arrays into the first one, with a tree (pairs of arrays at
+             * distance 1, 2, 4...). The values are split over the threads, and the
+             * order of the additions only depends on the number of arrays.
+             * @param data - the arrays of "length" values.
+             */
+            static void _reduce(const std::vector<float *> &data, size_t length);
+
+            /**
+             * Dense gradients: sum the gradients of the given replicas into the
+             * ones of the first (see "_reduce").
+             */
+            void _sum_gradients(const std::vector<size_t> &replicas);
+
+            /**
+             * Dense gradients: subtract the gradients of a replica, multiplied by
+             * "scale", from the parameters (see "_subtract").
+             */
+            void _update_parameters(size_t replica, float scale, bool atomic = false);
+
+            /**
+             * "values -= scale * gradients" ("length" values, on the current
+             * thread), in place, element by element: no temporary matrix, and
+             * each element is only written once.
+             * @param atomic - if set, each element is updated with a compare and
+             * swap of its bits (relaxed order): with Hogwild!, the concurrent
+             * updates of the other threads are not lost. The readers of "values"
+             * (plain loads) may see them partly applied.
+             */
+            static void _subtract(float *values, const float *gradients, size_t length,
+                                  float scale, bool atomic);
+    };
+}
+
+
+#endif //CUDANN_BASE_LAYER_H
@@ -0,0 +1,648 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "convolution.h"
+#include "lib/util/parallel/parallel.h"
+#include "lib/util/profiler/profiler.h"
+
+#include <algorithm>
+
+
+using namespace cudaNN;
+
+
+convolution::convolution(size_t channels, size_t height, size_t width,
+                         size_t nb_filters, size_t kernel_size,
+                         size_t stride /*= 1*/, size_t padding /*= 0*/,
+                         initializations init /*= initializations::HE*/,
+                         const function &activation_function /*= activation_functions::LINEAR*/,
+                         layouts layout /*= layouts::NCHW*/):
+        _channels(channels),
+        _height(height),
+        _width(width),
+        _nb_filters(nb_filters),
+        _kernel_size(kernel_size),
+        _stride(std::max((size_t) 1, stride)),
+        _padding(padding),
+        _output_height(height + 2 * padding >= kernel_size ?
+                       (height + 2 * padding - kernel_size) / _stride + 1 : 0),
+        _output_width(width + 2 * padding >= kernel_size ?
+                      (width + 2 * padding - kernel_size) / _stride + 1 : 0),
+        _activation_function(activation_function),
+        _layout(layout),
+        _algorithm(convolution_algorithms::AUTO),
+        _filters(nb_filters, channels * kernel_size * kernel_size, "convolution::filters"),
+        _biases(1, nb_filters, "convolution::biases"),
+        _replicas(1)
+{
+    if (kernel_size == 0 || _output_height == 0 || _output_width == 0 || channels == 0)
+    {
+        // Invalid.
+        util::ERROR("convolution::convolution",
+                    "Invalid filters of " + std::to_string(kernel_size) + "x"
+                    + std::to_string(kernel_size) + " for images of "
+                    + std::to_string(channels) + "x" + std::to_string(height) + "x"
+                    + std::to_string(width) + " (padding " + std::to_string(padding) + ")");
+        util::ERROR_EXIT();
+    }
+    if (activation_functions::is_row_wise(activation_function))
+    {
+        // Invalid (its derivative is only the diagonal of the Jacobian).
+        util::ERROR("convolution::convolution",
+                    "Invalid @activation_function (" + activation_function.get_id()
+                    + "), only element-wise functions are supported");
+        util::ERROR_EXIT();
+    }
+
+    _initialize(_filters, init, channels * kernel_size * kernel_size);
+    set_algorithm(convolution_algorithms::AUTO);
+}
+
+std::pair<size_t, size_t> convolution::_get_strides(size_t nb_channels, size_t nb_pixels) const
+{
+    return _layout == layouts::NCHW ? std::make_pair(nb_pixels, (size_t) 1)
+                                    : std::make_pair((size_t) 1, nb_channels);
+}
+
+matrix convolution::feed_forward(matrix &inputs, size_t replica /*= 0*/)
+{
+    if (inputs.get_dimensions().second != _channels * _height * _width)
+    {
+        // Invalid.
+        util::ERROR("convolution::feed_forward",
+                    "Invalid @inputs size ("
+                    + std::to_string(inputs.get_dimensions().second)
+                    + " instead of "
+                    + std::to_string(_channels * _height * _width)
+                    + ")");
+        util::ERROR_EXIT();
+    }
+
+    // Save the inputs from previous layer.
+    _replicas[replica].inputs = inputs;
+
+    return _forward(replica);
+}
+
+matrix convolution::recompute(size_t replica)
+{
+    return _forward(replica);
+}
+
+matrix convolution::_forward(size_t replica)
+{
+    auto &r = _replicas[replica];
+    auto nb_rows = r.inputs.get_dimensions().first;
+    auto nb_inputs = _channels * _height * _width;
+    PROFILE_SCOPE("convolution", _algorithm == convolution_algorithms::WINOGRAD ?
+                                 "forward (winograd)" : "forward (im2col)",
+                  nb_rows * _output_height * _output_width, _nb_filters, _filters.get_dimensions().second,
+                  (double) (nb_rows * (nb_inputs + size()) + _filters.get_length()) * sizeof(float),
+                  2. * (double) (nb_rows * size() * _filters.get_dimensions().second));
+    auto sum = matrix(nb_rows, size(), "convolution::outputs");
+
+    for (size_t n = 0; n < nb_rows; n ++)
+    {
+        if (_algorithm == convolution_algorithms::WINOGRAD)
+        {
+            _forward_winograd(r.inputs.get_data() + n * nb_inputs, sum.get_data() + n * size());
+        }
+        else
+        {
+            _forward_im2col(r.inputs.get_data() + n * nb_inputs, sum.get_data() + n * size());
+        }
+    }
+
+    // Compute the result of the activation function on the outputs, and of its
+    // derivative (for back propagation).
+    return _activation_function.compute_with_derivatives({ &sum }, r.derivatives);
+}
+
+void convolution::_forward_im2col(const float *inputs, float *outputs) const
+{
+    auto nb_pixels = _output_height * _output_width;
+    auto patch_size = _filters.get_dimensions().second;
+    auto in = _get_strides(_channels, _height * _width);
+    auto out = _get_strides(_nb_filters, nb_pixels);
+    const float *filters = _filters.get_data();
+    const float *biases = _biases.get_data();
+
+    parallel::for_range(nb_pixels, std::max((size_t) 1, PARALLEL_MIN_CHUNK_SIZE / (_nb_filters * patch_size)),
+                        [&](size_t begin, size_t end)
+    {
+        auto columns = std::vector<float>(patch_size * CONVOLUTION_BLOCK_SIZE);
+        auto results = std::vector<float>(_nb_filters * CONVOLUTION_BLOCK_SIZE);
+
+        for (size_t block = begin; block < end; block += CONVOLUTION_BLOCK_SIZE)
+        {
+            auto length = std::min((size_t) CONVOLUTION_BLOCK_SIZE, end - block);
+
+            // The patches of the pixels of the block, in columns (zeros out of
+            // the image).
+            for (size_t c = 0; c < _channels; c ++)
+            {
+                for (size_t i = 0; i < _kernel_size; i ++)
+                {
+                    for (size_t j = 0; j < _kernel_size; j ++)
+                    {
+                        float *column = columns.data() + ((c * _kernel_size + i) * _kernel_size + j) * length;
+
+                        for (size_t q = 0; q < length; q ++)
+                        {
+                            auto ih = (long) (((block + q) / _output_width) * _stride + i) - (long) _padding;
+                            auto iw = (long) (((block + q) % _output_width) * _stride + j) - (long) _padding;
+                            column[q] = ih < 0 || iw < 0 || ih >= (long) _height || iw >= (long) _width ? 0.f
+                                        : inputs[c * in.first + ((size_t) ih * _width + (size_t) iw) * in.second];
+                        }
+                    }
+                }
+            }
+
+            // Product of the filters and of the columns (the inner loop is
+            // contiguous, vectorized).
+            for (size_t k = 0; k < _nb_filters; k ++)
+            {
+                float *result = results.data() + k * length;
+                const float *filter = filters + k * patch_size;
+                std::fill(result, result + length, biases[k]);
+
+                for (size_t t = 0; t < patch_size; t ++)
+                {
+                    const float *column = columns.data() + t * length;
+                    auto weight = filter[t];
+
+                    for (size_t q = 0; q < length; q ++)
+                    {
+                        result[q] += weight * column[q];
+                    }
+                }
+
+                for (size_t q = 0; q < length; q ++)
+                {
+                    outputs[k * out.first + (block + q) * out.second] = result[q];
+                }
+            }
+        }
+    });
+}
+
+void convolution::_forward_winograd(const float *inputs, float *outputs) const
+{
+    auto nb_pixels = _output_height * _output_width;
+    auto tiles_width = (_output_width + 1) / 2;
+    auto nb_tiles = ((_output_height + 1) / 2) * tiles_width;
+    auto in = _get_strides(_channels, _height * _width);
+    auto out = _get_strides(_nb_filters, nb_pixels);
+    const float *filters = _filters.get_data();
+    const float *biases = _biases.get_data();
+    // Transformed filters "G g G^T" (4x4), by element of the tile: the 16
+    // matrices of "_nb_filters x _channels" values.
+    auto transformed = std::vector<float>(16 * _nb_filters * _channels);
+
+    for (size_t k = 0; k < _nb_filters; k ++)
+    {
+        for (size_t c = 0; c < _channels; c ++)
+        {
+            const float *g = filters + k * _filters.get_dimensions().second + c * 9;
+            float t[4][3];
+
+            for (size_t j = 0; j < 3; j ++)
+            {
+                t[0][j] = g[j];
+                t[1][j] = .5f * (g[j] + g[3 + j] + g[6 + j]);
+                t[2][j] = .5f * (g[j] - g[3 + j] + g[6 + j]);
+                t[3][j] = g[6 + j];
+            }
+
+            for (size_t i = 0; i < 4; i ++)
+            {
+                float u[4] = { t[i][0], .5f * (t[i][0] + t[i][1] + t[i][2]),
+                               .5f * (t[i][0] - t[i][1] + t[i][2]), t[i][2] };
+
+                for (size_t j = 0; j < 4; j ++)
+                {
+                    transformed[((i * 4 + j) * _nb_filters + k) * _channels + c] = u[j];
+                }
+            }
+        }
+    }
+
+    parallel::for_range(nb_tiles, std::max((size_t) 1, PARALLEL_MIN_CHUNK_SIZE / (16 * _nb_filters * _channels)),
+                        [&](size_t begin, size_t end)
+    {
+        auto tiles = std::vector<float>(16 * _channels * CONVOLUTION_BLOCK_SIZE);
+        auto products = std::vector<float>(16 * _nb_filters * CONVOLUTION_BLOCK_SIZE);
+
+        for (size_t block = begin; block < end; block += CONVOLUTION_BLOCK_SIZE)
+        {
+            auto length = std::min((size_t) CONVOLUTION_BLOCK_SIZE, end - block);
+
+            // Transformed inputs "B^T d B", of the 4x4 tiles of inputs
+            // (overlapping by 2) of the 2x2 blocks of outputs.
+            for (size_t c = 0; c < _channels; c ++)
+            {
+                for (size_t q = 0; q < length; q ++)
+                {
+                    auto h = (long) (2 * ((block + q) / tiles_width)) - (long) _padding;
+                    auto w = (long) (2 * ((block + q) % tiles_width)) - (long) _padding;
+                    float d[4][4];
+                    float t[4][4];
+
+                    for (long i = 0; i < 4; i ++)
+                    {
+                        for (long j = 0; j < 4; j ++)
+                        {
+                            d[i][j] = h + i < 0 || w + j < 0 || h + i >= (long) _height
+                                      || w + j >= (long) _width ? 0.f
+                                      : inputs[c * in.first + ((size_t) (h + i) * _width + (size_t) (w + j)) * in.second];
+                        }
+                    }
+
+                    for (size_t j = 0; j < 4; j ++)
+                    {
+                        t[0][j] = d[0][j] - d[2][j];
+                        t[1][j] = d[1][j] + d[2][j];
+                        t[2][j] = d[2][j] - d[1][j];
+                        t[3][j] = d[1][j] - d[3][j];
+                    }
+
+                    for (size_t i = 0; i < 4; i ++)
+                    {
+                        float v[4] = { t[i][0] - t[i][2], t[i][1] + t[i][2],
+                                       t[i][2] - t[i][1], t[i][1] - t[i][3] };
+
+                        for (size_t j = 0; j < 4; j ++)
+                        {
+                            tiles[((i * 4 + j) * _channels + c) * length + q] = v[j];
+                        }
+                    }
+                }
+            }
+
+            // An element-wise product per element of the tiles, summed over the
+            // channels: 16 matrix products (filters x channels x tiles).
+            for (size_t e = 0; e < 16; e ++)
+            {
+                for (size_t k = 0; k < _nb_filters; k ++)
+                {
+                    float *product = products.data() + (e * _nb_filters + k) * length;
+                    const float *u = transformed.data() + (e * _nb_filters + k) * _channels;
+                    std::fill(product, product + length, 0.f);
+
+                    for (size_t c = 0; c < _channels; c ++)
+                    {
+                        const float *v = tiles.data() + (e * _channels + c) * length;
+                        auto weight = u[c];
+
+                        for (size_t q = 0; q < length; q ++)
+                        {
+                            product[q] += weight * v[q];
+                        }
+                    }
+                }
+            }
+
+            // Outputs "A^T m A" (2x2) of each tile.
+            for (size_t k = 0; k < _nb_filters; k ++)
+            {
+                for (size_t q = 0; q < length; q ++)
+                {
+                    auto h = 2 * ((block + q) / tiles_width);
+                    auto w = 2 * ((block + q) % tiles_width);
+                    float t[2][4];
+
+                    for (size_t j = 0; j < 4; j ++)
+                    {
+                        auto m = [&](size_t i) { return products[((i * 4 + j) * _nb_filters + k) * length + q]; };
+                        t[0][j] = m(0) + m(1) + m(2);
+                        t[1][j] = m(1) - m(2) - m(3);
+                    }
+
+                    for (size_t i = 0; i < 2 && h + i < _output_height; i ++)
+                    {
+                        float y[2] = { t[i][0] + t[i][1] + t[i][2], t[i][1] - t[i][2] - t[i][3] };
+
+                        for (size_t j = 0; j < 2 && w + j < _output_width; j ++)
+                        {
+                            outputs[k * out.first + ((h + i) * _output_width + w + j) * out.second] = y[j] + biases[k];
+                        }
+                    }
+                }
+            }
+        }
+    });
+}
+
+void convolution::backward_propagation(matrix &errors, size_t replica /*= 0*/,
+                                       bool propagate /*= true*/)
+{
+    auto &r = _replicas[replica];
+    auto nb_rows = errors.get_dimensions().first;
+    auto nb_inputs = _channels * _height * _width;
+    PROFILE_SCOPE("convolution", "backward_propagation",
+                  nb_rows * _output_height * _output_width, _nb_filters, _filters.get_dimensions().second,
+                  (double) (nb_rows * (nb_inputs + size()) + _filters.get_length()) * sizeof(float),
+                  (propagate ? 4. : 2.) * (double) (nb_rows * size() * _filters.get_dimensions().second));
+    // The errors on the outputs before the activation function.
+    errors.hadamard_product_in_place(r.derivatives);
+
+    if (r.first_entry)
+    {
+        // The first entry of the batch (i.e. first computed errors).
+        r.filter_gradients = matrix(_filters.get_dimensions(), "convolution::filter_gradients");
+        r.bias_gradients = matrix(_biases.get_dimensions(), "convolution::bias_gradients");
+        r.first_entry = false;
+    }
+
+    auto input_errors = propagate ? matrix(nb_rows, nb_inputs, "convolution::input_errors") : matrix();
+
+    for (size_t n = 0; n < nb_rows; n ++)
+    {
+        _backward_filters(r.inputs.get_data() + n * nb_inputs, errors.get_data() + n * size(),
+                          r.filter_gradients.get_data(), r.bias_gradients.get_data());
+
+        if (propagate)
+        {
+            _backward_inputs(errors.get_data() + n * size(), input_errors.get_data() + n * nb_inputs);
+        }
+    }
+
+    if (propagate)
+    {
+        errors = input_errors;
+    }
+}
+
+void convolution::_backward_filters(const float *inputs, const float *errors,
+                                    float *filter_gradients, float *bias_gradients) const
+{
+    auto nb_pixels = _output_height * _output_width;
+    auto patch_size = _filters.get_dimensions().second;
+    auto in = _get_strides(_channels, _height * _width);
+    auto out = _get_strides(_nb_filters, nb_pixels);
+
+    // Each (filter, channel) pair owns its weights: no concurrent writes.
+    parallel::for_range(_nb_filters * _channels,
+                        std::max((size_t) 1, PARALLEL_MIN_CHUNK_SIZE / (_kernel_size * _kernel_size * nb_pixels)),
+                        [&](size_t begin, size_t end)
+    {
+        for (size_t kc = begin; kc < end; kc ++)
+        {
+            auto k = kc / _channels;
+            auto c = kc % _channels;
+            float *gradients = filter_gradients + k * patch_size + c * _kernel_size * _kernel_size;
+
+            for (size_t i = 0; i < _kernel_size; i ++)
+            {
+                for (size_t j = 0; j < _kernel_size; j ++)
+                {
+                    float sum = 0.f;
+
+                    for (size_t oh = 0; oh < _output_height; oh ++)
+                    {
+                        auto ih = (long) (oh * _stride + i) - (long) _padding;
+
+                        if (ih < 0 || ih >= (long) _height)
+                        {
+                            continue;
+                        }
+
+                        for (size_t ow = 0; ow < _output_width; ow ++)
+                        {
+                            auto iw = (long) (ow * _stride + j) - (long) _padding;
+
+                            if (iw >= 0 && iw < (long) _width)
+                            {
+                                sum += errors[k * out.first + (oh * _output_width + ow) * out.second]
+                                       * inputs[c * in.first + ((size_t) ih * _width + (size_t) iw) * in.second];
+                            }
+                        }
+                    }
+
+                    gradients[i * _kernel_size + j] += sum;
+                }
+            }
+
+            if (c == 0)
+            {
+                float sum = 0.f;
+
+                for (size_t p = 0; p < nb_pixels; p ++)
+                {
+                    sum += errors[k * out.first + p * out.second];
+                }
+
+                bias_gradients[k] += sum;
+            }
+        }
+    });
+}
+
+void convolution::_backward_inputs(const float *errors, float *input_errors) const
+{
+    auto nb_pixels = _output_height * _output_width;
+    auto patch_size = _filters.get_dimensions().second;
+    auto in = _get_strides(_channels, _height * _width);
+    auto out = _get_strides(_nb_filters, nb_pixels);
+    const float *filters = _filters.get_data();
+
+    // Each row of pixels of a channel of the inputs gathers its errors: no
+    // concurrent writes.
+    parallel::for_range(_channels * _height,
+                        std::max((size_t) 1, PARALLEL_MIN_CHUNK_SIZE / (_nb_filters * patch_size / _channels * _width)),
+                        [&](size_t begin, size_t end)
+    {
+        for (size_t ch = begin; ch < end; ch ++)
+        {
+            auto c = ch / _height;
+            auto ih = ch % _height;
+            float *row = input_errors + c * in.first + ih * _width * in.second;
+
+            for (size_t k = 0; k < _nb_filters; k ++)
+            {
+                for (size_t i = 0; i < _kernel_size; i ++)
+                {
+                    // The row of outputs using the row of inputs, with the row "i"
+                    // of the filters.
+                    auto oh = (long) (ih + _padding) - (long) i;
+
+                    if (oh < 0 || oh % (long) _stride != 0 || oh / (long) _stride >= (long) _output_height)
+                    {
+                        continue;
+                    }
+
+                    const float *output_errors = errors + k * out.first
+                                                 + (size_t) (oh / (long) _stride) * _output_width * out.second;
+
+                    for (size_t j = 0; j < _kernel_size; j ++)
+                    {
+                        auto weight = filters[k * patch_size + (c * _kernel_size + i) * _kernel_size + j];
+
+                        for (size_t iw = 0; iw < _width; iw ++)
+                        {
+                            auto ow = (long) (iw + _padding) - (long) j;
+
+                            if (ow >= 0 && ow % (long) _stride == 0 && ow / (long) _stride < (long) _output_width)
+                            {
+                                row[iw * in.second] += weight * output_errors[(size_t) (ow / (long) _stride) * out.second];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    });
+}
+
+void convolution::release(size_t replica, bool keep_inputs)
+{
+    auto &r = _replicas[replica];
+    r.derivatives.clear();
+
+    if (! keep_inputs)
+    {
+        r.inputs.clear();
+    }
+}
+
+void convolution::gradient_descent(size_t batch_size, float learning_rate)
+{
+    PROFILE_SCOPE("convolution", "gradient_descent", _nb_filters, _filters.get_dimensions().second);
+    // The replicas that processed entries.
+    auto replicas = std::vector<size_t>();
+
+    for (size_t r = 0; r < _replicas.size(); r ++)
+    {
+        if (! _replicas[r].first_entry)
+        {
+            replicas.push_back(r);
+            // Reset for next backpropagation.
+            _replicas[r].first_entry = true;
+        }
+    }
+
+    if (replicas.empty())
+    {
+        return;
+    }
+
+    _sum_gradients(replicas);
+    _update_parameters(replicas[0], learning_rate / (float) batch_size);
+}
+
+void convolution::apply_gradients(size_t replica, size_t batch_size, float learning_rate)
+{
+    PROFILE_SCOPE("convolution", "apply_gradients", _nb_filters, _filters.get_dimensions().second);
+
+    if (_replicas[replica].first_entry)
+    {
+        return;
+    }
+
+    // Reset for next backpropagation.
+    _replicas[replica].first_entry = true;
+    _update_parameters(replica, learning_rate / (float) batch_size, true);
+}
+
+void convolution::clear_gradients()
+{
+    for (auto &r: _replicas)
+    {
+        // Overwritten by the next backpropagation.
+        r.first_entry = true;
+    }
+}
+
+void convolution::set_nb_replicas(size_t nb_replicas)
+{
+    _replicas.resize(std::max((size_t) 1, nb_replicas));
+}
+
+size_t convolution::get_nb_replicas() const
+{
+    return _replicas.size();
+}
+
+std::vector<matrix *> convolution::get_parameters()
+{
+    return { &_filters, &_biases };
+}
+
+std::vector<matrix *> convolution::get_gradients(size_t replica /*= 0*/)
+{
+    return { &_replicas[replica].filter_gradients, &_replicas[replica].bias_gradients };
+}
+
+size_t convolution::size() const
+{
+    return _nb_filters * _output_height * _output_width;
+}
+
+size_t convolution::get_inputs_memory() const
+{
+    return _channels * _height * _width * sizeof(float);
+}
+
+size_t convolution::get_workspace_memory() const
+{
+    // The derivatives of the activation function.
+    return size() * sizeof(float);
+}
+
+void convolution::set_algorithm(convolution_algorithms algorithm)
+{
+    auto winograd = _kernel_size == 3 && _stride == 1;
+
+    if (algorithm == convolution_algorithms::WINOGRAD && ! winograd)
+    {
+        // Invalid.
+        util::ERROR("convolution::set_algorithm",
+                    "Winograd requires 3x3 filters and a stride of 1");
+        util::ERROR_EXIT();
+    }
+
+    _algorithm = algorithm != convolution_algorithms::AUTO ? algorithm
+                 : winograd ? convolution_algorithms::WINOGRAD : convolution_algorithms::IM2COL;
+}
+
+convolution_algorithms convolution::get_algorithm() const
+{
+    return _algorithm;
+}
+
+layouts convolution::get_layout() const
+{
+    return _layout;
+}
+
+size_t convolution::get_output_height() const
+{
+    return _output_height;
+}
+
+size_t convolution::get_output_width() const
+{
+    return _output_width;
+}
+
+matrix &convolution::get_filters()
+{
+    return _filters;
+}
+
+matrix &convolution::get_biases()
+{
+    return _biases;
+}
+
+void convolution::_print() const
+{
+    std::cout << "Convolution: " << _channels << "x" << _height << "x" << _width << " -> "
+              << _nb_filters << "x" << _output_height << "x" << _output_width
+              << (_layout == layouts::NCHW ? " (NCHW)" : " (NHWC)") << std::endl;
+    std::cout << "Filters:    " << _kernel_size << "x" << _kernel_size << ", stride " << _stride
+              << ", padding " << _padding
+              << (_algorithm == convolution_algorithms::WINOGRAD ? " (winograd)" : " (im2col)") << std::endl;
+    std::cout << "Activation: " << _activation_function.get_id() << std::endl;
+}
@@ -0,0 +1,221 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#ifndef CUDANN_CONVOLUTION_H
+#define CUDANN_CONVOLUTION_H
+
+#include "lib/models/neural_network/layers/base_layer.h"
+#include "lib/functions/activation_functions/activation_functions.h"
+#include "lib/util/util.h"
+
+#include <vector>
+
+
+/**
+ * Number of output pixels whose patches are copied in columns at once
+ * (im2col), and of 2x2 blocks of output pixels transformed at once
+ * (Winograd): the buffers of a thread stay in cache.
+ */
+#define CONVOLUTION_BLOCK_SIZE 64
+
+
+namespace cudaNN
+{
+    /**
+     * Order of the values of an image in a row of a matrix.
+     * @NCHW - channel by channel (the rows of pixels of each channel).
+     * @NHWC - pixel by pixel (the channels of each pixel).
+     */
+    enum layouts
+    {
+        NCHW,
+        NHWC
+    };
+
+    /**
+     * Computation of the forward propagation of a convolution.
+     * @AUTO - WINOGRAD if possible, IM2COL otherwise.
+     * @IM2COL - the patches of the inputs are copied in columns, multiplied
+     * by the filters (matrix product).
+     * @WINOGRAD - Winograd F(2x2, 3x3): each 2x2 block of outputs costs 16
+     * multiplications per filter and channel instead of 36 (3x3 filters
+     * with a stride of 1 only).
+     */
+    enum convolution_algorithms
+    {
+        AUTO,
+        IM2COL,
+        WINOGRAD
+    };
+
+
+    /**
+     * 2D convolution layer: each filter (of "kernel_size x kernel_size" weights
+     * per input channel) slides over the image, giving an output channel (the
+     * number of weights does not depend on the size of the images).
+     * Each row of the inputs is an image of "channels x height x width"
+     * values, each row of the outputs an image of "nb_filters x
+     * get_output_height() x get_output_width()" values (same layout).
+     * The forward propagation is split over the threads by blocks of output
+     * pixels; the backpropagation computes the gradients of the filters (split
+     * by filters) and the errors on the inputs (split by rows of input pixels)
+     * directly from the inputs (no copy of the patches is kept).
+     */
+    class convolution: public base_layer
+    {
+        public:
+
+            /**
+             * @param channels, height, width - the dimensions of the input images.
+             * @param nb_filters - the number of output channels.
+             * @param kernel_size - the size of the (square) filters.
+             * @param stride - the step between two positions of the filters.
+             * @param padding - the number of pixels (zeros) added on each side
+             * of the inputs.
+             * @param init - the type of initialization of the filters.
+             * @param activation_function - the function applied on the outputs.
+             * @param layout - the order of the values of the images (inputs and
+             * outputs).
+             */
+            convolution(size_t channels, size_t height, size_t width,
+                        size_t nb_filters, size_t kernel_size,
+                        size_t stride = 1, size_t padding = 0,
+                        initializations init = initializations::HE,
+                        const function &activation_function = activation_functions::LINEAR,
+                        layouts layout = layouts::NCHW);
+
+            matrix feed_forward(matrix &inputs, size_t replica = 0) override;
+            void backward_propagation(matrix &errors, size_t replica = 0,
+                                      bool propagate = true) override;
+            void release(size_t replica, bool keep_inputs) override;
+            matrix recompute(size_t replica) override;
+            void gradient_descent(size_t batch_size, float learning_rate) override;
+            void apply_gradients(size_t replica, size_t batch_size, float learning_rate) override;
+            void clear_gradients() override;
+            void set_nb_replicas(size_t nb_replicas) override;
+            size_t get_nb_replicas() const override;
+
+            /**
+             * @return - the filters (a row per filter, of "channels x kernel_size x
+             * kernel_size" weights) and the biases (one per filter).
+             */
+            std::vector<matrix *> get_parameters() override;
+            std::vector<matrix *> get_gradients(size_t replica = 0) override;
+
+            size_t size() const override;
+            size_t get_inputs_memory() const override;
+            size_t get_workspace_memory() const override;
+
+            /**
+             * @param algorithm - the computation of the next forward propagations
+             * (AUTO by default). WINOGRAD requires 3x3 filters and a stride of 1.
+             */
+            void set_algorithm(convolution_algorithms algorithm);
+
+            /**
+             * @return - the algorithm used by the forward propagation (never AUTO).
+             */
+            convolution_algorithms get_algorithm() const;
+
+            layouts get_layout() const;
+            size_t get_output_height() const;
+            size_t get_output_width() const;
+
+            matrix &get_filters();
+            matrix &get_biases();
+
+        protected:
+
+            /**
+             * Print the dimensions, the filters and the activation function.
+             */
+            void _print() const override;
+
+        private:
+
+            /**
+             * @return - the distances between the values of two consecutive
+             * channels of a pixel, and of two consecutive pixels of a channel, in
+             * an image of "nb_channels" channels of "nb_pixels" pixels (the value
+             * of the channel "c" of the pixel "p" is at "c * first + p * second").
+             */
+            std::pair<size_t, size_t> _get_strides(size_t nb_channels, size_t nb_pixels) const;
+
+            /**
+             * Forward propagation of the inputs saved in the replica.
+             */
+            matrix _forward(size_t replica);
+
+            /**
+             * Outputs of an image (before the activation function), with the
+             * patches of the inputs copied in columns (by blocks of output pixels),
+             * multiplied by the filters.
+             */
+            void _forward_im2col(const float *inputs, float *outputs) const;
+
+            /**
+             * Outputs of an image (before the activation function), by
+             * Winograd F(2x2, 3x3) (by blocks of 2x2 output pixels).
+             */
+            void _forward_winograd(const float *inputs, float *outputs) const;
+
+            /**
+             * Add the gradients of the filters and of the biases of an image.
+             * @param errors - the errors on the outputs (before the activation
+             * function).
+             */
+            void _backward_filters(const float *inputs, const float *errors,
+                                   float *filter_gradients, float *bias_gradients) const;
+
+            /**
+             * @param input_errors - receives the errors on the inputs of an image.
+             */
+            void _backward_inputs(const float *errors, float *input_errors) const;
+
+            const size_t _channels;
+            const size_t _height;
+            const size_t _width;
+            const size_t _nb_filters;
+            const size_t _kernel_size;
+            const size_t _stride;
+            const size_t _padding;
+            const size_t _output_height;
+            const size_t _output_width;
+            const function &_activation_function;
+            const layouts _layout;
+            convolution_algorithms _algorithm;
+
+            /**
+             * @_filters - a row per filter: the weights of the channel "c", row "i"
+             * and column "j" of the filter are at the column "(c * kernel_size + i)
+             * * kernel_size + j".
+             * @_biases - a column per filter, and only one row.
+             */
+            matrix _filters;
+            matrix _biases;
+
+            /**
+             * Buffers of the backpropagation and gradient descent (of a replica).
+             * @inputs - the current inputs (the outputs from the previous layer).
+             * @derivatives - the derivatives of the activation function on the
+             * current outputs.
+             * @filter_gradients, @bias_gradients - the sums over the entries of the
+             * batch (dimensions of the parameters).
+             * @first_entry - true if no entry has been processed since the last update.
+             */
+            struct replica
+            {
+                matrix inputs;
+                matrix derivatives;
+                matrix filter_gradients;
+                matrix bias_gradients;
+                bool first_entry = true;
+            };
+
+            std::vector<replica> _replicas;
+    };
+}
+
+
+#endif //CUDANN_CONVOLUTION_H
@@ -0,0 +1,285 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "dropout.h"
+#include "lib/util/parallel/parallel.h"
+#include "lib/util/profiler/profiler.h"
+
+#include <algorithm>
+
+
+using namespace cudaNN;
+
+
+namespace
+{
+    /**
+     * outputs[j] = inputs[j] * scale if the bit n°j is set, 0 otherwise.
+     * (Selection instead of a branch: vectorized.)
+     */
+    void apply_word(const float *inputs, uint32_t bits, size_t length, float scale,
+                    float *outputs)
+    {
+        for (size_t j = 0; j < length; j ++)
+        {
+            outputs[j] = inputs[j] * (((bits >> j) & 1u) != 0 ? scale : 0.f);
+        }
+    }
+}
+
+
+dropout::dropout(size_t size, float rate):
+        dropout(size, rate, rng::next_seed())
+{
+}
+
+dropout::dropout(size_t size, float rate, uint64_t seed):
+        _size(size),
+        _rate(rate),
+        _seed(seed),
+        _key(rng::make_key(seed)),
+        _keep_masks(true),
+        _training(false),
+        _replicas(1)
+{
+    if (size == 0 || ! (rate >= 0.f && rate < 1.f))
+    {
+        // Invalid.
+        util::ERROR("dropout::dropout",
+                    "Invalid rate " + std::to_string(rate) + " for "
+                    + std::to_string(size) + " inputs");
+        util::ERROR_EXIT();
+    }
+}
+
+matrix dropout::feed_forward(matrix &inputs, size_t replica /*= 0*/)
+{
+    if (inputs.get_dimensions().second != _size)
+    {
+        // Invalid.
+        util::ERROR("dropout::feed_forward",
+                    "Invalid @inputs size ("
+                    + std::to_string(inputs.get_dimensions().second)
+                    + " instead of "
+                    + std::to_string(_size)
+                    + ")");
+        util::ERROR_EXIT();
+    }
+
+    auto &r = _replicas[replica];
+
+    if (! _training)
+    {
+        // Predictions: identity.
+        r.dropped = false;
+
+        return matrix(inputs, "dropout::outputs");
+    }
+
+    if (r.released)
+    {
+        // The same entry, computed again.
+        r.released = false;
+    }
+    else
+    {
+        r.entry = r.nb_entries ++;
+        r.in_progress = true;
+    }
+
+    // (The inputs are not kept: only the mask is used by the backpropagation.)
+    return _forward(replica, inputs);
+}
+
+matrix dropout::recompute(size_t replica)
+{
+    _replicas[replica].released = false;
+
+    return _forward(replica, _replicas[replica].inputs);
+}
+
+bool dropout::needs_inputs() const
+{
+    return false;
+}
+
+void dropout::keep_inputs(const matrix &inputs, size_t replica)
+{
+    _replicas[replica].inputs = inputs;
+}
+
+matrix dropout::_forward(size_t replica, const matrix &inputs)
+{
+    auto &r = _replicas[replica];
+    r.nb_values = inputs.get_length();
+    r.dropped = true;
+    PROFILE_SCOPE("dropout", "forward", inputs.get_dimensions().first, _size, 1,
+                  (double) r.nb_values * 2. * sizeof(float));
+    auto outputs = matrix(inputs.get_dimensions(), "dropout::outputs");
+    r.masks.clear();
+    _apply(replica, inputs.get_data(), outputs.get_data(), _keep_masks);
+
+    return outputs;
+}
+
+void dropout::backward_propagation(matrix &errors, size_t replica /*= 0*/,
+                                   bool propagate /*= true*/)
+{
+    auto &r = _replicas[replica];
+    r.in_progress = false;
+
+    if (! propagate || ! r.dropped)
+    {
+        // No parameters: nothing to compute.
+        return;
+    }
+
+    PROFILE_SCOPE("dropout", r.masks.empty() ? "backward_propagation (generated)" : "backward_propagation",
+                  errors.get_dimensions().first, _size, 1, (double) r.nb_values * 2. * sizeof(float));
+    _apply(replica, errors.get_data(), errors.get_data(), false);
+}
+
+void dropout::_apply(size_t replica, const float *inputs, float *outputs, bool keep)
+{
+    auto &r = _replicas[replica];
+    auto nb_words = (r.nb_values + 31) / 32;
+    auto generate = r.masks.empty();
+    auto first = _get_counter(replica);
+    auto scale = 1.f / (1.f - _rate);
+    keep = keep && generate;
+
+    if (keep)
+    {
+        r.masks.resize(nb_words);
+    }
+
+    // (The generation of a word costs about 500 operations.)
+    parallel::for_range(nb_words, std::max((size_t) 1, (size_t) PARALLEL_MIN_CHUNK_SIZE / 512),
+                        [&](size_t begin, size_t end)
+    {
+        for (size_t w = begin; w < end; w ++)
+        {
+            auto bits = generate ? rng::bernoulli_word(_key, first, w, 1.f - _rate) : r.masks[w];
+
+            if (keep)
+            {
+                r.masks[w] = bits;
+            }
+
+            apply_word(inputs + w * 32, bits, std::min((size_t) 32, r.nb_values - w * 32), scale,
+                       outputs + w * 32);
+        }
+    });
+}
+
+rng::counter dropout::_get_counter(size_t replica) const
+{
+    auto &r = _replicas[replica];
+
+    return {{ 0, r.entry, (uint32_t) replica, r.step }};
+}
+
+void dropout::release(size_t replica, bool keep_inputs)
+{
+    auto &r = _replicas[replica];
+    r.masks.clear();
+    r.masks.shrink_to_fit();
+    r.released = r.in_progress;
+
+    if (! keep_inputs)
+    {
+        r.inputs.clear();
+    }
+}
+
+void dropout::gradient_descent(size_t batch_size, float learning_rate)
+{
+    for (size_t i = 0; i < _replicas.size(); i ++)
+    {
+        apply_gradients(i, batch_size, learning_rate);
+    }
+}
+
+void dropout::apply_gradients(size_t replica, size_t, float)
+{
+    auto &r = _replicas[replica];
+    r.step ++;
+    r.nb_entries = 0;
+}
+
+void dropout::clear_gradients()
+{
+    for (auto &r: _replicas)
+    {
+        r.nb_entries = 0;
+    }
+}
+
+void dropout::set_nb_replicas(size_t nb_replicas)
+{
+    _replicas.resize(std::max((size_t) 1, nb_replicas));
+}
+
+size_t dropout::get_nb_replicas() const
+{
+    return _replicas.size();
+}
+
+void dropout::set_training(bool training)
+{
+    _training = training;
+    clear_gradients();
+}
+
+std::vector<matrix *> dropout::get_parameters()
+{
+    return {};
+}
+
+std::vector<matrix *> dropout::get_gradients(size_t /*= 0*/)
+{
+    return {};
+}
+
+size_t dropout::size() const
+{
+    return _size;
+}
+
+size_t dropout::get_inputs_memory() const
+{
+    return _size * sizeof(float);
+}
+
+size_t dropout::get_workspace_memory() const
+{
+    return _keep_masks ? (_size + 31) / 32 * sizeof(uint32_t) : 0;
+}
+
+void dropout::set_keep_masks(bool keep_masks)
+{
+    _keep_masks = keep_masks;
+}
+
+bool dropout::get_keep_masks() const
+{
+    return _keep_masks;
+}
+
+float dropout::get_rate() const
+{
+    return _rate;
+}
+
+uint64_t dropout::get_seed() const
+{
+    return _seed;
+}
+
+void dropout::_print() const
+{
+    std::cout << "Dropout:    rate " << _rate << ", seed " << _seed
+              << (_keep_masks ? "" : " (masks generated again)") << std::endl;
+    std::cout << "Size:       " << _size << std::endl;
+}
@@ -0,0 +1,171 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#ifndef CUDANN_DROPOUT_H
+#define CUDANN_DROPOUT_H
+
+#include "lib/models/neural_network/layers/base_layer.h"
+#include "lib/util/rng/rng.h"
+#include "lib/util/util.h"
+
+#include <cstdint>
+#include <vector>
+
+
+namespace cudaNN
+{
+    /**
+     * Regularization layer: during a training, each input is set to 0 with the
+     * probability "rate", and the other ones are scaled by "1 / (1 - rate)"
+     * (same expected outputs). No parameters; the outputs are a copy of the
+     * inputs otherwise (no random numbers, no buffers).
+     * The masks are counter-based random bits (see -rng.h-), of the position
+     * "(step, replica, entry)": the number of updates, the replica, and the
+     * entry of the replica since the last update. They are kept as bitmasks
+     * (1 bit per input), or generated again during the backpropagation (see
+     * "set_keep_masks"); an entry computed again (activation checkpointing)
+     * has the same mask.
+     */
+    class dropout: public base_layer
+    {
+        public:
+
+            /**
+             * @param size - the number of inputs (and outputs).
+             * @param rate - the probability of each input to be dropped, in [0, 1[.
+             * @param seed - the sequence of the masks; by default, a new seed of the
+             * seed of the library (see -rng.h/next_seed-): distinct masks, reproduced
+             * by setting the same seed before building the layers.
+             */
+            dropout(size_t size, float rate);
+            dropout(size_t size, float rate, uint64_t seed);
+
+            matrix feed_forward(matrix &inputs, size_t replica = 0) override;
+            void backward_propagation(matrix &errors, size_t replica = 0,
+                                      bool propagate = true) override;
+            void release(size_t replica, bool keep_inputs) override;
+            matrix recompute(size_t replica) override;
+
+            /**
+             * @return - false: the backpropagation only uses the masks.
+             */
+            bool needs_inputs() const override;
+            void keep_inputs(const matrix &inputs, size_t replica) override;
+
+            /**
+             * No parameters: the next masks are the ones of the next step.
+             */
+            void gradient_descent(size_t batch_size, float learning_rate) override;
+            void apply_gradients(size_t replica, size_t batch_size, float learning_rate) override;
+
+            /**
+             * The next masks are the ones of the first entries of the step.
+             */
+            void clear_gradients() override;
+
+            void set_nb_replicas(size_t nb_replicas) override;
+            size_t get_nb_replicas() const override;
+
+            /**
+             * @param training - if set, the inputs are dropped, from the masks of
+             * the first entries of the current step (e.g. to propagate the entries
+             * of "neural_network::compute_gradients" again, with the same masks).
+             */
+            void set_training(bool training) override;
+
+            std::vector<matrix *> get_parameters() override;
+            std::vector<matrix *> get_gradients(size_t replica = 0) override;
+
+            size_t size() const override;
+
+            /**
+             * @return - the inputs, kept at the checkpoints only (see "needs_inputs").
+             */
+            size_t get_inputs_memory() const override;
+
+            /**
+             * @return - the bitmask (if kept, see "set_keep_masks").
+             */
+            size_t get_workspace_memory() const override;
+
+            /**
+             * @param keep_masks - if set (default), the mask of an entry is kept
+             * between its forward and backward propagations (1 bit per input);
+             * otherwise it is generated again during the backpropagation (no
+             * memory, for the cost of a second generation).
+             */
+            void set_keep_masks(bool keep_masks);
+            bool get_keep_masks() const;
+
+            float get_rate() const;
+            uint64_t get_seed() const;
+
+        protected:
+
+            /**
+             * Print the size, the rate and the seed.
+             */
+            void _print() const override;
+
+        private:
+
+            /**
+             * Forward propagation of "inputs", with the mask of the current entry
+             * of the replica.
+             */
+            matrix _forward(size_t replica, const matrix &inputs);
+
+            /**
+             * values[i] *= mask[i] / (1 - rate), from the mask of the current entry
+             * of the replica: kept one ("masks"), or generated (and kept if
+             * "keep" is set).
+             */
+            void _apply(size_t replica, const float *inputs, float *outputs, bool keep);
+
+            /**
+             * @return - the position of the first bits of the mask of the current
+             * entry of the replica.
+             */
+            rng::counter _get_counter(size_t replica) const;
+
+            const size_t _size;
+            const float _rate;
+            const uint64_t _seed;
+            const rng::key _key;
+            bool _keep_masks;
+            bool _training;
+
+            /**
+             * State and buffers of the propagations (of a replica).
+             * @inputs - the current inputs, at a checkpoint (see "keep_inputs").
+             * @masks - the mask of the current entry (a bit per input, 1 to keep it).
+             * @nb_values - the number of values of the current inputs.
+             * @dropped - false if the current inputs were not dropped (predictions).
+             * @step - the number of updates of the replica.
+             * @nb_entries - the number of entries propagated since the last update.
+             * @entry - the index of the current entry (since the last update).
+             * @in_progress - true if the current entry has not been backpropagated.
+             * @released - true if the buffers of the current entry have been
+             * released before its backpropagation: the next forward propagation
+             * is the one of the same entry (same mask).
+             */
+            struct replica
+            {
+                matrix inputs;
+                std::vector<uint32_t> masks;
+                size_t nb_values = 0;
+                bool dropped = false;
+                uint32_t step = 0;
+                uint32_t nb_entries = 0;
+                uint32_t entry = 0;
+                bool in_progress = false;
+                bool released = false;
+            };
+
+            std::vector<replica> _replicas;
+    };
+}
+
+
+#endif //CUDANN_DROPOUT_H
@@ -0,0 +1,34 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "embedding.h"
+
+
+using namespace cudaNN;
+
+
+embedding::embedding(size_t vocabulary_size, size_t dimension,
+                     initializations init /*= initializations::XAVIER*/,
+                     const function &activation_function /*= activation_functions::LINEAR*/):
+        layer(vocabulary_size, dimension, init, activation_function, input_types::IDS)
+{
+}
+
+matrix embedding::lookup(size_t id)
+{
+    if (id >= get_vocabulary_size())
+    {
+        // Invalid.
+        util::ERROR("embedding::lookup", "Invalid id " + std::to_string(id)
+                    + " (vocabulary of " + std::to_string(get_vocabulary_size()) + ")");
+        util::ERROR_EXIT();
+    }
+
+    return matrix(get_weights().get_data() + id * size(), { 1, size() }, "embedding::lookup");
+}
+
+size_t embedding::get_vocabulary_size()
+{
+    return get_weights().get_dimensions().first;
+}
@@ -0,0 +1,49 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#ifndef CUDANN_EMBEDDING_H
+#define CUDANN_EMBEDDING_H
+
+#include "lib/models/neural_network/layers/layer.h"
+
+
+namespace cudaNN
+{
+    /**
+     * Layer whose inputs are ids (a row of indices per entry, e.g. the values
+     * of categorical features), each one selecting a row of the weights: the
+     * vector of the id. The vectors of the ids of an entry are summed (bag of
+     * ids) with the biases, and given to the activation function.
+     * The forward propagation gathers the rows of the ids, and the
+     * backpropagation only computes (and the updates only apply) the gradients
+     * of these rows (scatter-add): the cost of the layer does not depend on
+     * the size of the vocabulary.
+     * To be the first layer of a neural network.
+     */
+    class embedding: public layer
+    {
+        public:
+
+            /**
+             * @param vocabulary_size - the number of ids (rows of the weights).
+             * @param dimension - the size of the vectors (number of neurons).
+             * @param init - the type of initialization of the vectors (the
+             * fan-in being a single id: unit variance for XAVIER).
+             * @param activation_function - the function applied on the sums.
+             */
+            embedding(size_t vocabulary_size, size_t dimension,
+                      initializations init = initializations::XAVIER,
+                      const function &activation_function = activation_functions::LINEAR);
+
+            /**
+             * @return - the vector of "id" (a copy of its row of the weights).
+             */
+            matrix lookup(size_t id);
+
+            size_t get_vocabulary_size();
+    };
+}
+
+
+#endif //CUDANN_EMBEDDING_H
@@ -3,6 +3,8 @@
 //
 
 #include "layer.h"
+#include "lib/util/parallel/parallel.h"
+#include "lib/util/profiler/profiler.h"
 
 
 using namespace cudaNN;
@@ -11,11 +13,18 @@ using namespace cudaNN;
 layer::layer(const size_t input_size, const size_t nb_neurons,
              initializations init /*= initializations::HE*/,
              const function &activation_function /*= activation_functions::LINEAR*/):
+        layer(input_size, nb_neurons, init, activation_function, input_types::DENSE)
+{
+}
+
+layer::layer(const size_t input_size, const size_t nb_neurons, initializations init,
+             const function &activation_function, input_types input_type):
 _size(nb_neurons),
 _biases(1, nb_neurons, "layer::biases"),
         _weights(input_size, nb_neurons, "layer::weights"),
         _activation_function(activation_function),
-        _first_entry(true)
+        _input_type(input_type),
+        _replicas(1)
 {
     _init_biases();
     _init_weights(init);
@@ -31,29 +40,17 @@ void layer::_init_biases()
 
 void layer::_init_weights(initializations init)
 {
-    std::random_device generator;
-    std::normal_distribution<float> distribution;
-
-    switch (init)
-    {
-        case initializations::XAVIER:
-            distribution = std::normal_distribution<float>(
-                    0.f, sqrtf(1.f / (float) _weights.get_dimensions().first));
-            break;
-        case initializations::HE:
-            distribution = std::normal_distribution<float>(
-                    0.f, sqrtf(2.f / (float) _weights.get_dimensions().first));
-            break;
-    }
+    // The outputs of an embedding are a row of the weights (a single input).
+    _initialize(_weights, init, _input_type == input_types::IDS ? 1 : _weights.get_dimensions().first);
+}
 
-    for (int i = 0; i < _weights.get_length(); i ++)
+matrix layer::feed_forward(matrix &inputs, size_t replica /*= 0*/)
+{
+    if (_input_type == input_types::IDS)
     {
-        _weights[i] = distribution(generator);
+        return _feed_forward_ids(inputs, replica);
     }
-}
 
-matrix layer::feed_forward(matrix &inputs)
-{
     if (inputs.get_dimensions().second != _weights.get_dimensions().first)
     {
         // Invalid.
@@ -65,49 +62,468 @@ matrix layer::feed_forward(matrix &inputs)
                     + ")");
         util::ERROR_EXIT();
     }
+    PROFILE_SCOPE("layer", "feed_forward", inputs.get_dimensions().first,
+                  _weights.get_dimensions().first, _weights.get_dimensions().second);
     // Save the inputs from previous layer.
-    _inputs = inputs;
-    // Compute the output of each neuron.
-    auto sum = _inputs * _weights + _biases;
-    // Compute the result of the activation function derivative on the inputs (for back propagation).
-    _derivatives = _activation_function.compute_derivatives({ &sum });
-    // Compute the result of the activation function on the inputs.
-    return _activation_function.compute({ &sum });
+    if (_input_type == input_types::SPARSE)
+    {
+        _replicas[replica].sparse_inputs = sparse_matrix(inputs);
+    }
+    else
+    {
+        _replicas[replica].inputs = inputs;
+    }
+
+    return _forward(replica);
 }
 
-void layer::backward_propagation(matrix &errors, layer *next)
+matrix layer::feed_forward(const sparse_matrix &inputs, size_t replica /*= 0*/)
 {
-    if (next != nullptr)
+    if (_input_type != input_types::SPARSE
+        || inputs.get_dimensions().second != _weights.get_dimensions().first)
     {
-        // If not the output layer.
-        errors = next->_weights * errors;
+        // Invalid.
+        util::ERROR("layer::feed_forward",
+                    "Invalid sparse @inputs (" + std::to_string(inputs.get_dimensions().second)
+                    + " columns for " + std::to_string(_weights.get_dimensions().first)
+                    + (_input_type == input_types::SPARSE ? " inputs)" : " inputs, not sparse)"));
+        util::ERROR_EXIT();
     }
+    PROFILE_SCOPE("layer", "feed_forward (sparse)", inputs.get_dimensions().first,
+                  inputs.get_nnz(), _weights.get_dimensions().second);
+    _replicas[replica].sparse_inputs = inputs;
+
+    return _forward(replica);
+}
+
+matrix layer::_feed_forward_ids(const matrix &inputs, size_t replica)
+{
+    PROFILE_SCOPE("layer", "feed_forward (ids)", inputs.get_dimensions().first,
+                  inputs.get_dimensions().second, _weights.get_dimensions().second);
+    // Each row of ids selects rows of the weights (one-hot, the repeated ids
+    // are summed): the sparse product gathers them.
+    auto nb_rows = inputs.get_dimensions().first;
+    auto nb_ids = inputs.get_dimensions().second;
+    auto vocabulary_size = _weights.get_dimensions().first;
+    auto rows = std::vector<size_t>(inputs.get_length());
+    auto ids = std::vector<size_t>(inputs.get_length());
+
+    for (size_t i = 0; i < inputs.get_length(); i ++)
+    {
+        auto id = inputs[(int) i];
+
+        if (id < 0.f || (size_t) id >= vocabulary_size || (float) (size_t) id != id)
+        {
+            // Invalid.
+            util::ERROR("layer::feed_forward",
+                        "Invalid id " + std::to_string(id) + " (vocabulary of "
+                        + std::to_string(vocabulary_size) + ")");
+            util::ERROR_EXIT();
+        }
+
+        rows[i] = i / nb_ids;
+        ids[i] = (size_t) id;
+    }
+
+    _replicas[replica].sparse_inputs = sparse_matrix({ nb_rows, vocabulary_size }, rows, ids,
+                                                     std::vector<float>(ids.size(), 1.f));
+
+    return _forward(replica);
+}
+
+void layer::set_sparse_inputs(bool sparse_inputs)
+{
+    if (_input_type == input_types::IDS)
+    {
+        // Invalid.
+        util::ERROR("layer::set_sparse_inputs", "The inputs of an embedding are ids");
+        util::ERROR_EXIT();
+    }
+
+    _input_type = sparse_inputs ? input_types::SPARSE : input_types::DENSE;
+
+    for (auto &r: _replicas)
+    {
+        // The gradients since the last update are discarded.
+        r = replica();
+    }
+}
+
+bool layer::has_sparse_inputs() const
+{
+    return _input_type != input_types::DENSE;
+}
+
+input_types layer::get_input_type() const
+{
+    return _input_type;
+}
+
+void layer::release(size_t replica, bool keep_inputs)
+{
+    auto &r = _replicas[replica];
+    r.derivatives.clear();
 
-    errors = errors.hadamard_product(_derivatives.transpose());
-    if (_first_entry)
+    if (! keep_inputs)
+    {
+        r.inputs.clear();
+        r.sparse_inputs = sparse_matrix();
+    }
+}
+
+matrix layer::recompute(size_t replica)
+{
+    PROFILE_SCOPE("layer", "recompute", _replicas[replica].inputs.get_dimensions().first,
+                  _weights.get_dimensions().first, _weights.get_dimensions().second);
+
+    return _forward(replica);
+}
+
+matrix layer::_forward(size_t replica)
+{
+    auto &r = _replicas[replica];
+    // Compute the output of each neuron (the biases are broadcast over the rows).
+    auto sum = has_sparse_inputs() ? r.sparse_inputs * _weights : r.inputs * _weights;
+    sum += _biases;
+    // Compute the result of the activation function on the inputs, and of its
+    // derivative (for back propagation; obtained from the outputs if possible).
+    auto outputs = _activation_function.compute_with_derivatives({ &sum }, r.derivatives);
+
+    if (activation_functions::is_row_wise(_activation_function))
+    {
+        // The outputs instead (see "_propagate_row_wise").
+        r.derivatives = outputs;
+    }
+
+    return outputs;
+}
+
+void layer::_propagate_row_wise(matrix &errors, const matrix &outputs) const
+{
+    auto nb_columns = errors.get_dimensions().second;
+    float *e = errors.get_data();
+    const float *y = outputs.get_data();
+
+    // Product of the Jacobian of the softmax ("diag(y) - y yt") and the errors,
+    // on each row: "y * (errors - sum(errors * y))".
+    parallel::for_range(errors.get_dimensions().first, 1, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i ++)
+        {
+            float *row = e + i * nb_columns;
+            const float *y_row = y + i * nb_columns;
+            float dot = 0.f;
+
+            for (size_t j = 0; j < nb_columns; j ++)
+            {
+                dot += row[j] * y_row[j];
+            }
+
+            for (size_t j = 0; j < nb_columns; j ++)
+            {
+                row[j] = y_row[j] * (row[j] - dot);
+            }
+        }
+    });
+}
+
+void layer::backward_propagation(matrix &errors, size_t replica /*= 0*/,
+                                 bool propagate /*= true*/)
+{
+    PROFILE_SCOPE("layer", "backward_propagation",
+                  _weights.get_dimensions().first, _weights.get_dimensions().second);
+    auto &r = _replicas[replica];
+    auto nb_rows = errors.get_dimensions().first;
+    // The errors on the inputs of the activation function.
+    if (activation_functions::is_row_wise(_activation_function))
+    {
+        _propagate_row_wise(errors, r.derivatives);
+    }
+    else
+    {
+        errors.hadamard_product_in_place(r.derivatives);
+    }
+    // (The biases are broadcast over the rows of inputs.)
+    auto bias_errors = nb_rows == 1 ? errors : errors.reduce_cols(reductions::SUM);
+
+    // Gradients of the entry.
+    if (has_sparse_inputs())
+    {
+        // Only the rows of the non-zero inputs.
+        _add_sparse_gradients(r, errors, r.first_entry);
+    }
+    else if (r.first_entry)
     {
         // The first entry of the batch (i.e. first computed errors).
-        _errors = errors;
-        _first_entry = false;
+        r.weight_gradients = r.inputs.transpose() * errors;
+    }
+    else
+    {
+        r.weight_gradients += r.inputs.transpose() * errors;
+    }
+
+    if (r.first_entry)
+    {
+        r.bias_gradients = bias_errors;
+        r.first_entry = false;
     }
     else
     {
-        _errors += errors;
+        r.bias_gradients += bias_errors;
     }
 
-    if(next == nullptr)
+    if (propagate)
     {
-        _errors = _errors.transpose();
+        // The errors on the inputs (the outputs of the previous layer).
+        errors = (_weights * errors.transpose()).transpose();
     }
 }
 
 void layer::gradient_descent(size_t batch_size, float learning_rate)
 {
+    PROFILE_SCOPE("layer", "gradient_descent",
+                  _weights.get_dimensions().first, _weights.get_dimensions().second);
+    // The replicas that processed entries.
+    auto replicas = std::vector<replica *>();
+    auto weight_gradients = std::vector<float *>();
+    auto bias_gradients = std::vector<float *>();
+
+    for (auto &r: _replicas)
+    {
+        if (! r.first_entry)
+        {
+            replicas.push_back(&r);
+            weight_gradients.push_back(has_sparse_inputs() ? nullptr : r.weight_gradients.get_data());
+            bias_gradients.push_back(r.bias_gradients.get_data());
+            // Reset for next backpropagation.
+            r.first_entry = true;
+        }
+    }
+
+    if (replicas.empty())
+    {
+        return;
+    }
+
+    // Sum of the gradients of the batch, in the first of these replicas.
+    _reduce(bias_gradients, _biases.get_length());
+    auto &sum = *replicas[0];
+
+    if (has_sparse_inputs())
+    {
+        // Same tree as "_reduce", over the touched rows only.
+        for (size_t stride = 1; stride < replicas.size(); stride *= 2)
+        {
+            for (size_t i = 0; i + stride < replicas.size(); i += 2 * stride)
+            {
+                _merge_sparse_gradients(*replicas[i], *replicas[i + stride]);
+            }
+        }
+
+        _apply_sparse_gradients(sum, learning_rate / (float) batch_size, false);
+    }
+    else
+    {
+        _reduce(weight_gradients, _weights.get_length());
+        _weights -= sum.weight_gradients * (learning_rate / (float) batch_size);
+    }
+
     // Update weights and biases.
-    _weights -= (_errors * _inputs).transpose() * (learning_rate / (float) batch_size);
-    _biases -= _errors.transpose() * (learning_rate / (float) batch_size);
+    _biases -= sum.bias_gradients * (learning_rate / (float) batch_size);
+}
+
+void layer::apply_gradients(size_t replica, size_t batch_size, float learning_rate)
+{
+    PROFILE_SCOPE("layer", "apply_gradients",
+                  _weights.get_dimensions().first, _weights.get_dimensions().second);
+    auto &r = _replicas[replica];
+
+    if (r.first_entry)
+    {
+        return;
+    }
+
     // Reset for next backpropagation.
-    _first_entry = true;
+    r.first_entry = true;
+
+    // In place, each element updated atomically (see "base_layer::_subtract").
+    auto scale = learning_rate / (float) batch_size;
+
+    if (has_sparse_inputs())
+    {
+        _apply_sparse_gradients(r, scale, true);
+    }
+    else
+    {
+        _subtract(_weights.get_data(), r.weight_gradients.get_data(), _weights.get_length(), scale, true);
+    }
+
+    _subtract(_biases.get_data(), r.bias_gradients.get_data(), _size, scale, true);
+}
+
+void layer::_add_sparse_gradients(replica &r, const matrix &errors, bool reset)
+{
+    if (reset)
+    {
+        r.slots.clear();
+        r.touched_rows.clear();
+        r.row_gradients.clear();
+    }
+    // "errors" has a row per row of inputs (and a column per neuron).
+    auto &inputs = r.sparse_inputs;
+    auto nb_rows = inputs.get_dimensions().first;
+    auto &offsets = inputs.get_row_offsets();
+    auto &columns = inputs.get_columns();
+    auto &values = inputs.get_values();
+    const float *e = errors.get_data();
+
+    for (size_t k = 0; k < nb_rows; k ++)
+    {
+        for (size_t p = offsets[k]; p < offsets[k + 1]; p ++)
+        {
+            // (The slot may grow "row_gradients".)
+            auto slot = _get_slot(r, columns[p]);
+            float *gradients = r.row_gradients.data() + slot * _size;
+
+            for (size_t j = 0; j < _size; j ++)
+            {
+                gradients[j] += e[k * _size + j] * values[p];
+            }
+        }
+    }
+}
+
+size_t layer::_get_slot(replica &r, size_t row)
+{
+    auto slot = r.slots.insert({ row, r.touched_rows.size() });
+
+    if (slot.second)
+    {
+        // First gradient of the row since the last update.
+        r.touched_rows.push_back(row);
+        r.row_gradients.resize(r.row_gradients.size() + _size, 0.f);
+    }
+
+    return slot.first->second;
+}
+
+void layer::_merge_sparse_gradients(replica &r, const replica &source)
+{
+    // The rows of "source" without gradient in "r" start at 0.
+    auto slots = std::vector<size_t>(source.touched_rows.size());
+
+    for (size_t s = 0; s < source.touched_rows.size(); s ++)
+    {
+        slots[s] = _get_slot(r, source.touched_rows[s]);
+    }
+
+    parallel::for_range(source.touched_rows.size(),
+                        std::max((size_t) 1, PARALLEL_MIN_CHUNK_SIZE / _size),
+                        [&](size_t begin, size_t end)
+    {
+        for (size_t s = begin; s < end; s ++)
+        {
+            float *gradients = r.row_gradients.data() + slots[s] * _size;
+            const float *gradients2 = source.row_gradients.data() + s * _size;
+
+            for (size_t j = 0; j < _size; j ++)
+            {
+                gradients[j] += gradients2[j];
+            }
+        }
+    });
+}
+
+void layer::_apply_sparse_gradients(const replica &r, float scale, bool atomic)
+{
+    // Each touched row once: the rows are split over the threads.
+    auto weights = _weights.get_data();
+
+    parallel::for_range(r.touched_rows.size(), std::max((size_t) 1, PARALLEL_MIN_CHUNK_SIZE / _size),
+                        [&](size_t begin, size_t end)
+    {
+        for (size_t s = begin; s < end; s ++)
+        {
+            _subtract(weights + r.touched_rows[s] * _size, r.row_gradients.data() + s * _size,
+                      _size, scale, atomic);
+        }
+    });
+}
+
+void layer::clear_gradients()
+{
+    for (auto &r: _replicas)
+    {
+        // Overwritten by the next backpropagation.
+        r.first_entry = true;
+    }
+}
+
+void layer::set_nb_replicas(size_t nb_replicas)
+{
+    _replicas.resize(std::max((size_t) 1, nb_replicas));
+}
+
+size_t layer::get_nb_replicas() const
+{
+    return _replicas.size();
+}
+
+std::vector<matrix *> layer::get_parameters()
+{
+    return { &_weights, &_biases };
+}
+
+std::vector<matrix *> layer::get_gradients(size_t replica /*= 0*/)
+{
+    auto &r = _replicas[replica];
+
+    if (has_sparse_inputs())
+    {
+        r.weight_gradients = matrix(_weights.get_dimensions(), "layer::weight_gradients");
+
+        for (size_t s = 0; s < r.touched_rows.size(); s ++)
+        {
+            for (size_t j = 0; j < _size; j ++)
+            {
+                r.weight_gradients[(int) (r.touched_rows[s] * _size + j)] = r.row_gradients[s * _size + j];
+            }
+        }
+    }
+
+    return { &r.weight_gradients, &r.bias_gradients };
+}
+
+bool layer::has_dense_gradients() const
+{
+    return ! has_sparse_inputs();
+}
+
+bool layer::can_propagate() const
+{
+    return _input_type != input_types::IDS;
+}
+
+size_t layer::get_inputs_memory() const
+{
+    // (The sparse inputs are not counted.)
+    return has_sparse_inputs() ? 0 : _weights.get_dimensions().first * sizeof(float);
+}
+
+size_t layer::get_workspace_memory() const
+{
+    // The derivatives of the activation function.
+    return _size * sizeof(float);
+}
+
+matrix &layer::get_weights()
+{
+    return _weights;
+}
+
+matrix &layer::get_biases()
+{
+    return _biases;
 }
 
 size_t layer::size() const
@@ -122,7 +538,14 @@ std::string layer::get_activation_function() const
 
 void layer::print_neurons()
 {
-    matrix::print(_inputs);
+    if (has_sparse_inputs())
+    {
+        sparse_matrix::print(_replicas[0].sparse_inputs);
+    }
+    else
+    {
+        matrix::print(_replicas[0].inputs);
+    }
 }
 
 void layer::print_weights()
@@ -137,11 +560,16 @@ void layer::print_biases()
 
 void layer::print_errors()
 {
-    matrix::print(_errors);
+    matrix::print(_replicas[0].bias_gradients);
 }
 
-void layer::print(const layer &l)
+void layer::_print() const
 {
-    std::cout << "Activation: " << l._activation_function.get_id() << std::endl;
-    std::cout << "Size:       " << l._size << std::endl;
+    std::cout << "Activation: " << _activation_function.get_id() << std::endl;
+    std::cout << "Size:       " << _size << std::endl;
+
+    if (has_sparse_inputs())
+    {
+        std::cout << "Inputs:     " << (_input_type == input_types::IDS ? "ids" : "sparse") << std::endl;
+    }
 }
\ No newline at end of file
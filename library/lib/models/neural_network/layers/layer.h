@@ -5,24 +5,30 @@
 #ifndef CUDANN_LAYER_H
 #define CUDANN_LAYER_H
 
-#include "lib/models/neural_network/layers/layer.h"
+#include "lib/models/neural_network/layers/base_layer.h"
+#include "lib/data_structures/sparse_matrix/sparse_matrix.h"
 #include "lib/functions/activation_functions/activation_functions.h"
 #include "lib/util/util.h"
 
-#include <random>
+#include <unordered_map>
+#include <vector>
 
 
 namespace cudaNN
 {
     /**
-     * Layer weights type of initialization.
-     * @XAVIER - for tanh activation.
-     * @HE - for RELU activation.
+     * Type of the inputs of a layer.
+     * @DENSE - a row of values per entry.
+     * @SPARSE - a row of values per entry, mostly zeros (stored sparse,
+     * see "layer::set_sparse_inputs").
+     * @IDS - a row of indices of rows of the weights per entry (embedding,
+     * see -embedding.h-).
      */
-    enum initializations
+    enum input_types
     {
-        XAVIER,
-        HE
+        DENSE,
+        SPARSE,
+        IDS
     };
 
 
@@ -32,7 +38,7 @@ namespace cudaNN
      * The input of this function (for each neuron) is the
      * weighted sum of the previous layer outputs, summed with a bias.
      */
-    class layer
+    class layer: public base_layer
     {
         public:
 
@@ -46,12 +52,76 @@ namespace cudaNN
                   initializations init = initializations::HE,
                   const function &activation_function = activation_functions::LINEAR);
 
-            matrix feed_forward(matrix &inputs);
-            void backward_propagation(matrix &errors, layer *next);
-            void gradient_descent(size_t batch_size, float learning_rate);
+            /**
+             * Forward and backward propagation of an entry (see -base_layer.h-).
+             * The replicas keep the inputs and the derivatives of the activation
+             * function, and the gradients.
+             */
+            matrix feed_forward(matrix &inputs, size_t replica = 0) override;
+            void backward_propagation(matrix &errors, size_t replica = 0,
+                                      bool propagate = true) override;
+
+            /**
+             * Forward propagation of inputs that are already sparse (the layer
+             * must have sparse inputs, see "set_sparse_inputs").
+             */
+            matrix feed_forward(const sparse_matrix &inputs, size_t replica = 0);
+
+            /**
+             * @param sparse_inputs - if set, the inputs are mostly zeros (e.g. one-hot
+             * or bag-of-words features of a first layer): they are stored sparse, the
+             * forward propagation is a sparse product, and the backpropagation only
+             * computes (and the updates only apply) the gradients of the rows of the
+             * weights of the non-zero inputs. The cost of the layer depends on the
+             * number of non-zero inputs instead of the number of inputs.
+             */
+            void set_sparse_inputs(bool sparse_inputs);
+
+            /**
+             * @return - true if the inputs are stored sparse (sparse inputs, or ids).
+             */
+            bool has_sparse_inputs() const;
+            input_types get_input_type() const;
+
+            void release(size_t replica, bool keep_inputs) override;
+            matrix recompute(size_t replica) override;
+            void gradient_descent(size_t batch_size, float learning_rate) override;
+            void apply_gradients(size_t replica, size_t batch_size, float learning_rate) override;
+            void clear_gradients() override;
+            void set_nb_replicas(size_t nb_replicas) override;
+            size_t get_nb_replicas() const override;
+
+            /**
+             * @return - the weights and the biases.
+             */
+            std::vector<matrix *> get_parameters() override;
+
+            /**
+             * @return - the gradients of the weights and of the biases. With
+             * sparse inputs, the weight gradients are only kept for the non-zero
+             * inputs: they are copied in a dense matrix on each call.
+             */
+            std::vector<matrix *> get_gradients(size_t replica = 0) override;
+
+            /**
+             * @return - false with sparse inputs (or ids): the gradients of a replica
+             * only cover the rows of the weights of its non-zero inputs.
+             */
+            bool has_dense_gradients() const override;
+
+            /**
+             * @return - false for ids.
+             */
+            bool can_propagate() const override;
+
+            size_t get_inputs_memory() const override;
+            size_t get_workspace_memory() const override;
+
+            matrix &get_weights();
+            matrix &get_biases();
 
             std::string get_activation_function() const;
-            size_t size() const;
+            size_t size() const override;
 
             /**
              * Printing functions of the layer.
@@ -61,11 +131,19 @@ namespace cudaNN
             void print_biases();
             void print_errors();
 
+        protected:
+
+            /**
+             * @param input_type - the type of the inputs (the number of
+             * inputs being the number of rows of the weights).
+             */
+            layer(size_t input_size, size_t nb_neurons, initializations init,
+                  const function &activation_function, input_types input_type);
+
             /**
-             * Print the given layer (activation function and size).
-             * @param l - the layer concerned.
+             * Print the activation function and the size of the layer.
              */
-            static void print(const layer &l);
+            void _print() const override;
 
         private:
 
@@ -82,6 +160,49 @@ namespace cudaNN
              */
             void _init_weights(initializations init);
 
+            /**
+             * Forward propagation of the inputs saved in the replica.
+             */
+            matrix _forward(size_t replica);
+
+            /**
+             * Errors on the inputs of a row-wise activation function (softmax),
+             * from the errors on its outputs and the "outputs", in place.
+             */
+            void _propagate_row_wise(matrix &errors, const matrix &outputs) const;
+
+            /**
+             * Forward propagation of a row of ids per entry (embedding).
+             */
+            matrix _feed_forward_ids(const matrix &inputs, size_t replica);
+
+            struct replica;
+
+            /**
+             * Sparse inputs: add "inputs^T * errors" to the gradients of the rows of
+             * the weights of the non-zero inputs of the replica (reset first if
+             * "reset").
+             */
+            void _add_sparse_gradients(replica &r, const matrix &errors, bool reset);
+
+            /**
+             * @return - the index of the gradients of the row n°"row" of the weights
+             * in "r" (added, at 0, if the row has no gradient).
+             */
+            size_t _get_slot(replica &r, size_t row);
+
+            /**
+             * Sparse inputs: add the gradients of "source" to the ones of "r".
+             */
+            void _merge_sparse_gradients(replica &r, const replica &source);
+
+            /**
+             * Sparse inputs: update the rows of the weights with a gradient in "r".
+             * @param scale - the learning rate, divided by the size of the batch.
+             * @param atomic - Hogwild!: see -base_layer.h/_subtract-.
+             */
+            void _apply_sparse_gradients(const replica &r, float scale, bool atomic);
+
             /**
              * Dimension of the layer (number of neurons).
              */
@@ -92,6 +213,11 @@ namespace cudaNN
              */
             const function &_activation_function;
 
+            /**
+             * The type of the inputs (see "set_sparse_inputs", and -embedding.h-).
+             */
+            input_types _input_type;
+
             /**
              * Parameters to compute the input of the activation function.
              * The functions of the neuron n°i in the layer are
@@ -105,19 +231,38 @@ namespace cudaNN
             matrix _weights;
 
             /**
-             * Parameters of the backpropagation and gradient descent.
-             * @_derivatives - to store the results of the derivative of the activation
-             * function on the current inputs.
-             * @_inputs - to store the current inputs (the outputs from previous layer).
-             * @_errors - the sum of the errors for the batch. Computed during the
-             * backpropagation.
-             * @_first_entry - true if it is the errors on the first entry of the batch that
+             * Parameters of the backpropagation and gradient descent (of a replica).
+             * @derivatives - to store the results of the derivative of the activation
+             * function on the current inputs (its outputs if it is row-wise, see
+             * -activation_functions.h/is_row_wise-).
+             * @inputs - to store the current inputs (the outputs from previous layer).
+             * @weight_gradients, @bias_gradients - the sums over the entries of the
+             * batch of "inputs^T * errors" and of "errors" (the errors on the outputs
+             * of the activation function), with the dimensions of the parameters.
+             * @first_entry - true if it is the errors on the first entry of the batch that
              * are currently processed during the backpropagation process.
+             * @sparse_inputs - the inputs, if they are sparse (instead of "inputs").
+             * @touched_rows - sparse inputs: the rows of the weights with a gradient
+             * since the last update (in order of first use), instead of "weight_gradients".
+             * @slots - sparse inputs: the index in "touched_rows" of the touched rows
+             * (hashed: its size does not depend on the number of inputs).
+             * @row_gradients - sparse inputs: the gradients of the touched rows (a
+             * row of "_size" values per touched row).
              */
-            matrix _derivatives;
-            matrix _inputs;
-            matrix _errors;
-            bool _first_entry;
+            struct replica
+            {
+                matrix derivatives;
+                matrix inputs;
+                matrix weight_gradients;
+                matrix bias_gradients;
+                bool first_entry = true;
+                sparse_matrix sparse_inputs;
+                std::vector<size_t> touched_rows;
+                std::unordered_map<size_t, size_t> slots;
+                std::vector<float> row_gradients;
+            };
+
+            std::vector<replica> _replicas;
     };
 }
 
@@ -0,0 +1,648 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "normalization.h"
+#include "lib/models/neural_network/layers/embedding.h"
+#include "lib/util/parallel/parallel.h"
+#include "lib/util/profiler/profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+using namespace cudaNN;
+
+
+/**
+ * Number of partial statistics of a row (see "row_statistics").
+ */
+#define NB_LANES 8
+
+
+namespace
+{
+    /**
+     * Merge the statistics (number of values, mean, sum of squared deviations)
+     * of two sets of values into the first ones (Chan et al.).
+     */
+    void merge_statistics(float &count, float &mean, float &deviations,
+                          float other_count, float other_mean, float other_deviations)
+    {
+        if (other_count == 0.f)
+        {
+            return;
+        }
+
+        auto total = count + other_count;
+        auto delta = other_mean - mean;
+        mean += delta * other_count / total;
+        deviations += other_deviations + delta * delta * count * other_count / total;
+        count = total;
+    }
+
+    /**
+     * Mean and variance of "length" values, in a single pass (Welford). The
+     * values "l", "l + NB_LANES"... are accumulated by the lane "l" (the lanes
+     * are updated together: vectorized), then the lanes are merged.
+     */
+    void row_statistics(const float *values, size_t length, float &mean, float &variance)
+    {
+        float means[NB_LANES] = {};
+        float deviations[NB_LANES] = {};
+        auto nb_blocks = length / NB_LANES;
+
+        for (size_t b = 0; b < nb_blocks; b ++)
+        {
+            auto inverse = 1.f / (float) (b + 1);
+            const float *block = values + b * NB_LANES;
+
+            for (size_t l = 0; l < NB_LANES; l ++)
+            {
+                auto delta = block[l] - means[l];
+                means[l] += delta * inverse;
+                deviations[l] += delta * (block[l] - means[l]);
+            }
+        }
+
+        float count = 0.f;
+        float sum = 0.f;
+        mean = 0.f;
+
+        for (size_t l = 0; l < NB_LANES; l ++)
+        {
+            merge_statistics(count, mean, sum, (float) nb_blocks, means[l], deviations[l]);
+        }
+
+        // The last values (less than a block).
+        for (size_t i = nb_blocks * NB_LANES; i < length; i ++)
+        {
+            merge_statistics(count, mean, sum, 1.f, values[i], 0.f);
+        }
+
+        variance = count > 0.f ? sum / count : 0.f;
+    }
+}
+
+
+normalization::normalization(size_t size,
+                             normalization_types type /*= normalization_types::BATCH_NORMALIZATION*/,
+                             const function &activation_function /*= activation_functions::LINEAR*/,
+                             float momentum /*= NORMALIZATION_MOMENTUM*/,
+                             float epsilon /*= NORMALIZATION_EPSILON*/):
+        _size(size),
+        _type(type),
+        _activation_function(activation_function),
+        _momentum(momentum),
+        _epsilon(epsilon),
+        _scales(1, size, "normalization::scales"),
+        _shifts(1, size, "normalization::shifts"),
+        _means(1, size, "normalization::means"),
+        _variances(1, size, "normalization::variances"),
+        _has_statistics(false),
+        _training(false),
+        _replicas(1)
+{
+    if (size == 0 || momentum <= 0.f || momentum > 1.f || epsilon < 0.f)
+    {
+        // Invalid.
+        util::ERROR("normalization::normalization",
+                    "Invalid size (" + std::to_string(size) + "), momentum ("
+                    + std::to_string(momentum) + ") or epsilon ("
+                    + std::to_string(epsilon) + ")");
+        util::ERROR_EXIT();
+    }
+    if (activation_functions::is_row_wise(activation_function))
+    {
+        // Invalid (its derivative is only the diagonal of the Jacobian).
+        util::ERROR("normalization::normalization",
+                    "Invalid @activation_function (" + activation_function.get_id()
+                    + "), only element-wise functions are supported");
+        util::ERROR_EXIT();
+    }
+
+    // Identity until trained (and until the first statistics).
+    for (size_t j = 0; j < size; j ++)
+    {
+        _scales[j] = 1.f;
+        _variances[j] = 1.f;
+    }
+}
+
+matrix normalization::feed_forward(matrix &inputs, size_t replica /*= 0*/)
+{
+    if (inputs.get_dimensions().second != _size)
+    {
+        // Invalid.
+        util::ERROR("normalization::feed_forward",
+                    "Invalid @inputs size ("
+                    + std::to_string(inputs.get_dimensions().second)
+                    + " instead of "
+                    + std::to_string(_size)
+                    + ")");
+        util::ERROR_EXIT();
+    }
+
+    // Save the inputs from previous layer.
+    _replicas[replica].inputs = inputs;
+
+    return _forward(replica);
+}
+
+matrix normalization::recompute(size_t replica)
+{
+    return _forward(replica);
+}
+
+matrix normalization::_forward(size_t replica)
+{
+    auto &r = _replicas[replica];
+    auto nb_rows = r.inputs.get_dimensions().first;
+    PROFILE_SCOPE("normalization", _type == normalization_types::BATCH_NORMALIZATION ?
+                                   "forward (batch)" : "forward (layer)",
+                  nb_rows, _size, 1, (double) (2 * nb_rows * _size) * sizeof(float));
+    auto sum = matrix(nb_rows, _size, "normalization::outputs");
+    const float *inputs = r.inputs.get_data();
+    const float *scales = _scales.get_data();
+    const float *shifts = _shifts.get_data();
+    float *outputs = sum.get_data();
+
+    if (_type == normalization_types::BATCH_NORMALIZATION)
+    {
+        // The statistics of the rows during a training, the running ones otherwise.
+        r.batch_statistics = _training && nb_rows > 1;
+        r.statistics.resize(2 * _size);
+        float *means = r.statistics.data();
+        float *variances = means + _size;
+
+        // The columns are independent.
+        parallel::for_range(_size, PARALLEL_MIN_CHUNK_SIZE, [&](size_t begin, size_t end)
+        {
+            if (r.batch_statistics)
+            {
+                // Welford, over the rows (vectorized over the columns).
+                std::fill(means + begin, means + end, 0.f);
+                std::fill(variances + begin, variances + end, 0.f);
+
+                for (size_t n = 0; n < nb_rows; n ++)
+                {
+                    auto inverse_count = 1.f / (float) (n + 1);
+
+                    for (size_t j = begin; j < end; j ++)
+                    {
+                        auto delta = inputs[n * _size + j] - means[j];
+                        means[j] += delta * inverse_count;
+                        variances[j] += delta * (inputs[n * _size + j] - means[j]);
+                    }
+                }
+
+                for (size_t j = begin; j < end; j ++)
+                {
+                    variances[j] /= (float) nb_rows;
+                }
+            }
+            else
+            {
+                std::copy(_means.get_data() + begin, _means.get_data() + end, means + begin);
+                std::copy(_variances.get_data() + begin, _variances.get_data() + end, variances + begin);
+            }
+
+            for (size_t n = 0; n < nb_rows; n ++)
+            {
+                for (size_t j = begin; j < end; j ++)
+                {
+                    auto factor = scales[j] / std::sqrt(variances[j] + _epsilon);
+                    outputs[n * _size + j] = (inputs[n * _size + j] - means[j]) * factor + shifts[j];
+                }
+            }
+        });
+    }
+    else
+    {
+        r.statistics.resize(2 * nb_rows);
+
+        parallel::for_range(nb_rows, std::max((size_t) 1, PARALLEL_MIN_CHUNK_SIZE / _size),
+                            [&](size_t begin, size_t end)
+        {
+            for (size_t n = begin; n < end; n ++)
+            {
+                const float *row = inputs + n * _size;
+                float mean, variance;
+                row_statistics(row, _size, mean, variance);
+                auto inverse = 1.f / std::sqrt(variance + _epsilon);
+                r.statistics[2 * n] = mean;
+                r.statistics[2 * n + 1] = inverse;
+
+                for (size_t j = 0; j < _size; j ++)
+                {
+                    outputs[n * _size + j] = (row[j] - mean) * inverse * scales[j] + shifts[j];
+                }
+            }
+        });
+    }
+
+    // Compute the result of the activation function on the outputs, and of its
+    // derivative (for back propagation).
+    return _activation_function.compute_with_derivatives({ &sum }, r.derivatives);
+}
+
+void normalization::backward_propagation(matrix &errors, size_t replica /*= 0*/,
+                                         bool propagate /*= true*/)
+{
+    auto &r = _replicas[replica];
+    auto nb_rows = errors.get_dimensions().first;
+    PROFILE_SCOPE("normalization", "backward_propagation", nb_rows, _size, 1,
+                  (double) (3 * nb_rows * _size) * sizeof(float));
+    // The errors on the outputs before the activation function.
+    errors.hadamard_product_in_place(r.derivatives);
+
+    if (r.first_entry)
+    {
+        // The first entry of the batch (i.e. first computed errors).
+        r.scale_gradients = matrix(_scales.get_dimensions(), "normalization::scale_gradients");
+        r.shift_gradients = matrix(_shifts.get_dimensions(), "normalization::shift_gradients");
+        r.first_entry = false;
+    }
+
+    const float *inputs = r.inputs.get_data();
+    const float *scales = _scales.get_data();
+    float *e = errors.get_data();
+    float *scale_gradients = r.scale_gradients.get_data();
+    float *shift_gradients = r.shift_gradients.get_data();
+
+    if (_type == normalization_types::BATCH_NORMALIZATION)
+    {
+        if (r.nb_entries == 0)
+        {
+            r.batch_means.assign(_size, 0.f);
+            r.batch_deviations.assign(_size, 0.f);
+        }
+
+        const float *means = r.statistics.data();
+        const float *variances = means + _size;
+        float *batch_means = r.batch_means.data();
+        float *batch_deviations = r.batch_deviations.data();
+
+        // The columns are independent: the gradients, the errors on the inputs,
+        // and the statistics of the batch (for the running ones).
+        parallel::for_range(_size, PARALLEL_MIN_CHUNK_SIZE, [&](size_t begin, size_t end)
+        {
+            if (! r.batch_statistics)
+            {
+                // Constant statistics: a single pass (Welford for the statistics).
+                for (size_t n = 0; n < nb_rows; n ++)
+                {
+                    auto inverse_count = 1.f / (float) (r.nb_entries + n + 1);
+
+                    for (size_t j = begin; j < end; j ++)
+                    {
+                        auto x = inputs[n * _size + j];
+                        auto g = e[n * _size + j];
+                        auto inverse = 1.f / std::sqrt(variances[j] + _epsilon);
+                        scale_gradients[j] += g * (x - means[j]) * inverse;
+                        shift_gradients[j] += g;
+
+                        if (propagate)
+                        {
+                            e[n * _size + j] = g * scales[j] * inverse;
+                        }
+
+                        auto delta = x - batch_means[j];
+                        batch_means[j] += delta * inverse_count;
+                        batch_deviations[j] += delta * (x - batch_means[j]);
+                    }
+                }
+
+                return;
+            }
+
+            // Statistics of the rows: the sums over the rows of the errors, and of
+            // the errors times the normalized inputs.
+            auto sums = std::vector<float>(2 * (end - begin), 0.f);
+            float *error_sums = sums.data();
+            float *normalized_sums = error_sums + (end - begin);
+
+            for (size_t n = 0; n < nb_rows; n ++)
+            {
+                for (size_t j = begin; j < end; j ++)
+                {
+                    auto g = e[n * _size + j];
+                    error_sums[j - begin] += g;
+                    normalized_sums[j - begin] += g * (inputs[n * _size + j] - means[j])
+                                                  / std::sqrt(variances[j] + _epsilon);
+                }
+            }
+
+            for (size_t j = begin; j < end; j ++)
+            {
+                scale_gradients[j] += normalized_sums[j - begin];
+                shift_gradients[j] += error_sums[j - begin];
+                // (Merged with the statistics of the previous rows of the batch.)
+                auto count = (float) r.nb_entries;
+                merge_statistics(count, batch_means[j], batch_deviations[j], (float) nb_rows,
+                                 means[j], variances[j] * (float) nb_rows);
+            }
+
+            if (! propagate)
+            {
+                return;
+            }
+
+            // The errors on the inputs (through the mean and the variance).
+            auto inverse_count = 1.f / (float) nb_rows;
+
+            for (size_t n = 0; n < nb_rows; n ++)
+            {
+                for (size_t j = begin; j < end; j ++)
+                {
+                    auto inverse = 1.f / std::sqrt(variances[j] + _epsilon);
+                    auto normalized = (inputs[n * _size + j] - means[j]) * inverse;
+                    e[n * _size + j] = inverse * scales[j]
+                                       * (e[n * _size + j]
+                                          - (error_sums[j - begin] + normalized * normalized_sums[j - begin])
+                                            * inverse_count);
+                }
+            }
+        });
+
+        r.nb_entries += nb_rows;
+
+        return;
+    }
+
+    // Layer normalization: the statistics of each row depend on all its inputs.
+    auto inverse_size = 1.f / (float) _size;
+
+    for (size_t n = 0; n < nb_rows; n ++)
+    {
+        const float *row = inputs + n * _size;
+        float *g = e + n * _size;
+        auto mean = r.statistics[2 * n];
+        auto inverse = r.statistics[2 * n + 1];
+        float sum = 0.f;
+        float normalized_sum = 0.f;
+
+        // The gradients, and the sums of the errors on the normalized inputs.
+        for (size_t j = 0; j < _size; j ++)
+        {
+            auto normalized = (row[j] - mean) * inverse;
+            scale_gradients[j] += g[j] * normalized;
+            shift_gradients[j] += g[j];
+            sum += g[j] * scales[j];
+            normalized_sum += g[j] * scales[j] * normalized;
+        }
+
+        if (! propagate)
+        {
+            continue;
+        }
+
+        // The errors on the inputs (through the mean and the variance).
+        for (size_t j = 0; j < _size; j ++)
+        {
+            auto normalized = (row[j] - mean) * inverse;
+            g[j] = inverse * (g[j] * scales[j] - (sum + normalized * normalized_sum) * inverse_size);
+        }
+    }
+}
+
+void normalization::release(size_t replica, bool keep_inputs)
+{
+    auto &r = _replicas[replica];
+    r.derivatives.clear();
+    r.statistics.clear();
+
+    if (! keep_inputs)
+    {
+        r.inputs.clear();
+    }
+}
+
+void normalization::gradient_descent(size_t batch_size, float learning_rate)
+{
+    PROFILE_SCOPE("normalization", "gradient_descent", 1, _size);
+    // The replicas that processed entries.
+    auto replicas = std::vector<size_t>();
+
+    for (size_t r = 0; r < _replicas.size(); r ++)
+    {
+        if (! _replicas[r].first_entry)
+        {
+            replicas.push_back(r);
+            // Reset for next backpropagation.
+            _replicas[r].first_entry = true;
+        }
+    }
+
+    if (replicas.empty())
+    {
+        return;
+    }
+
+    _sum_gradients(replicas);
+    _update_parameters(replicas[0], learning_rate / (float) batch_size);
+    _update_statistics(replicas);
+}
+
+void normalization::apply_gradients(size_t replica, size_t batch_size, float learning_rate)
+{
+    PROFILE_SCOPE("normalization", "apply_gradients", 1, _size);
+
+    if (_replicas[replica].first_entry)
+    {
+        return;
+    }
+
+    // Reset for next backpropagation.
+    _replicas[replica].first_entry = true;
+    _update_parameters(replica, learning_rate / (float) batch_size, true);
+    _update_statistics({ replica });
+}
+
+void normalization::_update_statistics(const std::vector<size_t> &replicas)
+{
+    if (_type != normalization_types::BATCH_NORMALIZATION)
+    {
+        return;
+    }
+
+    float count = 0.f;
+    auto means = std::vector<float>(_size, 0.f);
+    auto deviations = std::vector<float>(_size, 0.f);
+
+    for (auto i: replicas)
+    {
+        auto &r = _replicas[i];
+
+        if (r.nb_entries == 0)
+        {
+            continue;
+        }
+
+        for (size_t j = 0; j < _size; j ++)
+        {
+            auto c = count;
+            merge_statistics(c, means[j], deviations[j], (float) r.nb_entries,
+                             r.batch_means[j], r.batch_deviations[j]);
+        }
+
+        count += (float) r.nb_entries;
+        r.nb_entries = 0;
+    }
+
+    if (count == 0.f)
+    {
+        return;
+    }
+
+    // Running statistics (unbiased variance), replaced by the first ones.
+    auto weight = _has_statistics ? _momentum : 1.f;
+
+    for (size_t j = 0; j < _size; j ++)
+    {
+        auto variance = deviations[j] / std::max(count - 1.f, 1.f);
+        _means[j] += weight * (means[j] - _means[j]);
+        _variances[j] += weight * (variance - _variances[j]);
+    }
+
+    _has_statistics = true;
+}
+
+void normalization::clear_gradients()
+{
+    for (auto &r: _replicas)
+    {
+        // Overwritten by the next backpropagation.
+        r.first_entry = true;
+        r.nb_entries = 0;
+    }
+}
+
+void normalization::set_nb_replicas(size_t nb_replicas)
+{
+    _replicas.resize(std::max((size_t) 1, nb_replicas));
+}
+
+size_t normalization::get_nb_replicas() const
+{
+    return _replicas.size();
+}
+
+std::vector<matrix *> normalization::get_parameters()
+{
+    return { &_scales, &_shifts };
+}
+
+std::vector<matrix *> normalization::get_gradients(size_t replica /*= 0*/)
+{
+    return { &_replicas[replica].scale_gradients, &_replicas[replica].shift_gradients };
+}
+
+void normalization::set_training(bool training)
+{
+    _training = training;
+}
+
+bool normalization::depends_on_batch() const
+{
+    return _type == normalization_types::BATCH_NORMALIZATION;
+}
+
+size_t normalization::size() const
+{
+    return _size;
+}
+
+size_t normalization::get_inputs_memory() const
+{
+    return _size * sizeof(float);
+}
+
+size_t normalization::get_workspace_memory() const
+{
+    // The derivatives of the activation function, and the statistics (of the
+    // columns, or of the row).
+    return (_size + (_type == normalization_types::BATCH_NORMALIZATION ? 2 * _size : 2)) * sizeof(float);
+}
+
+layer *normalization::fold(layer &previous) const
+{
+    if (_type != normalization_types::BATCH_NORMALIZATION || previous.size() != _size
+        || previous.get_activation_function() != activation_functions::LINEAR.get_id())
+    {
+        // Invalid: the normalization would not apply on the outputs of the products.
+        util::ERROR("normalization::fold",
+                    "Only a batch normalization of the outputs of a linear layer can be folded");
+        util::ERROR_EXIT();
+    }
+
+    auto &weights = previous.get_weights();
+    auto &biases = previous.get_biases();
+    auto nb_inputs = weights.get_dimensions().first;
+    auto folded = previous.get_input_type() == input_types::IDS ?
+                  new embedding(nb_inputs, _size, initializations::XAVIER, _activation_function) :
+                  new layer(nb_inputs, _size, initializations::HE, _activation_function);
+
+    if (previous.get_input_type() == input_types::SPARSE)
+    {
+        folded->set_sparse_inputs(true);
+    }
+
+    // "scale * (x * w + b - mean) / sqrt(variance + epsilon) + shift", for each output.
+    auto factors = std::vector<float>(_size);
+    float *folded_weights = folded->get_weights().get_data();
+    float *folded_biases = folded->get_biases().get_data();
+
+    for (size_t j = 0; j < _size; j ++)
+    {
+        factors[j] = _scales[j] / std::sqrt(_variances[j] + _epsilon);
+        folded_biases[j] = (biases[j] - _means[j]) * factors[j] + _shifts[j];
+    }
+
+    for (size_t i = 0; i < nb_inputs; i ++)
+    {
+        for (size_t j = 0; j < _size; j ++)
+        {
+            folded_weights[i * _size + j] = weights[i * _size + j] * factors[j];
+        }
+    }
+
+    return folded;
+}
+
+normalization_types normalization::get_type() const
+{
+    return _type;
+}
+
+const function &normalization::get_activation_function() const
+{
+    return _activation_function;
+}
+
+matrix &normalization::get_scales()
+{
+    return _scales;
+}
+
+matrix &normalization::get_shifts()
+{
+    return _shifts;
+}
+
+matrix &normalization::get_means()
+{
+    return _means;
+}
+
+matrix &normalization::get_variances()
+{
+    return _variances;
+}
+
+void normalization::_print() const
+{
+    std::cout << (_type == normalization_types::BATCH_NORMALIZATION ? "Batch" : "Layer")
+              << " normalization: " << _size << std::endl;
+    std::cout << "Activation: " << _activation_function.get_id() << std::endl;
+}
@@ -0,0 +1,220 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#ifndef CUDANN_NORMALIZATION_H
+#define CUDANN_NORMALIZATION_H
+
+#include "lib/models/neural_network/layers/base_layer.h"
+#include "lib/models/neural_network/layers/layer.h"
+#include "lib/functions/activation_functions/activation_functions.h"
+#include "lib/util/util.h"
+
+#include <vector>
+
+
+/**
+ * Weight of the statistics of the last batch in the statistics of a batch
+ * normalization (exponential moving average).
+ */
+#define NORMALIZATION_MOMENTUM .1f
+
+/**
+ * Added to the variances (no division by zero).
+ */
+#define NORMALIZATION_EPSILON 1e-5f
+
+
+namespace cudaNN
+{
+    /**
+     * Statistics used to normalize the inputs of a normalization layer.
+     * @BATCH_NORMALIZATION - each input over the entries: the mean and the
+     * variance of each column (of the batch during a training, running
+     * ones otherwise).
+     * @LAYER_NORMALIZATION - each entry over its inputs: the mean and the
+     * variance of each row.
+     */
+    enum normalization_types
+    {
+        BATCH_NORMALIZATION,
+        LAYER_NORMALIZATION
+    };
+
+
+    /**
+     * Layer normalizing its inputs (zero mean, unit variance), then scaling and
+     * shifting each of them (learned), before the activation function:
+     * "f(scale * (x - mean) / sqrt(variance + epsilon) + shift)". Keeps the
+     * inputs of the activation functions of deep networks in their range,
+     * which allows larger learning rates.
+     * The means and the variances are computed in a single pass (Welford),
+     * and backpropagated.
+     * Batch normalization: during a training, the entries of a batch are
+     * propagated together (see -base_layer.h/depends_on_batch-; a batch per
+     * replica) and normalized with the statistics of their rows (at least 2,
+     * the running statistics being used otherwise); these statistics are
+     * merged over the replicas at each update, into running statistics (exponential moving average) used
+     * for the predictions, which can then be folded in the previous layer
+     * (see "fold").
+     * Layer normalization: the statistics of each row of the inputs.
+     */
+    class normalization: public base_layer
+    {
+        public:
+
+            /**
+             * @param size - the number of inputs (and outputs).
+             * @param type - the statistics used to normalize the inputs.
+             * @param activation_function - the function applied on the outputs.
+             * @param momentum - batch normalization: the weight of the statistics
+             * of each batch in the running statistics.
+             * @param epsilon - added to the variances.
+             */
+            normalization(size_t size, normalization_types type = normalization_types::BATCH_NORMALIZATION,
+                          const function &activation_function = activation_functions::LINEAR,
+                          float momentum = NORMALIZATION_MOMENTUM, float epsilon = NORMALIZATION_EPSILON);
+
+            matrix feed_forward(matrix &inputs, size_t replica = 0) override;
+            void backward_propagation(matrix &errors, size_t replica = 0,
+                                      bool propagate = true) override;
+            void release(size_t replica, bool keep_inputs) override;
+            matrix recompute(size_t replica) override;
+
+            /**
+             * Batch normalization: the running statistics are also updated with
+             * the ones of the entries backpropagated since the last update.
+             */
+            void gradient_descent(size_t batch_size, float learning_rate) override;
+            void apply_gradients(size_t replica, size_t batch_size, float learning_rate) override;
+
+            /**
+             * Also discard the statistics of the backpropagated entries.
+             */
+            void clear_gradients() override;
+
+            void set_nb_replicas(size_t nb_replicas) override;
+            size_t get_nb_replicas() const override;
+            void set_training(bool training) override;
+
+            /**
+             * @return - true for a batch normalization.
+             */
+            bool depends_on_batch() const override;
+
+            /**
+             * @return - the scales and the shifts (a column per input). The
+             * running statistics are not trained: each process of a distributed
+             * training keeps the ones of its own batches.
+             */
+            std::vector<matrix *> get_parameters() override;
+            std::vector<matrix *> get_gradients(size_t replica = 0) override;
+
+            size_t size() const override;
+            size_t get_inputs_memory() const override;
+            size_t get_workspace_memory() const override;
+
+            /**
+             * Inference: a dense layer computing "previous" followed by this batch
+             * normalization (the normalization is folded in its weights and
+             * biases: no extra cost).
+             * @param previous - a layer with a linear activation function, whose
+             * outputs are the inputs of this layer.
+             * @return - a new layer (of the type of "previous", with the activation
+             * function of this layer), to be deleted by the caller.
+             */
+            layer *fold(layer &previous) const;
+
+            normalization_types get_type() const;
+            const function &get_activation_function() const;
+
+            matrix &get_scales();
+            matrix &get_shifts();
+
+            /**
+             * @return - batch normalization: the running statistics (a column per
+             * input), 0 and 1 before the first update.
+             */
+            matrix &get_means();
+            matrix &get_variances();
+
+        protected:
+
+            /**
+             * Print the type, the size and the activation function.
+             */
+            void _print() const override;
+
+        private:
+
+            /**
+             * Forward propagation of the inputs saved in the replica.
+             */
+            matrix _forward(size_t replica);
+
+            /**
+             * Batch normalization: merge the statistics accumulated by the replicas
+             * (in their order) into the running statistics.
+             */
+            void _update_statistics(const std::vector<size_t> &replicas);
+
+            const size_t _size;
+            const normalization_types _type;
+            const function &_activation_function;
+            const float _momentum;
+            const float _epsilon;
+
+            /**
+             * @_scales, @_shifts - the parameters: a column per input, one row.
+             * @_means, @_variances - batch normalization: the running statistics
+             * (a column per input, one row).
+             * @_has_statistics - false before the first update of the running
+             * statistics (replaced by the ones of the first batch).
+             * @_training - see "set_training".
+             */
+            matrix _scales;
+            matrix _shifts;
+            matrix _means;
+            matrix _variances;
+            bool _has_statistics;
+            bool _training;
+
+            /**
+             * Buffers of the backpropagation and gradient descent (of a replica).
+             * @inputs - the current inputs (the outputs from the previous layer).
+             * @derivatives - the derivatives of the activation function on the
+             * current outputs.
+             * @statistics - the statistics used to normalize the current inputs:
+             * batch normalization, the means then the variances of the columns;
+             * layer normalization, the mean and the inverse of the standard
+             * deviation of each row.
+             * @batch_statistics - batch normalization: true if the statistics are
+             * the ones of the rows of the current inputs.
+             * @scale_gradients, @shift_gradients - the sums over the entries of the
+             * batch (dimensions of the parameters).
+             * @first_entry - true if no entry has been processed since the last update.
+             * @nb_entries, @batch_means, @batch_deviations - batch normalization: the
+             * number of rows backpropagated since the last update, with the means
+             * and the sums of squared deviations of their columns (merged, see
+             * "_update_statistics").
+             */
+            struct replica
+            {
+                matrix inputs;
+                matrix derivatives;
+                std::vector<float> statistics;
+                bool batch_statistics = false;
+                matrix scale_gradients;
+                matrix shift_gradients;
+                bool first_entry = true;
+                size_t nb_entries = 0;
+                std::vector<float> batch_means;
+                std::vector<float> batch_deviations;
+            };
+
+            std::vector<replica> _replicas;
+    };
+}
+
+
+#endif //CUDANN_NORMALIZATION_H
@@ -0,0 +1,358 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "pooling.h"
+#include "lib/util/parallel/parallel.h"
+#include "lib/util/profiler/profiler.h"
+
+#include <algorithm>
+#include <limits>
+
+
+using namespace cudaNN;
+
+
+namespace
+{
+    /**
+     * The windows are reduced by rows of contiguous outputs: the pixels of a
+     * row of a channel (NCHW), or the channels of a pixel (NHWC), such that the
+     * inner loops are vectorized.
+     * @nb_rows - the number of rows of outputs of an image.
+     * @length - the number of outputs of a row.
+     * @pixel_stride - the distance between two consecutive input pixels.
+     * @step - the distance between the inputs of two consecutive outputs
+     * of a row.
+     */
+    struct rows
+    {
+        size_t nb_rows;
+        size_t length;
+        size_t pixel_stride;
+        size_t step;
+    };
+
+    /**
+     * Keep in "outputs" the maxima with the inputs of the next position of the
+     * windows of a row, and their positions.
+     * (Selections instead of branches, on local sizes: vectorized.)
+     */
+    void max_row(const float *inputs, size_t step, size_t length, uint8_t position,
+                 float *outputs, uint8_t *positions)
+    {
+        for (size_t q = 0; q < length; q ++)
+        {
+            auto value = inputs[q * step];
+            auto greater = value > outputs[q];
+            outputs[q] = greater ? value : outputs[q];
+            positions[q] = greater ? position : positions[q];
+        }
+    }
+
+    /**
+     * outputs[q * output_step] += inputs[q * input_step] * scale.
+     */
+    void add_row(const float *inputs, size_t input_step, size_t length, float scale,
+                 float *outputs, size_t output_step)
+    {
+        for (size_t q = 0; q < length; q ++)
+        {
+            outputs[q * output_step] += inputs[q * input_step] * scale;
+        }
+    }
+}
+
+
+pooling::pooling(size_t channels, size_t height, size_t width, size_t window_size,
+                 size_t stride /*= 0*/, pooling_types type /*= pooling_types::MAX_POOLING*/,
+                 layouts layout /*= layouts::NCHW*/):
+        _channels(channels),
+        _height(height),
+        _width(width),
+        _window_size(window_size),
+        _stride(stride == 0 ? window_size : stride),
+        _output_height(window_size > 0 && height >= window_size ? (height - window_size) / _stride + 1 : 0),
+        _output_width(window_size > 0 && width >= window_size ? (width - window_size) / _stride + 1 : 0),
+        _type(type),
+        _layout(layout),
+        _replicas(1)
+{
+    if (_output_height == 0 || _output_width == 0 || channels == 0
+        || (type == pooling_types::MAX_POOLING && window_size > POOLING_MAX_WINDOW_SIZE))
+    {
+        // Invalid.
+        util::ERROR("pooling::pooling",
+                    "Invalid windows of " + std::to_string(window_size) + "x"
+                    + std::to_string(window_size) + " for images of "
+                    + std::to_string(channels) + "x" + std::to_string(height) + "x"
+                    + std::to_string(width));
+        util::ERROR_EXIT();
+    }
+}
+
+matrix pooling::feed_forward(matrix &inputs, size_t replica /*= 0*/)
+{
+    if (inputs.get_dimensions().second != _channels * _height * _width)
+    {
+        // Invalid.
+        util::ERROR("pooling::feed_forward",
+                    "Invalid @inputs size ("
+                    + std::to_string(inputs.get_dimensions().second)
+                    + " instead of "
+                    + std::to_string(_channels * _height * _width)
+                    + ")");
+        util::ERROR_EXIT();
+    }
+
+    // (The inputs are not kept: only the positions of the maxima are used by
+    // the backpropagation.)
+    return _forward(replica, inputs);
+}
+
+matrix pooling::recompute(size_t replica)
+{
+    return _forward(replica, _replicas[replica].inputs);
+}
+
+bool pooling::needs_inputs() const
+{
+    return false;
+}
+
+void pooling::keep_inputs(const matrix &inputs, size_t replica)
+{
+    _replicas[replica].inputs = inputs;
+}
+
+matrix pooling::_forward(size_t replica, const matrix &inputs)
+{
+    auto &r = _replicas[replica];
+    auto nb_inputs = _channels * _height * _width;
+    r.nb_rows = inputs.get_dimensions().first;
+    PROFILE_SCOPE("pooling", _type == pooling_types::MAX_POOLING ? "forward (max)" : "forward (average)",
+                  r.nb_rows, size(), _window_size * _window_size,
+                  (double) (r.nb_rows * (nb_inputs + size())) * sizeof(float));
+    auto outputs = matrix(r.nb_rows, size(), "pooling::outputs");
+
+    if (_type == pooling_types::MAX_POOLING)
+    {
+        r.positions.resize(r.nb_rows * size());
+    }
+
+    for (size_t n = 0; n < r.nb_rows; n ++)
+    {
+        _forward_image(inputs.get_data() + n * nb_inputs, outputs.get_data() + n * size(),
+                       _type == pooling_types::MAX_POOLING ? r.positions.data() + n * size() : nullptr);
+    }
+
+    return outputs;
+}
+
+void pooling::_forward_image(const float *inputs, float *outputs, uint8_t *positions) const
+{
+    auto nchw = _layout == layouts::NCHW;
+    auto r = nchw ? rows { _channels * _output_height, _output_width, 1, _stride }
+                  : rows { _output_height * _output_width, _channels, _channels, 1 };
+    auto scale = 1.f / (float) (_window_size * _window_size);
+
+    parallel::for_range(r.nb_rows, std::max((size_t) 1, PARALLEL_MIN_CHUNK_SIZE
+                                                        / (r.length * _window_size * _window_size)),
+                        [&](size_t begin, size_t end)
+    {
+        for (size_t row = begin; row < end; row ++)
+        {
+            // The first input of the first window of the row.
+            auto first = nchw ? (row / _output_height) * _height * _width
+                                + (row % _output_height) * _stride * _width
+                              : ((row / _output_width) * _stride * _width
+                                 + (row % _output_width) * _stride) * _channels;
+            float *output = outputs + row * r.length;
+
+            if (_type == pooling_types::AVERAGE_POOLING)
+            {
+                std::fill(output, output + r.length, 0.f);
+            }
+            else
+            {
+                std::fill(output, output + r.length, -std::numeric_limits<float>::infinity());
+                std::fill(positions + row * r.length, positions + (row + 1) * r.length, 0);
+            }
+
+            for (size_t i = 0; i < _window_size; i ++)
+            {
+                for (size_t j = 0; j < _window_size; j ++)
+                {
+                    const float *input = inputs + first + (i * _width + j) * r.pixel_stride;
+
+                    if (_type == pooling_types::AVERAGE_POOLING)
+                    {
+                        add_row(input, r.step, r.length, scale, output, 1);
+                    }
+                    else
+                    {
+                        max_row(input, r.step, r.length, (uint8_t) (i * _window_size + j),
+                                output, positions + row * r.length);
+                    }
+                }
+            }
+        }
+    });
+}
+
+void pooling::backward_propagation(matrix &errors, size_t replica /*= 0*/,
+                                   bool propagate /*= true*/)
+{
+    if (! propagate)
+    {
+        // No parameters: nothing to compute.
+        return;
+    }
+
+    auto &r = _replicas[replica];
+    auto nb_inputs = _channels * _height * _width;
+    PROFILE_SCOPE("pooling", "backward_propagation", r.nb_rows, size(), _window_size * _window_size,
+                  (double) (r.nb_rows * (nb_inputs + size())) * sizeof(float));
+    auto input_errors = matrix(r.nb_rows, nb_inputs, "pooling::input_errors");
+
+    for (size_t n = 0; n < r.nb_rows; n ++)
+    {
+        _backward_image(errors.get_data() + n * size(),
+                        _type == pooling_types::MAX_POOLING ? r.positions.data() + n * size() : nullptr,
+                        input_errors.get_data() + n * nb_inputs);
+    }
+
+    errors = input_errors;
+}
+
+void pooling::_backward_image(const float *errors, const uint8_t *positions,
+                              float *input_errors) const
+{
+    auto nchw = _layout == layouts::NCHW;
+    auto r = nchw ? rows { _channels * _output_height, _output_width, 1, _stride }
+                  : rows { _output_height * _output_width, _channels, _channels, 1 };
+    auto scale = 1.f / (float) (_window_size * _window_size);
+    // Overlapping windows: the rows of a channel (NCHW), or all the rows
+    // (NHWC), may add to the same inputs, and are processed by the same thread.
+    auto group = _stride >= _window_size ? 1 : nchw ? _output_height : r.nb_rows;
+
+    parallel::for_range(r.nb_rows / group, std::max((size_t) 1, PARALLEL_MIN_CHUNK_SIZE / (group * r.length)),
+                        [&](size_t begin, size_t end)
+    {
+        for (size_t row = begin * group; row < end * group; row ++)
+        {
+            auto first = nchw ? (row / _output_height) * _height * _width
+                                + (row % _output_height) * _stride * _width
+                              : ((row / _output_width) * _stride * _width
+                                 + (row % _output_width) * _stride) * _channels;
+            const float *error = errors + row * r.length;
+
+            if (_type == pooling_types::MAX_POOLING)
+            {
+                // Only the maximum of the window.
+                const uint8_t *p = positions + row * r.length;
+
+                for (size_t q = 0; q < r.length; q ++)
+                {
+                    auto i = p[q] / _window_size;
+                    auto j = p[q] % _window_size;
+                    input_errors[first + (i * _width + j) * r.pixel_stride + q * r.step] += error[q];
+                }
+
+                continue;
+            }
+
+            for (size_t i = 0; i < _window_size; i ++)
+            {
+                for (size_t j = 0; j < _window_size; j ++)
+                {
+                    add_row(error, 1, r.length, scale,
+                            input_errors + first + (i * _width + j) * r.pixel_stride, r.step);
+                }
+            }
+        }
+    });
+}
+
+void pooling::release(size_t replica, bool keep_inputs)
+{
+    auto &r = _replicas[replica];
+    r.positions.clear();
+    r.positions.shrink_to_fit();
+
+    if (! keep_inputs)
+    {
+        r.inputs.clear();
+    }
+}
+
+void pooling::gradient_descent(size_t, float)
+{
+}
+
+void pooling::apply_gradients(size_t, size_t, float)
+{
+}
+
+void pooling::clear_gradients()
+{
+}
+
+void pooling::set_nb_replicas(size_t nb_replicas)
+{
+    _replicas.resize(std::max((size_t) 1, nb_replicas));
+}
+
+size_t pooling::get_nb_replicas() const
+{
+    return _replicas.size();
+}
+
+std::vector<matrix *> pooling::get_parameters()
+{
+    return {};
+}
+
+std::vector<matrix *> pooling::get_gradients(size_t /*= 0*/)
+{
+    return {};
+}
+
+size_t pooling::size() const
+{
+    return _channels * _output_height * _output_width;
+}
+
+size_t pooling::get_inputs_memory() const
+{
+    return _channels * _height * _width * sizeof(float);
+}
+
+size_t pooling::get_workspace_memory() const
+{
+    return _type == pooling_types::MAX_POOLING ? size() * sizeof(uint8_t) : 0;
+}
+
+pooling_types pooling::get_type() const
+{
+    return _type;
+}
+
+size_t pooling::get_output_height() const
+{
+    return _output_height;
+}
+
+size_t pooling::get_output_width() const
+{
+    return _output_width;
+}
+
+void pooling::_print() const
+{
+    std::cout << "Pooling:    " << (_type == pooling_types::MAX_POOLING ? "max" : "average") << " "
+              << _window_size << "x" << _window_size << ", stride " << _stride << std::endl;
+    std::cout << "Size:       " << _channels << "x" << _height << "x" << _width << " -> "
+              << _channels << "x" << _output_height << "x" << _output_width
+              << (_layout == layouts::NCHW ? " (NCHW)" : " (NHWC)") << std::endl;
+}
@@ -0,0 +1,164 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#ifndef CUDANN_POOLING_H
+#define CUDANN_POOLING_H
+
+#include "lib/models/neural_network/layers/base_layer.h"
+#include "lib/models/neural_network/layers/convolution.h"
+#include "lib/util/util.h"
+
+#include <cstdint>
+#include <vector>
+
+
+/**
+ * Largest size of the windows of a max-pooling: the position of the
+ * maximum in its window is stored in a byte.
+ */
+#define POOLING_MAX_WINDOW_SIZE 16
+
+
+namespace cudaNN
+{
+    /**
+     * Reduction of the windows of a pooling layer.
+     * @MAX_POOLING - the maximum of the window.
+     * @AVERAGE_POOLING - the mean of the window.
+     */
+    enum pooling_types
+    {
+        MAX_POOLING,
+        AVERAGE_POOLING
+    };
+
+
+    /**
+     * Downsampling layer: each channel of the images is split in windows of
+     * "window_size x window_size" pixels (every "stride" pixels, without
+     * padding), each reduced to a pixel of the outputs. No parameters.
+     * Each row of the inputs is an image of "channels x height x width"
+     * values, each row of the outputs an image of "channels x
+     * get_output_height() x get_output_width()" values (same layout).
+     * The max-pooling keeps the position of the maximum of each window (a
+     * byte per output): the backpropagation only scatters the errors, without
+     * the inputs.
+     */
+    class pooling: public base_layer
+    {
+        public:
+
+            /**
+             * @param channels, height, width - the dimensions of the input images.
+             * @param window_size - the size of the (square) windows (at most
+             * -POOLING_MAX_WINDOW_SIZE- for a max-pooling).
+             * @param stride - the step between two windows ("window_size" if 0:
+             * the windows do not overlap).
+             * @param type - the reduction of the windows.
+             * @param layout - the order of the values of the images (inputs and
+             * outputs).
+             */
+            pooling(size_t channels, size_t height, size_t width, size_t window_size,
+                    size_t stride = 0, pooling_types type = pooling_types::MAX_POOLING,
+                    layouts layout = layouts::NCHW);
+
+            matrix feed_forward(matrix &inputs, size_t replica = 0) override;
+            void backward_propagation(matrix &errors, size_t replica = 0,
+                                      bool propagate = true) override;
+            void release(size_t replica, bool keep_inputs) override;
+            matrix recompute(size_t replica) override;
+
+            /**
+             * @return - false: the backpropagation only uses the positions of the
+             * maxima.
+             */
+            bool needs_inputs() const override;
+            void keep_inputs(const matrix &inputs, size_t replica) override;
+
+            /**
+             * No parameters: no update.
+             */
+            void gradient_descent(size_t batch_size, float learning_rate) override;
+            void apply_gradients(size_t replica, size_t batch_size, float learning_rate) override;
+            void clear_gradients() override;
+
+            void set_nb_replicas(size_t nb_replicas) override;
+            size_t get_nb_replicas() const override;
+            std::vector<matrix *> get_parameters() override;
+            std::vector<matrix *> get_gradients(size_t replica = 0) override;
+
+            size_t size() const override;
+
+            /**
+             * @return - the inputs, kept at the checkpoints only (see "needs_inputs").
+             */
+            size_t get_inputs_memory() const override;
+
+            /**
+             * @return - the positions of the maxima (a byte per output).
+             */
+            size_t get_workspace_memory() const override;
+
+            pooling_types get_type() const;
+            size_t get_output_height() const;
+            size_t get_output_width() const;
+
+        protected:
+
+            /**
+             * Print the dimensions and the windows.
+             */
+            void _print() const override;
+
+        private:
+
+            /**
+             * Forward propagation of "inputs" (the buffers kept in the replica).
+             */
+            matrix _forward(size_t replica, const matrix &inputs);
+
+            /**
+             * Reduce the windows of an image.
+             * @param positions - receives the positions of the maxima in their
+             * windows (max-pooling only).
+             */
+            void _forward_image(const float *inputs, float *outputs, uint8_t *positions) const;
+
+            /**
+             * Scatter the errors on the outputs of an image to its inputs.
+             * @param positions - the positions of the maxima (max-pooling only).
+             */
+            void _backward_image(const float *errors, const uint8_t *positions,
+                                 float *input_errors) const;
+
+            const size_t _channels;
+            const size_t _height;
+            const size_t _width;
+            const size_t _window_size;
+            const size_t _stride;
+            const size_t _output_height;
+            const size_t _output_width;
+            const pooling_types _type;
+            const layouts _layout;
+
+            /**
+             * Buffers of the backpropagation (of a replica).
+             * @inputs - the current inputs, at a checkpoint (see "keep_inputs").
+             * @positions - max-pooling: the position "i * window_size + j" of the
+             * maximum in the window of each output.
+             * @nb_rows - the number of rows of the current inputs.
+             */
+            struct replica
+            {
+                matrix inputs;
+                std::vector<uint8_t> positions;
+                size_t nb_rows = 0;
+            };
+
+            std::vector<replica> _replicas;
+    };
+}
+
+
+#endif //CUDANN_POOLING_H
@@ -0,0 +1,543 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "recurrent.h"
+#include "lib/util/parallel/parallel.h"
+#include "lib/util/profiler/profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+using namespace cudaNN;
+
+
+namespace
+{
+    inline float sigmoid(float x)
+    {
+        return 1.f / (1.f + std::exp(- x));
+    }
+
+    /**
+     * outputs[j] += value * inputs[j].
+     * (Local sizes: vectorized.)
+     */
+    void add_scaled(const float *inputs, size_t length, float value, float *outputs)
+    {
+        for (size_t j = 0; j < length; j ++)
+        {
+            outputs[j] += value * inputs[j];
+        }
+    }
+
+    /**
+     * Copy the matrix "m" ("nb_rows x nb_columns") transposed in "result".
+     */
+    void transpose(const float *m, size_t nb_rows, size_t nb_columns, float *result)
+    {
+        parallel::for_range(nb_columns, std::max((size_t) 1, (size_t) PARALLEL_MIN_CHUNK_SIZE / nb_rows),
+                            [&](size_t begin, size_t end)
+        {
+            for (size_t j = begin; j < end; j ++)
+            {
+                for (size_t i = 0; i < nb_rows; i ++)
+                {
+                    result[j * nb_rows + i] = m[i * nb_columns + j];
+                }
+            }
+        });
+    }
+
+    /**
+     * Keep the memory of "m" if it already has the dimensions.
+     */
+    void allocate(matrix &m, size_t nb_rows, size_t nb_columns, const std::string &id)
+    {
+        if (m.get_data() == nullptr || m.get_dimensions() != std::make_pair(nb_rows, nb_columns))
+        {
+            m = matrix(nb_rows, nb_columns, id);
+        }
+    }
+}
+
+
+recurrent::recurrent(size_t input_size, size_t size,
+                     recurrent_types type /*= recurrent_types::LSTM*/,
+                     bool sequences /*= true*/, size_t truncation /*= 0*/,
+                     initializations init /*= initializations::XAVIER*/):
+        _input_size(input_size),
+        _size(size),
+        _type(type),
+        _sequences(sequences),
+        _truncation(truncation),
+        _sequence_length(1),
+        _input_weights(input_size, _get_nb_gates() * size, "recurrent::input_weights"),
+        _recurrent_weights(size, _get_nb_gates() * size, "recurrent::recurrent_weights"),
+        _biases(1, _get_nb_gates() * size, "recurrent::biases"),
+        _recurrent_biases(type == recurrent_types::GRU ? matrix(1, size, "recurrent::recurrent_biases")
+                                                       : matrix()),
+        _replicas(1)
+{
+    if (input_size == 0 || size == 0)
+    {
+        // Invalid.
+        util::ERROR("recurrent::recurrent",
+                    "Invalid dimensions " + std::to_string(input_size) + " -> "
+                    + std::to_string(size));
+        util::ERROR_EXIT();
+    }
+
+    _initialize(_input_weights, init, input_size);
+    _initialize(_recurrent_weights, init, size);
+
+    if (type == recurrent_types::LSTM)
+    {
+        // Forget gates open at first (the cell state is kept).
+        for (size_t j = 0; j < size; j ++)
+        {
+            _biases[(int) (size + j)] = 1.f;
+        }
+    }
+}
+
+matrix recurrent::feed_forward(matrix &inputs, size_t replica /*= 0*/)
+{
+    if (inputs.get_dimensions().second != _input_size || inputs.get_dimensions().first == 0)
+    {
+        // Invalid.
+        util::ERROR("recurrent::feed_forward",
+                    "Invalid @inputs size ("
+                    + std::to_string(inputs.get_dimensions().second)
+                    + " instead of "
+                    + std::to_string(_input_size)
+                    + ")");
+        util::ERROR_EXIT();
+    }
+
+    // Save the inputs from previous layer (for backpropagation).
+    _replicas[replica].inputs = inputs;
+
+    return _forward(replica);
+}
+
+matrix recurrent::recompute(size_t replica)
+{
+    return _forward(replica);
+}
+
+matrix recurrent::_forward(size_t replica)
+{
+    auto &r = _replicas[replica];
+    auto nb_steps = r.inputs.get_dimensions().first;
+    auto nb_gates = _get_nb_gates();
+    _sequence_length.store(nb_steps, std::memory_order_relaxed);
+    PROFILE_SCOPE("recurrent", _type == recurrent_types::LSTM ? "forward (lstm)" : "forward (gru)",
+                  nb_steps, nb_gates * _size, _input_size + _size,
+                  (double) (r.inputs.get_length() + _input_weights.get_length() + _recurrent_weights.get_length()
+                            + nb_steps * (nb_gates + 3) * _size) * sizeof(float),
+                  2. * (double) (nb_steps * nb_gates * _size * (_input_size + _size)));
+    // The input projections of every time step (a single product).
+    r.gates = r.inputs * _input_weights;
+    allocate(r.previous, nb_steps, _size, "recurrent::previous");
+    allocate(r.cells, nb_steps, _size, "recurrent::cells");
+    auto outputs = matrix(_sequences ? nb_steps : 1, _size, "recurrent::outputs");
+    auto chunk = std::max((size_t) 1, (size_t) PARALLEL_MIN_CHUNK_SIZE / (nb_gates * _size));
+
+    for (size_t t = 0; t < nb_steps; t ++)
+    {
+        float *state = outputs.get_data() + (_sequences ? t * _size : 0);
+
+        parallel::for_range(_size, chunk, [&](size_t begin, size_t end)
+        {
+            _forward_step(replica, t, state, begin, end);
+        });
+    }
+
+    return outputs;
+}
+
+void recurrent::_forward_step(size_t replica, size_t t, float *state, size_t begin, size_t end)
+{
+    auto &r = _replicas[replica];
+    auto nb_steps = r.gates.get_dimensions().first;
+    auto nb_gates = _get_nb_gates();
+    auto width = nb_gates * _size;
+    auto length = end - begin;
+    float *gates = r.gates.get_data() + t * width;
+    const float *previous = r.previous.get_data() + t * _size;
+    float *cells = r.cells.get_data() + t * _size;
+    const float *biases = _biases.get_data();
+    const float *weights = _recurrent_weights.get_data();
+    auto gru = _type == recurrent_types::GRU;
+
+    // Pre-activations: input projections, biases, and the product of the
+    // previous state by the recurrent weights (GRU: the new gate apart).
+    for (size_t q = 0; q < nb_gates; q ++)
+    {
+        add_scaled(biases + q * _size + begin, length, 1.f, gates + q * _size + begin);
+    }
+
+    if (gru)
+    {
+        std::copy(_recurrent_biases.get_data() + begin, _recurrent_biases.get_data() + end, cells + begin);
+    }
+
+    for (size_t k = 0; t > 0 && k < _size; k ++)
+    {
+        for (size_t q = 0; q < nb_gates; q ++)
+        {
+            float *outputs = gru && q == 2 ? cells : gates + q * _size;
+            add_scaled(weights + k * width + q * _size + begin, length, previous[k], outputs + begin);
+        }
+    }
+
+    // Gates and new state.
+    float *next = t + 1 < nb_steps ? r.previous.get_data() + (t + 1) * _size : nullptr;
+
+    for (size_t j = begin; j < end; j ++)
+    {
+        float h;
+
+        if (gru)
+        {
+            auto reset = sigmoid(gates[j]);
+            auto update = sigmoid(gates[_size + j]);
+            auto n = std::tanh(gates[2 * _size + j] + reset * cells[j]);
+            gates[j] = reset;
+            gates[_size + j] = update;
+            gates[2 * _size + j] = n;
+            h = (1.f - update) * n + update * previous[j];
+        }
+        else
+        {
+            auto input = sigmoid(gates[j]);
+            auto forget = sigmoid(gates[_size + j]);
+            auto cell = std::tanh(gates[2 * _size + j]);
+            auto output = sigmoid(gates[3 * _size + j]);
+            auto c = forget * (t > 0 ? cells[j - _size] : 0.f) + input * cell;
+            gates[j] = input;
+            gates[_size + j] = forget;
+            gates[2 * _size + j] = cell;
+            gates[3 * _size + j] = output;
+            cells[j] = c;
+            h = output * std::tanh(c);
+        }
+
+        if (next != nullptr)
+        {
+            next[j] = h;
+        }
+
+        if (state != nullptr && (_sequences || t + 1 == nb_steps))
+        {
+            state[j] = h;
+        }
+    }
+}
+
+void recurrent::backward_propagation(matrix &errors, size_t replica /*= 0*/,
+                                     bool propagate /*= true*/)
+{
+    auto &r = _replicas[replica];
+    auto nb_steps = r.inputs.get_dimensions().first;
+    auto nb_gates = _get_nb_gates();
+    auto width = nb_gates * _size;
+    PROFILE_SCOPE("recurrent", _type == recurrent_types::LSTM ? "backward_propagation (lstm)"
+                                                              : "backward_propagation (gru)",
+                  nb_steps, width, _input_size + _size,
+                  (double) (r.inputs.get_length() + _input_weights.get_length() + _recurrent_weights.get_length()
+                            + nb_steps * (2 * nb_gates + 3) * _size) * sizeof(float),
+                  (propagate ? 6. : 4.) * (double) (nb_steps * width * (_input_size + _size)));
+
+    if (r.first_entry)
+    {
+        // The first entry of the batch (i.e. first computed errors).
+        r.input_weight_gradients = matrix(_input_weights.get_dimensions(), "recurrent::input_weight_gradients");
+        r.recurrent_weight_gradients = matrix(_recurrent_weights.get_dimensions(),
+                                              "recurrent::recurrent_weight_gradients");
+        r.bias_gradients = matrix(_biases.get_dimensions(), "recurrent::bias_gradients");
+        r.recurrent_bias_gradients = matrix(_recurrent_biases.get_dimensions(),
+                                            "recurrent::recurrent_bias_gradients");
+        r.first_entry = false;
+    }
+
+    if (_type == recurrent_types::GRU)
+    {
+        allocate(r.gate_errors, nb_steps, width, "recurrent::gate_errors");
+    }
+
+    allocate(r.transposed_weights, width, _size, "recurrent::transposed_weights");
+    transpose(_recurrent_weights.get_data(), _size, width, r.transposed_weights.get_data());
+    r.state_errors.assign(_size, 0.f);
+    r.cell_errors.assign(_size, 0.f);
+    auto chunk = std::max((size_t) 1, (size_t) PARALLEL_MIN_CHUNK_SIZE / width);
+
+    // Backpropagation through time (truncated: no errors across the segments).
+    for (size_t t = nb_steps; t > 0; t --)
+    {
+        auto carry = t < nb_steps && (_truncation == 0 || t % _truncation != 0);
+        const float *e = _sequences ? errors.get_data() + (t - 1) * _size
+                                    : t == nb_steps ? errors.get_data() : nullptr;
+
+        parallel::for_range(_size, chunk, [&](size_t begin, size_t end)
+        {
+            _backward_step(replica, t - 1, e, carry, begin, end);
+        });
+    }
+
+    // Gradients of the weights over the whole sequence: "gates" holds the
+    // errors of the recurrent products, "gate_errors" (GRU) of the inputs.
+    auto &input_errors = _type == recurrent_types::GRU ? r.gate_errors : r.gates;
+    r.input_weight_gradients += r.inputs.transpose() * input_errors;
+    r.recurrent_weight_gradients += r.previous.transpose() * r.gates;
+
+    for (size_t t = 0; t < nb_steps; t ++)
+    {
+        add_scaled(input_errors.get_data() + t * width, width, 1.f, r.bias_gradients.get_data());
+
+        if (_type == recurrent_types::GRU)
+        {
+            add_scaled(r.gates.get_data() + t * width + 2 * _size, _size, 1.f,
+                       r.recurrent_bias_gradients.get_data());
+        }
+    }
+
+    if (propagate)
+    {
+        errors = (_input_weights * input_errors.transpose()).transpose();
+    }
+}
+
+void recurrent::_backward_step(size_t replica, size_t t, const float *errors, bool carry,
+                               size_t begin, size_t end)
+{
+    auto &r = _replicas[replica];
+    auto width = _get_nb_gates() * _size;
+    auto length = end - begin;
+    float *gates = r.gates.get_data() + t * width;
+    const float *previous = r.previous.get_data() + t * _size;
+    const float *cells = r.cells.get_data() + t * _size;
+    float *state_errors = r.state_errors.data();
+    float *cell_errors = r.cell_errors.data();
+
+    // Errors on the state: from the outputs, and from the step "t + 1" (its
+    // recurrent products, in its row of "gates", and the rest).
+    for (size_t j = begin; j < end; j ++)
+    {
+        state_errors[j] = (errors != nullptr ? errors[j] : 0.f) + (carry ? state_errors[j] : 0.f);
+    }
+
+    if (carry)
+    {
+        const float *next = gates + width;
+        const float *weights = r.transposed_weights.get_data();
+
+        for (size_t q = 0; q < width; q ++)
+        {
+            add_scaled(weights + q * _size + begin, length, next[q], state_errors + begin);
+        }
+    }
+
+    for (size_t j = begin; j < end; j ++)
+    {
+        auto dh = state_errors[j];
+
+        if (_type == recurrent_types::GRU)
+        {
+            auto reset = gates[j];
+            auto update = gates[_size + j];
+            auto n = gates[2 * _size + j];
+            auto dn = dh * (1.f - update) * (1.f - n * n);
+            auto dr = dn * cells[j] * reset * (1.f - reset);
+            auto dz = dh * (previous[j] - n) * update * (1.f - update);
+            float *input_errors = r.gate_errors.get_data() + t * width;
+            input_errors[j] = dr;
+            input_errors[_size + j] = dz;
+            input_errors[2 * _size + j] = dn;
+            gates[j] = dr;
+            gates[_size + j] = dz;
+            gates[2 * _size + j] = dn * reset;
+            state_errors[j] = dh * update;
+        }
+        else
+        {
+            auto input = gates[j];
+            auto forget = gates[_size + j];
+            auto cell = gates[2 * _size + j];
+            auto output = gates[3 * _size + j];
+            auto c = std::tanh(cells[j]);
+            auto dc = dh * output * (1.f - c * c) + (carry ? cell_errors[j] : 0.f);
+            gates[j] = dc * cell * input * (1.f - input);
+            gates[_size + j] = dc * (t > 0 ? cells[j - _size] : 0.f) * forget * (1.f - forget);
+            gates[2 * _size + j] = dc * input * (1.f - cell * cell);
+            gates[3 * _size + j] = dh * c * output * (1.f - output);
+            cell_errors[j] = dc * forget;
+            state_errors[j] = 0.f;
+        }
+    }
+}
+
+void recurrent::release(size_t replica, bool keep_inputs)
+{
+    auto &r = _replicas[replica];
+    r.gates.clear();
+    r.previous.clear();
+    r.cells.clear();
+    r.gate_errors.clear();
+
+    if (! keep_inputs)
+    {
+        r.inputs.clear();
+    }
+}
+
+void recurrent::gradient_descent(size_t batch_size, float learning_rate)
+{
+    PROFILE_SCOPE("recurrent", "gradient_descent", _size, _get_nb_gates() * _size);
+    // The replicas that processed entries.
+    auto replicas = std::vector<size_t>();
+
+    for (size_t r = 0; r < _replicas.size(); r ++)
+    {
+        if (! _replicas[r].first_entry)
+        {
+            replicas.push_back(r);
+            // Reset for next backpropagation.
+            _replicas[r].first_entry = true;
+        }
+    }
+
+    if (replicas.empty())
+    {
+        return;
+    }
+
+    _sum_gradients(replicas);
+    _update_parameters(replicas[0], learning_rate / (float) batch_size);
+}
+
+void recurrent::apply_gradients(size_t replica, size_t batch_size, float learning_rate)
+{
+    PROFILE_SCOPE("recurrent", "apply_gradients", _size, _get_nb_gates() * _size);
+
+    if (_replicas[replica].first_entry)
+    {
+        return;
+    }
+
+    // Reset for next backpropagation.
+    _replicas[replica].first_entry = true;
+    _update_parameters(replica, learning_rate / (float) batch_size, true);
+}
+
+void recurrent::clear_gradients()
+{
+    for (auto &r: _replicas)
+    {
+        // Overwritten by the next backpropagation.
+        r.first_entry = true;
+    }
+}
+
+void recurrent::set_nb_replicas(size_t nb_replicas)
+{
+    _replicas.resize(std::max((size_t) 1, nb_replicas));
+}
+
+size_t recurrent::get_nb_replicas() const
+{
+    return _replicas.size();
+}
+
+std::vector<matrix *> recurrent::get_parameters()
+{
+    if (_type == recurrent_types::GRU)
+    {
+        return { &_input_weights, &_recurrent_weights, &_biases, &_recurrent_biases };
+    }
+
+    return { &_input_weights, &_recurrent_weights, &_biases };
+}
+
+std::vector<matrix *> recurrent::get_gradients(size_t replica /*= 0*/)
+{
+    auto &r = _replicas[replica];
+
+    if (_type == recurrent_types::GRU)
+    {
+        return { &r.input_weight_gradients, &r.recurrent_weight_gradients, &r.bias_gradients,
+                 &r.recurrent_bias_gradients };
+    }
+
+    return { &r.input_weight_gradients, &r.recurrent_weight_gradients, &r.bias_gradients };
+}
+
+size_t recurrent::size() const
+{
+    return _size;
+}
+
+size_t recurrent::get_inputs_memory() const
+{
+    return _sequence_length.load(std::memory_order_relaxed) * _input_size * sizeof(float);
+}
+
+size_t recurrent::get_workspace_memory() const
+{
+    auto width = _get_nb_gates() * _size;
+    // The gates (and their errors, GRU), the previous states and the cells.
+    auto per_step = (_type == recurrent_types::GRU ? 2 : 1) * width + 2 * _size;
+
+    return _sequence_length.load(std::memory_order_relaxed) * per_step * sizeof(float);
+}
+
+void recurrent::set_truncation(size_t truncation)
+{
+    _truncation = truncation;
+}
+
+size_t recurrent::get_truncation() const
+{
+    return _truncation;
+}
+
+recurrent_types recurrent::get_type() const
+{
+    return _type;
+}
+
+matrix &recurrent::get_input_weights()
+{
+    return _input_weights;
+}
+
+matrix &recurrent::get_recurrent_weights()
+{
+    return _recurrent_weights;
+}
+
+matrix &recurrent::get_biases()
+{
+    return _biases;
+}
+
+matrix &recurrent::get_recurrent_biases()
+{
+    return _recurrent_biases;
+}
+
+size_t recurrent::_get_nb_gates() const
+{
+    return _type == recurrent_types::LSTM ? 4 : 3;
+}
+
+void recurrent::_print() const
+{
+    std::cout << "Recurrent:  " << (_type == recurrent_types::LSTM ? "lstm" : "gru") << ", "
+              << _input_size << " -> " << _size << (_sequences ? " (sequences)" : " (last state)")
+              << std::endl;
+    std::cout << "Truncation: " << (_truncation == 0 ? std::string("none") : std::to_string(_truncation))
+              << std::endl;
+}
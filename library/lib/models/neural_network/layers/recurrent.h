@@ -0,0 +1,215 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#ifndef CUDANN_RECURRENT_H
+#define CUDANN_RECURRENT_H
+
+#include "lib/models/neural_network/layers/base_layer.h"
+#include "lib/util/util.h"
+
+#include <atomic>
+#include <vector>
+
+
+namespace cudaNN
+{
+    /**
+     * Cell of a recurrent layer (state "h" of "size" values, updated at each
+     * time step from the inputs "x" and the previous state).
+     * @LSTM - long short-term memory: input, forget, cell and output gates,
+     * with a cell state "c":
+     * "c = f * c' + i * g, h = o * tanh(c)".
+     * @GRU - gated recurrent unit: reset, update and new gates (the reset
+     * gate applied after the product of the previous state, as cuDNN):
+     * "n = tanh(x Wn + bn + r * (h' Un + un)), h = (1 - z) * n + z * h'".
+     */
+    enum recurrent_types
+    {
+        LSTM,
+        GRU
+    };
+
+
+    /**
+     * Recurrent layer: each entry is a sequence, a row of the inputs per time
+     * step. The gates of the cell are concatenated (a column block per gate),
+     * such that:
+     * - the input projections of the whole sequence are a single matrix
+     * product (inputs x input weights);
+     * - each time step is a single product of the previous state by the
+     * recurrent weights (every gate), fused with the gates (activation
+     * functions and new state): one pass over the threads per time step.
+     * The backpropagation through time runs backwards over the same buffers
+     * (allocated once per sequence length, and kept by the replica), and the
+     * gradients of the weights are matrix products over the whole sequence.
+     * Not to be combined with layers depending on the batch (the rows are
+     * time steps, see -base_layer.h/depends_on_batch-).
+     */
+    class recurrent: public base_layer
+    {
+        public:
+
+            /**
+             * @param input_size - the number of inputs of a time step.
+             * @param size - the number of values of the state (outputs of a time step).
+             * @param type - the cell.
+             * @param sequences - if set, the outputs are the states of every time
+             * step (a row each); otherwise the last one only (a single row).
+             * @param truncation - truncated backpropagation through time: the errors
+             * go back through at most "truncation" time steps (the sequence is split
+             * in segments of "truncation" steps, whose errors are not propagated to
+             * the previous ones); 0 for the whole sequence.
+             * @param init - the type of initialization of the weights.
+             */
+            recurrent(size_t input_size, size_t size, recurrent_types type = recurrent_types::LSTM,
+                      bool sequences = true, size_t truncation = 0,
+                      initializations init = initializations::XAVIER);
+
+            matrix feed_forward(matrix &inputs, size_t replica = 0) override;
+            void backward_propagation(matrix &errors, size_t replica = 0,
+                                      bool propagate = true) override;
+            void release(size_t replica, bool keep_inputs) override;
+            matrix recompute(size_t replica) override;
+            void gradient_descent(size_t batch_size, float learning_rate) override;
+            void apply_gradients(size_t replica, size_t batch_size, float learning_rate) override;
+            void clear_gradients() override;
+            void set_nb_replicas(size_t nb_replicas) override;
+            size_t get_nb_replicas() const override;
+
+            /**
+             * @return - the input weights, the recurrent weights and the biases
+             * (a column block per gate), and the recurrent biases of the new
+             * gate (GRU only).
+             */
+            std::vector<matrix *> get_parameters() override;
+            std::vector<matrix *> get_gradients(size_t replica = 0) override;
+
+            size_t size() const override;
+
+            /**
+             * Memory of a sequence of the length of the last one (1 before the
+             * first forward propagation).
+             * @return - the inputs.
+             */
+            size_t get_inputs_memory() const override;
+
+            /**
+             * @return - the gates, the states and the errors of the gates.
+             */
+            size_t get_workspace_memory() const override;
+
+            void set_truncation(size_t truncation);
+            size_t get_truncation() const;
+
+            recurrent_types get_type() const;
+            matrix &get_input_weights();
+            matrix &get_recurrent_weights();
+            matrix &get_biases();
+
+            /**
+             * @return - GRU: the biases of the recurrent part of the new gate.
+             */
+            matrix &get_recurrent_biases();
+
+        protected:
+
+            /**
+             * Print the type, the dimensions and the truncation.
+             */
+            void _print() const override;
+
+        private:
+
+            /**
+             * Forward propagation of the sequence saved in the replica.
+             */
+            matrix _forward(size_t replica);
+
+            /**
+             * Time step "t" of the forward propagation, for the units [begin, end[
+             * of the state: the gates (from the input projections in "gates"),
+             * and the new state.
+             * @param state - receives the new state (a row of the outputs).
+             */
+            void _forward_step(size_t replica, size_t t, float *state, size_t begin, size_t end);
+
+            /**
+             * Time step "t" of the backpropagation, for the units [begin, end[:
+             * the errors of the gates, from the errors on the state and the ones
+             * propagated from the step "t + 1".
+             * @param errors - the errors on the state (a row of the errors on the
+             * outputs), nullptr if none.
+             * @param carry - false if the step "t + 1" is not in the segment of "t"
+             * (or does not exist): no errors propagated from it.
+             */
+            void _backward_step(size_t replica, size_t t, const float *errors, bool carry,
+                                size_t begin, size_t end);
+
+            /**
+             * @return - the number of gates of the cell.
+             */
+            size_t _get_nb_gates() const;
+
+            const size_t _input_size;
+            const size_t _size;
+            const recurrent_types _type;
+            const bool _sequences;
+            size_t _truncation;
+            std::atomic<size_t> _sequence_length;
+
+            /**
+             * @_input_weights - "input_size x (nb_gates * size)".
+             * @_recurrent_weights - "size x (nb_gates * size)".
+             * @_biases - "1 x (nb_gates * size)".
+             * @_recurrent_biases - GRU: "1 x size" (the new gate), empty otherwise.
+             */
+            matrix _input_weights;
+            matrix _recurrent_weights;
+            matrix _biases;
+            matrix _recurrent_biases;
+
+            /**
+             * Buffers of the propagations (of a replica), a row per time step,
+             * allocated once per sequence length.
+             * @inputs - the current sequence.
+             * @gates - the input projections, then the gates (after their
+             * activation functions), then (backpropagation) the errors of the
+             * recurrent products (before the activation functions).
+             * @previous - the state before each time step (0 before the first).
+             * @cells - LSTM: the cell state after each time step; GRU: the recurrent
+             * part of the new gate ("h' Un + un").
+             * @gate_errors - GRU: the errors of the input projections (the ones of
+             * the recurrent products, except for the new gate: not multiplied by the
+             * reset gate). LSTM: the same errors, in "gates".
+             * @transposed_weights - the recurrent weights, transposed (errors
+             * propagated to the previous state).
+             * @state_errors, @cell_errors - the errors propagated from a time step
+             * to the previous one, out of the recurrent products.
+             * @*_gradients - the sums over the entries of the batch (dimensions of
+             * the parameters).
+             * @first_entry - true if no entry has been processed since the last update.
+             */
+            struct replica
+            {
+                matrix inputs;
+                matrix gates;
+                matrix previous;
+                matrix cells;
+                matrix gate_errors;
+                matrix transposed_weights;
+                std::vector<float> state_errors;
+                std::vector<float> cell_errors;
+                matrix input_weight_gradients;
+                matrix recurrent_weight_gradients;
+                matrix bias_gradients;
+                matrix recurrent_bias_gradients;
+                bool first_entry = true;
+            };
+
+            std::vector<replica> _replicas;
+    };
+}
+
+
+#endif //CUDANN_RECURRENT_H
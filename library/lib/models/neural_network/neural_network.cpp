@@ -3,13 +3,38 @@
 //
 
 #include "neural_network.h"
+#include "lib/util/parallel/parallel.h"
+#include "lib/util/profiler/profiler.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
 
 
 using namespace cudaNN;
 
 
-neural_network::neural_network(std::initializer_list<layer *> layers):
-        _layers(layers)
+neural_network::neural_network(std::initializer_list<base_layer *> layers):
+        _layers(layers),
+        _training_times(),
+        _step_allocations(),
+        _training_mode(training_modes::SYNCHRONOUS),
+        _communicator(nullptr),
+        _checkpoint_interval(1),
+        _activation_budget(0),
+        _training(false)
+{
+}
+
+neural_network::neural_network(std::vector<base_layer *> layers):
+        _layers(std::move(layers)),
+        _training_times(),
+        _step_allocations(),
+        _training_mode(training_modes::SYNCHRONOUS),
+        _communicator(nullptr),
+        _checkpoint_interval(1),
+        _activation_budget(0),
+        _training(false)
 {
 }
 
@@ -21,48 +46,314 @@ void neural_network::fit(dataset &data,
                          bool print_loss /*= true*/,
                          size_t delta_loss /*= 100*/)
 {
+    PROFILE_SCOPE("training", "fit", data.size(), 0, epochs);
+
+    if (_communicator != nullptr && _training_mode != training_modes::SYNCHRONOUS)
+    {
+        // Invalid.
+        util::ERROR("neural_network::fit", "Distributed training is only synchronous");
+        util::ERROR_EXIT();
+    }
+
+    for (size_t i = 0; i < _layers.size(); i ++)
+    {
+        if (_communicator != nullptr && ! _layers[i]->has_dense_gradients())
+        {
+            // Invalid: the processes would not touch the same parameters.
+            util::ERROR("neural_network::fit", "Distributed training of sparse gradients");
+            util::ERROR_EXIT();
+        }
+
+        if (i > 0 && ! _layers[i]->can_propagate())
+        {
+            // Invalid: no errors for the previous layer (e.g. an embedding).
+            util::ERROR("neural_network::fit", "The layer n°" + std::to_string(i)
+                        + " can only be the first one");
+            util::ERROR_EXIT();
+        }
+    }
+
+    if (_has_sparse_inputs())
+    {
+        // The features of the entries converted once, not at each propagation.
+        data.set_sparse_features();
+    }
+
+    size_t nb_processes = _communicator == nullptr ? 1 : _communicator->get_nb_processes();
+    // The metrics files (same paths) are written by the process 0 only.
+    print_loss = print_loss && (_communicator == nullptr || _communicator->get_rank() == 0);
+    // (The counters of the statistics are only kept with -global.h/_STATISTICS-.)
+    bool print_statistics = print_loss && _STATISTICS;
+
+    // Metrics written in background, if the print option is set.
+    std::unique_ptr<metrics::logger> losses;
+    std::unique_ptr<metrics::logger> allocations_log;
+
     if (print_loss)
     {
-        // Name the csv column if the print option is set.
-        util::add_to_csv("Loss", PATH_LOSS_FILE);
+        losses.reset(new metrics::logger(PATH_LOSS_FILE,
+                                         { "Entry", "Loss", "Samples/s", "Learning rate" }));
+    }
+
+    if (print_statistics)
+    {
+        allocations_log.reset(new metrics::logger(PATH_ALLOCATIONS_FILE,
+                                                  { "Step", "Allocations", "Frees", "Allocated bytes",
+                                                    "Peak bytes", "Alive matrices", "Alive bytes" }));
     }
 
     size_t nb_batches = data.size() / batch_size;
+    // Synchronous: the entries of a batch are split in shards, processed at the
+    // same time by the threads (each with its replica of the buffers of the layers).
+    // In deterministic mode, the split does not depend on the number of threads.
+    // Hogwild: a replica per thread, processing its own batches.
+    // Distributed: a single shard (the processes share the batches).
+    // Layers depending on the batch (e.g. batch statistics): a single shard, the
+    // whole batch (the layers are parallel within it).
+    size_t nb_shards = _training_mode == training_modes::HOGWILD ? parallel::get_nb_threads()
+                       : _communicator != nullptr || depends_on_batch() ? 1
+                       : std::min(batch_size, parallel::is_deterministic() ?
+                                  (size_t) NB_DETERMINISTIC_SHARDS : parallel::get_nb_threads());
+    auto shard_times = std::vector<training_times>(nb_shards);
+    auto shard_losses = std::vector<metrics::running_mean>(nb_shards);
     size_t entries = 0;
+    auto loss = metrics::running_mean();
+    auto records = benchmark::stopwatch();
+    auto stopwatch = benchmark::stopwatch();
+    _training_times = training_times();
+
+    auto training = _training;
+    set_training(true);
+
+    for (auto l: _layers)
+    {
+        l->set_nb_replicas(nb_shards);
+    }
+
+    if (_communicator != nullptr)
+    {
+        _synchronize_parameters(nb_batches);
+    }
+
+    if (_activation_budget > 0)
+    {
+        // The interval with the least recomputation (i.e. the most kept layers).
+        size_t best = 0;
+        auto least_memory = std::numeric_limits<size_t>::max();
+
+        for (size_t k = 1; k <= _layers.size(); k ++)
+        {
+            auto memory = nb_shards * get_activation_memory(k);
+            least_memory = std::min(least_memory, memory);
+
+            if (memory <= _activation_budget
+                && (best == 0 || _get_first_kept_layer(k) < _get_first_kept_layer(best)))
+            {
+                best = k;
+            }
+        }
+
+        if (best == 0)
+        {
+            // Invalid: no interval fits.
+            util::ERROR("neural_network::fit", "Activation budget of "
+                        + std::to_string(_activation_budget) + " bytes too small (at least "
+                        + std::to_string(least_memory) + " bytes)");
+            util::ERROR_EXIT();
+        }
+
+        _checkpoint_interval = best;
+    }
+
+    // Add the times of the shards, in proportion of the time of their processing.
+    auto add_shard_times = [&](double time)
+    {
+        double shards_time = 0.;
+
+        for (auto &t: shard_times)
+        {
+            shards_time += t.forward + t.loss + t.backward + t.update;
+        }
+
+        for (auto &t: shard_times)
+        {
+            auto ratio = shards_time > 0. ? time / shards_time : 0.;
+            _training_times.forward += t.forward * ratio;
+            _training_times.loss += t.loss * ratio;
+            _training_times.backward += t.backward * ratio;
+            _training_times.update += t.update * ratio;
+            t = training_times();
+        }
+    };
+
+    // Log + save the mean loss since the previous record (every "delta_loss" entries).
+    auto record_loss = [&](size_t nb_entries)
+    {
+        for (auto &l: shard_losses)
+        {
+            loss.merge(l);
+            l.reset();
+        }
+
+        entries += nb_entries;
+
+        if (entries / delta_loss != (entries - nb_entries) / delta_loss)
+        {
+            auto time = records.lap();
+            losses->log({ (double) entries, loss.get(),
+                          time > 0. ? 1000. * (double) loss.get_count() / time : 0.,
+                          learning_rate });
+            util::INFO("neural_network::fit", "loss is " + std::to_string(loss.get()));
+            loss.reset();
+        }
+    };
 
     for (size_t i = 1; i <= epochs; i ++)
     {
         util::INFO("neural_network::fit",
                     "Starting epoch " + std::to_string(i) 
                     + " with " + std::to_string(nb_batches) + " batches");
+        stopwatch.lap();
+
+        if (_training_mode == training_modes::HOGWILD)
+        {
+            // The entries of the epoch, in a random order.
+            auto epoch = data.get_random_batch(nb_batches * batch_size);
+            _training_times.sampling += stopwatch.lap();
+            _fit_hogwild(epoch, loss_function, batch_size, learning_rate, print_loss,
+                         shard_times, shard_losses);
+            add_shard_times(stopwatch.lap());
+
+            if (print_loss)
+            {
+                record_loss(epoch.size());
+            }
+
+            continue;
+        }
 
         // For each epoch, execute the training on batches:
         for (size_t j = 1; j <= nb_batches; j ++)
         {
+            PROFILE_SCOPE("training", "step", batch_size);
+            auto allocations = statistics::get_allocations();
+            statistics::reset_peak();
             // Get a sample of "batch size" (features + labels).
             auto batch = data.get_random_batch(batch_size);
+            _training_times.sampling += stopwatch.lap();
             // Train with it.
-            for (size_t k = 0; k < batch_size; k ++)
+            parallel::for_each_chunk(nb_shards, [&](size_t s)
+            {
+                _fit_entries(batch, s * batch_size / nb_shards, (s + 1) * batch_size / nb_shards, s,
+                             loss_function, print_loss, shard_times[s], shard_losses[s]);
+            });
+            add_shard_times(stopwatch.lap());
+
+            if (print_loss)
+            {
+                record_loss(batch_size);
+            }
+
+            if (_communicator != nullptr)
             {
-                auto &e = batch.get(k);
-                // Forward + backward propagation.
-                auto predictions = _feed_forward(e.get_features());
-                auto labels = e.get_labels();
-                _backward_propagation(predictions, labels, loss_function);
-                // Log + save the loss.
-                if (print_loss && (entries ++) % delta_loss == 0)
-                {
-                    auto loss = std::to_string(loss_function.compute(
-                            { &predictions, &labels })[0]);
-                    util::INFO("neural_network::_backward_propagation",
-                               "loss is " + loss);
-                    util::add_to_csv(loss, PATH_LOSS_FILE);
-                }
+                // Gradients of the batches of every process.
+                _communicator->wait_all();
+                _training_times.communication += stopwatch.lap();
             }
 
-            _gradient_descent(batch_size, learning_rate);
+            _gradient_descent(nb_processes * batch_size, learning_rate);
+            _training_times.update += stopwatch.lap();
+            // Memory of the step.
+            _step_allocations = statistics::get_allocations();
+            _step_allocations.nb_allocations -= allocations.nb_allocations;
+            _step_allocations.nb_frees -= allocations.nb_frees;
+            _step_allocations.allocated_bytes -= allocations.allocated_bytes;
+
+            if (print_statistics)
+            {
+                auto &a = _step_allocations;
+                allocations_log->log({ (double) ((i - 1) * nb_batches + j),
+                                       (double) a.nb_allocations, (double) a.nb_frees,
+                                       (double) a.allocated_bytes, (double) a.peak_bytes,
+                                       (double) a.nb_alive, (double) a.bytes_alive });
+            }
         }
     }
+
+    if (print_statistics)
+    {
+        // Counters of the operations (since the start, or the last reset).
+        statistics::write_csv(PATH_OPERATIONS_FILE);
+    }
+
+    set_training(training);
+}
+
+void neural_network::set_training_mode(training_modes mode)
+{
+    _training_mode = mode;
+}
+
+training_modes neural_network::get_training_mode() const
+{
+    return _training_mode;
+}
+
+void neural_network::set_communicator(distributed::communicator *communicator)
+{
+    _communicator = communicator;
+}
+
+void neural_network::set_checkpoint_interval(size_t interval)
+{
+    _checkpoint_interval = std::max((size_t) 1, interval);
+}
+
+size_t neural_network::get_checkpoint_interval() const
+{
+    return _checkpoint_interval;
+}
+
+void neural_network::set_activation_budget(size_t budget)
+{
+    _activation_budget = budget;
+}
+
+size_t neural_network::get_activation_memory(size_t interval) const
+{
+    // Inputs and workspace of each layer.
+    auto first_kept = _get_first_kept_layer(interval);
+    size_t kept = 0;
+    size_t segment = 0;
+    size_t max_segment = 0;
+
+    for (size_t i = 0; i < _layers.size(); i ++)
+    {
+        auto checkpoint = i < first_kept && i % interval == 0;
+        // (Only the checkpoints keep the inputs not used by the backpropagation.)
+        auto inputs = checkpoint || _layers[i]->needs_inputs() ? _layers[i]->get_inputs_memory() : 0;
+        auto outputs = _layers[i]->get_workspace_memory();
+
+        if (i >= first_kept)
+        {
+            kept += inputs + outputs;
+        }
+        else if (checkpoint)
+        {
+            // Checkpoint: first layer of a segment.
+            kept += inputs;
+            segment = outputs;
+        }
+        else
+        {
+            segment += inputs + outputs;
+        }
+
+        max_segment = std::max(max_segment, i < first_kept ? segment : 0);
+    }
+
+    // The largest segment is computed again (during the backpropagation).
+    return kept + max_segment;
 }
 
 matrix neural_network::predict(const matrix &features) const
@@ -76,34 +367,225 @@ std::vector<matrix> neural_network::predict(dataset &test) const
 
     for (const auto& e: test.get_entries())
     {
-        predictions.push_back(_feed_forward(e.get_features()));
+        predictions.push_back(_feed_forward(e));
     }
 
     return predictions;
 }
 
-matrix neural_network::_feed_forward(const matrix &features) const
+void neural_network::_fit_hogwild(dataset &epoch, const function &loss_function,
+                                  size_t batch_size, float learning_rate, bool compute_loss,
+                                  std::vector<training_times> &times,
+                                  std::vector<metrics::running_mean> &losses)
 {
-    auto predictions = matrix(features, "neural_network::_feed_forward::predictions");
+    size_t nb_batches = epoch.size() / batch_size;
+    size_t nb_threads = times.size();
 
-    for (auto l: _layers)
+    // Each thread processes every "nb_threads" batch, and updates the
+    // parameters with its gradients without waiting for the others.
+    parallel::for_each_chunk(nb_threads, [&](size_t t)
+    {
+        auto stopwatch = benchmark::stopwatch();
+
+        for (size_t b = t; b < nb_batches; b += nb_threads)
+        {
+            PROFILE_SCOPE("training", "hogwild step", batch_size);
+            _fit_entries(epoch, b * batch_size, (b + 1) * batch_size, t,
+                         loss_function, compute_loss, times[t], losses[t]);
+            stopwatch.lap();
+
+            for (auto l: _layers)
+            {
+                l->apply_gradients(t, batch_size, learning_rate);
+            }
+
+            times[t].update += stopwatch.lap();
+        }
+    });
+}
+
+void neural_network::_fit_entries(dataset &batch, size_t begin, size_t end, size_t replica,
+                                  const function &loss_function, bool compute_loss,
+                                  training_times &times, metrics::running_mean &loss)
+{
+    auto stopwatch = benchmark::stopwatch();
+
+    if (depends_on_batch() && begin < end)
+    {
+        // The entries of the shard together (a row each).
+        auto rows = batch.stack(begin, end);
+        auto predictions = _feed_forward(rows.first, replica, true);
+        times.forward += stopwatch.lap();
+        auto errors = matrix();
+
+        if (compute_loss)
+        {
+            // The loss of each entry (its row), as below.
+            auto losses = loss_function.compute_with_derivatives({ &predictions, &rows.second }, errors);
+
+            for (size_t k = begin; k < end; k ++)
+            {
+                loss.add(losses[(int) ((k - begin) * losses.get_dimensions().second)]);
+            }
+        }
+        else
+        {
+            errors = loss_function.compute_derivatives({ &predictions, &rows.second });
+        }
+
+        times.loss += stopwatch.lap();
+        _backward_propagation(errors, replica, _communicator != nullptr);
+        times.backward += stopwatch.lap();
+
+        return;
+    }
+
+    for (size_t k = begin; k < end; k ++)
+    {
+        auto &e = batch.get(k);
+        // Forward propagation, loss, and backward propagation.
+        auto predictions = _feed_forward(e, replica, true);
+        auto labels = e.get_labels();
+        times.forward += stopwatch.lap();
+        auto errors = matrix();
+
+        if (compute_loss)
+        {
+            // The loss of each entry, with its derivatives (in one pass if possible).
+            loss.add(loss_function.compute_with_derivatives({ &predictions, &labels }, errors)[0]);
+        }
+        else
+        {
+            errors = loss_function.compute_derivatives({ &predictions, &labels });
+        }
+
+        times.loss += stopwatch.lap();
+        _backward_propagation(errors, replica, _communicator != nullptr && k + 1 == end);
+        times.backward += stopwatch.lap();
+    }
+}
+
+matrix neural_network::_feed_forward(const matrix &features, size_t replica /*= 0*/,
+                                     bool checkpoint /*= false*/,
+                                     const sparse_matrix *sparse_features /*= nullptr*/) const
+{
+    // (No copy of the features given sparse.)
+    auto predictions = sparse_features == nullptr
+                       ? matrix(features, "neural_network::_feed_forward::predictions") : matrix();
+    // Predictions: the buffers are freed after each layer, except in training
+    // mode (kept as during a training: e.g. the next forward propagation of a
+    // released layer would be the one of the same entry, see -dropout.h-).
+    auto first_kept = checkpoint ? _get_first_kept_layer(_checkpoint_interval)
+                                 : _training ? 0 : _layers.size();
+
+    for (size_t i = 0; i < _layers.size(); i ++)
     {
-        predictions = l->feed_forward(predictions);
+        if (checkpoint && i < first_kept && i % _checkpoint_interval == 0
+            && ! _layers[i]->needs_inputs())
+        {
+            // A checkpoint, not kept by the layer itself.
+            _layers[i]->keep_inputs(predictions, replica);
+        }
+
+        predictions = i == 0 && sparse_features != nullptr
+                      ? static_cast<layer *>(_layers[0])->feed_forward(*sparse_features, replica)
+                      : _layers[i]->feed_forward(predictions, replica);
+
+        if (i < first_kept)
+        {
+            // Computed again during the backpropagation (from the checkpoints).
+            _layers[i]->release(replica, i % _checkpoint_interval == 0);
+        }
     }
 
     return predictions;
 }
 
-void neural_network::_backward_propagation(matrix &predictions,
-                                           matrix &labels,
-                                           const function &loss_function)
+matrix neural_network::_feed_forward(const entry &e, size_t replica /*= 0*/,
+                                     bool checkpoint /*= false*/) const
+{
+    return _feed_forward(e.get_features(), replica, checkpoint,
+                         e.has_sparse_features() && _has_sparse_inputs() ? &e.get_sparse_features() : nullptr);
+}
+
+bool neural_network::_has_sparse_inputs() const
+{
+    auto first = _layers.empty() ? nullptr : dynamic_cast<layer *>(_layers[0]);
+
+    return first != nullptr && first->get_input_type() == input_types::SPARSE;
+}
+
+void neural_network::_backward_propagation(matrix &errors, size_t replica /*= 0*/,
+                                           bool communicate /*= false*/)
 {
-    auto errors = loss_function.compute_derivatives({ &predictions, &labels });
+    auto first_kept = _get_first_kept_layer(_checkpoint_interval);
 
     for (size_t i = _layers.size(); i > 0; i --)
     {
-        _layers[i - 1]->backward_propagation(errors,(i == _layers.size() ?
-                                                     nullptr : _layers[i]));
+        auto l = _layers[i - 1];
+
+        if (i - 1 < first_kept && i % _checkpoint_interval == 0)
+        {
+            // Last layer of a segment: forward propagation of the segment
+            // again, from its checkpoint.
+            auto c = i - _checkpoint_interval;
+            auto outputs = _layers[c]->recompute(replica);
+
+            for (size_t j = c + 1; j < i; j ++)
+            {
+                outputs = _layers[j]->feed_forward(outputs, replica);
+            }
+        }
+
+        // (No errors to propagate before the first layer.)
+        l->backward_propagation(errors, replica, i > 1);
+
+        if (i - 1 < first_kept)
+        {
+            l->release(replica, false);
+        }
+
+        if (communicate)
+        {
+            // Sent while the previous layers are processed.
+            for (auto g: l->get_gradients(replica))
+            {
+                _communicator->all_reduce_async(g->get_data(), g->get_length());
+            }
+        }
+    }
+}
+
+size_t neural_network::_get_first_kept_layer(size_t interval) const
+{
+    if (interval <= 1 || _layers.empty())
+    {
+        return 0;
+    }
+
+    // The last segment (which may be incomplete) is kept.
+    return (_layers.size() - 1) / interval * interval;
+}
+
+void neural_network::_synchronize_parameters(size_t nb_batches)
+{
+    auto batches = (float) nb_batches;
+    _communicator->all_reduce(&batches, 1);
+
+    if (batches != (float) (nb_batches * _communicator->get_nb_processes()))
+    {
+        // Invalid.
+        util::ERROR("neural_network::_synchronize_parameters",
+                    "The processes do not have the same number of batches");
+        util::ERROR_EXIT();
+    }
+
+    for (auto l: _layers)
+    {
+        for (auto p: l->get_parameters())
+        {
+            _communicator->broadcast(p->get_data(), p->get_length());
+        }
     }
 }
 
@@ -115,11 +597,115 @@ void neural_network::_gradient_descent(size_t batch_size, float learning_rate)
     }
 }
 
-layer *neural_network::get_layer(int i)
+void neural_network::set_training(bool training)
+{
+    _training = training;
+
+    for (auto l: _layers)
+    {
+        l->set_training(training);
+    }
+}
+
+bool neural_network::is_training() const
+{
+    return _training;
+}
+
+bool neural_network::depends_on_batch() const
+{
+    for (auto l: _layers)
+    {
+        if (l->depends_on_batch())
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+size_t neural_network::fold_normalizations()
+{
+    size_t nb_folded = 0;
+
+    for (size_t i = 0; i + 1 < _layers.size(); i ++)
+    {
+        auto previous = dynamic_cast<layer *>(_layers[i]);
+        auto n = dynamic_cast<normalization *>(_layers[i + 1]);
+
+        if (previous == nullptr || n == nullptr
+            || n->get_type() != normalization_types::BATCH_NORMALIZATION
+            || previous->get_activation_function() != activation_functions::LINEAR.get_id())
+        {
+            continue;
+        }
+
+        _layers[i] = n->fold(*previous);
+        _layers.erase(_layers.begin() + (long) i + 1);
+        nb_folded ++;
+    }
+
+    return nb_folded;
+}
+
+base_layer *neural_network::get_layer(int i)
 {
     return _layers[i];
 }
 
+size_t neural_network::get_nb_layers() const
+{
+    return _layers.size();
+}
+
+std::vector<std::vector<matrix>> neural_network::compute_gradients(dataset &batch,
+                                                                   const function &loss_function)
+{
+    // Local to this process.
+    auto communicator = _communicator;
+    auto times = training_times();
+    auto loss = metrics::running_mean();
+    auto results = std::vector<std::vector<matrix>>();
+    auto training = _training;
+    _communicator = nullptr;
+    set_training(true);
+
+    for (auto l: _layers)
+    {
+        l->clear_gradients();
+    }
+
+    _fit_entries(batch, 0, batch.size(), 0, loss_function, false, times, loss);
+
+    for (auto l: _layers)
+    {
+        results.emplace_back();
+
+        for (auto g: l->get_gradients())
+        {
+            results.back().push_back(*g);
+        }
+
+        l->clear_gradients();
+    }
+
+    _communicator = communicator;
+    set_training(training);
+
+    return results;
+}
+
+const neural_network::training_times &neural_network::get_training_times() const
+{
+    return _training_times;
+}
+
+const statistics::allocations &neural_network::get_step_allocations() const
+{
+    return _step_allocations;
+}
+
 void neural_network::print(const neural_network &n)
 {
     std::cout << "---------------------------" << std::endl;
@@ -128,7 +714,7 @@ void neural_network::print(const neural_network &n)
 
     for (auto l: n._layers)
     {
-        layer::print(*l);
+        base_layer::print(*l);
         std::cout << "---------------------------" << std::endl;
     }
 }
\ No newline at end of file
@@ -6,28 +6,95 @@
 #define CUDANN_NEURAL_NETWORK_H
 
 #include "lib/models/model.h"
+#include "lib/models/neural_network/layers/attention.h"
+#include "lib/models/neural_network/layers/convolution.h"
+#include "lib/models/neural_network/layers/dropout.h"
+#include "lib/models/neural_network/layers/embedding.h"
 #include "lib/models/neural_network/layers/layer.h"
+#include "lib/models/neural_network/layers/normalization.h"
+#include "lib/models/neural_network/layers/pooling.h"
+#include "lib/models/neural_network/layers/recurrent.h"
 #include "lib/util/util.h"
+#include "lib/util/benchmark/benchmark.h"
+#include "lib/util/distributed/distributed.h"
+#include "lib/util/metrics/metrics.h"
+#include "lib/util/statistics/statistics.h"
 
 #include <initializer_list>
 
 
 #define PATH_LOSS_FILE "loss.csv"
+#define PATH_ALLOCATIONS_FILE "allocations.csv"
+#define PATH_OPERATIONS_FILE "operations.csv"
+
+/**
+ * Number of shards of a batch processed at the same time during the training
+ * in deterministic mode (see -global.h/_DETERMINISTIC-); a shard per thread
+ * otherwise.
+ */
+#define NB_DETERMINISTIC_SHARDS 16
 
 
 namespace cudaNN
 {
+    /**
+     * How the threads share the training of a neural network.
+     * @SYNCHRONOUS - the entries of each batch are processed over the threads,
+     * and their gradients summed before a single update (same result whatever
+     * the number of threads in deterministic mode).
+     * @HOGWILD - each thread processes its own batches, and updates the shared
+     * weights and biases without any lock (Hogwild!). Unlike the original
+     * scheme (plain writes, where the updates of the threads may overwrite each
+     * other), each element is updated with a relaxed compare and swap of its
+     * bits, for a few more cycles per element: the concurrent updates are not
+     * lost (see -base_layer.h/_subtract-). The propagations still read the
+     * weights with plain loads, at the same time: they may see values partly
+     * updated by the other threads. Not reproducible.
+     */
+    enum training_modes
+    {
+        SYNCHRONOUS,
+        HOGWILD
+    };
+
     /**
      * Model implementation of a neural network.
      * Current implementation can be used with dataset 
      * of 1 row features and 1 row labels (horizontal vectors).
      * Is made of layers.
+     * The entries of a batch are processed over the threads (data
+     * parallelism); their gradients are summed before each update.
      */
     class neural_network: public model
     {
         public:
 
-            neural_network(std::initializer_list<layer *> layers);
+            /**
+             * Time (ms) spent in each phase of the last training ("fit").
+             * @sampling - selection of the batches.
+             * @forward - forward propagation.
+             * @loss - derivatives of the loss function (and logging of the loss).
+             * @backward - backpropagation.
+             * @update - gradient descent.
+             * @communication - waiting for the gradients of the other processes
+             * (distributed training).
+             */
+            struct training_times
+            {
+                double sampling;
+                double forward;
+                double loss;
+                double backward;
+                double update;
+                double communication;
+            };
+
+            /**
+             * @param layers - layers of any type (see -base_layer.h-), each one
+             * taking the outputs of the previous one.
+             */
+            neural_network(std::initializer_list<base_layer *> layers);
+            explicit neural_network(std::vector<base_layer *> layers);
 
             void fit(dataset &data,
                      const function &loss_function,
@@ -39,8 +106,100 @@ namespace cudaNN
 
             matrix predict(const matrix &features) const override;
             std::vector<matrix> predict(dataset &test) const override;
-            layer *get_layer(int i);
+            base_layer *get_layer(int i);
+            size_t get_nb_layers() const;
+            const training_times &get_training_times() const;
+
+            /**
+             * @return - the memory of the matrices during the last step
+             * of the training (a batch): the numbers of allocations and
+             * frees, the allocated bytes, and the peak during the step;
+             * the alive matrices at its end (zeros if -global.h/_STATISTICS- is not set).
+             */
+            const statistics::allocations &get_step_allocations() const;
+
+            /**
+             * Backpropagation of the loss on every entry of "batch", without update
+             * (e.g. to be compared with finite differences, see -gradient_check.h-),
+             * as during a training (a single shard).
+             * @return - the gradients of each layer, summed over the entries: a matrix
+             * per parameter of the layer (see "base_layer::get_parameters").
+             */
+            std::vector<std::vector<matrix>> compute_gradients(dataset &batch,
+                                                               const function &loss_function);
+
+            /**
+             * @param mode - how the threads share the next trainings ("fit");
+             * synchronous by default.
+             */
+            void set_training_mode(training_modes mode);
+            training_modes get_training_mode() const;
+
+            /**
+             * @param communicator - if set, the next trainings are distributed over
+             * its processes (synchronous mode only): each one trains on its own
+             * dataset (with the same number of batches), starting from the weights
+             * of the process 0, and the gradients of each batch are summed over the
+             * processes before the update. The sum of the gradients of a layer is
+             * started as soon as they are computed, during the backpropagation
+             * of the previous layers. Only the process 0 writes the metrics files.
+             * Not available with layers of sparse gradients (e.g. sparse inputs).
+             * nullptr to train alone (default).
+             */
+            void set_communicator(distributed::communicator *communicator);
+
+            /**
+             * Activation checkpointing: during the training, only the inputs of
+             * every "interval"-th layer (and the buffers of the last layers) are
+             * kept after the forward propagation of an entry; the other ones are
+             * computed again from them during the backpropagation. It costs at
+             * most one more forward propagation per entry.
+             * @param interval - the number of layers between two checkpoints
+             * (1 to keep every buffer, default).
+             */
+            void set_checkpoint_interval(size_t interval);
+            size_t get_checkpoint_interval() const;
+
+            /**
+             * @param budget - the maximal memory (bytes) of the buffers kept between
+             * the forward and backward propagations, over the threads. The next
+             * trainings use the checkpoint interval fitting the budget with the least
+             * recomputation (0 to use the one of "set_checkpoint_interval"); a
+             * training fails if none fits.
+             */
+            void set_activation_budget(size_t budget);
 
+            /**
+             * @return - the estimated memory (bytes) of the buffers of the layers
+             * used to train on an entry (peak, for a thread), with checkpoints
+             * every "interval" layers.
+             */
+            size_t get_activation_memory(size_t interval) const;
+
+            /**
+             * @param training - if set, the next predictions are computed as during
+             * a training (e.g. with the statistics of their rows, see
+             * -base_layer.h/set_training-). Set during "fit" only by default.
+             */
+            void set_training(bool training);
+            bool is_training() const;
+
+            /**
+             * @return - true if a layer depends on the batch of the entries (see
+             * -base_layer.h/depends_on_batch-): during a training, the entries of
+             * each batch are then propagated together, a row per entry (a single
+             * shard in synchronous mode, whatever the number of threads).
+             */
+            bool depends_on_batch() const;
+
+            /**
+             * Export for inference: each batch normalization following a layer
+             * with a linear activation function is folded in it (see
+             * -normalization.h/fold-). The pair is replaced by the folded layer
+             * (the replaced layers are not deleted).
+             * @return - the number of folded normalizations.
+             */
+            size_t fold_normalizations();
 
             /**
              * Print the given network (layers).
@@ -50,26 +209,80 @@ namespace cudaNN
 
         private:
 
+            /**
+             * An epoch of Hogwild! training: the batches of "epoch" are distributed
+             * over the threads, which update the layers after each of them.
+             * @param epoch - the entries of the epoch, in the order of processing.
+             * @param times, losses - an element per thread.
+             */
+            void _fit_hogwild(dataset &epoch, const function &loss_function,
+                              size_t batch_size, float learning_rate, bool compute_loss,
+                              std::vector<training_times> &times,
+                              std::vector<metrics::running_mean> &losses);
+
+            /**
+             * Forward propagation, loss and backpropagation of the entries
+             * [begin, end[ of the batch (a shard), with a replica of the layers.
+             * @param compute_loss - if set, the loss of each entry is added to "loss".
+             * @param times - receives the time spent in each phase.
+             */
+            void _fit_entries(dataset &batch, size_t begin, size_t end, size_t replica,
+                              const function &loss_function, bool compute_loss,
+                              training_times &times, metrics::running_mean &loss);
+
             /**
              * Forward propagation/pass; for a given entry, compute the predictions
              * of the model.
              * @param features - from a dataset entry.
+             * @param replica - the buffers of the layers to be used.
+             * @param checkpoint - if set, the buffers of the layers that are not
+             * checkpoints are freed (training, see "set_checkpoint_interval");
+             * otherwise every buffer is freed, except in training mode.
+             * @param sparse_features - if given, the same features, sparse, for
+             * the first layer (of sparse inputs): not converted again.
              * @return - the neural network predictions.
              */
-            matrix _feed_forward(const matrix &features) const;
+            matrix _feed_forward(const matrix &features, size_t replica = 0,
+                                 bool checkpoint = false,
+                                 const sparse_matrix *sparse_features = nullptr) const;
+
+            /**
+             * Forward propagation of the features of "e": the sparse ones if it has
+             * them and the first layer has sparse inputs (see "_has_sparse_inputs").
+             */
+            matrix _feed_forward(const entry &e, size_t replica = 0, bool checkpoint = false) const;
+
+            /**
+             * @return - true if the first layer has sparse inputs (see
+             * -layer.h/set_sparse_inputs-): its inputs can be given sparse.
+             */
+            bool _has_sparse_inputs() const;
 
             /**
              * Backpropagation; calculate and store the gradients of intermediate
-             * variables and functions, using the given loss function, for a given
-             * entry.
-             * @param predictions - the prediction of the model on this entry.
-             * @param labels - the ground truth of the entry.
-             * @param loss_function - compute the error between the predictions
-             * and labels.
+             * variables and functions, for a given entry.
+             * @param errors - the derivatives of the loss function on the
+             * predictions of the model on this entry.
+             * @param replica - the buffers of the layers to be used.
+             * @param communicate - if set, the all-reduce of the gradients of each
+             * layer is started once its backpropagation is done (last entry of
+             * a batch, in distributed training).
+             */
+            void _backward_propagation(matrix &errors, size_t replica = 0, bool communicate = false);
+
+            /**
+             * @return - the index of the first layer whose buffers are all kept
+             * after the forward propagation, with checkpoints every "interval"
+             * layers (the layers before are grouped in segments of "interval"
+             * layers, recomputed from their first one).
+             */
+            size_t _get_first_kept_layer(size_t interval) const;
+
+            /**
+             * Distributed training: start from the parameters of the process 0,
+             * and check that every process has "nb_batches" batches.
              */
-            void _backward_propagation(matrix &predictions,
-                                       matrix &labels,
-                                       const function &loss_function);
+            void _synchronize_parameters(size_t nb_batches);
 
             /**
              * Change the model weights and biases in response to the computed
@@ -81,7 +294,14 @@ namespace cudaNN
              */
             void _gradient_descent(size_t batch_size, float learning_rate);
 
-            std::vector<layer *> _layers;
+            std::vector<base_layer *> _layers;
+            training_times _training_times;
+            statistics::allocations _step_allocations;
+            training_modes _training_mode;
+            distributed::communicator *_communicator;
+            size_t _checkpoint_interval;
+            size_t _activation_budget;
+            bool _training;
     };
 }
 
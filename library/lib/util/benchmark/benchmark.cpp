@@ -0,0 +1,232 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "benchmark.h"
+#include "lib/util/util.h"
+#include "lib/util/parallel/parallel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+
+using namespace cudaNN;
+
+
+namespace
+{
+    typedef std::chrono::steady_clock clock_;
+
+    double elapsed(const clock_::time_point &start)
+    {
+        return std::chrono::duration<double, std::milli>(clock_::now() - start).count();
+    }
+
+    /**
+     * @return - the value at "p" (in [0, 1]) of the sorted "values".
+     */
+    double percentile(const std::vector<double> &values, double p)
+    {
+        double position = p * (double) (values.size() - 1);
+        auto i = (size_t) position;
+
+        if (i + 1 >= values.size())
+        {
+            return values.back();
+        }
+
+        return values[i] + (position - (double) i) * (values[i + 1] - values[i]);
+    }
+
+    std::string escape(const std::string &s)
+    {
+        std::string escaped;
+
+        for (auto c: s)
+        {
+            if (c == '"' || c == '\\')
+            {
+                escaped += '\\';
+            }
+
+            escaped += c;
+        }
+
+        return escaped;
+    }
+}
+
+
+benchmark::stopwatch::stopwatch():
+        _start(clock_::now())
+{
+}
+
+double benchmark::stopwatch::lap()
+{
+    auto now = clock_::now();
+    auto time = std::chrono::duration<double, std::milli>(now - _start).count();
+    _start = now;
+
+    return time;
+}
+
+benchmark::options benchmark::default_options()
+{
+    return { BENCHMARK_NB_WARMUPS, BENCHMARK_WARMUP_TIME,
+             BENCHMARK_MIN_NB_RUNS, BENCHMARK_MAX_NB_RUNS, BENCHMARK_MIN_TIME };
+}
+
+benchmark::result benchmark::run(const std::string &name, const std::string &shape,
+                                 const std::function<void()> &f,
+                                 double flops, double bytes,
+                                 const options &o /*= default_options()*/)
+{
+    // Warmups (at least one).
+    auto start = clock_::now();
+
+    for (size_t i = 0; i == 0 || (i < o.nb_warmups && elapsed(start) < 1000. * o.warmup_time); i ++)
+    {
+        f();
+    }
+
+    // Measures.
+    auto times = std::vector<double>();
+    double total = 0.;
+
+    while (times.size() < o.max_nb_runs
+           && (times.size() < o.min_nb_runs || total < 1000. * o.min_time))
+    {
+        auto run_start = clock_::now();
+        f();
+        times.push_back(elapsed(run_start));
+        total += times.back();
+    }
+
+    auto r = compute_statistics(times);
+    r.name = name;
+    r.shape = shape;
+    // Rates on the median (ms to s, and to giga).
+    r.gflops = r.median > 0. ? flops / (r.median * 1e6) : 0.;
+    r.gbytes = r.median > 0. ? bytes / (r.median * 1e6) : 0.;
+
+    return r;
+}
+
+benchmark::result benchmark::compute_statistics(std::vector<double> times)
+{
+    auto r = result();
+
+    if (times.empty())
+    {
+        return r;
+    }
+
+    std::sort(times.begin(), times.end());
+
+    double sum = 0.;
+    double sum_squares = 0.;
+
+    for (auto t: times)
+    {
+        sum += t;
+        sum_squares += t * t;
+    }
+
+    r.nb_runs = times.size();
+    r.min = times.front();
+    r.max = times.back();
+    r.mean = sum / (double) times.size();
+    r.stddev = std::sqrt(std::max(0., sum_squares / (double) times.size() - r.mean * r.mean));
+    r.median = percentile(times, .5);
+    r.p10 = percentile(times, .1);
+    r.p90 = percentile(times, .9);
+    r.p99 = percentile(times, .99);
+
+    return r;
+}
+
+void benchmark::print(const result &r)
+{
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(4)
+         << std::left << std::setw(40) << r.name + " " + r.shape
+         << std::right
+         << " median " << std::setw(11) << r.median << " ms"
+         << " [p10 " << r.p10 << ", p90 " << r.p90 << "]"
+         << " (" << r.nb_runs << " runs)";
+
+    if (r.gflops > 0.)
+    {
+        line << std::setprecision(2) << " " << r.gflops << " GFLOP/s";
+    }
+    if (r.gbytes > 0.)
+    {
+        line << std::setprecision(2) << " " << r.gbytes << " GB/s";
+    }
+    if (r.items_per_second > 0.)
+    {
+        line << std::setprecision(1) << " " << r.items_per_second << " items/s";
+    }
+
+    std::cout << line.str() << std::endl;
+}
+
+void benchmark::write_json(const std::vector<result> &results,
+                           const std::string &label, const std::string &path)
+{
+    auto file = std::ofstream(path);
+
+    if (!file)
+    {
+        util::ERROR("benchmark::write_json", "Unable to open " + path);
+        return;
+    }
+
+    char date[32];
+    auto now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    file << std::setprecision(9)
+         << "{\n"
+         << "  \"context\": {\n"
+         << "    \"label\": \"" << escape(label) << "\",\n"
+         << "    \"date\": \"" << date << "\",\n"
+         << "    \"backend\": \"" << (_USE_GPU ? "gpu" : "cpu") << "\",\n"
+         << "    \"nb_threads\": " << parallel::get_nb_threads() << ",\n"
+         << "    \"deterministic\": " << (parallel::is_deterministic() ? "true" : "false") << ",\n"
+         << "    \"time_unit\": \"ms\"\n"
+         << "  },\n"
+         << "  \"benchmarks\": [";
+
+    for (size_t i = 0; i < results.size(); i ++)
+    {
+        auto &r = results[i];
+
+        file << (i == 0 ? "\n" : ",\n")
+             << "    {"
+             << "\"name\": \"" << escape(r.name) << "\", "
+             << "\"shape\": \"" << escape(r.shape) << "\", "
+             << "\"nb_runs\": " << r.nb_runs << ", "
+             << "\"min\": " << r.min << ", "
+             << "\"median\": " << r.median << ", "
+             << "\"mean\": " << r.mean << ", "
+             << "\"stddev\": " << r.stddev << ", "
+             << "\"p10\": " << r.p10 << ", "
+             << "\"p90\": " << r.p90 << ", "
+             << "\"p99\": " << r.p99 << ", "
+             << "\"max\": " << r.max << ", "
+             << "\"gflops\": " << r.gflops << ", "
+             << "\"gbytes_per_second\": " << r.gbytes << ", "
+             << "\"items_per_second\": " << r.items_per_second
+             << "}";
+    }
+
+    file << "\n  ]\n}\n";
+}
@@ -0,0 +1,142 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#ifndef CUDANN_BENCHMARK_H
+#define CUDANN_BENCHMARK_H
+
+#include "lib/global.h"
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+/**
+ * Default number of runs not measured before the measures (to warm the
+ * caches, the allocator and the device), and their maximal duration (s).
+ */
+#define BENCHMARK_NB_WARMUPS 3
+#define BENCHMARK_WARMUP_TIME 0.1
+
+/**
+ * Default bounds of the number of measured runs; the runs go on
+ * until BENCHMARK_MIN_TIME (s) is spent (at least the minimal number).
+ */
+#define BENCHMARK_MIN_NB_RUNS 5
+#define BENCHMARK_MAX_NB_RUNS 1000
+#define BENCHMARK_MIN_TIME 0.5
+
+
+namespace cudaNN
+{
+    /**
+     * Measures of the wall time of operations (on host or device;
+     * every operation of the library waits for the device).
+     */
+    namespace benchmark
+    {
+        /**
+         * Parameters of the measures (see the BENCHMARK_* macros).
+         */
+        struct options
+        {
+            size_t nb_warmups;
+            double warmup_time;
+            size_t min_nb_runs;
+            size_t max_nb_runs;
+            double min_time;
+        };
+
+        /**
+         * @return - the options from the BENCHMARK_* macros.
+         */
+        options default_options();
+
+        /**
+         * Wall time measure between successive calls.
+         */
+        class stopwatch
+        {
+            public:
+
+                stopwatch();
+
+                /**
+                 * @return - the time (ms) since the previous call
+                 * (or the construction), and restart the measure.
+                 */
+                double lap();
+
+            private:
+
+                std::chrono::steady_clock::time_point _start;
+        };
+
+        /**
+         * Statistics on the measured times of an operation (ms).
+         * The percentiles are interpolated between the closest runs.
+         * The rates are computed on the median; "items_per_second" is
+         * set by the caller if relevant (e.g. the samples of a training).
+         */
+        struct result
+        {
+            std::string name;
+            std::string shape;
+            size_t nb_runs;
+            double min;
+            double median;
+            double mean;
+            double stddev;
+            double p10;
+            double p90;
+            double p99;
+            double max;
+            double gflops;
+            double gbytes;
+            double items_per_second;
+        };
+
+        /**
+         * Measure "f" (warmups, then repeated runs).
+         * @param name - the name of the operation.
+         * @param shape - the description of the inputs (e.g. "32x1024").
+         * @param f - the operation.
+         * @param flops - the number of floating point operations done by "f"
+         * (0 if not relevant), to compute the GFLOP/s.
+         * @param bytes - the number of bytes read and written by "f"
+         * (0 if not relevant), to compute the GB/s.
+         * @return - the statistics on the measures (on the median for the rates).
+         */
+        result run(const std::string &name, const std::string &shape,
+                   const std::function<void()> &f,
+                   double flops, double bytes,
+                   const options &o = default_options());
+
+        /**
+         * @param times - the times (ms) of the runs of an operation.
+         * @return - the statistics on the times (without name, shape and rates).
+         */
+        result compute_statistics(std::vector<double> times);
+
+        /**
+         * Print a result on a line (median, percentiles, rates).
+         */
+        void print(const result &r);
+
+        /**
+         * Write the results in a JSON file, with the context of the measures
+         * (backend, number of threads, date, and a label naming the run).
+         * @param results - the results to be written.
+         * @param label - a name to compare the runs (e.g. a commit).
+         * @param path - the path of the JSON file.
+         */
+        void write_json(const std::vector<result> &results,
+                        const std::string &label, const std::string &path);
+    }
+}
+
+
+#endif //CUDANN_BENCHMARK_H
@@ -0,0 +1,338 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "distributed.h"
+#include "lib/util/util.h"
+#include "lib/util/profiler/profiler.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+
+using namespace cudaNN;
+
+
+namespace
+{
+    void socket_error(const std::string &location, const std::string &message)
+    {
+        util::ERROR(location, message + " (" + std::string(std::strerror(errno)) + ")");
+        util::ERROR_EXIT();
+    }
+
+    sockaddr_in get_address(const std::string &host, int port)
+    {
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons((uint16_t) port);
+
+        if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1)
+        {
+            util::ERROR("distributed::communicator", "Invalid host " + host);
+            util::ERROR_EXIT();
+        }
+
+        return address;
+    }
+
+    /**
+     * Small messages are sent at once, and the socket does not
+     * block the ring exchanges (see "_exchange").
+     */
+    void configure(int s)
+    {
+        int one = 1;
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+    }
+
+    /**
+     * @return - the range of the segment n°i of a buffer of "length"
+     * floats split between "n" processes.
+     */
+    std::pair<size_t, size_t> get_segment(size_t i, size_t n, size_t length)
+    {
+        return { i * length / n, (i + 1) * length / n };
+    }
+}
+
+
+distributed::communicator::communicator(size_t rank, size_t nb_processes,
+                                        int port /*= DISTRIBUTED_PORT*/,
+                                        const std::string &host /*= DISTRIBUTED_HOST*/):
+        _rank(rank),
+        _nb_processes(nb_processes)
+{
+    if (nb_processes == 0 || rank >= nb_processes)
+    {
+        // Invalid.
+        util::ERROR("distributed::communicator::communicator",
+                    "Invalid rank " + std::to_string(rank)
+                    + " for " + std::to_string(nb_processes) + " processes");
+        util::ERROR_EXIT();
+    }
+
+    if (nb_processes > 1)
+    {
+        // Listen for the previous process, connect to the next one, then accept:
+        // the connection succeeds as soon as the next process is listening.
+        auto listener = socket(AF_INET, SOCK_STREAM, 0);
+        auto address = get_address(host, port + (int) rank);
+        int one = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        if (listener < 0 || bind(listener, (sockaddr *) &address, sizeof(address)) < 0
+            || listen(listener, 1) < 0)
+        {
+            socket_error("distributed::communicator::communicator",
+                         "Unable to listen on port " + std::to_string(port + rank));
+        }
+
+        auto next = get_address(host, port + (int) ((rank + 1) % nb_processes));
+        auto start = std::chrono::steady_clock::now();
+
+        while (true)
+        {
+            _next = socket(AF_INET, SOCK_STREAM, 0);
+
+            if (connect(_next, (sockaddr *) &next, sizeof(next)) == 0)
+            {
+                break;
+            }
+
+            close(_next);
+
+            if (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()
+                > DISTRIBUTED_TIMEOUT)
+            {
+                socket_error("distributed::communicator::communicator",
+                             "Unable to connect to the process "
+                             + std::to_string((rank + 1) % nb_processes));
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        _previous = accept(listener, nullptr, nullptr);
+        close(listener);
+
+        if (_previous < 0)
+        {
+            socket_error("distributed::communicator::communicator",
+                         "Unable to accept the previous process");
+        }
+
+        configure(_next);
+        configure(_previous);
+    }
+
+    _worker = std::thread(&communicator::_run, this);
+}
+
+distributed::communicator::~communicator()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+
+    // The pending requests are completed before the end of the worker.
+    _wake.notify_one();
+    _worker.join();
+
+    if (_next >= 0)
+    {
+        close(_next);
+        close(_previous);
+    }
+}
+
+void distributed::communicator::all_reduce(float *data, size_t length)
+{
+    // Through the worker, to keep the order of the requests.
+    wait(all_reduce_async(data, length));
+}
+
+size_t distributed::communicator::all_reduce_async(float *data, size_t length)
+{
+    size_t id;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _requests.push_back({ data, length });
+        id = _nb_submitted ++;
+    }
+
+    _wake.notify_one();
+
+    return id;
+}
+
+void distributed::communicator::wait(size_t id)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _completed.wait(lock, [&]() { return _nb_completed > id; });
+}
+
+void distributed::communicator::wait_all()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _completed.wait(lock, [&]() { return _nb_completed == _nb_submitted; });
+}
+
+void distributed::communicator::broadcast(float *data, size_t length, size_t root /*= 0*/)
+{
+    // Sum with zeros: exact.
+    if (_rank != root)
+    {
+        std::fill(data, data + length, 0.f);
+    }
+
+    all_reduce(data, length);
+}
+
+size_t distributed::communicator::get_rank() const
+{
+    return _rank;
+}
+
+size_t distributed::communicator::get_nb_processes() const
+{
+    return _nb_processes;
+}
+
+void distributed::communicator::_run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (true)
+    {
+        _wake.wait(lock, [&]() { return _stop || ! _requests.empty(); });
+
+        if (_requests.empty())
+        {
+            // Stopped.
+            return;
+        }
+
+        auto r = _requests.front();
+        _requests.pop_front();
+        lock.unlock();
+        _all_reduce(r.data, r.length);
+        lock.lock();
+        _nb_completed ++;
+        _completed.notify_all();
+    }
+}
+
+void distributed::communicator::_all_reduce(float *data, size_t length)
+{
+    PROFILE_SCOPE("distributed", "all_reduce", length);
+    auto n = _nb_processes;
+
+    if (n == 1)
+    {
+        return;
+    }
+
+    _buffer.resize(length / n + 1);
+
+    // Reduce-scatter: at the step s, each process adds the segment n°(rank - s - 1)
+    // of the previous one to its own. At the end, the process holds the sum
+    // of the segment n°(rank + 1).
+    for (size_t s = 0; s + 1 < n; s ++)
+    {
+        auto send = get_segment((_rank + n - s) % n, n, length);
+        auto receive = get_segment((_rank + 2 * n - s - 1) % n, n, length);
+        _exchange((const char *) (data + send.first), (send.second - send.first) * sizeof(float),
+                  (char *) _buffer.data(), (receive.second - receive.first) * sizeof(float));
+
+        for (size_t i = receive.first; i < receive.second; i ++)
+        {
+            data[i] += _buffer[i - receive.first];
+        }
+    }
+
+    // All-gather: the summed segments go around the ring.
+    for (size_t s = 0; s + 1 < n; s ++)
+    {
+        auto send = get_segment((_rank + n - s + 1) % n, n, length);
+        auto receive = get_segment((_rank + n - s) % n, n, length);
+        _exchange((const char *) (data + send.first), (send.second - send.first) * sizeof(float),
+                  (char *) (data + receive.first), (receive.second - receive.first) * sizeof(float));
+    }
+}
+
+void distributed::communicator::_exchange(const char *send_data, size_t send_length,
+                                          char *receive_data, size_t receive_length)
+{
+    while (send_length > 0 || receive_length > 0)
+    {
+        pollfd fds[2];
+        nfds_t nb_fds = 0;
+
+        if (send_length > 0)
+        {
+            fds[nb_fds ++] = { _next, POLLOUT, 0 };
+        }
+
+        if (receive_length > 0)
+        {
+            fds[nb_fds ++] = { _previous, POLLIN, 0 };
+        }
+
+        if (poll(fds, nb_fds, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            socket_error("distributed::communicator::_exchange", "Poll failed");
+        }
+
+        for (nfds_t i = 0; i < nb_fds; i ++)
+        {
+            if (fds[i].revents == 0)
+            {
+                continue;
+            }
+
+            if (fds[i].fd == _next)
+            {
+                auto n = send(_next, send_data, send_length, MSG_NOSIGNAL);
+
+                if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                {
+                    socket_error("distributed::communicator::_exchange", "Unable to send");
+                }
+
+                send_data += std::max((ssize_t) 0, n);
+                send_length -= (size_t) std::max((ssize_t) 0, n);
+            }
+            else
+            {
+                auto n = recv(_previous, receive_data, receive_length, 0);
+
+                if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+                {
+                    socket_error("distributed::communicator::_exchange",
+                                 "Unable to receive (previous process stopped?)");
+                }
+
+                receive_data += std::max((ssize_t) 0, n);
+                receive_length -= (size_t) std::max((ssize_t) 0, n);
+            }
+        }
+    }
+}
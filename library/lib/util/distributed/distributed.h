@@ -0,0 +1,144 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#ifndef CUDANN_DISTRIBUTED_H
+#define CUDANN_DISTRIBUTED_H
+
+#include "lib/global.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/**
+ * Default host and first port of the processes: the process n°i
+ * listens on "DISTRIBUTED_PORT + i".
+ */
+#define DISTRIBUTED_HOST "127.0.0.1"
+#define DISTRIBUTED_PORT 47000
+
+/**
+ * Maximal time (s) to wait for the other processes at the connection.
+ */
+#define DISTRIBUTED_TIMEOUT 30.
+
+
+namespace cudaNN
+{
+    /**
+     * Communication between the processes of a distributed training.
+     */
+    namespace distributed
+    {
+        /**
+         * Member of a ring of processes (over TCP sockets), summing buffers
+         * of floats between them (ring all-reduce: each process sends and
+         * receives "2 * (n - 1) / n" times the buffer, whatever the number
+         * "n" of processes).
+         * The all-reduces can be started in background, and are executed
+         * in the order of their submission: every process has to submit
+         * the same all-reduces, in the same order.
+         */
+        class communicator
+        {
+            public:
+
+                /**
+                 * Connect to the previous and next processes of the ring
+                 * (blocks until they are started, or exits after a timeout).
+                 * @param rank - the index of this process, in [0, "nb_processes"[.
+                 * @param nb_processes - the number of processes of the ring.
+                 * @param port - the port of the process 0 (see -DISTRIBUTED_PORT-).
+                 * @param host - the address of every process.
+                 */
+                communicator(size_t rank, size_t nb_processes,
+                             int port = DISTRIBUTED_PORT,
+                             const std::string &host = DISTRIBUTED_HOST);
+                ~communicator();
+
+                communicator(const communicator &) = delete;
+                communicator &operator=(const communicator &) = delete;
+
+                /**
+                 * Replace "data" by its sum over the processes (blocking).
+                 * @param data - the buffer of this process.
+                 * @param length - the number of floats (same for every process).
+                 */
+                void all_reduce(float *data, size_t length);
+
+                /**
+                 * Start the all-reduce of "data" in background. The buffer
+                 * must not be used until the corresponding "wait".
+                 * @return - the id of the request.
+                 */
+                size_t all_reduce_async(float *data, size_t length);
+
+                /**
+                 * Wait until the request "id" (and the previous ones) is completed.
+                 */
+                void wait(size_t id);
+                void wait_all();
+
+                /**
+                 * Replace "data" by the one of the process "root" (blocking).
+                 */
+                void broadcast(float *data, size_t length, size_t root = 0);
+
+                size_t get_rank() const;
+                size_t get_nb_processes() const;
+
+            private:
+
+                struct request
+                {
+                    float *data;
+                    size_t length;
+                };
+
+                void _run();
+                void _all_reduce(float *data, size_t length);
+
+                /**
+                 * Send "send_length" bytes to the next process while receiving
+                 * "receive_length" bytes from the previous one (both at the
+                 * same time, to avoid an interlocking of the ring).
+                 */
+                void _exchange(const char *send_data, size_t send_length,
+                               char *receive_data, size_t receive_length);
+
+                const size_t _rank;
+                const size_t _nb_processes;
+
+                /**
+                 * @_next, @_previous - the sockets connected to the neighbours
+                 * in the ring (-1 if alone).
+                 */
+                int _next = -1;
+                int _previous = -1;
+
+                /**
+                 * @_requests - the all-reduces not started yet.
+                 * @_nb_submitted, @_nb_completed - the numbers of requests.
+                 * @_buffer - the segments received.
+                 */
+                std::thread _worker;
+                std::mutex _mutex;
+                std::condition_variable _wake;
+                std::condition_variable _completed;
+                std::deque<request> _requests;
+                size_t _nb_submitted = 0;
+                size_t _nb_completed = 0;
+                bool _stop = false;
+                std::vector<float> _buffer;
+        };
+    }
+}
+
+
+#endif //CUDANN_DISTRIBUTED_H
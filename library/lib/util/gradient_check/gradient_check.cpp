@@ -0,0 +1,207 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "gradient_check.h"
+#include "lib/functions/loss_functions/loss_functions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+
+using namespace cudaNN;
+
+
+namespace
+{
+    /**
+     * The cross entropy losses give the loss of the whole entry in
+     * each element; the other ones, the loss of each output.
+     */
+    bool is_element_wise(const function &loss_function)
+    {
+        return loss_function.get_id() != loss_functions::CROSS_ENTROPY_LOSS.get_id()
+               && loss_function.get_id() != loss_functions::SOFTMAX_CROSS_ENTROPY_LOSS.get_id();
+    }
+
+    double relative_difference(double a, double b)
+    {
+        return std::abs(a - b) / std::max({ std::abs(a), std::abs(b), (double) GRADIENT_CHECK_FLOOR });
+    }
+
+    /**
+     * Loss for the parameter "values[i]" perturbed by "k * epsilon / 2",
+     * for k in [-2, 2] (the value is restored).
+     * @steps - the perturbations actually applied (rounded to float).
+     */
+    struct perturbations
+    {
+        double losses[5];
+        double steps[5];
+    };
+
+    perturbations perturb(neural_network &nn, dataset &batch, const function &loss_function,
+                          matrix &values, size_t i, double epsilon)
+    {
+        auto value = values[i];
+        auto p = perturbations();
+
+        for (int k = -2; k <= 2; k ++)
+        {
+            values[i] = value + (float) (k * epsilon / 2.);
+            p.steps[k + 2] = (double) values[i] - (double) value;
+            // From the first entries of the step (e.g. the dropout masks of the
+            // gradients, see -dropout.h/set_training-).
+            nn.set_training(true);
+            p.losses[k + 2] = gradient_check::get_loss(nn, batch, loss_function);
+        }
+
+        values[i] = value;
+
+        return p;
+    }
+
+    /**
+     * Check the parameters of "values" (of the layer n°"l"), with their
+     * analytic "gradients" (same dimensions).
+     */
+    void check_parameters(neural_network &nn, dataset &batch, const function &loss_function,
+                          matrix &values, const matrix &gradients, size_t l, size_t parameter,
+                          double epsilon, double tolerance, size_t max_parameters,
+                          gradient_check::report &r)
+    {
+        auto length = values.get_length();
+        auto stride = max_parameters == 0 || max_parameters >= length ? 1 : length / max_parameters;
+
+        for (size_t i = 0; i < length; i += stride)
+        {
+            auto p = perturb(nn, batch, loss_function, values, i, epsilon);
+            auto &losses = p.losses;
+            // Central differences of steps "epsilon" and "epsilon / 2".
+            auto numerical = (losses[4] - losses[0]) / (p.steps[4] - p.steps[0]);
+            auto half = (losses[3] - losses[1]) / (p.steps[3] - p.steps[1]);
+            // Differences between the forward and backward differences: proportional
+            // to the step if the loss is smooth, constant if it has a kink at p.
+            auto jump = (losses[4] - 2. * losses[2] + losses[0]) / epsilon;
+            auto half_jump = (losses[3] - 2. * losses[2] + losses[1]) / (epsilon / 2.);
+
+            // (At a quarter of the tolerance: the kinks close to the ends of the steps,
+            // or several kinks, are only partially measured, but can still exceed it.)
+            if (relative_difference(numerical, half) > tolerance / 4.
+                || std::abs(jump - 2. * half_jump) > tolerance / 4. * std::max({ std::abs(numerical),
+                                                                                 std::abs(half),
+                                                                                 (double) GRADIENT_CHECK_FLOOR }))
+            {
+                // Non-differentiable point close to p (e.g. a ReLU input, or an
+                // absolute error, crossing 0): no reliable numerical gradient.
+                r.nb_skipped ++;
+                continue;
+            }
+
+            auto analytic = (double) gradients[i];
+            auto relative_error = relative_difference(analytic, numerical);
+
+            r.nb_checks ++;
+            r.nb_failures += relative_error > tolerance ? 1 : 0;
+            r.max_errors[l] = std::max(r.max_errors[l], relative_error);
+
+            if (r.nb_checks == 1 || relative_error > r.worst.relative_error)
+            {
+                r.worst = { l, parameter, i, analytic, numerical, relative_error };
+            }
+        }
+    }
+}
+
+
+gradient_check::report gradient_check::check(neural_network &nn, dataset &batch,
+                                             const function &loss_function,
+                                             double epsilon /*= GRADIENT_CHECK_EPSILON*/,
+                                             double tolerance /*= GRADIENT_CHECK_TOLERANCE*/,
+                                             size_t max_parameters /*= 0*/)
+{
+    // The gradients are computed as during a training (e.g. batch statistics).
+    auto training = nn.is_training();
+    nn.set_training(true);
+    auto gradients = nn.compute_gradients(batch, loss_function);
+    auto r = check(nn, batch, loss_function, gradients, epsilon, tolerance, max_parameters);
+    nn.set_training(training);
+
+    return r;
+}
+
+gradient_check::report gradient_check::check(neural_network &nn, dataset &batch,
+                                             const function &loss_function,
+                                             const std::vector<std::vector<matrix>> &gradients,
+                                             double epsilon /*= GRADIENT_CHECK_EPSILON*/,
+                                             double tolerance /*= GRADIENT_CHECK_TOLERANCE*/,
+                                             size_t max_parameters /*= 0*/)
+{
+    // The losses are computed as the gradients.
+    auto training = nn.is_training();
+    nn.set_training(true);
+    auto r = report();
+    r.max_errors = std::vector<double>(nn.get_nb_layers(), 0.);
+
+    for (size_t l = 0; l < nn.get_nb_layers(); l ++)
+    {
+        auto parameters = nn.get_layer((int) l)->get_parameters();
+
+        for (size_t p = 0; p < parameters.size(); p ++)
+        {
+            check_parameters(nn, batch, loss_function, *parameters[p], gradients[l][p],
+                             l, p, epsilon, tolerance, max_parameters, r);
+        }
+    }
+
+    nn.set_training(training);
+
+    return r;
+}
+
+double gradient_check::get_loss(const neural_network &nn, dataset &batch, const function &loss_function)
+{
+    double loss = 0.;
+    // The entries depending on each other are predicted together (a row each).
+    auto stacked = nn.is_training() && nn.depends_on_batch();
+
+    for (size_t k = 0; k < (stacked ? 1 : batch.size()); k ++)
+    {
+        auto rows = stacked ? batch.stack(0, batch.size())
+                            : std::make_pair(batch.get(k).get_features(), batch.get(k).get_labels());
+        auto predictions = nn.predict(rows.first);
+        auto losses = loss_function.compute({ &predictions, &rows.second });
+        auto nb_cols = losses.get_dimensions().second;
+
+        for (size_t i = 0; i < losses.get_length(); i ++)
+        {
+            // The loss of the whole row in each element otherwise.
+            if (is_element_wise(loss_function) || i % nb_cols == 0)
+            {
+                loss += (double) losses[(int) i];
+            }
+        }
+    }
+
+    return loss;
+}
+
+void gradient_check::print(const report &r)
+{
+    std::cout << std::scientific << std::setprecision(2);
+
+    for (size_t l = 0; l < r.max_errors.size(); l ++)
+    {
+        std::cout << "layer " << l << ": max relative error " << r.max_errors[l] << std::endl;
+    }
+
+    std::cout << "worst: layer " << r.worst.layer << " parameter " << r.worst.parameter
+              << "[" << r.worst.index << "]" << " (analytic " << r.worst.analytic
+              << ", numerical " << r.worst.numerical << ", relative error "
+              << r.worst.relative_error << ")" << std::endl
+              << r.nb_checks - r.nb_failures << "/" << r.nb_checks << " parameters checked ("
+              << r.nb_skipped << " skipped)"
+              << std::defaultfloat << std::endl;
+}
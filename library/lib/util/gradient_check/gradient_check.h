@@ -0,0 +1,117 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#ifndef CUDANN_GRADIENT_CHECK_H
+#define CUDANN_GRADIENT_CHECK_H
+
+#include "lib/data_structures/dataset/dataset.h"
+#include "lib/functions/function.h"
+#include "lib/models/neural_network/neural_network.h"
+
+#include <cstddef>
+#include <vector>
+
+
+/**
+ * Default perturbation of the parameters, and tolerated relative
+ * error between the analytic and numerical gradients.
+ * The relative errors are computed on at least -GRADIENT_CHECK_FLOOR-
+ * (to ignore the rounding errors of the gradients close to 0).
+ */
+#define GRADIENT_CHECK_EPSILON 1e-2
+#define GRADIENT_CHECK_TOLERANCE 4e-2
+#define GRADIENT_CHECK_FLOOR 1e-2
+
+
+namespace cudaNN
+{
+    /**
+     * Validation of the backpropagation with finite differences: each parameter
+     * of the layers is perturbed, and the variation of the loss compared with the
+     * gradient computed by the network.
+     */
+    namespace gradient_check
+    {
+        /**
+         * A checked parameter.
+         * @layer - the index of its layer.
+         * @parameter - the index of its matrix in the parameters of the layer
+         * (see "base_layer::get_parameters", e.g. 0 for the weights, 1 for the biases).
+         * @index - its index in this matrix (row major).
+         * @analytic, @numerical - the gradients of the loss for it.
+         * @relative_error - "|analytic - numerical| / max(|analytic|, |numerical|, floor)".
+         */
+        struct error
+        {
+            size_t layer;
+            size_t parameter;
+            size_t index;
+            double analytic;
+            double numerical;
+            double relative_error;
+        };
+
+        /**
+         * Results of a check.
+         * @nb_skipped - the parameters at a non-differentiable point of the loss.
+         * @max_errors - the largest relative error of each layer.
+         * @worst - the parameter with the largest relative error.
+         */
+        struct report
+        {
+            size_t nb_checks;
+            size_t nb_failures;
+            size_t nb_skipped;
+            std::vector<double> max_errors;
+            error worst;
+        };
+
+        /**
+         * Compare the gradients of the loss on "batch" (sum over its entries)
+         * computed by the backpropagation of "nn" with central differences:
+         * "(loss(p + epsilon) - loss(p - epsilon)) / (2 * epsilon)", for each
+         * parameter "p". The parameters are restored afterwards.
+         * The parameters at a non-differentiable point (e.g. a ReLU input
+         * close to 0) are skipped: those whose finite differences of steps
+         * "epsilon" and "epsilon / 2" differ by more than a quarter of the "tolerance"
+         * (a wrong backpropagation does not change them, only the loss is
+         * computed).
+         * @param max_parameters - the maximal number of values checked per matrix
+         * of parameters, evenly spaced (0 for all).
+         * @return - the errors, and the number of parameters whose relative
+         * error is above "tolerance".
+         */
+        report check(neural_network &nn, dataset &batch, const function &loss_function,
+                     double epsilon = GRADIENT_CHECK_EPSILON,
+                     double tolerance = GRADIENT_CHECK_TOLERANCE,
+                     size_t max_parameters = 0);
+
+        /**
+         * Same, with the given analytic "gradients" instead of the ones of the
+         * backpropagation (e.g. altered, to check that they are rejected).
+         * @param gradients - a matrix per parameter of each layer (see
+         * "neural_network::compute_gradients").
+         */
+        report check(neural_network &nn, dataset &batch, const function &loss_function,
+                     const std::vector<std::vector<matrix>> &gradients,
+                     double epsilon = GRADIENT_CHECK_EPSILON,
+                     double tolerance = GRADIENT_CHECK_TOLERANCE,
+                     size_t max_parameters = 0);
+
+        /**
+         * @return - the loss of "nn" on "batch": the sum over the entries (and
+         * over the outputs, for the element-wise losses). In training mode, the
+         * entries depending on each other are predicted together.
+         */
+        double get_loss(const neural_network &nn, dataset &batch, const function &loss_function);
+
+        /**
+         * Print the given report (largest errors of each layer).
+         */
+        void print(const report &r);
+    }
+}
+
+
+#endif //CUDANN_GRADIENT_CHECK_H
@@ -0,0 +1,163 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "metrics.h"
+#include "lib/util/util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <limits>
+
+
+using namespace cudaNN;
+
+
+metrics::logger::logger(const std::string &path, std::vector<std::string> columns,
+                        size_t flush_size /*= METRICS_FLUSH_SIZE*/,
+                        double flush_period /*= METRICS_FLUSH_PERIOD*/):
+        _columns(std::move(columns)),
+        _flush_size(std::max((size_t) 1, flush_size)),
+        _flush_period(flush_period),
+        _file(path)
+{
+    if (!_file || _columns.empty())
+    {
+        util::ERROR("metrics::logger::logger", "Unable to open " + path + " (or no column)");
+        util::ERROR_EXIT();
+    }
+
+    for (size_t i = 0; i < _columns.size(); i ++)
+    {
+        _file << (i == 0 ? "" : std::string(1, METRICS_SEPARATOR)) << _columns[i];
+    }
+
+    _file << '\n' << std::setprecision(std::numeric_limits<float>::max_digits10);
+    _buffer.reserve(_flush_size * _columns.size());
+    _writer = std::thread(&logger::_write, this);
+}
+
+metrics::logger::~logger()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+
+    // The remaining rows are written before the end of the writer.
+    _wake.notify_one();
+    _writer.join();
+}
+
+void metrics::logger::log(std::initializer_list<double> values)
+{
+    log(std::vector<double>(values));
+}
+
+void metrics::logger::log(const std::vector<double> &values)
+{
+    if (values.size() != _columns.size())
+    {
+        // Invalid.
+        util::ERROR("metrics::logger::log",
+                    "Invalid number of values (" + std::to_string(values.size())
+                    + " instead of " + std::to_string(_columns.size()) + ")");
+        util::ERROR_EXIT();
+    }
+
+    bool wake;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _buffer.insert(_buffer.end(), values.begin(), values.end());
+        _nb_logged ++;
+        wake = _nb_logged - _nb_written >= _flush_size;
+    }
+
+    if (wake)
+    {
+        _wake.notify_one();
+    }
+}
+
+void metrics::logger::flush()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto nb_logged = _nb_logged;
+    _flush = true;
+    _wake.notify_one();
+    _written.wait(lock, [&] { return _nb_written >= nb_logged; });
+}
+
+void metrics::logger::_write()
+{
+    auto period = std::chrono::duration<double>(_flush_period);
+    auto rows = std::vector<double>();
+    rows.reserve(_buffer.capacity());
+
+    while (true)
+    {
+        bool stop;
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait_for(lock, period, [this]
+            {
+                return _stop || _flush || _nb_logged - _nb_written >= _flush_size;
+            });
+            // Take the buffered rows; the logging goes on in the other buffer.
+            std::swap(rows, _buffer);
+            _flush = false;
+            stop = _stop;
+        }
+
+        for (size_t i = 0; i < rows.size(); i ++)
+        {
+            _file << rows[i] << ((i + 1) % _columns.size() == 0 ? '\n' : METRICS_SEPARATOR);
+        }
+
+        _file.flush();
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _nb_written += rows.size() / _columns.size();
+        }
+
+        rows.clear();
+        _written.notify_all();
+
+        if (stop)
+        {
+            return;
+        }
+    }
+}
+
+void metrics::running_mean::add(double value)
+{
+    _sum += value;
+    _count ++;
+}
+
+void metrics::running_mean::merge(const running_mean &m)
+{
+    _sum += m._sum;
+    _count += m._count;
+}
+
+void metrics::running_mean::reset()
+{
+    _sum = 0.;
+    _count = 0;
+}
+
+double metrics::running_mean::get() const
+{
+    return _count == 0 ? 0. : _sum / (double) _count;
+}
+
+size_t metrics::running_mean::get_count() const
+{
+    return _count;
+}
@@ -0,0 +1,131 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#ifndef CUDANN_METRICS_H
+#define CUDANN_METRICS_H
+
+#include "lib/global.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/**
+ * Default number of rows buffered before waking the writer,
+ * and maximal time (s) between two writes.
+ */
+#define METRICS_FLUSH_SIZE 1024
+#define METRICS_FLUSH_PERIOD 1.
+
+/**
+ * Separator of the columns of the csv files.
+ */
+#define METRICS_SEPARATOR ';'
+
+
+namespace cudaNN
+{
+    /**
+     * Logging of the metrics of a training (e.g. the loss, the throughput).
+     */
+    namespace metrics
+    {
+        /**
+         * Csv file of metrics (a row per record), written by a background
+         * thread: logging a row only appends its values to a buffer.
+         * The file is kept open, and completed at the destruction.
+         */
+        class logger
+        {
+            public:
+
+                /**
+                 * @param path - the path of the csv file (overwritten).
+                 * @param columns - the names of the metrics (the header).
+                 * @param flush_size - the number of rows buffered before a write.
+                 * @param flush_period - the maximal time (s) between two writes.
+                 */
+                logger(const std::string &path, std::vector<std::string> columns,
+                       size_t flush_size = METRICS_FLUSH_SIZE,
+                       double flush_period = METRICS_FLUSH_PERIOD);
+                ~logger();
+
+                logger(const logger &) = delete;
+                logger &operator=(const logger &) = delete;
+
+                /**
+                 * Add a row.
+                 * @param values - a value per column.
+                 */
+                void log(std::initializer_list<double> values);
+                void log(const std::vector<double> &values);
+
+                /**
+                 * Wait until the logged rows are written in the file.
+                 */
+                void flush();
+
+            private:
+
+                void _write();
+
+                const std::vector<std::string> _columns;
+                const size_t _flush_size;
+                const double _flush_period;
+                std::ofstream _file;
+                std::thread _writer;
+                std::mutex _mutex;
+                std::condition_variable _wake;
+                std::condition_variable _written;
+
+                /**
+                 * @_buffer - the values of the rows not written yet.
+                 * @_nb_logged, @_nb_written - the numbers of rows.
+                 * @_flush - set to wake the writer whatever the buffer size.
+                 */
+                std::vector<double> _buffer;
+                size_t _nb_logged = 0;
+                size_t _nb_written = 0;
+                bool _flush = false;
+                bool _stop = false;
+        };
+
+        /**
+         * Mean of the values added since the last reset (e.g. the loss
+         * of each entry between two records).
+         */
+        class running_mean
+        {
+            public:
+
+                void add(double value);
+
+                /**
+                 * Add the values of "m" (e.g. computed by another thread).
+                 */
+                void merge(const running_mean &m);
+                void reset();
+
+                /**
+                 * @return - the mean of the added values (0 if none).
+                 */
+                double get() const;
+                size_t get_count() const;
+
+            private:
+
+                double _sum = 0.;
+                size_t _count = 0;
+        };
+    }
+}
+
+
+#endif //CUDANN_METRICS_H
@@ -0,0 +1,267 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "parallel.h"
+#include "lib/util/profiler/profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace cudaNN;
+
+
+namespace
+{
+    /**
+     * Fixed set of worker threads waiting for chunks of work.
+     */
+    class pool
+    {
+        public:
+
+            explicit pool(size_t nb_threads);
+            ~pool();
+
+            /**
+             * Process the chunks [0, "nb_chunks"[ with the workers
+             * and the calling thread.
+             */
+            void run(size_t nb_chunks, const std::function<void(size_t)> &f);
+
+        private:
+
+            void _work();
+            void _process();
+
+            std::vector<std::thread> _workers;
+            std::mutex _mutex;
+            std::mutex _run_mutex;
+            std::condition_variable _start;
+            std::condition_variable _done;
+
+            /**
+             * Current task.
+             * @_task - the function to be applied on each chunk.
+             * @_nb_chunks - the number of chunks of the task.
+             * @_next - the next chunk to be processed.
+             * @_nb_busy - the number of workers still processing the task.
+             * @_generation - incremented for each new task.
+             */
+            const std::function<void(size_t)> *_task = nullptr;
+            size_t _nb_chunks = 0;
+            std::atomic<size_t> _next;
+            size_t _nb_busy = 0;
+            size_t _generation = 0;
+            bool _stop = false;
+    };
+
+    thread_local bool is_worker = false;
+
+    std::mutex instance_mutex;
+    /**
+     * Shared with the computations in progress: a pool replaced by
+     * "set_nb_threads" is destroyed once they end.
+     */
+    std::shared_ptr<pool> instance;
+    std::atomic<size_t> nb_threads(_NB_THREADS);
+    bool deterministic = _DETERMINISTIC;
+
+
+    pool::pool(size_t nb_threads):
+            _next(0)
+    {
+        // The calling thread is also used for the computations.
+        for (size_t i = 1; i < nb_threads; i ++)
+        {
+            _workers.emplace_back(&pool::_work, this);
+        }
+    }
+
+    pool::~pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+
+        _start.notify_all();
+
+        for (auto &w: _workers)
+        {
+            w.join();
+        }
+    }
+
+    void pool::run(size_t nb_chunks, const std::function<void(size_t)> &f)
+    {
+        if (is_worker || _workers.empty() || nb_chunks < 2 || ! _run_mutex.try_lock())
+        {
+            // Nested call, or pool already used by another thread.
+            for (size_t i = 0; i < nb_chunks; i ++)
+            {
+                f(i);
+            }
+
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _task = &f;
+            _nb_chunks = nb_chunks;
+            _next = 0;
+            _nb_busy = _workers.size();
+            _generation ++;
+        }
+
+        _start.notify_all();
+        // Help the workers.
+        is_worker = true;
+        _process();
+        is_worker = false;
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _done.wait(lock, [this] { return _nb_busy == 0; });
+            _task = nullptr;
+        }
+
+        _run_mutex.unlock();
+    }
+
+    void pool::_work()
+    {
+        is_worker = true;
+        size_t generation = 0;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _start.wait(lock, [&] { return _stop || _generation != generation; });
+
+                if (_stop)
+                {
+                    return;
+                }
+
+                generation = _generation;
+            }
+
+            _process();
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+
+                if (-- _nb_busy == 0)
+                {
+                    _done.notify_one();
+                }
+            }
+        }
+    }
+
+    void pool::_process()
+    {
+        size_t i;
+
+        while ((i = _next ++) < _nb_chunks)
+        {
+            // The work of each thread (under the operation of the caller).
+            PROFILE_SCOPE("parallel", "chunk");
+            (*_task)(i);
+        }
+    }
+
+    std::shared_ptr<pool> get_instance()
+    {
+        std::lock_guard<std::mutex> lock(instance_mutex);
+
+        if (instance == nullptr)
+        {
+            instance = std::make_shared<pool>(parallel::get_nb_threads());
+        }
+
+        return instance;
+    }
+}
+
+
+size_t parallel::get_nb_threads()
+{
+    size_t n = nb_threads;
+
+    if (n == 0)
+    {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    return n;
+}
+
+void parallel::set_nb_threads(size_t nb_threads_)
+{
+    std::shared_ptr<pool> previous;
+
+    {
+        std::lock_guard<std::mutex> lock(instance_mutex);
+        nb_threads = nb_threads_;
+        // Restarted with the new number of threads on next use.
+        previous.swap(instance);
+    }
+
+    // The previous pool is stopped here, or by the last computation
+    // still running on it (when it ends).
+}
+
+bool parallel::is_deterministic()
+{
+    return deterministic;
+}
+
+void parallel::set_deterministic(bool deterministic_)
+{
+    deterministic = deterministic_;
+}
+
+size_t parallel::get_nb_chunks(size_t length, size_t min_chunk_size)
+{
+    size_t nb_chunks = length / std::max((size_t) 1, min_chunk_size);
+
+    return std::max((size_t) 1, std::min(get_nb_threads(), nb_chunks));
+}
+
+void parallel::for_each_chunk(size_t nb_chunks, const std::function<void(size_t)> &f)
+{
+    // The pool is kept until the end of the task.
+    get_instance()->run(nb_chunks, f);
+}
+
+void parallel::for_range(size_t length, size_t min_chunk_size,
+                         const std::function<void(size_t, size_t)> &f)
+{
+    if (length == 0)
+    {
+        return;
+    }
+
+    size_t nb_chunks = get_nb_chunks(length, min_chunk_size);
+    size_t chunk_size = (length + nb_chunks - 1) / nb_chunks;
+
+    for_each_chunk(nb_chunks, [&](size_t i)
+    {
+        size_t begin = i * chunk_size;
+        size_t end = std::min(length, begin + chunk_size);
+
+        if (begin < end)
+        {
+            f(begin, end);
+        }
+    });
+}
\ No newline at end of file
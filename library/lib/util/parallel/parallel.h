@@ -0,0 +1,81 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#ifndef CUDANN_PARALLEL_H
+#define CUDANN_PARALLEL_H
+
+#include "lib/global.h"
+
+#include <cstddef>
+#include <functional>
+
+
+/**
+ * Minimal number of values processed by a thread
+ * (smaller inputs are not worth splitting).
+ */
+#define PARALLEL_MIN_CHUNK_SIZE 16384
+
+
+namespace cudaNN
+{
+    /**
+     * Multithreading of the computations on host. A pool of
+     * worker threads is started on first use, and the calling
+     * thread takes part in the work.
+     * Calls made from a worker (nested parallelism) are run on
+     * the calling thread.
+     */
+    namespace parallel
+    {
+        /**
+         * @return - the number of threads used for the computations.
+         */
+        size_t get_nb_threads();
+
+        /**
+         * Can be called during a computation (e.g. from another thread):
+         * the computations in progress end on the previous threads,
+         * which are stopped once they are idle.
+         * @param nb_threads - the number of threads to be used for the
+         * computations (0 to use every hardware thread).
+         */
+        void set_nb_threads(size_t nb_threads);
+
+        /**
+         * @return - true if the reductions are done in a fixed order
+         * (independent of the number of threads).
+         */
+        bool is_deterministic();
+        void set_deterministic(bool deterministic);
+
+        /**
+         * @param length - the number of elements to be processed.
+         * @param min_chunk_size - the minimal number of elements in a chunk.
+         * @return - the number of chunks to split "length" elements into,
+         * such that every thread has work and no chunk is too small.
+         */
+        size_t get_nb_chunks(size_t length, size_t min_chunk_size);
+
+        /**
+         * Execute "f(i)" for each "i" in [0, "nb_chunks"[, over the threads.
+         * Returns when every chunk has been processed.
+         * @param nb_chunks - the number of independent chunks of work.
+         * @param f - the function processing the chunk n°i.
+         */
+        void for_each_chunk(size_t nb_chunks, const std::function<void(size_t)> &f);
+
+        /**
+         * Execute "f(begin, end)" over sub-ranges of [0, "length"[.
+         * @param length - the number of elements to be processed.
+         * @param min_chunk_size - the minimal number of elements in a sub-range.
+         * @param f - the function processing the range [begin, end[.
+         */
+        void for_range(size_t length, size_t min_chunk_size,
+                       const std::function<void(size_t, size_t)> &f);
+    }
+}
+
+
+#endif //CUDANN_PARALLEL_H
\ No newline at end of file
@@ -0,0 +1,247 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "profiler.h"
+#include "lib/util/util.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILER_USE_TSC true
+#else
+#define PROFILER_USE_TSC false
+#endif
+
+
+using namespace cudaNN;
+
+
+namespace
+{
+    typedef std::chrono::steady_clock clock_;
+
+    /**
+     * Events of a thread.
+     * @events - the ring buffer (PROFILER_BUFFER_SIZE events).
+     * @nb_events - the number of recorded events (the last
+     * PROFILER_BUFFER_SIZE ones are kept).
+     * @id - the number of the thread (in order of first event).
+     */
+    struct buffer
+    {
+        std::vector<profiler::event> events;
+        size_t nb_events;
+        size_t id;
+    };
+
+    const clock_::time_point epoch = clock_::now();
+#if PROFILER_USE_TSC
+    const uint64_t epoch_ticks = __rdtsc();
+#endif
+    std::atomic<bool> enabled(true);
+
+    // Never freed, such that the events of the finished threads are kept.
+    std::mutex buffers_mutex;
+    std::vector<buffer *> buffers;
+
+    thread_local buffer *local_buffer = nullptr;
+    thread_local uint32_t local_depth = 0;
+
+    /**
+     * @return - the time since the epoch, in ticks of the time stamp
+     * counter if available (cheaper than the clock), in ns otherwise.
+     */
+    uint64_t now()
+    {
+#if PROFILER_USE_TSC
+        return __rdtsc() - epoch_ticks;
+#else
+        return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(clock_::now() - epoch).count();
+#endif
+    }
+
+    /**
+     * @return - the number of ns per tick of "now" (measured
+     * against the clock since the epoch).
+     */
+    double get_tick_duration()
+    {
+#if PROFILER_USE_TSC
+        auto ticks = (double) (__rdtsc() - epoch_ticks);
+        auto ns = std::chrono::duration<double, std::nano>(clock_::now() - epoch).count();
+
+        return ticks > 0. ? ns / ticks : 1.;
+#else
+        return 1.;
+#endif
+    }
+
+    buffer &get_local_buffer()
+    {
+        if (local_buffer == nullptr)
+        {
+            std::lock_guard<std::mutex> lock(buffers_mutex);
+            local_buffer = new buffer { std::vector<profiler::event>(PROFILER_BUFFER_SIZE), 0, buffers.size() };
+            buffers.push_back(local_buffer);
+        }
+
+        return *local_buffer;
+    }
+
+    void write_escaped(std::ofstream &file, const char *s)
+    {
+        for (; *s != '\0'; s ++)
+        {
+            if (*s == '"' || *s == '\\')
+            {
+                file << '\\';
+            }
+
+            file << *s;
+        }
+    }
+}
+
+
+profiler::scope::scope(const char *category, const char *name,
+                       size_t nb_rows /*= 0*/, size_t nb_cols /*= 0*/, size_t depth /*= 0*/,
+                       double bytes /*= 0.*/, double flops /*= 0.*/):
+        _enabled(enabled.load(std::memory_order_relaxed)),
+        _category(category)
+{
+    if (!_enabled)
+    {
+        return;
+    }
+
+    std::strncpy(_name, name, PROFILER_NAME_SIZE - 1);
+    _name[PROFILER_NAME_SIZE - 1] = '\0';
+    _dimensions[0] = nb_rows;
+    _dimensions[1] = nb_cols;
+    _dimensions[2] = depth;
+    _bytes = bytes;
+    _flops = flops;
+    local_depth ++;
+    // Last, to not measure the construction.
+    _start = now();
+}
+
+profiler::scope::scope(const char *category, const std::string &name,
+                       size_t nb_rows /*= 0*/, size_t nb_cols /*= 0*/, size_t depth /*= 0*/,
+                       double bytes /*= 0.*/, double flops /*= 0.*/):
+        scope(category, name.c_str(), nb_rows, nb_cols, depth, bytes, flops)
+{
+}
+
+profiler::scope::~scope()
+{
+    if (!_enabled)
+    {
+        return;
+    }
+
+    auto end = now();
+    auto &b = get_local_buffer();
+    auto &e = b.events[b.nb_events % PROFILER_BUFFER_SIZE];
+    local_depth --;
+
+    e.category = _category;
+    std::memcpy(e.name, _name, PROFILER_NAME_SIZE);
+    e.start = _start;
+    e.duration = end - _start;
+    std::copy(_dimensions, _dimensions + 3, e.dimensions);
+    e.bytes = _bytes;
+    e.flops = _flops;
+    e.depth = local_depth;
+    b.nb_events ++;
+}
+
+bool profiler::is_enabled()
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void profiler::set_enabled(bool enabled_)
+{
+    enabled.store(enabled_, std::memory_order_relaxed);
+}
+
+void profiler::clear()
+{
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+
+    for (auto b: buffers)
+    {
+        b->nb_events = 0;
+    }
+}
+
+size_t profiler::get_nb_events()
+{
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    size_t nb_events = 0;
+
+    for (auto b: buffers)
+    {
+        nb_events += std::min(b->nb_events, (size_t) PROFILER_BUFFER_SIZE);
+    }
+
+    return nb_events;
+}
+
+void profiler::export_chrome_trace(const std::string &path)
+{
+    auto file = std::ofstream(path);
+
+    if (!file)
+    {
+        util::ERROR("profiler::export_chrome_trace", "Unable to open " + path);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    bool first = true;
+    auto tick_duration = get_tick_duration();
+
+    // Complete events ("X"), with the times in µs.
+    file << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+
+    for (auto b: buffers)
+    {
+        auto nb_kept = std::min(b->nb_events, (size_t) PROFILER_BUFFER_SIZE);
+
+        for (auto i = b->nb_events - nb_kept; i < b->nb_events; i ++)
+        {
+            auto &e = b->events[i % PROFILER_BUFFER_SIZE];
+
+            file << (first ? "\n" : ",\n") << "{\"name\":\"";
+            write_escaped(file, e.name);
+            file << "\",\"cat\":\"" << e.category << "\",\"ph\":\"X\""
+                 << ",\"ts\":" << (double) e.start * tick_duration / 1000.
+                 << ",\"dur\":" << (double) e.duration * tick_duration / 1000.
+                 << ",\"pid\":0,\"tid\":" << b->id
+                 << ",\"args\":{\"shape\":\"" << e.dimensions[0] << "x" << e.dimensions[1];
+
+            if (e.dimensions[2] != 0)
+            {
+                file << "x" << e.dimensions[2];
+            }
+
+            file << "\",\"bytes\":" << std::setprecision(0) << e.bytes
+                 << ",\"flops\":" << e.flops << std::setprecision(3)
+                 << ",\"depth\":" << e.depth << "}}";
+            first = false;
+        }
+    }
+
+    file << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
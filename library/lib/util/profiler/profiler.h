@@ -0,0 +1,137 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#ifndef CUDANN_PROFILER_H
+#define CUDANN_PROFILER_H
+
+#include "lib/global.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+/**
+ * Number of events kept per thread (the oldest are overwritten).
+ */
+#define PROFILER_BUFFER_SIZE 65536
+
+/**
+ * Maximal length of the name of an event (longer names are truncated).
+ */
+#define PROFILER_NAME_SIZE 40
+
+#define PROFILER_CONCAT_(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_(a, b)
+
+/**
+ * Record the scope as an event (see profiler::scope for the parameters).
+ * Expands to nothing if -global.h/_PROFILE- is not set.
+ */
+#if _PROFILE
+#define PROFILE_SCOPE(...) \
+    cudaNN::profiler::scope PROFILER_CONCAT(__profiler_scope_, __LINE__)(__VA_ARGS__)
+#else
+#define PROFILE_SCOPE(...)
+#endif
+
+
+namespace cudaNN
+{
+    /**
+     * Tracing of the operations (wall time, shapes, bytes and FLOPs).
+     * Each thread records its events in its own ring buffer (no locks,
+     * except on the first event of a thread); the buffers can be
+     * exported as a Chrome trace (chrome://tracing, or ui.perfetto.dev),
+     * where the nested scopes are displayed as a hierarchy.
+     */
+    namespace profiler
+    {
+        /**
+         * Event recorded for a scope.
+         * @category - the type of operation (e.g. "matrix", "layer").
+         * @name - the operation.
+         * @start, @duration - in ticks of the profiler clock (since the start
+         * of the program; converted in µs by the export).
+         * @dimensions - the shape of the main operand (0 if not relevant),
+         * and a third dimension (e.g. the columns of the second operand
+         * of a product).
+         * @bytes, @flops - the estimated memory traffic and floating point
+         * operations.
+         * @depth - the number of enclosing scopes on the thread.
+         */
+        struct event
+        {
+            const char *category;
+            char name[PROFILER_NAME_SIZE];
+            uint64_t start;
+            uint64_t duration;
+            size_t dimensions[3];
+            double bytes;
+            double flops;
+            uint32_t depth;
+        };
+
+        /**
+         * Record an event from its construction to its destruction
+         * (to be used through the PROFILE_SCOPE macro).
+         */
+        class scope
+        {
+            public:
+
+                /**
+                 * @param category - a string literal (not copied).
+                 * @param name - copied in the event.
+                 */
+                scope(const char *category, const char *name,
+                      size_t nb_rows = 0, size_t nb_cols = 0, size_t depth = 0,
+                      double bytes = 0., double flops = 0.);
+                scope(const char *category, const std::string &name,
+                      size_t nb_rows = 0, size_t nb_cols = 0, size_t depth = 0,
+                      double bytes = 0., double flops = 0.);
+                ~scope();
+
+                scope(const scope &) = delete;
+                scope &operator=(const scope &) = delete;
+
+            private:
+
+                bool _enabled;
+                const char *_category;
+                char _name[PROFILER_NAME_SIZE];
+                uint64_t _start;
+                size_t _dimensions[3];
+                double _bytes;
+                double _flops;
+        };
+
+        /**
+         * @return - true if the events are recorded (default: true).
+         */
+        bool is_enabled();
+        void set_enabled(bool enabled);
+
+        /**
+         * Remove the recorded events of every thread.
+         * To be called while no operation is running.
+         */
+        void clear();
+
+        /**
+         * @return - the number of recorded events (over the threads).
+         */
+        size_t get_nb_events();
+
+        /**
+         * Write the recorded events of every thread as a Chrome trace (JSON).
+         * To be called while no operation is running.
+         * @param path - the path of the file.
+         */
+        void export_chrome_trace(const std::string &path);
+    }
+}
+
+
+#endif //CUDANN_PROFILER_H
@@ -0,0 +1,154 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "rng.h"
+#include "lib/util/parallel/parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+
+using namespace cudaNN;
+
+
+namespace
+{
+    std::atomic<uint64_t> seed(0);
+    std::atomic<uint64_t> nb_sequences(0);
+
+    /**
+     * Call "f(i, x)" for the positions i of [0, (length + 3) / 4[ of the
+     * sequence starting at "first", over the threads ("x" the 4 numbers).
+     * @param cost - the number of operations of "f".
+     */
+    template <typename F>
+    void for_positions(size_t length, size_t cost, rng::key k, rng::counter first, F f)
+    {
+        auto nb_positions = (length + 3) / 4;
+
+        parallel::for_range(nb_positions, std::max((size_t) 1, (size_t) PARALLEL_MIN_CHUNK_SIZE / cost),
+                            [&](size_t begin, size_t end)
+        {
+            auto c = first;
+            c[0] += (uint32_t) begin;
+
+            for (size_t i = begin; i < end; i ++)
+            {
+                f(i, rng::philox(c, k));
+                c[0] ++;
+            }
+        });
+    }
+}
+
+
+void rng::set_seed(uint64_t s)
+{
+    seed = s;
+    nb_sequences = 0;
+}
+
+uint64_t rng::get_seed()
+{
+    return seed;
+}
+
+rng::key rng::get_key()
+{
+    return make_key(seed);
+}
+
+rng::counter rng::next_counter()
+{
+    auto n = nb_sequences ++;
+
+    return {{ 0, 1u << 31, (uint32_t) n, (uint32_t) (n >> 32) }};
+}
+
+uint64_t rng::next_seed()
+{
+    auto x = philox(next_counter(), get_key());
+
+    return (uint64_t) x[0] | (uint64_t) x[1] << 32;
+}
+
+void rng::uniform(float *data, size_t length, float min, float max, key k, counter first)
+{
+    // (A position costs about 100 operations.)
+    for_positions(length, 100, k, first, [&](size_t i, const counter &x)
+    {
+        for (size_t j = 0; j < 4 && i * 4 + j < length; j ++)
+        {
+            data[i * 4 + j] = min + (max - min) * to_uniform(x[j]);
+        }
+    });
+}
+
+void rng::normal(float *data, size_t length, float mean, float deviation, key k, counter first)
+{
+    for_positions(length, 200, k, first, [&](size_t i, const counter &x)
+    {
+        for (size_t j = 0; j < 4; j += 2)
+        {
+            // "u" in ]0, 1] (logarithm).
+            auto u = to_uniform(x[j]) + 1.f / 16777216.f;
+            auto radius = deviation * std::sqrt(-2.f * std::log(u));
+            auto angle = 6.28318531f * to_uniform(x[j + 1]);
+
+            if (i * 4 + j < length)
+            {
+                data[i * 4 + j] = mean + radius * std::cos(angle);
+            }
+
+            if (i * 4 + j + 1 < length)
+            {
+                data[i * 4 + j + 1] = mean + radius * std::sin(angle);
+            }
+        }
+    });
+}
+
+void rng::shuffle(std::vector<size_t> &values, key k, counter first)
+{
+    counter x;
+
+    for (size_t i = values.size(); i > 1; i --)
+    {
+        auto n = values.size() - i;
+
+        if (n % 4 == 0)
+        {
+            x = philox(first, k);
+            first[0] ++;
+        }
+
+        // A position in [0, i[ (high bits of the product: no division).
+        auto j = (size_t) (((uint64_t) x[n % 4] * (uint64_t) i) >> 32);
+        std::swap(values[i - 1], values[j]);
+    }
+}
+
+
+uint32_t rng::bernoulli_word(key k, counter first, size_t w, float probability)
+{
+    // The numbers (uniform over the 32 bits) below which a bit is set.
+    auto p = std::min(std::max((double) probability, 0.), 1.);
+    auto threshold = (uint64_t) (p * 4294967296.);
+    uint32_t bits = 0;
+    first[0] += (uint32_t) (w * 8);
+
+    for (uint32_t b = 0; b < 8; b ++)
+    {
+        auto x = philox(first, k);
+        first[0] ++;
+
+        for (uint32_t j = 0; j < 4; j ++)
+        {
+            bits |= (uint32_t) ((uint64_t) x[j] < threshold) << (b * 4 + j);
+        }
+    }
+
+    return bits;
+}
@@ -0,0 +1,127 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#ifndef CUDANN_RNG_H
+#define CUDANN_RNG_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace cudaNN
+{
+    /**
+     * Counter-based random numbers (Philox4x32-10): the numbers are a function
+     * of a key (the seed) and of a counter (their position), without any state.
+     * Any part of a sequence can be generated independently (e.g. over the
+     * threads, or again later), and gives the same values.
+     */
+    namespace rng
+    {
+        /**
+         * @counter - the position of 4 random numbers in the sequence.
+         * @key - the sequence (the seed).
+         */
+        typedef std::array<uint32_t, 4> counter;
+        typedef std::array<uint32_t, 2> key;
+
+        /**
+         * @return - the key of the sequence of "seed".
+         */
+        inline key make_key(uint64_t seed)
+        {
+            return {{ (uint32_t) seed, (uint32_t) (seed >> 32) }};
+        }
+
+        /**
+         * @return - the 4 random numbers (uniform over the 32 bits) of the
+         * position "c" in the sequence "k".
+         */
+        inline counter philox(counter c, key k)
+        {
+            for (int round = 0; round < 10; round ++)
+            {
+                auto p0 = (uint64_t) 0xD2511F53 * c[0];
+                auto p1 = (uint64_t) 0xCD9E8D57 * c[2];
+                c = {{ (uint32_t) (p1 >> 32) ^ c[1] ^ k[0], (uint32_t) p1,
+                       (uint32_t) (p0 >> 32) ^ c[3] ^ k[1], (uint32_t) p0 }};
+                k[0] += 0x9E3779B9;
+                k[1] += 0xBB67AE85;
+            }
+
+            return c;
+        }
+
+        /**
+         * @return - a number uniform in [0, 1[, from 32 random bits (the 24 most
+         * significant ones: every value is a float).
+         */
+        inline float to_uniform(uint32_t x)
+        {
+            return (float) (x >> 8) * (1.f / 16777216.f);
+        }
+
+        /**
+         * Seed of the random numbers of the library (initializations of the
+         * weights, shuffles of the datasets...): each of them takes its own
+         * sequence of this seed (see "next_counter"), such that a run is
+         * reproduced by setting the same seed before building the models.
+         * @param seed - 0 by default; also starts the sequences over.
+         */
+        void set_seed(uint64_t seed);
+        uint64_t get_seed();
+
+        /**
+         * @return - the key of the seed of the library (see "set_seed").
+         */
+        key get_key();
+
+        /**
+         * @return - the first counter of a new sequence of the seed of the library:
+         * "{ 0, 1 << 31, n, n >> 32 }", "n" the number of sequences taken since the
+         * seed was set (the second number keeps them apart from the sequences of
+         * the dropouts, see -dropout.h-).
+         */
+        counter next_counter();
+
+        /**
+         * @return - a new seed drawn from the seed of the library (the numbers of
+         * "next_counter"), e.g. for the masks of a dropout: distinct for each
+         * call, and reproduced by setting the same seed (see "set_seed").
+         */
+        uint64_t next_seed();
+
+        /**
+         * Fill "data" with the numbers n°[0, length[ of the sequence starting at
+         * "first" (the number n°i from the number "i % 4" of the position "{
+         * first[0] + i / 4, first[1], first[2], first[3] }"), over the threads:
+         * the values do not depend on the number of threads.
+         * @uniform - in [min, max[.
+         * @normal - of the normal distribution (Box-Muller, two values out of two
+         * numbers).
+         */
+        void uniform(float *data, size_t length, float min, float max, key k, counter first);
+        void normal(float *data, size_t length, float mean, float deviation, key k, counter first);
+
+        /**
+         * Shuffle "values" (Fisher-Yates), with the numbers of the sequence
+         * starting at "first" (as "uniform").
+         */
+        void shuffle(std::vector<size_t> &values, key k, counter first);
+
+        /**
+         * Bernoulli bits: the bit n°i of the sequence is set with the probability
+         * "probability", from the number "i % 4" of the position "{ first[0] + i / 4,
+         * first[1], first[2], first[3] }".
+         * @return - the bits [32 * w, 32 * w + 32[ (bit n°i in "1 << (i % 32)"):
+         * any word of the sequence can be generated independently.
+         */
+        uint32_t bernoulli_word(key k, counter first, size_t w, float probability);
+    }
+}
+
+
+#endif //CUDANN_RNG_H
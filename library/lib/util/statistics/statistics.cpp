@@ -0,0 +1,145 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#include "statistics.h"
+#include "lib/util/util.h"
+
+#include <atomic>
+#include <fstream>
+
+
+using namespace cudaNN;
+
+
+namespace
+{
+    struct atomic_counter
+    {
+        std::atomic<uint64_t> nb_calls;
+        std::atomic<uint64_t> nb_elements;
+        std::atomic<uint64_t> bytes;
+        std::atomic<uint64_t> flops;
+    };
+
+    const char *NAMES[statistics::NB_OPERATIONS] =
+    {
+        "add", "subtract", "multiply", "add float", "subtract float", "multiply float",
+        "hadamard_product", "sum", "mean", "max", "min", "argmax",
+        "reduce_rows", "reduce_cols", "transpose", "copy",
+        "function", "function derivative", "function with derivative"
+    };
+
+    atomic_counter counters[statistics::NB_OPERATIONS];
+
+    std::atomic<uint64_t> nb_alive(0);
+    std::atomic<uint64_t> bytes_alive(0);
+    std::atomic<uint64_t> peak_bytes(0);
+    std::atomic<uint64_t> nb_allocations(0);
+    std::atomic<uint64_t> nb_frees(0);
+    std::atomic<uint64_t> allocated_bytes(0);
+
+    // The counters are independent (no ordering needed).
+    const auto relaxed = std::memory_order_relaxed;
+}
+
+
+const char *statistics::get_name(operations o)
+{
+    return NAMES[o];
+}
+
+void statistics::count(operations o, size_t nb_elements, double bytes /*= 0.*/, double flops /*= 0.*/)
+{
+    auto &c = counters[o];
+    c.nb_calls.fetch_add(1, relaxed);
+    c.nb_elements.fetch_add(nb_elements, relaxed);
+    c.bytes.fetch_add((uint64_t) bytes, relaxed);
+    c.flops.fetch_add((uint64_t) flops, relaxed);
+}
+
+void statistics::count_allocation(size_t bytes)
+{
+    nb_alive.fetch_add(1, relaxed);
+    nb_allocations.fetch_add(1, relaxed);
+    allocated_bytes.fetch_add(bytes, relaxed);
+
+    auto alive = bytes_alive.fetch_add(bytes, relaxed) + bytes;
+    auto peak = peak_bytes.load(relaxed);
+
+    while (alive > peak && ! peak_bytes.compare_exchange_weak(peak, alive, relaxed))
+    {
+    }
+}
+
+void statistics::count_free(size_t bytes)
+{
+    nb_alive.fetch_sub(1, relaxed);
+    nb_frees.fetch_add(1, relaxed);
+    bytes_alive.fetch_sub(bytes, relaxed);
+}
+
+statistics::counter statistics::get_counter(operations o)
+{
+    auto &c = counters[o];
+
+    return { c.nb_calls.load(relaxed), c.nb_elements.load(relaxed),
+             c.bytes.load(relaxed), c.flops.load(relaxed) };
+}
+
+statistics::allocations statistics::get_allocations()
+{
+    return { nb_alive.load(relaxed), bytes_alive.load(relaxed), peak_bytes.load(relaxed),
+             nb_allocations.load(relaxed), nb_frees.load(relaxed), allocated_bytes.load(relaxed) };
+}
+
+void statistics::reset_peak()
+{
+    peak_bytes.store(bytes_alive.load(relaxed), relaxed);
+}
+
+void statistics::reset()
+{
+    for (auto &c: counters)
+    {
+        c.nb_calls.store(0, relaxed);
+        c.nb_elements.store(0, relaxed);
+        c.bytes.store(0, relaxed);
+        c.flops.store(0, relaxed);
+    }
+
+    nb_allocations.store(0, relaxed);
+    nb_frees.store(0, relaxed);
+    allocated_bytes.store(0, relaxed);
+    reset_peak();
+}
+
+void statistics::write_csv(const std::string &path)
+{
+    auto file = std::ofstream(path);
+
+    if (!file)
+    {
+        util::ERROR("statistics::write_csv", "Unable to open " + path);
+        return;
+    }
+
+    file << "Operation;Calls;Elements;Bytes;FLOPs" << std::endl;
+
+    for (size_t i = 0; i < NB_OPERATIONS; i ++)
+    {
+        auto c = get_counter((operations) i);
+
+        if (c.nb_calls > 0)
+        {
+            file << NAMES[i] << ";" << c.nb_calls << ";" << c.nb_elements << ";"
+                 << c.bytes << ";" << c.flops << std::endl;
+        }
+    }
+
+    auto a = get_allocations();
+    file << "alive matrices;" << a.nb_alive       << ";;" << a.bytes_alive     << ";" << std::endl
+         << "peak;"           << ";"              << ";"  << a.peak_bytes      << ";" << std::endl
+         << "allocations;"    << a.nb_allocations << ";;" << a.allocated_bytes << ";" << std::endl
+         << "frees;"          << a.nb_frees       << ";;;" << std::endl;
+}
@@ -0,0 +1,136 @@
+//
+// Created by Emilien Aufauvre on 19/10/2026.
+//
+
+#ifndef CUDANN_STATISTICS_H
+#define CUDANN_STATISTICS_H
+
+#include "lib/global.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+/**
+ * Count an operation (see statistics::count for the parameters).
+ * Expands to nothing if -global.h/_STATISTICS- is not set.
+ */
+#if _STATISTICS
+#define COUNT_OPERATION(...) cudaNN::statistics::count(__VA_ARGS__)
+#define COUNT_ALLOCATION(bytes) cudaNN::statistics::count_allocation(bytes)
+#define COUNT_FREE(bytes) cudaNN::statistics::count_free(bytes)
+#else
+#define COUNT_OPERATION(...)
+#define COUNT_ALLOCATION(bytes)
+#define COUNT_FREE(bytes)
+#endif
+
+
+namespace cudaNN
+{
+    /**
+     * Counters of the operations on the matrices (calls, elements, bytes
+     * moved and FLOPs per type of operation), and of the memory of the
+     * matrices (alive, allocated and peak bytes).
+     * The counters are global (over the threads), and can be queried
+     * at any time.
+     */
+    namespace statistics
+    {
+        enum operations
+        {
+            ADD,
+            SUBTRACT,
+            MULTIPLY,
+            ADD_FLOAT,
+            SUBTRACT_FLOAT,
+            MULTIPLY_FLOAT,
+            HADAMARD_PRODUCT,
+            SUM,
+            MEAN,
+            MAXIMUM,
+            MINIMUM,
+            ARGMAX,
+            REDUCE_ROWS,
+            REDUCE_COLS,
+            TRANSPOSE,
+            COPY,
+            FUNCTION,
+            FUNCTION_DERIVATIVE,
+            FUNCTION_WITH_DERIVATIVE,
+            NB_OPERATIONS
+        };
+
+        /**
+         * Counter of a type of operation.
+         * @nb_calls - the number of operations.
+         * @nb_elements - the number of values processed (inputs, or outputs
+         * of the products).
+         * @bytes - the estimated bytes read and written.
+         * @flops - the estimated floating point operations.
+         */
+        struct counter
+        {
+            uint64_t nb_calls;
+            uint64_t nb_elements;
+            uint64_t bytes;
+            uint64_t flops;
+        };
+
+        /**
+         * Memory of the matrices (host memory, in bytes).
+         * @nb_alive, @bytes_alive - the matrices currently allocated.
+         * @peak_bytes - the greatest "bytes_alive" since the last "reset_peak".
+         * @nb_allocations, @nb_frees, @allocated_bytes - since the last "reset".
+         */
+        struct allocations
+        {
+            uint64_t nb_alive;
+            uint64_t bytes_alive;
+            uint64_t peak_bytes;
+            uint64_t nb_allocations;
+            uint64_t nb_frees;
+            uint64_t allocated_bytes;
+        };
+
+        /**
+         * @return - the name of the operation (e.g. "hadamard_product").
+         */
+        const char *get_name(operations o);
+
+        /**
+         * @param o - the type of the operation.
+         * @param nb_elements - the number of values processed.
+         * @param bytes - the estimated bytes read and written.
+         * @param flops - the estimated floating point operations.
+         */
+        void count(operations o, size_t nb_elements, double bytes = 0., double flops = 0.);
+        void count_allocation(size_t bytes);
+        void count_free(size_t bytes);
+
+        counter get_counter(operations o);
+        allocations get_allocations();
+
+        /**
+         * Restart the peak from the bytes currently alive.
+         */
+        void reset_peak();
+
+        /**
+         * Reset the counters of the operations, the peak, and the numbers
+         * of allocations (the alive matrices are kept).
+         */
+        void reset();
+
+        /**
+         * Write the counters of the operations in a csv file
+         * (a row per type of operation, with the memory of the matrices).
+         * @param path - the path of the csv file.
+         */
+        void write_csv(const std::string &path);
+    }
+}
+
+
+#endif //CUDANN_STATISTICS_H
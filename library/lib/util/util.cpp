@@ -3,6 +3,7 @@
 //
 
 #include "util.h"
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 
@@ -24,7 +25,8 @@ void util::CUDA_ASSERT(cudaError_t code, const char *file, int line, bool abort
 
 void util::INFO(const std::string &location, const std::string &message)
 {
-    std::cout << "[INFO] at " + location + " >> " + message << std::endl;
+    // Not flushed at each message, unlike the errors.
+    std::cout << "[INFO] at " + location + " >> " + message << '\n';
 }
 
 void util::DEBUG(const std::string &location, const std::string &message)
@@ -86,7 +88,8 @@ std::pair<dim3, dim3> util::get_cuda_2dims(std::pair<size_t, size_t> dimensions)
     size_t nb_cols = dimensions.second;
 
     dim3 blocks_per_grid(1, 1);
-    dim3 threads_per_block = dim3(nb_cols, nb_rows);
+    // At least one thread (a valid launch) for the empty matrices.
+    dim3 threads_per_block = dim3(std::max(nb_cols, (size_t) 1), std::max(nb_rows, (size_t) 1));
 
     if (nb_rows * nb_cols > MAX_NB_THREADS_BLOCK)
     {
@@ -119,7 +122,7 @@ std::pair<dim3, dim3> util::get_cuda_1dims(std::pair<size_t, size_t> dimensions)
     size_t nb_cols = dimensions.second;
 
     dim3 blocks_per_grid(1);
-    dim3 threads_per_block = dim3(nb_cols * nb_rows);
+    dim3 threads_per_block = dim3(std::max(nb_cols * nb_rows, (size_t) 1));
 
     if (nb_rows * nb_cols > MAX_NB_THREADS_BLOCK)
     {
@@ -166,10 +169,3 @@ void util::CPU_end_record(float *time_event)
     *time_event = 1000.f * ((float) std::clock() - *time_event) / CLOCKS_PER_SEC;
 }
 
-void util::add_to_csv(const std::string &row, const std::string &path)
-{
-    std::ofstream file;
-    file.open(path, std::ios::app);
-    file << row << std::endl;
-    file.close();
-}
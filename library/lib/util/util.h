@@ -81,13 +81,6 @@ namespace cudaNN
          * @param end_event - the end event (ms).
          */
         void CPU_end_record(float *time_event);
-
-        /**
-         * Add a row to a csv file.
-         * @param row - the row content to add (without the line break).
-         * @param path - the path of csv file.
-         */
-        void add_to_csv(const std::string &row, const std::string &path);
     };
 }
 
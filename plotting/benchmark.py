@@ -0,0 +1,106 @@
+import json
+import sys
+
+import matplotlib.pyplot as plt
+import pandas as pd
+
+
+def load(path):
+    """
+    Load the results of a run of "library/examples/benchmark.cpp",
+    with the label of the run (e.g. a commit, or the backend).
+    """
+    with open(path) as file:
+        data = json.load(file)
+    results = pd.DataFrame(data["benchmarks"])
+    results["label"] = data["context"]["label"]
+    return results
+
+
+def print_comparison(results, labels):
+    """
+    Print the median time of each benchmark for every run,
+    and the speedup of each run over the first one.
+    """
+    table = results.pivot_table(index=["name", "shape"], columns="label",
+                                values="median", sort=False)[labels]
+    for label in labels[1:]:
+        table["speedup " + label] = table[labels[0]] / table[label]
+    with pd.option_context("display.max_rows", None, "display.width", 200):
+        print(table)
+
+
+def print_data(results, labels, metric, ax, title):
+    # One line per run; the shapes for the x axes.
+    for label in labels:
+        data = results[results["label"] == label]
+        if metric == "median":
+            ax.errorbar(data["shape"], data["median"],
+                        yerr=[data["median"] - data["p10"], data["p90"] - data["median"]],
+                        marker='o', capsize=3, label=label)
+        else:
+            ax.plot(data["shape"], data[metric], marker='o', label=label)
+    # Set the title.
+    ax.set_title(title, fontsize=12)
+    ax.tick_params(axis='x', labelrotation=90, labelsize=6)
+    ax.set_yscale("log")
+    ax.legend()
+
+
+def main():
+    """
+    Compare the runs of the "library/examples/benchmark.cpp" (or
+    "benchmark_training.cpp") target (e.g. CPU and GPU, or two commits).
+    Usage: python benchmark.py
+    [--metric median|gflops|gbytes_per_second|items_per_second]
+    run_1.json [run_2.json ...]
+    The first run is the reference of the printed speedups.
+    Executing this script will produce a chart per operation (the median
+    time, with the 10th and 90th percentiles, or the given rate).
+    """
+    args = sys.argv[1:]
+    metric = "median"
+    if len(args) >= 2 and args[0] == "--metric":
+        metric = args[1]
+        args = args[2:]
+    YLABELS = {"median": "Execution time (ms)",
+               "gflops": "GFLOP/s",
+               "gbytes_per_second": "GB/s",
+               "items_per_second": "Items/s"}
+
+    runs = [load(path) for path in args]
+    results = pd.concat(runs)
+    labels = [run["label"].iloc[0] for run in runs]
+    names = list(dict.fromkeys(results["name"]))
+    if metric != "median":
+        # Only the operations with the rate.
+        names = [name for name in names
+                 if (results[results["name"] == name][metric] > 0).any()]
+
+    print_comparison(results, labels)
+
+    NB_COLS = 4
+    NB_ROWS = (len(names) + NB_COLS - 1) // NB_COLS
+    fig, ax = plt.subplots(nrows=NB_ROWS, ncols=NB_COLS, squeeze=False,
+                           figsize=(6 * NB_COLS, 4 * NB_ROWS))
+    plt.tight_layout(pad=3)
+
+    for i in range(0, NB_ROWS):
+        for j in range(0, NB_COLS):
+            index = i * NB_COLS + j
+            if index < len(names):
+                data = results[results["name"] == names[index]]
+                print_data(data, labels, metric, ax[i][j], names[index])
+                ax[i][j].set_ylabel(YLABELS[metric])
+            else:
+                ax[i][j].set_visible(False)
+
+    # Save into pdf.
+    plt.savefig("benchmark", format="pdf", dpi=1200)
+    # Show the graph.
+    plt.show()
+
+
+
+if __name__ == "__main__":
+    main()
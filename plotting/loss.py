@@ -3,8 +3,8 @@ import pandas as pd
 
 
 def print_data(csv, ax, title):
-    # Uses the first column for the x axes.
-    csv.plot(y=csv.columns[0], marker='o', xticks=csv.iloc[:,0].astype(int), ax=ax)
+    # Uses the entries for the x axes.
+    csv.plot(x="Entry", y="Loss", marker='o', ax=ax)
     # Set the bottom value to 0 for the Y axes.
     ax.set_ylim(bottom=0)
     # Set the title.
@@ -18,11 +18,12 @@ def main():
     of a neural network.
     The loss file (loss.csv) obtained from a neural network
     training (with option "print_loss" set), should be placed
-    in the "data/" directory.
+    in the "data/" directory. Each record is the mean loss of the
+    entries since the previous one.
     """
     NB_ROWS = 1
     NB_COLS = 1
-    XLABEL = "Number of (loss) records"
+    XLABEL = "Number of entries"
     YLABEL = "Loss value"
 
     fig, ax = plt.subplots(nrows=NB_ROWS, ncols=NB_COLS)